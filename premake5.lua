@@ -34,6 +34,8 @@ project "cdogs-sdl"
 	}
 	removefiles
 	{
+		"src/bake/**",
+		"src/bench/**",
 		"src/cdogsed/**",
 		"src/tests/**",
 	}
@@ -44,8 +46,7 @@ project "cdogs-sdl"
 		"src/cdogs",
 		"src/cdogs/include/",
 		"src/cdogs/proto/nanopb/",
-		"src/cdogs/enet/include/",
-		"src/cdogs/yajl/api/"
+		"src/cdogs/enet/include/"
 	}
 	
 	filter "configurations:Debug"
@@ -54,4 +55,72 @@ project "cdogs-sdl"
 
    filter "configurations:Release"
       defines { "NDEBUG" }
-      optimize "On"
\ No newline at end of file
+      optimize "On"
+
+-- Headless simulation benchmark; shares the game library but not the
+-- menus and screens
+project "cdogs-bench"
+	kind "ConsoleApp"
+	language "C++"
+	targetdir "bin/%{cfg.buildcfg}"
+
+	files
+	{
+		"src/bench/**.h",
+		"src/bench/**.cpp",
+		"src/cdogs/**.h",
+		"src/cdogs/**.cpp",
+		"src/json/**.h",
+		"src/json/**.cpp"
+	}
+
+	includedirs
+	{
+		"src/",
+		"src/cdogs",
+		"src/cdogs/include/",
+		"src/cdogs/proto/nanopb/",
+		"src/cdogs/enet/include/"
+	}
+
+	filter "configurations:Debug"
+      defines { "DEBUG" }
+      symbols "On"
+
+   filter "configurations:Release"
+      defines { "NDEBUG" }
+      optimize "On"
+
+-- Asset baker; decodes graphics and sounds, and flattens class tables, into
+-- a pack the game can map at start-up
+project "cdogs-bake"
+	kind "ConsoleApp"
+	language "C++"
+	targetdir "bin/%{cfg.buildcfg}"
+
+	files
+	{
+		"src/bake/**.h",
+		"src/bake/**.cpp",
+		"src/cdogs/**.h",
+		"src/cdogs/**.cpp",
+		"src/json/**.h",
+		"src/json/**.cpp"
+	}
+
+	includedirs
+	{
+		"src/",
+		"src/cdogs",
+		"src/cdogs/include/",
+		"src/cdogs/proto/nanopb/",
+		"src/cdogs/enet/include/"
+	}
+
+	filter "configurations:Debug"
+      defines { "DEBUG" }
+      symbols "On"
+
+   filter "configurations:Release"
+      defines { "NDEBUG" }
+      optimize "On"
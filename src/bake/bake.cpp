@@ -0,0 +1,151 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+
+#include <cdogs/asset_pack.h>
+#include <cdogs/files.h>
+#include <cdogs/log.h>
+#include <cdogs/sounds.h>
+#include <cdogs/sys_config.h>
+#include <cdogs/XGetopt.h>
+
+// Asset baker
+// Decodes the graphics and sounds, and flattens the class tables, ahead of
+// time into a pack that the game maps at start-up, instead of decoding and
+// parsing each file.
+
+typedef struct {
+	const char *Data;
+	const char *Output;
+} BakeOptions;
+
+static void PrintBakeHelp(void) {
+	printf("%s\n", "Usage: cdogs-bake [options]\n"
+			"    --data=DIR       Data directory (default the game's)\n"
+			"    --output=FILE    Pack to write (default data "
+			ASSET_PACK_FILE ")\n");
+}
+
+static bool ParseBakeArgs(BakeOptions *o, int argc, char *argv[]) {
+	struct option longopts[] = { { "data", required_argument, NULL, 'd' },
+			{ "output", required_argument, NULL, 'o' }, { "help",
+					no_argument, NULL, 'h' }, { 0, 0, NULL, 0 } };
+	int opt = 0;
+	int idx = 0;
+	while ((opt = getopt_long(argc, argv, "d:o:h", longopts, &idx)) != -1) {
+		switch (opt) {
+		case 'd':
+			o->Data = optarg;
+			break;
+		case 'o':
+			o->Output = optarg;
+			break;
+		default:
+			PrintBakeHelp();
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	int err = EXIT_SUCCESS;
+	BakeOptions o;
+	memset(&o, 0, sizeof o);
+	char output[CDOGS_PATH_MAX];
+	CArray files[ASSET_SECTION_COUNT];
+	int count = 0;
+	for (int i = 0; i < ASSET_SECTION_COUNT; i++) {
+		CArrayInit(&files[i], sizeof(AssetFile));
+	}
+	Uint64 start;
+
+	LogInit();
+	if (!ParseBakeArgs(&o, argc, argv)) {
+		LogTerminate();
+		return EXIT_FAILURE;
+	}
+	if (o.Output != NULL) {
+		strcpy(output, o.Output);
+	} else {
+		GetDataFilePath(output, ASSET_PACK_FILE);
+	}
+	if (!IMG_Init(IMG_INIT_PNG)) {
+		printf("IMG_Init: %s\n", IMG_GetError());
+		err = EXIT_FAILURE;
+		goto bail;
+	}
+	// Sounds are decoded to the format the game opens the device with; no
+	// sound is played, so the dummy driver will do
+	SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+	if (SDL_Init(SDL_INIT_AUDIO) != 0
+			|| Mix_OpenAudio(SOUND_FREQUENCY, SOUND_FORMAT,
+					SOUND_OUTPUT_CHANNELS, 1024) != 0) {
+		printf("Cannot open audio: %s\n", SDL_GetError());
+		err = EXIT_FAILURE;
+		goto bail;
+	}
+
+	for (int i = 0; i < ASSET_SECTION_COUNT; i++) {
+		AssetSectionFilesList(&files[i], (AssetSection) i, o.Data);
+		count += (int) files[i].size;
+	}
+	if (count == 0) {
+		printf("No files found to bake\n");
+		err = EXIT_FAILURE;
+		goto bail;
+	}
+	start = SDL_GetPerformanceCounter();
+	if (!AssetPackWrite(output, files)) {
+		err = EXIT_FAILURE;
+		goto bail;
+	}
+	printf("Baked %d images, %d class tables and %d sounds into %s in "
+			"%.0fms\n", (int) files[ASSET_SECTION_IMAGES].size,
+			(int) files[ASSET_SECTION_CLASSES].size,
+			(int) files[ASSET_SECTION_SOUNDS].size, output,
+			(SDL_GetPerformanceCounter() - start) * 1000.0
+					/ SDL_GetPerformanceFrequency());
+
+bail:
+	for (int i = 0; i < ASSET_SECTION_COUNT; i++) {
+		AssetFilesTerminate(&files[i]);
+	}
+	Mix_CloseAudio();
+	IMG_Quit();
+	SDL_Quit();
+	LogTerminate();
+	return err;
+}
@@ -0,0 +1,579 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL2/SDL.h>
+
+#include <cdogs/actor_placement.h>
+#include <cdogs/actors.h>
+#include <cdogs/ai.h>
+#include <cdogs/ammo.h>
+#include <cdogs/asset_pack.h>
+#include <cdogs/camera.h>
+#include <cdogs/campaigns.h>
+#include <cdogs/character_class.h>
+#include <cdogs/collision/collision.h>
+#include <cdogs/config_io.h>
+#include <cdogs/draw/char_sprites.h>
+#include <cdogs/events.h>
+#include <cdogs/files.h>
+#include <cdogs/font_utils.h>
+#include <cdogs/gamedata.h>
+#include <cdogs/grafx.h>
+#include <cdogs/handle_game_events.h>
+#include <cdogs/json_utils.h>
+#include <cdogs/log.h>
+#include <cdogs/los.h>
+#include <cdogs/map_build.h>
+#include <cdogs/mission.h>
+#include <cdogs/mission_arena.h>
+#include <cdogs/objs.h>
+#include <cdogs/particle.h>
+#include <cdogs/pic_manager.h>
+#include <cdogs/pickup.h>
+#include <cdogs/player.h>
+#include <cdogs/utils.h>
+#include <cdogs/XGetopt.h>
+
+static void PrintBenchHelp(void) {
+	printf("%s\n", "Usage: cdogs-bench [options]\n"
+			"Scenario:\n"
+			"    --campaign=PATH  Load a campaign instead of a stress mission\n"
+			"    --mission=N      Mission index in the campaign (default 0)\n"
+			"    --enemies=N      Stress mission enemies (default 50)\n"
+			"    --barrels=N      Stress mission explosive barrels (default 50)\n"
+			"    --map=TYPE       Stress mission map type: classic, cave\n"
+			"    --size=WxH       Stress mission size in tiles (default 64x64)\n"
+			"    --players=N      AI players (default 1)\n"
+			"    --seed=N         Random seed (default 0)\n"
+			"Run:\n"
+			"    --ticks=N        Ticks to measure (default 3000)\n"
+			"    --warmup=N       Ticks to run before measuring (default 60)\n"
+			"    --json=FILE      Write results as JSON to FILE\n"
+			"    --golden=FILE    Draw the first frame of the mission and\n"
+			"                     compare it with the PNG FILE, failing if\n"
+			"                     any pixel differs or FILE doesn't exist\n"
+			"    --record-golden  Write the frame to the --golden FILE\n"
+			"                     instead of comparing it\n"
+			"    --mix=N          Time mixing N sound voices instead of\n"
+			"                     running a mission\n"
+			"    --load=N         Time loading every campaign in missions/\n"
+			"                     N times instead of running a mission\n"
+			"    --tiles=N        Time N passes over the tile layer of\n"
+			"                     128x128, 512x512 and 1024x1024 maps instead\n"
+			"                     of running a mission\n"
+			"    --missions=N     Build and warm up N missions in a row,\n"
+			"                     cycling through the campaign, and report\n"
+			"                     arena and resident memory after each\n");
+}
+
+static bool ParseBenchArgs(BenchOptions *o, int argc, char *argv[]) {
+	struct option longopts[] = { { "campaign", required_argument, NULL, 'c' },
+			{ "mission", required_argument, NULL, 'm' }, { "enemies",
+					required_argument, NULL, 'e' }, { "barrels",
+					required_argument, NULL, 'b' }, { "map",
+					required_argument, NULL, 't' }, { "size",
+					required_argument, NULL, 's' }, { "players",
+					required_argument, NULL, 'p' }, { "ticks",
+					required_argument, NULL, 'k' }, { "warmup",
+					required_argument, NULL, 'w' }, { "seed",
+					required_argument, NULL, 'r' }, { "json",
+					required_argument, NULL, 'j' }, { "golden",
+					required_argument, NULL, 'g' }, { "mix", required_argument,
+					NULL, 'x' }, { "load", required_argument, NULL, 'l' }, {
+					"tiles", required_argument, NULL, 'i' }, { "missions",
+					required_argument, NULL, 'n' }, {
+					"record-golden", no_argument, NULL, 'R' }, { "help",
+					no_argument, NULL, 'h' }, { 0, 0, NULL, 0 } };
+	int opt = 0;
+	int idx = 0;
+	while ((opt = getopt_long(argc, argv, "c:m:e:b:t:s:p:k:w:r:j:g:x:l:i:n:Rh",
+			longopts, &idx)) != -1) {
+		switch (opt) {
+		case 'c':
+			o->Campaign = optarg;
+			break;
+		case 'm':
+			o->MissionIndex = MAX(0, atoi(optarg));
+			break;
+		case 'e':
+			o->Enemies = MAX(0, atoi(optarg));
+			break;
+		case 'b':
+			o->Barrels = MAX(0, atoi(optarg));
+			break;
+		case 't':
+			o->Type = StrMapType(optarg);
+			if (o->Type == MAPTYPE_STATIC) {
+				printf("Cannot generate static maps\n");
+				return false;
+			}
+			break;
+		case 's':
+			if (sscanf(optarg, "%dx%d", &o->Size.x, &o->Size.y) != 2
+					|| o->Size.x <= 0 || o->Size.y <= 0) {
+				printf("Invalid size %s\n", optarg);
+				return false;
+			}
+			break;
+		case 'p':
+			o->Players = CLAMP(atoi(optarg), 0, MAX_LOCAL_PLAYERS);
+			break;
+		case 'k':
+			o->Ticks = MAX(1, atoi(optarg));
+			break;
+		case 'w':
+			o->Warmup = MAX(0, atoi(optarg));
+			break;
+		case 'r':
+			o->Seed = atoi(optarg);
+			break;
+		case 'j':
+			o->JSONPath = optarg;
+			break;
+		case 'g':
+			o->GoldenPath = optarg;
+			break;
+		case 'R':
+			o->RecordGolden = true;
+			break;
+		case 'x':
+			o->MixVoices = MAX(1, atoi(optarg));
+			break;
+		case 'l':
+			o->LoadPasses = MAX(1, atoi(optarg));
+			break;
+		case 'i':
+			o->TilePasses = MAX(1, atoi(optarg));
+			break;
+		case 'n':
+			o->Missions = MAX(1, atoi(optarg));
+			break;
+		default:
+			PrintBenchHelp();
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool Init(void) {
+	SetupConfigDir();
+	gConfig = ConfigDefault();
+	ConfigGet(&gConfig, "Graphics.ShowHUD")->u.Bool.Value = false;
+	ConfigGet(&gConfig, "Graphics.ShakeMultiplier")->u.Int.Value = 0;
+
+	// Nothing is shown or heard; use the dummy drivers so that this runs
+	// on machines without a display
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+	SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+	if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_VIDEO) != 0) {
+		LOG(LM_MAIN, LL_ERROR, "Could not initialise SDL: %s", SDL_GetError());
+		return false;
+	}
+
+	AssetPackInit(&gAssetPack);
+	EventInit(&gEventHandlers, NULL, NULL, false);
+	PicManagerInit(&gPicManager);
+	TileClassesInit(&gTileClasses);
+	GraphicsInit(&gGraphicsDevice, &gConfig);
+	GraphicsInitialize(&gGraphicsDevice);
+	if (!gGraphicsDevice.IsInitialized) {
+		LOG(LM_MAIN, LL_ERROR, "Video didn't init!");
+		return false;
+	}
+	FontLoadFromJSON(&gFont, "graphics/font.png", "graphics/font.json");
+	PicManagerLoad(&gPicManager);
+	CharSpriteClassesInit(&gCharSpriteClasses);
+	ParticleClassesInit(&gParticleClasses, "data/particles.json");
+	AmmoInitialize(&gAmmo, "data/ammo.json");
+	BulletAndWeaponInitialize(&gBulletClasses, &gWeaponClasses,
+			"data/bullets.json", "data/guns.json");
+	CharacterClassesInitialize(&gCharacterClasses,
+			"data/character_classes.json");
+	PickupClassesInit(&gPickupClasses, "data/pickups.json", &gAmmo,
+			&gWeaponClasses);
+	MapObjectsInit(&gMapObjects, "data/map_objects.json", &gAmmo,
+			&gWeaponClasses);
+	CollisionSystemInit(&gCollisionSystem);
+	MissionArenaInit(&gMissionArena, "mission");
+	CampaignInit(&gCampaign);
+	PlayerDataInit(&gPlayerDatas);
+	return true;
+}
+static void Terminate(void) {
+	MapTerminate(&gMap);
+	PlayerDataTerminate(&gPlayerDatas);
+	MapObjectsTerminate(&gMapObjects);
+	PickupClassesTerminate(&gPickupClasses);
+	ParticleClassesTerminate(&gParticleClasses);
+	AmmoTerminate(&gAmmo);
+	WeaponClassesTerminate(&gWeaponClasses);
+	BulletTerminate(&gBulletClasses);
+	CharacterClassesTerminate(&gCharacterClasses);
+	MissionOptionsTerminate(&gMission);
+	EventTerminate(&gEventHandlers);
+	GraphicsTerminate(&gGraphicsDevice);
+	CampaignTerminate(&gCampaign);
+	CollisionSystemTerminate(&gCollisionSystem);
+	MissionArenaTerminate(&gMissionArena);
+	CharSpriteClassesTerminate(&gCharSpriteClasses);
+	TileClassesTerminate(&gTileClasses);
+	TileListsTerminate();
+	TileClassIndexTerminate();
+	PicManagerTerminate(&gPicManager);
+	FontTerminate(&gFont);
+	AssetPackClose(&gAssetPack);
+	ConfigDestroy(&gConfig);
+	SDL_Quit();
+}
+
+static bool LoadCampaign(const BenchOptions *o) {
+	CampaignEntry entry;
+	gCampaign.Entry.Mode = GAME_MODE_NORMAL;
+	if (!CampaignEntryTryLoad(&entry, o->Campaign, GAME_MODE_NORMAL)
+			|| !CampaignLoad(&gCampaign, &entry)) {
+		printf("Failed to load campaign %s\n", o->Campaign);
+		return false;
+	}
+	if (o->MissionIndex >= (int) gCampaign.Setting.Missions.size) {
+		printf("Campaign only has %d missions\n",
+				(int) gCampaign.Setting.Missions.size);
+		return false;
+	}
+	gCampaign.MissionIndex = o->MissionIndex;
+	return true;
+}
+// Generate quick play missions until one has the requested map type, then
+// override its size and population
+#define STRESS_MAX_ATTEMPTS 32
+static bool LoadStressMission(const BenchOptions *o) {
+	const MapObject *barrel = StrMapObject("barrel");
+	for (int i = 0; i < STRESS_MAX_ATTEMPTS; i++) {
+		srand((unsigned int) (o->Seed + i));
+		CampaignEntry entry;
+		CampaignEntryInit(&entry, "Benchmark", GAME_MODE_QUICK_PLAY);
+		gCampaign.Entry.Mode = GAME_MODE_QUICK_PLAY;
+		CampaignLoad(&gCampaign, &entry);
+		CA_FOREACH(Mission, m, gCampaign.Setting.Missions)
+			if (m->Type != o->Type) {
+				continue;
+			}
+			gCampaign.MissionIndex = _ca_index;
+			m->Size = o->Size;
+			m->EnemyDensity = o->Enemies;
+			CArrayClear(&m->MapObjectDensities);
+			if (o->Barrels > 0 && barrel != NULL) {
+				MapObjectDensity mod;
+				mod.M = barrel;
+				// Density is per 1000 tiles
+				mod.Density = MAX(1,
+						o->Barrels * 1000 / (o->Size.x * o->Size.y));
+				CArrayPushBack(&m->MapObjectDensities, &mod);
+			}
+			return true;
+		CA_FOREACH_END()
+		CampaignSettingTerminate(&gCampaign.Setting);
+		CampaignUnload(&gCampaign);
+	}
+	printf("Could not generate a %s mission\n", MapTypeStr(o->Type));
+	return false;
+}
+
+void BenchAddPlayers(const int numPlayers) {
+	for (int i = 0; i < numPlayers; i++) {
+		GameEvent e = GameEventNew(GAME_EVENT_PLAYER_DATA);
+		e.u.PlayerData = PlayerDataDefault(i);
+		e.u.PlayerData.UID = i;
+		GameEventsEnqueue(&gGameEvents, e);
+	}
+	HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
+	const WeaponClass *gun = NULL;
+	if (gMission.Weapons.size > 0) {
+		gun = *(const WeaponClass**) CArrayGet(&gMission.Weapons, 0);
+	}
+	CA_FOREACH(PlayerData, p, gPlayerDatas)
+		p->inputDevice = INPUT_DEVICE_AI;
+		if (gun != NULL && PlayerGetNumWeapons(p) == 0) {
+			p->guns[0] = gun;
+		}
+	CA_FOREACH_END()
+}
+
+double BenchTimerUs(const Uint64 start, const Uint64 end) {
+	return (double) (end - start) * 1000000.0
+			/ (double) SDL_GetPerformanceFrequency();
+}
+
+// Mirrors RunGameOnEnter, minus the drawing and networking
+void BenchStart(Bench *b) {
+	MapBuild(&gMap, gMission.missionData, &gCampaign);
+
+	CA_FOREACH(const PlayerData, p, gPlayerDatas)
+		GameEvent e = GameEventNew(GAME_EVENT_PLAYER_DATA);
+		e.u.PlayerData = PlayerDataMissionReset(p);
+		GameEventsEnqueue(&gGameEvents, e);
+	CA_FOREACH_END()
+	HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
+
+	struct vec2 firstPos = svec2_zero();
+	CA_FOREACH(const PlayerData, p, gPlayerDatas)
+		firstPos = PlacePlayer(&gMap, p, firstPos, true);
+	CA_FOREACH_END()
+	InitializeBadGuys();
+	CreateEnemies();
+
+	CameraInit(&b->camera);
+	if (gPlayerDatas.size == 0) {
+		LOSSetAllVisible(&gMap.LOS);
+	}
+	GameTickInit(&b->tick, &gMission, &gMap, &b->camera);
+	b->tick.RecordTimes = true;
+	gMission.state = MISSION_STATE_WAITING;
+	GameEvent start = GameEventNew(GAME_EVENT_GAME_START);
+	GameEventsEnqueue(&gGameEvents, start);
+}
+void BenchEnd(Bench *b) {
+	HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
+	GameTickTerminate(&b->tick);
+	CameraTerminate(&b->camera);
+	CFREE(b->samples);
+}
+
+// Runs the same tick as the game, with its sections timed
+void BenchTick(Bench *b, double *out) {
+	const Uint64 start = SDL_GetPerformanceCounter();
+	GameTickUpdate(&b->tick, b->cmds, 1);
+	const Uint64 end = SDL_GetPerformanceCounter();
+	for (int i = 0; i < GAME_TICK_COUNT; i++) {
+		out[i] = BenchTimerUs(0, b->tick.SectionTimes[i]);
+	}
+	out[BENCH_TOTAL] = BenchTimerUs(start, end);
+}
+
+typedef struct {
+	double Mean;
+	double P50;
+	double P99;
+	double Max;
+} BenchStats;
+static int CompareDouble(const void *v1, const void *v2) {
+	const double d1 = *(const double*) v1;
+	const double d2 = *(const double*) v2;
+	return d1 < d2 ? -1 : (d1 > d2 ? 1 : 0);
+}
+static BenchStats CalcStats(const double *samples, const int n,
+		const int section, double *scratch) {
+	BenchStats s;
+	memset(&s, 0, sizeof s);
+	double sum = 0;
+	for (int i = 0; i < n; i++) {
+		scratch[i] = samples[i * BENCH_COUNT + section];
+		sum += scratch[i];
+	}
+	qsort(scratch, n, sizeof *scratch, CompareDouble);
+	s.Mean = sum / n;
+	s.P50 = scratch[(n - 1) / 2];
+	s.P99 = scratch[(n - 1) * 99 / 100];
+	s.Max = scratch[n - 1];
+	return s;
+}
+
+static int CountInUse(const CArray *a, const size_t isInUseOffset) {
+	int count = 0;
+	for (int i = 0; i < (int) a->size; i++) {
+		const char *elem = (const char*) CArrayGet(a, i);
+		if (*(const bool*) (elem + isInUseOffset)) {
+			count++;
+		}
+	}
+	return count;
+}
+static void AddNumberPair(json_t *parent, const char *name, const double d) {
+	char buf[32];
+	sprintf(buf, "%.3f", d);
+	json_insert_pair_into_object(parent, name, json_new_number(buf));
+}
+static const char *SectionName(const int i) {
+	return i == BENCH_TOTAL ?
+			"total" : GameTickSectionStr((GameTickSection) i);
+}
+static void PrintResults(const BenchOptions *o, const Bench *b) {
+	const Mission *m = gMission.missionData;
+	const int actors = CountInUse(&gActors, offsetof(TActor, isInUse));
+	const int objs = CountInUse(&gObjs, offsetof(TObject, isInUse));
+	const int mobObjs = CountInUse(&gMobObjs,
+			offsetof(TMobileObject, isInUse));
+	const int particles = CountInUse(&gParticles,
+			offsetof(Particle, isInUse));
+	printf("Mission: %s (%s %dx%d)\n", m->Title, MapTypeStr(m->Type),
+			m->Size.x, m->Size.y);
+	printf("Ticks: %d (warmup %d)\n", o->Ticks, o->Warmup);
+	printf("End: actors %d, objects %d, bullets %d, particles %d\n", actors,
+			objs, mobObjs, particles);
+	printf("%-10s %10s %10s %10s %10s\n", "us/tick", "mean", "p50", "p99",
+			"max");
+
+	json_t *root = json_new_object();
+	json_t *scenario = json_new_object();
+	AddStringPair(scenario, "Mission", m->Title);
+	AddStringPair(scenario, "MapType", MapTypeStr(m->Type));
+	AddIntPair(scenario, "Width", m->Size.x);
+	AddIntPair(scenario, "Height", m->Size.y);
+	AddIntPair(scenario, "Players", (int) gPlayerDatas.size);
+	AddIntPair(scenario, "Seed", o->Seed);
+	AddIntPair(scenario, "Ticks", o->Ticks);
+	AddIntPair(scenario, "Warmup", o->Warmup);
+	json_insert_pair_into_object(root, "Scenario", scenario);
+	json_t *counts = json_new_object();
+	AddIntPair(counts, "Actors", actors);
+	AddIntPair(counts, "Objects", objs);
+	AddIntPair(counts, "Bullets", mobObjs);
+	AddIntPair(counts, "Particles", particles);
+	json_insert_pair_into_object(root, "EndCounts", counts);
+	MissionArenaStats arenas[4];
+	const int numArenas = MissionArenasGetStats(arenas, 4);
+	json_t *arenasNode = json_new_object();
+	for (int i = 0; i < numArenas; i++) {
+		const MissionArenaStats *s = &arenas[i];
+		printf("Arena %s: %d allocs, %d KiB used, %d KiB reserved\n",
+				s->Name, s->Allocs, (int) (s->Used / 1024),
+				(int) (s->Reserved / 1024));
+		json_t *arena = json_new_object();
+		AddIntPair(arena, "Allocs", s->Allocs);
+		AddIntPair(arena, "Used", (int) s->Used);
+		AddIntPair(arena, "Peak", (int) s->Peak);
+		AddIntPair(arena, "Reserved", (int) s->Reserved);
+		json_insert_pair_into_object(arenasNode, s->Name, arena);
+	}
+	json_insert_pair_into_object(root, "Arenas", arenasNode);
+
+	double *scratch;
+	CMALLOC(scratch, o->Ticks * sizeof *scratch);
+	json_t *sections = json_new_object();
+	for (int i = 0; i < BENCH_COUNT; i++) {
+		const BenchStats s = CalcStats(b->samples, o->Ticks, i, scratch);
+		printf("%-10s %10.2f %10.2f %10.2f %10.2f\n", SectionName(i), s.Mean,
+				s.P50, s.P99, s.Max);
+		json_t *section = json_new_object();
+		AddNumberPair(section, "Mean", s.Mean);
+		AddNumberPair(section, "P50", s.P50);
+		AddNumberPair(section, "P99", s.P99);
+		AddNumberPair(section, "Max", s.Max);
+		json_insert_pair_into_object(sections, SectionName(i), section);
+	}
+	json_insert_pair_into_object(root, "Sections", sections);
+	CFREE(scratch);
+
+	if (o->JSONPath != NULL) {
+		if (!TrySaveJSONFile(root, o->JSONPath)) {
+			printf("Failed to write %s\n", o->JSONPath);
+		}
+	}
+	json_free_value(&root);
+}
+
+int main(int argc, char *argv[]) {
+	int err = EXIT_SUCCESS;
+	BenchOptions o;
+	memset(&o, 0, sizeof o);
+	o.Enemies = 50;
+	o.Barrels = 50;
+	o.Type = MAPTYPE_CLASSIC;
+	o.Size = svec2i(64, 64);
+	o.Players = 1;
+	o.Ticks = 3000;
+	o.Warmup = 60;
+
+	LogInit();
+	if (!ParseBenchArgs(&o, argc, argv)) {
+		LogTerminate();
+		return EXIT_FAILURE;
+	}
+	if (o.MixVoices > 0) {
+		BenchRunMix(o.MixVoices);
+		LogTerminate();
+		return EXIT_SUCCESS;
+	}
+	if (!Init()) {
+		err = EXIT_FAILURE;
+		goto bail;
+	}
+	ConfigGet(&gConfig, "Game.RandomSeed")->u.Int.Value = o.Seed;
+	if (o.LoadPasses > 0) {
+		BenchRunLoad(o.LoadPasses);
+		goto bail;
+	}
+	if (o.TilePasses > 0) {
+		BenchRunTiles(o.TilePasses);
+		goto bail;
+	}
+
+	if (!(o.Campaign != NULL ? LoadCampaign(&o) : LoadStressMission(&o))) {
+		err = EXIT_FAILURE;
+		goto bail;
+	}
+	if (o.Missions > 0) {
+		BenchRunMissions(&o);
+		goto bail;
+	}
+	CampaignAndMissionSetup(&gCampaign, &gMission);
+	BenchAddPlayers(o.Players);
+
+	{
+		Bench b;
+		memset(&b, 0, sizeof b);
+		CMALLOC(b.samples, o.Ticks * BENCH_COUNT * sizeof *b.samples);
+		BenchStart(&b);
+		// Draw before any ticks so the image only depends on the seed
+		if (o.GoldenPath != NULL
+				&& !BenchCheckGoldenImage(o.GoldenPath, o.RecordGolden)) {
+			err = EXIT_FAILURE;
+		}
+		double warmup[BENCH_COUNT];
+		for (int i = 0; i < o.Warmup; i++) {
+			BenchTick(&b, warmup);
+		}
+		for (int i = 0; i < o.Ticks; i++) {
+			BenchTick(&b, &b.samples[i * BENCH_COUNT]);
+		}
+		PrintResults(&o, &b);
+		BenchEnd(&b);
+	}
+
+bail:
+	Terminate();
+	LogTerminate();
+	return err;
+}
@@ -0,0 +1,86 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <SDL2/SDL_stdinc.h>
+
+#include <cdogs/camera.h>
+#include <cdogs/game_tick.h>
+#include <cdogs/mission.h>
+#include <cdogs/player.h>
+
+// Headless simulation benchmark
+// Runs a mission for a fixed number of ticks without rendering or sound,
+// timing each section of the game tick separately.
+
+typedef struct {
+	const char *Campaign;
+	int MissionIndex;
+	int Enemies;
+	int Barrels;
+	MapType Type;
+	struct vec2i Size;
+	int Players;
+	int Ticks;
+	int Warmup;
+	int Seed;
+	const char *JSONPath;
+	const char *GoldenPath;
+	bool RecordGolden;
+	int MixVoices;
+	int LoadPasses;
+	int TilePasses;
+	int Missions;
+} BenchOptions;
+
+// Samples are the game tick sections followed by the whole tick
+#define BENCH_TOTAL GAME_TICK_COUNT
+#define BENCH_COUNT (GAME_TICK_COUNT + 1)
+
+typedef struct {
+	Camera camera;
+	GameTick tick;
+	int cmds[MAX_LOCAL_PLAYERS];
+	// Per-tick samples in microseconds, BENCH_COUNT per tick
+	double *samples;
+} Bench;
+
+double BenchTimerUs(const Uint64 start, const Uint64 end);
+
+void BenchAddPlayers(const int numPlayers);
+void BenchStart(Bench *b);
+void BenchTick(Bench *b, double *out);
+void BenchEnd(Bench *b);
+
+// Harnesses that run instead of, or alongside, the mission benchmark
+bool BenchCheckGoldenImage(const char *path, const bool record);
+void BenchRunMix(const int numVoices);
+void BenchRunLoad(const int passes);
+void BenchRunTiles(const int passes);
+void BenchRunMissions(const BenchOptions *o);
@@ -0,0 +1,144 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "bench.h"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <cdogs/actors.h>
+#include <cdogs/config.h>
+#include <cdogs/draw/draw.h>
+#include <cdogs/draw/sprite_batch.h>
+#include <cdogs/grafx.h>
+#include <cdogs/log.h>
+#include <cdogs/los.h>
+#include <cdogs/map.h>
+
+static SDL_Surface *DrawFrame(void);
+static int CountPixelDiffs(const SDL_Surface *a, const SDL_Surface *b);
+// Compare the drawn map with a golden image, to catch any change in what is
+// drawn, or record the golden image
+bool BenchCheckGoldenImage(const char *path, const bool record) {
+	SDL_Surface *frame = DrawFrame();
+	if (frame == NULL) {
+		return false;
+	}
+	bool ok = true;
+	if (record) {
+		if (IMG_SavePNG(frame, path) != 0) {
+			LOG(LM_MAIN, LL_ERROR, "cannot save golden image %s: %s", path,
+					IMG_GetError());
+			ok = false;
+		} else {
+			printf("Recorded golden image %s\n", path);
+		}
+		SDL_FreeSurface(frame);
+		return ok;
+	}
+	SDL_Surface *golden = IMG_Load(path);
+	if (golden == NULL) {
+		printf("Cannot load golden image %s: %s\n", path, IMG_GetError());
+		SDL_FreeSurface(frame);
+		return false;
+	}
+	SDL_Surface *expected = SDL_ConvertSurfaceFormat(golden,
+			SDL_PIXELFORMAT_ARGB8888, 0);
+	SDL_FreeSurface(golden);
+	if (expected->w != frame->w || expected->h != frame->h) {
+		printf("Golden image %s is %dx%d but frame is %dx%d\n", path,
+				expected->w, expected->h, frame->w, frame->h);
+		ok = false;
+	} else {
+		const int diffs = CountPixelDiffs(frame, expected);
+		printf("Golden image %s: %d pixels differ\n", path, diffs);
+		ok = diffs == 0;
+	}
+	SDL_FreeSurface(expected);
+	SDL_FreeSurface(frame);
+	return ok;
+}
+static int CountPixelDiffs(const SDL_Surface *a, const SDL_Surface *b) {
+	int diffs = 0;
+	for (int y = 0; y < a->h; y++) {
+		const Uint32 *ap = (const Uint32*) ((const Uint8*) a->pixels
+				+ y * a->pitch);
+		const Uint32 *bp = (const Uint32*) ((const Uint8*) b->pixels
+				+ y * b->pitch);
+		for (int x = 0; x < a->w; x++) {
+			if (ap[x] != bp[x]) {
+				diffs++;
+			}
+		}
+	}
+	return diffs;
+}
+// Draw the map as the game camera would, centred on the first player
+static SDL_Surface *DrawFrame(void) {
+	GraphicsDevice *g = &gGraphicsDevice;
+	SDL_Renderer *r = g->gameWindow.renderer;
+	struct vec2 center = svec2(gMap.Size.x * TILE_WIDTH / 2.0f,
+			gMap.Size.y * TILE_HEIGHT / 2.0f);
+	const TActor *a = gPlayerDatas.size > 0 ?
+			ActorGetByUID(((const PlayerData*) CArrayGet(&gPlayerDatas, 0))
+					->ActorUID) : NULL;
+	if (a != NULL) {
+		center = a->thing.Pos;
+		LOSCalcFrom(&gMap, Vec2ToTile(center), false);
+	}
+	// Include objective highlights and chatter
+	ConfigGet(&gConfig, "Graphics.ShowHUD")->u.Bool.Value = true;
+
+	DrawBuffer buffer;
+	DrawBufferInit(&buffer, svec2i(X_TILES, Y_TILES), g);
+	if (SDL_SetRenderDrawColor(r, 0, 0, 0, 255) != 0
+			|| SDL_RenderClear(r) != 0) {
+		LOG(LM_MAIN, LL_ERROR, "cannot clear renderer: %s", SDL_GetError());
+	}
+	DrawBufferSetFromMap(&buffer, &gMap, center, X_TILES);
+	DrawBufferFix(&buffer);
+	DrawBufferDraw(&buffer, svec2i_zero(), NULL);
+	SpriteBatchFlush(&gSpriteBatch);
+	DrawBufferTerminate(&buffer);
+	ConfigGet(&gConfig, "Graphics.ShowHUD")->u.Bool.Value = false;
+
+	int w, h;
+	if (SDL_GetRendererOutputSize(r, &w, &h) != 0) {
+		LOG(LM_MAIN, LL_ERROR, "cannot get output size: %s", SDL_GetError());
+		return NULL;
+	}
+	SDL_Surface *s = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32,
+			SDL_PIXELFORMAT_ARGB8888);
+	if (SDL_RenderReadPixels(r, NULL, SDL_PIXELFORMAT_ARGB8888, s->pixels,
+			s->pitch) != 0) {
+		LOG(LM_MAIN, LL_ERROR, "cannot read pixels: %s", SDL_GetError());
+		SDL_FreeSurface(s);
+		return NULL;
+	}
+	return s;
+}
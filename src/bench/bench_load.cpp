@@ -0,0 +1,93 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <SDL2/SDL_timer.h>
+
+#include <cdogs/campaigns.h>
+
+// Load every campaign found in missions/, reporting the time to list them
+// and the best of N loads for each one
+typedef struct {
+	int passes;
+	int count;
+	double totalMs;
+} LoadBench;
+static void LoadBenchList(LoadBench *lb, const campaign_list_t *list) {
+	CA_FOREACH(const campaign_list_t, sub, list->subFolders)
+		LoadBenchList(lb, sub);
+	CA_FOREACH_END()
+	CA_FOREACH(CampaignEntry, entry, list->list)
+		double best = -1;
+		int missions = 0;
+		for (int i = 0; i < lb->passes; i++) {
+			gCampaign.Entry.Mode = entry->Mode;
+			const Uint64 start = SDL_GetPerformanceCounter();
+			const bool ok = CampaignLoad(&gCampaign, entry);
+			const double ms =
+					BenchTimerUs(start, SDL_GetPerformanceCounter()) / 1000;
+			if (!ok) {
+				printf("Failed to load campaign %s\n", entry->Path);
+				break;
+			}
+			missions = (int) gCampaign.Setting.Missions.size;
+			CampaignSettingTerminate(&gCampaign.Setting);
+			CampaignUnload(&gCampaign);
+			if (best < 0 || ms < best) {
+				best = ms;
+			}
+		}
+		if (best < 0) {
+			continue;
+		}
+		printf("%9.2f ms  %3d missions  %s\n", best, missions, entry->Path);
+		lb->count++;
+		lb->totalMs += best;
+	CA_FOREACH_END()
+}
+void BenchRunLoad(const int passes) {
+	custom_campaigns_t campaigns;
+	const Uint64 start = SDL_GetPerformanceCounter();
+	LoadAllCampaigns(&campaigns);
+	const double listMs =
+			BenchTimerUs(start, SDL_GetPerformanceCounter()) / 1000;
+
+	LoadBench lb;
+	memset(&lb, 0, sizeof lb);
+	lb.passes = passes;
+	LoadBenchList(&lb, &campaigns.campaignList);
+	printf("Listed campaigns in %.2f ms\n", listMs);
+	printf("Loaded %d campaigns in %.2f ms (best of %d)\n", lb.count,
+			lb.totalMs, passes);
+
+	UnloadAllCampaigns(&campaigns);
+}
@@ -0,0 +1,109 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include <cdogs/campaigns.h>
+#include <cdogs/json_utils.h>
+#include <cdogs/map.h>
+#include <cdogs/mission_arena.h>
+
+// Resident set size in KiB, or -1 if it cannot be read on this platform
+static int ReadRSSKiB(void) {
+#ifdef __linux__
+	FILE *f = fopen("/proc/self/statm", "r");
+	if (f == NULL) {
+		return -1;
+	}
+	long size, resident;
+	const bool ok = fscanf(f, "%ld %ld", &size, &resident) == 2;
+	fclose(f);
+	return ok ? (int) (resident * (sysconf(_SC_PAGESIZE) / 1024)) : -1;
+#else
+	return -1;
+#endif
+}
+// Set up, build and warm up N missions one after another, as a long session
+// would, reporting how much the arenas hold and the process's resident
+// memory after each one; both should level off rather than keep growing
+void BenchRunMissions(const BenchOptions *o) {
+	const int numMissions = (int) gCampaign.Setting.Missions.size;
+	const int firstIndex = gCampaign.MissionIndex;
+	bool addPlayers = true;
+	json_t *missionsNode = json_new_array();
+	printf("%4s %-24s %9s %12s %12s %10s\n", "#", "mission", "size",
+			"mission KiB", "map KiB", "RSS KiB");
+	for (int i = 0; i < o->Missions; i++) {
+		gCampaign.MissionIndex = (firstIndex + i) % numMissions;
+		CampaignAndMissionSetup(&gCampaign, &gMission);
+		if (addPlayers) {
+			BenchAddPlayers(o->Players);
+			addPlayers = false;
+		}
+		Bench b;
+		memset(&b, 0, sizeof b);
+		BenchStart(&b);
+		double warmup[BENCH_COUNT];
+		for (int j = 0; j < o->Warmup; j++) {
+			BenchTick(&b, warmup);
+		}
+		BenchEnd(&b);
+		const Mission *m = gMission.missionData;
+		const int missionKiB = (int) (gMissionArena.Stats.Reserved / 1024);
+		const int mapKiB = (int) (gMap.arena.Stats.Reserved / 1024);
+		const int rssKiB = ReadRSSKiB();
+		printf("%4d %-24.24s %4dx%-4d %12d %12d %10d\n", i, m->Title,
+				m->Size.x, m->Size.y, missionKiB, mapKiB, rssKiB);
+		json_t *node = json_new_object();
+		AddStringPair(node, "Mission", m->Title);
+		AddIntPair(node, "Width", m->Size.x);
+		AddIntPair(node, "Height", m->Size.y);
+		AddIntPair(node, "MissionArenaKiB", missionKiB);
+		AddIntPair(node, "MapArenaKiB", mapKiB);
+		AddIntPair(node, "RSSKiB", rssKiB);
+		json_insert_child(missionsNode, node);
+		MissionOptionsTerminate(&gMission);
+	}
+
+	if (o->JSONPath != NULL) {
+		json_t *root = json_new_object();
+		json_insert_pair_into_object(root, "Missions", missionsNode);
+		if (!TrySaveJSONFile(root, o->JSONPath)) {
+			printf("Failed to write %s\n", o->JSONPath);
+		}
+		json_free_value(&root);
+	} else {
+		json_free_value(&missionsNode);
+	}
+}
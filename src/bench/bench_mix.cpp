@@ -0,0 +1,94 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL2/SDL_timer.h>
+
+#include <cdogs/sound_mix.h>
+#include <cdogs/utils.h>
+
+// Mix a second of noise through the sound effect mixer, a quarter of the
+// voices muffled, and report the cost per mixer block
+#define MIX_BENCH_FRAMES 44100
+#define MIX_BENCH_BLOCKS 200
+void BenchRunMix(const int numVoices) {
+	int16_t *samples;
+	CMALLOC(samples, MIX_BENCH_FRAMES * 2 * sizeof *samples);
+	for (int i = 0; i < MIX_BENCH_FRAMES * 2; i++) {
+		samples[i] = (int16_t) (rand() % 8192 - 4096);
+	}
+	SoundMixVoice *voices;
+	CCALLOC(voices, numVoices * sizeof *voices);
+	SoundMixVoice **voicePtrs;
+	CMALLOC(voicePtrs, numVoices * sizeof *voicePtrs);
+	for (int i = 0; i < numVoices; i++) {
+		SoundMixVoice *v = &voices[i];
+		v->samples = samples;
+		v->frames = MIX_BENCH_FRAMES;
+		v->played = rand() % MIX_BENCH_FRAMES;
+		v->gains[0] = (int16_t) (rand() % SOUND_MIX_GAIN_ONE);
+		v->gains[1] = (int16_t) (rand() % SOUND_MIX_GAIN_ONE);
+		v->isMuffled = i % 4 == 0;
+		voicePtrs[i] = v;
+	}
+	SoundMixer m;
+	SoundMixerInit(&m, SOUND_MIX_FRAMES);
+	int16_t stream[SOUND_MIX_FRAMES * 2];
+
+	double total = 0;
+	for (int i = 0; i < MIX_BENCH_BLOCKS; i++) {
+		memset(stream, 0, sizeof stream);
+		// Loop the voices so they all stay playing
+		for (int j = 0; j < numVoices; j++) {
+			if (voices[j].played >= MIX_BENCH_FRAMES - SOUND_MIX_FRAMES) {
+				voices[j].played = 0;
+			}
+		}
+		const Uint64 start = SDL_GetPerformanceCounter();
+		SoundMixerMix(&m, stream, SOUND_MIX_FRAMES, voicePtrs, numVoices);
+		total += BenchTimerUs(start, SDL_GetPerformanceCounter());
+	}
+
+	const double perBlock = total / MIX_BENCH_BLOCKS;
+	const double blockUs = SOUND_MIX_FRAMES * 1000000.0 / 44100;
+	printf("Mixed %d voices, %d blocks of %d frames\n", numVoices,
+			MIX_BENCH_BLOCKS, SOUND_MIX_FRAMES);
+	printf("%.2f us per block (%.2f%% of real time), "
+			"%.2f us per block per 1000 voices\n", perBlock,
+			perBlock * 100 / blockUs, perBlock * 1000 / numVoices);
+
+	SoundMixerTerminate(&m);
+	CFREE(voicePtrs);
+	CFREE(voices);
+	CFREE(samples);
+}
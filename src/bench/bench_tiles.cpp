@@ -0,0 +1,97 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <SDL2/SDL_timer.h>
+
+#include <cdogs/map.h>
+#include <cdogs/tile.h>
+
+// Fill maps of increasing size with a wall/floor pattern and a sprinkling of
+// things, then report the tile layer's memory and the best time of N
+// walkability and thing scans over it
+static const int tileBenchSizes[] = { 128, 512, 1024 };
+void BenchRunTiles(const int passes) {
+	for (int i = 0; i < (int) (sizeof tileBenchSizes / sizeof *tileBenchSizes);
+			i++) {
+		const int size = tileBenchSizes[i];
+		Map map;
+		memset(&map, 0, sizeof map);
+		MapInit(&map, svec2i(size, size));
+		struct vec2i v;
+		int things = 0;
+		for (v.y = 0; v.y < size; v.y++) {
+			for (v.x = 0; v.x < size; v.x++) {
+				Tile *t = MapGetTile(&map, v);
+				const bool isWall = (v.x % 8) == 0 || (v.y % 8) == 0;
+				TileSetClass(t, isWall ? &gTileWall : &gTileFloor);
+				if (!isWall && (v.x * 31 + v.y * 17) % 64 == 0) {
+					ThingId tid;
+					tid.Id = things++;
+					tid.Kind = KIND_OBJECT;
+					TileAddThing(t, tid);
+				}
+			}
+		}
+
+		double best = -1;
+		int walkable = 0;
+		int found = 0;
+		for (int pass = 0; pass < passes; pass++) {
+			walkable = 0;
+			found = 0;
+			const Uint64 start = SDL_GetPerformanceCounter();
+			for (v.y = 0; v.y < size; v.y++) {
+				for (v.x = 0; v.x < size; v.x++) {
+					const Tile *t = MapGetTile(&map, v);
+					walkable += TileCanWalk(t);
+					found += (int) TileGetThings(t)->size;
+				}
+			}
+			const double us = BenchTimerUs(start, SDL_GetPerformanceCounter());
+			if (best < 0 || us < best) {
+				best = us;
+			}
+		}
+		const size_t tileBytes = (size_t) (size * size) * sizeof(Tile);
+		printf("%4dx%-4d  tiles %8.1f KiB  lists %7.1f KiB  "
+				"scan %9.2f us (%.2f ns/tile)\n", size, size,
+				tileBytes / 1024.0, TileListsMemSize() / 1024.0, best,
+				best * 1000 / (size * size));
+		if (walkable == 0 || found != things) {
+			printf("Unexpected scan result: %d walkable, %d/%d things\n",
+					walkable, found, things);
+		}
+		MapTerminate(&map);
+	}
+	printf("%d bytes per tile\n", (int) sizeof(Tile));
+}
@@ -31,6 +31,7 @@
 #include <cdogs/files.h>
 #include <cdogs/font.h>
 #include <cdogs/grafx_bg.h>
+#include <cdogs/map_layout.h>
 #include <cdogs/music.h>
 #include <cdogs/objective.h>
 
@@ -203,6 +204,10 @@ GameLoopData* ScreenMissionBriefing(const struct MissionOptions *m) {
 	}
 	mData->MissionOptions = m;
 
+	// Generate the map while the briefing is read, if not done already
+	MapLayoutPrefetch(m->missionData, gCampaign.Entry.Mode,
+			CampaignGetMissionSeed(m->index));
+
 	return GameLoopDataNew(mData, MissionBriefingTerminate, NULL,
 			MissionBriefingOnExit, MissionBriefingInput, MissionBriefingUpdate,
 			MissionBriefingDraw);
@@ -54,6 +54,7 @@
 #include <SDL2/SDL.h>
 
 #include <cdogs/ammo.h>
+#include <cdogs/asset_pack.h>
 #include <cdogs/campaigns.h>
 #include <cdogs/character_class.h>
 #include <cdogs/collision/collision.h>
@@ -67,17 +68,21 @@
 #include <cdogs/joystick.h>
 #include <cdogs/keyboard.h>
 #include <cdogs/log.h>
+#include <cdogs/map_layout.h>
 #include <cdogs/mission.h>
 #include <cdogs/music.h>
 #include <cdogs/net_client.h>
 #include <cdogs/net_server.h>
+#include <cdogs/net_stats.h>
 #include <cdogs/objs.h>
 #include <cdogs/palette.h>
 #include <cdogs/particle.h>
 #include <cdogs/pic_manager.h>
 #include <cdogs/pickup.h>
 #include <cdogs/pics.h>
+#include <cdogs/profiler.h>
 #include <cdogs/player_template.h>
+#include <cdogs/replay.h>
 #include <cdogs/sounds.h>
 #include <cdogs/SDL_JoystickButtonNames/SDL_joystickbuttonnames.h>
 #include <cdogs/triggers.h>
@@ -87,6 +92,7 @@
 #include "briefing_screens.h"
 #include "command_line.h"
 #include "credits.h"
+#include "game.h"
 #include "mainmenu.h"
 #include "prep.h"
 
@@ -140,6 +146,10 @@ int main(int argc, char *argv[]) {
 	AutosaveLoad(&gAutosave, GetConfigFilePath(AUTOSAVE_FILE));
 #endif
 
+	NetStatsInit(&gNetStats);
+	ReplayInit(&gReplay);
+	ProfilerInit(&gProfiler);
+
 #ifndef __EMSCRIPTEN__
 	if (enet_initialize() != 0) {
 		LOG(LM_MAIN, LL_ERROR, "An error occurred while initializing ENet.");
@@ -181,6 +191,8 @@ int main(int argc, char *argv[]) {
 	LOG(LM_MAIN, LL_INFO, "data dir(%s)", buf);
 	LOG(LM_MAIN, LL_INFO, "config dir(%s)", GetConfigFilePath(""));
 
+	PROFILE_BEGIN("load assets");
+	AssetPackInit(&gAssetPack);
 	SoundInitialize(&gSoundDevice, "sounds");
 	if (!gSoundDevice.isInitialised) {
 		LOG(LM_MAIN, LL_ERROR, "Sound initialization failed!");
@@ -221,8 +233,10 @@ int main(int argc, char *argv[]) {
 	MapObjectsInit(&gMapObjects, "data/map_objects.json", &gAmmo,
 			&gWeaponClasses);
 	CollisionSystemInit(&gCollisionSystem);
+	MissionArenaInit(&gMissionArena, "mission");
 	CampaignInit(&gCampaign);
 	PlayerDataInit(&gPlayerDatas);
+	PROFILE_END();
 
 	l = LoopRunnerNew(NULL);
 	LoopRunnerPush(&l, MainMenu(&gGraphicsDevice, &l));
@@ -239,6 +253,12 @@ int main(int argc, char *argv[]) {
 				|| !CampaignLoad(&gCampaign, &entry)) {
 			LOG(LM_MAIN, LL_ERROR, "Failed to load campaign %s", loadCampaign);
 		}
+	} else if (gReplay.Mode == REPLAY_MODE_PLAY) {
+		if (ReplayLoad(&gReplay, &gCampaign, &gMission)) {
+			LoopRunnerPush(&l, RunGame(&gCampaign, &gMission, &gMap));
+		} else {
+			printf("Failed to load replay\n");
+		}
 	} else if (connectAddr.host != 0) {
 		if (NetClientTryScanAndConnect(&gNetClient, connectAddr.host)) {
 			LoopRunnerPush(&l, ScreenWaitForCampaignDef());
@@ -251,6 +271,7 @@ int main(int argc, char *argv[]) {
 	LoopRunnerTerminate(&l);
 
 	bail: NetServerTerminate(&gNetServer);
+	MapLayoutCacheTerminate();
 	MapTerminate(&gMap);
 	PlayerDataTerminate(&gPlayerDatas);
 	MapObjectsTerminate(&gMapObjects);
@@ -262,20 +283,26 @@ int main(int argc, char *argv[]) {
 	CharacterClassesTerminate(&gCharacterClasses);
 	MissionOptionsTerminate(&gMission);
 	NetClientTerminate(&gNetClient);
+	NetStatsTerminate(&gNetStats);
 	atexit(enet_deinitialize);
 	EventTerminate(&gEventHandlers);
 	GraphicsTerminate(&gGraphicsDevice);
 	CampaignTerminate(&gCampaign);
 	CollisionSystemTerminate(&gCollisionSystem);
+	MissionArenaTerminate(&gMissionArena);
 
 	CharSpriteClassesTerminate(&gCharSpriteClasses);
 	TileClassesTerminate(&gTileClasses);
+	TileListsTerminate();
+	TileClassIndexTerminate();
 	PicManagerTerminate(&gPicManager);
 	FontTerminate(&gFont);
 	AutosaveSave(&gAutosave, GetConfigFilePath(AUTOSAVE_FILE));
 	AutosaveTerminate(&gAutosave);
 	PlayerTemplatesTerminate(&gPlayerTemplates);
 	SoundTerminate(&gSoundDevice, true);
+	AssetPackClose(&gAssetPack);
+	ProfilerTerminate(&gProfiler);
 	ConfigDestroy(&gConfig);
 	LogTerminate();
 
@@ -67,6 +67,7 @@
 #include "events.h"
 #include "game_events.h"
 #include "log.h"
+#include "net_predict.h"
 #include "pic_manager.h"
 #include "sounds.h"
 #include "thing.h"
@@ -382,14 +383,23 @@ static struct vec2 GetConstrainedPos(const Map *map, const struct vec2 from,
 	// All alternative movements are in collision; don't move
 	return from;
 }
+struct vec2 ActorGetConstrainedPos(const TActor *a, const struct vec2 from,
+		const struct vec2 to) {
+	return GetConstrainedPos(&gMap, from, to, a->thing.size);
+}
 
 void ActorMove(const NActorMove am) {
 	TActor *a = ActorGetByUID(am.UID);
 	if (a == NULL || !a->isInUse)
 		return;
+	const struct vec2 oldPos = a->Pos;
 	a->Pos = NetToVec2(am.Pos);
 	a->MoveVel = NetToVec2(am.MoveVel);
+	a->InputSeq = am.Seq;
 	OnMove(a);
+	if (gCampaign.IsClient) {
+		NetInterpOnMove(a, oldPos);
+	}
 }
 static void CheckTrigger(const struct vec2i tilePos, const bool showLocked);
 static void CheckRescue(const TActor *a);
@@ -413,9 +423,9 @@ static void OnMove(TActor *a) {
 static void CheckTrigger(const struct vec2i tilePos, const bool showLocked) {
 	const Tile *t = MapGetTile(&gMap, tilePos);
 
-	for (size_t _ca_index = 0; _ca_index < t->triggers.size; _ca_index++) {
-		Trigger *tp =
-				static_cast<Trigger*>(CArrayGet(&(t->triggers), _ca_index));
+	const CArray *triggers = TileGetTriggers(t);
+	for (size_t _ca_index = 0; _ca_index < triggers->size; _ca_index++) {
+		Trigger *tp = *static_cast<Trigger**>(CArrayGet(triggers, _ca_index));
 
 		if (!TriggerTryActivate(tp, gMission.KeyFlags, tilePos)
 				&& (tp)->isActive && TriggerCannotActivate(tp) && showLocked) {
@@ -694,6 +704,7 @@ static bool TryGrenade(TActor *a, const int cmd) {
 
 static bool ActorTryMove(TActor *actor, int cmd, int hasShot, int ticks);
 void CommandActor(TActor *actor, int cmd, int ticks) {
+	actor->InputSeq++;
 	if (actor->confused) {
 		cmd = CmdGetReverse(cmd);
 	}
@@ -762,6 +773,7 @@ static bool ActorTryMove(TActor *actor, int cmd, int hasShot, int ticks) {
 		e.u.ActorMove.UID = actor->uid;
 		e.u.ActorMove.Pos = Vec2ToNet(actor->Pos);
 		e.u.ActorMove.MoveVel = Vec2ToNet(actor->MoveVel);
+		e.u.ActorMove.Seq = actor->InputSeq;
 		GameEventsEnqueue(&gGameEvents, e);
 	}
 
@@ -1178,6 +1190,8 @@ void ActorDestroy(TActor *a) {
 	if (p != NULL)
 		p->ActorUID = -1;
 	AIContextDestroy(a->aiContext);
+	NetActorStateDestroy(a->netState);
+	a->netState = NULL;
 	a->isInUse = false;
 }
 
@@ -103,6 +103,9 @@ typedef struct Actor {
 	// Whether the player ran into something whilst trying to move
 	// In this situation, we interrupt dead reckoning and resend the position
 	bool hasCollided;
+	// Sequence number of the last input applied; used to reconcile
+	// client-side prediction with the server (see net_predict.h)
+	uint32_t InputSeq;
 	// Whether the last special command was performed with a direction
 	// This differentiates between a special command and weapon switch
 	bool specialCmdDir;
@@ -160,6 +163,7 @@ typedef struct Actor {
 	// Signals to other AIs what this actor is doing
 	ActorAction action;
 	AIContext *aiContext;
+	struct NetActorState *netState;
 	Thing thing;
 	bool isInUse;
 } TActor;
@@ -177,6 +181,9 @@ extern CArray gActors;	// of TActor
 void ActorSetState(TActor *actor, const ActorAnimation state);
 void UpdateActorState(TActor *actor, int ticks);
 bool TryMoveActor(TActor *actor, struct vec2 pos);
+// Get the furthest position towards 'to' that the actor can move to
+struct vec2 ActorGetConstrainedPos(const TActor *a, const struct vec2 from,
+		const struct vec2 to);
 void ActorMove(const NActorMove am);
 void CommandActor(TActor *actor, int cmd, int ticks);
 void SlideActor(TActor *actor, int cmd);
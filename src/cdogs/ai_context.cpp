@@ -27,13 +27,16 @@
  */
 #include "ai_context.h"
 
+#include "mission_arena.h"
+
+static MissionPool sAIContextPool;
+
 AIContext* AIContextNew(void) {
-	AIContext *c;
-	c = static_cast<AIContext*>(calloc(1, sizeof *c));
-//	CCALLOC(c, sizeof *c);
-	if (c == NULL && sizeof *c > 0) {
-		exit(1);
+	if (sAIContextPool.arena == NULL) {
+		MissionPoolInit(&sAIContextPool, &gMissionArena, sizeof(AIContext),
+				"ai");
 	}
+	AIContext *c = static_cast<AIContext*>(MissionPoolAlloc(&sAIContextPool));
 
 	c->EnemyId = -1;
 	c->GunRangeScalar = 1.0;
@@ -43,7 +46,7 @@ void AIContextDestroy(AIContext *c) {
 	if (c) {
 		CachedPathDestroy(&c->Goto.Path);
 	}
-	CFREE(c);
+	MissionPoolFree(&sAIContextPool, c);
 }
 
 const char* AIStateGetChatterText(const AIState s) {
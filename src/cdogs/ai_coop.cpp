@@ -130,7 +130,7 @@ static int AICoopGetCmdNormal(TActor *actor) {
 			const Tile *t = MapGetTile(&gMap, v);
 			if (t == NULL)
 				continue;
-			CA_FOREACH(const ThingId, tid, t->things)
+			CA_FOREACH(const ThingId, tid, *TileGetThings(t))
 			// Only look for bullets
 				if (tid->Kind != KIND_MOBILEOBJECT)
 					continue;
@@ -188,7 +188,7 @@ bool IsTileWalkable(Map *map, const struct vec2i pos) {
 	// Check if tile has a dangerous (explosive) item on it
 	// For AI, we don't want to shoot it, so just walk around
 	Tile *t = MapGetTile(map, pos);
-	CA_FOREACH(ThingId, tid, t->things)
+	CA_FOREACH(ThingId, tid, *TileGetThings(t))
 	// Only look for explosive objects
 		if (tid->Kind != KIND_OBJECT) {
 			continue;
@@ -209,7 +209,7 @@ bool IsTileWalkableAroundObjects(Map *map, const struct vec2i pos) {
 	}
 	// Check if tile has any item on it
 	Tile *t = MapGetTile(map, pos);
-	CA_FOREACH(ThingId, tid, t->things)
+	CA_FOREACH(ThingId, tid, *TileGetThings(t))
 		if (tid->Kind == KIND_OBJECT) {
 			// Check that the object has hitbox - i.e. health > 0
 			const TObject *o = static_cast<const TObject*>(CArrayGet(&gObjs,
@@ -247,7 +247,7 @@ static bool IsTileWalkableOrOpenable(Map *map, struct vec2i pos) {
 	if (TileCanWalk(tile)) {
 		return true;
 	}
-	if (tile->Class->Type == TILE_CLASS_DOOR) {
+	if (TileGetClass(tile)->Type == TILE_CLASS_DOOR) {
 		// A door; check if we can open it
 		int keycard = MapGetDoorKeycardFlag(map, pos);
 		if (!keycard) {
@@ -386,7 +386,7 @@ static bool FindFriendliesInTile(void *data, const struct vec2i tile) {
 		return true;
 	FindFriendliesInTileData *tData =
 			static_cast<FindFriendliesInTileData*>(data);
-	CA_FOREACH(const ThingId, tid, t->things)
+	CA_FOREACH(const ThingId, tid, *TileGetThings(t))
 		if (tid->Kind != KIND_CHARACTER)
 			continue;
 		const TActor *other = static_cast<TActor*>(CArrayGet(&gActors, tid->Id));
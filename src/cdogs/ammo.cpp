@@ -29,6 +29,7 @@
 
 #include <string.h>
 
+#include "asset_pack.h"
 #include "json_utils.h"
 #include "log.h"
 #include "pic_manager.h"
@@ -63,27 +64,12 @@ void AmmoInitialize(AmmoClasses *ammo, const char *path) {
 	CArrayInit(&ammo->Ammo, sizeof(Ammo));
 	CArrayInit(&ammo->CustomAmmo, sizeof(Ammo));
 
-	json_t *root = NULL;
-	enum json_error e;
-
-	char buf[CDOGS_PATH_MAX];
-	GetDataFilePath(buf, path);
-	FILE *f = fopen(buf, "r");
-	if (f == NULL) {
-		LOG(LM_MAIN, LL_ERROR, "Error: cannot load ammo file %s", buf);
-		goto bail;
-	}
-	e = json_stream_parse(f, &root);
-	if (e != JSON_OK) {
-		LOG(LM_MAIN, LL_ERROR, "Error parsing ammo file %s [error %d]", buf,
-				(int )e);
-		goto bail;
+	json_t *root = AssetPackReadJSON(&gAssetPack, path);
+	if (root == NULL) {
+		LOG(LM_MAIN, LL_ERROR, "Error: cannot load ammo file %s", path);
+		return;
 	}
 	AmmoLoadJSON(&ammo->Ammo, root);
-
-	bail: if (f) {
-		fclose(f);
-	}
 	json_free_value(&root);
 }
 void AmmoLoadJSON(CArray *ammo, json_t *node) {
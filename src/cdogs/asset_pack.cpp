@@ -0,0 +1,663 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "asset_pack.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <tinydir/tinydir.h>
+
+#include "json_utils.h"
+#include "log.h"
+#include "sounds.h"
+#include "sys_config.h"
+#include "utils.h"
+
+AssetPack gAssetPack;
+
+static const char packMagic[4] = { 'C', 'D', 'P', 'K' };
+// Class tables, relative to the data dir
+static const char *classFiles[] = {
+	"data/ammo.json",
+	"data/bullets.json",
+	"data/character_classes.json",
+	"data/guns.json",
+	"data/map_objects.json",
+	"data/particles.json",
+	"data/pickups.json"
+};
+#define NUM_CLASS_FILES (sizeof classFiles / sizeof classFiles[0])
+
+void AssetFilesList(CArray *files, const char *path, const char *prefix) {
+	tinydir_dir dir;
+	if (tinydir_open(&dir, path) == -1) {
+		if (errno != ENOENT) {
+			LOG(LM_MAIN, LL_ERROR, "Error opening dir '%s': %s", path,
+					strerror(errno));
+		}
+		goto bail;
+	}
+
+	for (; dir.has_next; tinydir_next(&dir)) {
+		tinydir_file file;
+		if (tinydir_readfile(&dir, &file) == -1) {
+			LOG(LM_MAIN, LL_ERROR, "Cannot read file '%s': %s", file.path,
+					strerror(errno));
+			goto bail;
+		}
+		if (file.is_reg) {
+			char buf[CDOGS_PATH_MAX];
+			if (prefix) {
+				char buf1[CDOGS_PATH_MAX];
+				sprintf(buf1, "%s/%s", prefix, file.name);
+				PathGetWithoutExtension(buf, buf1);
+			} else {
+				PathGetBasenameWithoutExtension(buf, file.name);
+			}
+			AssetFile af;
+			CSTRDUP(af.Path, file.path);
+			CSTRDUP(af.Name, buf);
+			CArrayPushBack(files, &af);
+		} else if (file.is_dir && file.name[0] != '.') {
+			if (prefix) {
+				char buf[CDOGS_PATH_MAX];
+				sprintf(buf, "%s/%s", prefix, file.name);
+				AssetFilesList(files, file.path, buf);
+			} else {
+				AssetFilesList(files, file.path, file.name);
+			}
+		}
+	}
+
+bail:
+	tinydir_close(&dir);
+}
+static void DataPath(char *buf, const char *dataDir, const char *path) {
+	if (dataDir != NULL) {
+		sprintf(buf, "%s/%s", dataDir, path);
+	} else {
+		GetDataFilePath(buf, path);
+	}
+}
+void AssetSectionFilesList(CArray *files, const AssetSection s,
+		const char *dataDir) {
+	char buf[CDOGS_PATH_MAX];
+	switch (s) {
+	case ASSET_SECTION_IMAGES:
+		DataPath(buf, dataDir, GRAPHICS_DIR);
+		AssetFilesList(files, buf, NULL);
+		break;
+	case ASSET_SECTION_CLASSES:
+		for (int i = 0; i < (int) NUM_CLASS_FILES; i++) {
+			DataPath(buf, dataDir, classFiles[i]);
+			AssetFile af;
+			CSTRDUP(af.Path, buf);
+			CSTRDUP(af.Name, classFiles[i]);
+			CArrayPushBack(files, &af);
+		}
+		break;
+	case ASSET_SECTION_SOUNDS:
+		DataPath(buf, dataDir, SOUNDS_DIR);
+		AssetFilesList(files, buf, NULL);
+		break;
+	default:
+		CASSERT(false, "unknown asset section");
+		break;
+	}
+}
+void AssetFilesTerminate(CArray *files) {
+	CA_FOREACH(AssetFile, af, *files)
+		CFREE(af->Path);
+		CFREE(af->Name);
+	CA_FOREACH_END()
+	CArrayTerminate(files);
+}
+
+// FNV-1a
+#define HASH_INIT 14695981039346656037ull
+static uint64_t HashBytes(uint64_t hash, const uint8_t *data, const size_t n) {
+	for (size_t i = 0; i < n; i++) {
+		hash = (hash ^ data[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+static uint64_t HashFile(const AssetFile *af) {
+	uint64_t hash = HashBytes(HASH_INIT, (const uint8_t*) af->Name,
+			strlen(af->Name) + 1);
+	FILE *f = fopen(af->Path, "rb");
+	if (f == NULL) {
+		return hash;
+	}
+	uint8_t buf[64 * 1024];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof buf, f)) > 0) {
+		hash = HashBytes(hash, buf, n);
+	}
+	fclose(f);
+	return hash;
+}
+uint64_t AssetFilesHash(const CArray *files) {
+	// Sum so that the order files are listed in doesn't matter
+	uint64_t hash = files->size;
+	CA_FOREACH(const AssetFile, af, *files)
+		hash += HashFile(af);
+	CA_FOREACH_END()
+	return hash;
+}
+static uint64_t HashFileStat(const AssetFile *af) {
+	uint64_t hash = HashBytes(HASH_INIT, (const uint8_t*) af->Name,
+			strlen(af->Name) + 1);
+	struct stat st;
+	if (stat(af->Path, &st) != 0) {
+		return hash;
+	}
+	const uint64_t size = (uint64_t) st.st_size;
+	const uint64_t mtime = (uint64_t) st.st_mtime;
+	hash = HashBytes(hash, (const uint8_t*) &size, sizeof size);
+	return HashBytes(hash, (const uint8_t*) &mtime, sizeof mtime);
+}
+uint64_t AssetFilesStatHash(const CArray *files) {
+	uint64_t hash = files->size;
+	CA_FOREACH(const AssetFile, af, *files)
+		hash += HashFileStat(af);
+	CA_FOREACH_END()
+	return hash;
+}
+
+SDL_Surface *AssetDecodePNG(const char *path) {
+	SDL_Surface *image = NULL;
+	SDL_RWops *rwops = SDL_RWFromFile(path, "rb");
+	if (rwops == NULL) {
+		return NULL;
+	}
+	if (!IMG_isPNG(rwops)) {
+		goto bail;
+	}
+	SDL_Surface *data;
+	data = IMG_Load_RW(rwops, 0);
+	if (!data) {
+		LOG(LM_MAIN, LL_ERROR, "Cannot load image IMG_Load: %s",
+				IMG_GetError());
+		goto bail;
+	}
+	// Use 32-bit image
+	image = SDL_ConvertSurfaceFormat(data, SDL_PIXELFORMAT_RGBA8888, 0);
+	SDL_FreeSurface(data);
+
+bail:
+	rwops->close(rwops);
+	return image;
+}
+
+
+static uint8_t *BakeImage(const AssetFile *af, AssetPackEntry *e) {
+	SDL_Surface *image = AssetDecodePNG(af->Path);
+	if (image == NULL) {
+		return NULL;
+	}
+	e->W = image->w;
+	e->H = image->h;
+	e->DataSize = (uint64_t) image->w * image->h * 4;
+	uint8_t *data;
+	CMALLOC(data, e->DataSize);
+	for (int y = 0; y < image->h; y++) {
+		memcpy(data + (size_t) y * image->w * 4,
+				(const uint8_t*) image->pixels + y * image->pitch,
+				(size_t) image->w * 4);
+	}
+	SDL_FreeSurface(image);
+	return data;
+}
+static uint8_t *BakeClasses(const AssetFile *af, AssetPackEntry *e) {
+	uint8_t *data = NULL;
+	struct json_flat_node *nodes = NULL;
+	char *strings = NULL;
+	size_t count;
+	size_t length;
+	json_t *root = JSONReadFile(af->Path);
+	if (root == NULL) {
+		return NULL;
+	}
+	const enum json_error err = json_flatten(root, &nodes, &count, &strings,
+			&length);
+	if (err != JSON_OK) {
+		LOG(LM_MAIN, LL_ERROR, "cannot flatten %s: error(%d)", af->Path,
+				(int) err);
+		goto bail;
+	}
+	e->Nodes = (uint32_t) count;
+	e->DataSize = count * sizeof *nodes + length;
+	CMALLOC(data, e->DataSize);
+	memcpy(data, nodes, count * sizeof *nodes);
+	if (length > 0) {
+		memcpy(data + count * sizeof *nodes, strings, length);
+	}
+
+bail:
+	free(nodes);
+	free(strings);
+	json_free_value(&root);
+	return data;
+}
+static uint8_t *BakeSound(const AssetFile *af, AssetPackEntry *e) {
+	if (!SoundIsFile(af->Path)) {
+		return NULL;
+	}
+	// Decoded and converted to the format the audio device was opened with
+	Mix_Chunk *chunk = Mix_LoadWAV(af->Path);
+	if (chunk == NULL) {
+		LOG(LM_MAIN, LL_ERROR, "cannot load sound %s: %s", af->Path,
+				Mix_GetError());
+		return NULL;
+	}
+	e->DataSize = chunk->alen;
+	uint8_t *data;
+	CMALLOC(data, chunk->alen > 0 ? chunk->alen : 1);
+	memcpy(data, chunk->abuf, chunk->alen);
+	Mix_FreeChunk(chunk);
+	return data;
+}
+
+static int CompareAssetFileNames(const void *v1, const void *v2) {
+	const AssetFile *af1 = *(const AssetFile * const *) v1;
+	const AssetFile *af2 = *(const AssetFile * const *) v2;
+	return strcmp(af1->Name, af2->Name);
+}
+// Bake the files that can be, sorted by name, adding their entries and data
+static void BakeSection(CArray *entries, CArray *data, CArray *names,
+		const CArray *files, const AssetSection s) {
+	CArray sorted;
+	CArrayInit(&sorted, sizeof(const AssetFile*));
+	CA_FOREACH(const AssetFile, af, *files)
+		CArrayPushBack(&sorted, &af);
+	CA_FOREACH_END()
+	if (sorted.size > 0) {
+		qsort(sorted.data, sorted.size, sorted.elemSize,
+				CompareAssetFileNames);
+	}
+	CA_FOREACH(const AssetFile *, afp, sorted)
+		const AssetFile *af = *afp;
+		AssetPackEntry e;
+		memset(&e, 0, sizeof e);
+		uint8_t *d = NULL;
+		switch (s) {
+		case ASSET_SECTION_IMAGES:
+			d = BakeImage(af, &e);
+			break;
+		case ASSET_SECTION_CLASSES:
+			d = BakeClasses(af, &e);
+			break;
+		case ASSET_SECTION_SOUNDS:
+			d = BakeSound(af, &e);
+			break;
+		default:
+			CASSERT(false, "unknown asset section");
+			break;
+		}
+		if (d == NULL) {
+			continue;
+		}
+		e.NameOffset = (uint32_t) names->size;
+		for (const char *c = af->Name;; c++) {
+			CArrayPushBack(names, c);
+			if (*c == '\0') {
+				break;
+			}
+		}
+		CArrayPushBack(entries, &e);
+		CArrayPushBack(data, &d);
+	CA_FOREACH_END()
+	CArrayTerminate(&sorted);
+}
+
+static size_t Align(const size_t n) {
+	return (n + 15) & ~(size_t) 15;
+}
+bool AssetPackWrite(const char *filename,
+		const CArray sectionFiles[ASSET_SECTION_COUNT]) {
+	bool ok = false;
+	CArray entries;
+	CArrayInit(&entries, sizeof(AssetPackEntry));
+	CArray data;
+	CArrayInit(&data, sizeof(uint8_t*));
+	CArray names;
+	CArrayInit(&names, sizeof(char));
+	FILE *f = NULL;
+	AssetPackHeader h;
+	memset(&h, 0, sizeof h);
+	memcpy(h.Magic, packMagic, sizeof h.Magic);
+	h.Version = ASSET_PACK_VERSION;
+	h.ByteOrder = ASSET_PACK_BYTE_ORDER;
+	h.HeaderSize = (uint16_t) sizeof(AssetPackHeader);
+	h.EntrySize = (uint16_t) sizeof(AssetPackEntry);
+	int frequency;
+	Uint16 format;
+	int channels;
+	const bool hasAudio = Mix_QuerySpec(&frequency, &format, &channels) != 0;
+	if (hasAudio) {
+		h.AudioFrequency = frequency;
+		h.AudioFormat = format;
+		h.AudioChannels = (uint16_t) channels;
+	}
+
+	for (int i = 0; i < ASSET_SECTION_COUNT; i++) {
+		const AssetSection s = (AssetSection) i;
+		AssetPackSection *sec = &h.Sections[s];
+		sec->Start = (uint32_t) entries.size;
+		// Leave the sounds stale without an audio device to decode them
+		if (s == ASSET_SECTION_SOUNDS && !hasAudio) {
+			LOG(LM_MAIN, LL_WARN, "audio not open; not baking sounds");
+			continue;
+		}
+		sec->SourceHash = AssetFilesHash(&sectionFiles[s]);
+		sec->StatHash = AssetFilesStatHash(&sectionFiles[s]);
+		BakeSection(&entries, &data, &names, &sectionFiles[s], s);
+		sec->Count = (uint32_t) entries.size - sec->Start;
+	}
+	h.Count = (uint32_t) entries.size;
+
+	// Lay out: header, entries, names, then data
+	const size_t namesStart = sizeof(AssetPackHeader)
+			+ entries.size * sizeof(AssetPackEntry);
+	size_t offset = Align(namesStart + names.size);
+	CA_FOREACH(AssetPackEntry, e, entries)
+		e->NameOffset += (uint32_t) namesStart;
+		e->DataOffset = offset;
+		offset = Align(offset + (size_t) e->DataSize);
+	CA_FOREACH_END()
+
+	f = fopen(filename, "wb");
+	if (f == NULL) {
+		LOG(LM_MAIN, LL_ERROR, "cannot write pack %s: %s", filename,
+				strerror(errno));
+		goto bail;
+	}
+	fwrite(&h, sizeof h, 1, f);
+	if (entries.size > 0) {
+		fwrite(entries.data, entries.elemSize, entries.size, f);
+		fwrite(names.data, names.elemSize, names.size, f);
+	}
+	CA_FOREACH(const AssetPackEntry, e, entries)
+		const uint8_t *d = *(const uint8_t **) CArrayGet(&data, _ca_index);
+		const uint8_t zero[16] = { 0 };
+		fwrite(zero, 1, e->DataOffset - (size_t) ftell(f), f);
+		fwrite(d, 1, (size_t) e->DataSize, f);
+	CA_FOREACH_END()
+	ok = ferror(f) == 0;
+	if (!ok) {
+		LOG(LM_MAIN, LL_ERROR, "error writing pack %s", filename);
+	}
+
+bail:
+	if (f != NULL) {
+		fclose(f);
+	}
+	CA_FOREACH(uint8_t *, d, data)
+		CFREE(*d);
+	CA_FOREACH_END()
+	CArrayTerminate(&data);
+	CArrayTerminate(&names);
+	CArrayTerminate(&entries);
+	return ok;
+}
+
+static bool MapFile(AssetPack *ap, const char *filename);
+static bool IsValid(const AssetPack *ap);
+bool AssetPackOpen(AssetPack *ap, const char *filename) {
+	memset(ap, 0, sizeof *ap);
+	if (!MapFile(ap, filename)) {
+		return false;
+	}
+	if (!IsValid(ap)) {
+		LOG(LM_MAIN, LL_WARN, "ignoring invalid pack %s", filename);
+		AssetPackClose(ap);
+		return false;
+	}
+	return true;
+}
+static bool MapFile(AssetPack *ap, const char *filename) {
+#ifdef _WIN32
+	FILE *f = fopen(filename, "rb");
+	if (f == NULL) {
+		return false;
+	}
+	fseek(f, 0, SEEK_END);
+	const long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	uint8_t *data;
+	CMALLOC(data, size > 0 ? size : 1);
+	ap->size = fread(data, 1, size > 0 ? size : 0, f);
+	fclose(f);
+	ap->data = data;
+	ap->isMapped = false;
+#else
+	const int fd = open(filename, O_RDONLY);
+	if (fd == -1) {
+		return false;
+	}
+	struct stat st;
+	void *data = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	close(fd);
+	if (data == MAP_FAILED) {
+		LOG(LM_MAIN, LL_ERROR, "cannot map pack %s: %s", filename,
+				strerror(errno));
+		return false;
+	}
+	ap->data = static_cast<const uint8_t*>(data);
+	ap->size = st.st_size;
+	ap->isMapped = true;
+#endif
+	ap->Header = reinterpret_cast<const AssetPackHeader*>(ap->data);
+	ap->Entries = reinterpret_cast<const AssetPackEntry*>(
+			ap->data + sizeof(AssetPackHeader));
+	return true;
+}
+static const char *EntryName(const AssetPack *ap, const AssetPackEntry *e) {
+	return reinterpret_cast<const char*>(ap->data + e->NameOffset);
+}
+static bool IsEntryValid(const AssetPack *ap, const AssetPackEntry *e,
+		const AssetSection s) {
+	// Data is aligned so that it can be used in place
+	if (e->NameOffset >= ap->size
+			|| memchr(ap->data + e->NameOffset, '\0',
+					ap->size - e->NameOffset) == NULL
+			|| e->DataOffset % 16 != 0 || e->DataOffset > ap->size
+			|| e->DataSize > ap->size - e->DataOffset) {
+		return false;
+	}
+	switch (s) {
+	case ASSET_SECTION_IMAGES:
+		return e->W > 0 && e->H > 0
+				&& e->DataSize / 4 / e->W >= (uint64_t) e->H;
+	case ASSET_SECTION_CLASSES:
+		return e->DataSize / sizeof(struct json_flat_node) >= e->Nodes;
+	default:
+		return true;
+	}
+}
+static bool IsValid(const AssetPack *ap) {
+	if (ap->size < sizeof(AssetPackHeader)
+			|| memcmp(ap->Header->Magic, packMagic, sizeof packMagic) != 0
+			|| ap->Header->Version != ASSET_PACK_VERSION) {
+		return false;
+	}
+	// The data and offsets are used as-is, so they need to have been
+	// baked with the same byte order and struct layout
+	if (ap->Header->ByteOrder != ASSET_PACK_BYTE_ORDER
+			|| ap->Header->HeaderSize != sizeof(AssetPackHeader)
+			|| ap->Header->EntrySize != sizeof(AssetPackEntry)) {
+		LOG(LM_MAIN, LL_WARN, "pack was baked on another platform");
+		return false;
+	}
+	if ((ap->size - sizeof(AssetPackHeader)) / sizeof(AssetPackEntry)
+			< ap->Header->Count) {
+		return false;
+	}
+	for (int i = 0; i < ASSET_SECTION_COUNT; i++) {
+		const AssetPackSection *sec = &ap->Header->Sections[i];
+		if ((uint64_t) sec->Start + sec->Count > ap->Header->Count) {
+			return false;
+		}
+		const AssetPackEntry *entries = ap->Entries + sec->Start;
+		for (int j = 0; j < (int) sec->Count; j++) {
+			if (!IsEntryValid(ap, &entries[j], (AssetSection) i)) {
+				return false;
+			}
+			// Sorted, for AssetPackFind
+			if (j > 0 && strcmp(EntryName(ap, &entries[j - 1]),
+					EntryName(ap, &entries[j])) > 0) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+void AssetPackClose(AssetPack *ap) {
+	if (ap->data == NULL) {
+		return;
+	}
+#ifdef _WIN32
+	CFREE((void*) ap->data);
+#else
+	if (ap->isMapped) {
+		munmap((void*) ap->data, ap->size);
+	}
+#endif
+	memset(ap, 0, sizeof *ap);
+}
+
+static const char *sectionNames[ASSET_SECTION_COUNT] = {
+	"images", "class tables", "sounds"
+};
+static bool IsSectionFresh(const AssetPack *ap, const AssetSection s);
+void AssetPackInit(AssetPack *ap) {
+	char buf[CDOGS_PATH_MAX];
+	GetDataFilePath(buf, ASSET_PACK_FILE);
+	if (!AssetPackOpen(ap, buf)) {
+		return;
+	}
+	for (int i = 0; i < ASSET_SECTION_COUNT; i++) {
+		ap->IsFresh[i] = IsSectionFresh(ap, (AssetSection) i);
+	}
+}
+static bool IsSectionFresh(const AssetPack *ap, const AssetSection s) {
+	const AssetPackSection *sec = &ap->Header->Sections[s];
+	bool fresh = true;
+	CArray files;
+	CArrayInit(&files, sizeof(AssetFile));
+	AssetSectionFilesList(&files, s, NULL);
+	// Only read the files if their sizes or times have changed
+	if (sec->StatHash != AssetFilesStatHash(&files)) {
+		if (sec->SourceHash != AssetFilesHash(&files)) {
+			LOG(LM_MAIN, LL_INFO, "%s in %s are stale; loading their files",
+					sectionNames[s], ASSET_PACK_FILE);
+			fresh = false;
+		} else {
+			LOG(LM_MAIN, LL_DEBUG,
+					"%s in %s match but file times have changed; re-bake "
+					"it to skip hashing", sectionNames[s], ASSET_PACK_FILE);
+		}
+	}
+	AssetFilesTerminate(&files);
+	return fresh;
+}
+
+const AssetPackEntry *AssetPackFind(const AssetPack *ap, const AssetSection s,
+		const char *name) {
+	if (!ap->IsFresh[s]) {
+		return NULL;
+	}
+	const AssetPackSection *sec = &ap->Header->Sections[s];
+	int lo = (int) sec->Start;
+	int hi = (int) (sec->Start + sec->Count);
+	while (lo < hi) {
+		const int mid = lo + (hi - lo) / 2;
+		const int cmp = strcmp(EntryName(ap, &ap->Entries[mid]), name);
+		if (cmp == 0) {
+			return &ap->Entries[mid];
+		}
+		if (cmp < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return NULL;
+}
+
+SDL_Surface *AssetPackGetImage(const AssetPack *ap, const int i,
+		const char **name) {
+	const AssetPackEntry *e = &ap->Entries[i];
+	*name = EntryName(ap, e);
+	// The pixels are only read, so they can stay in the read-only mapping
+	void *pixels = const_cast<uint8_t*>(ap->data + e->DataOffset);
+	SDL_Surface *s = SDL_CreateRGBSurfaceWithFormatFrom(pixels, e->W, e->H,
+			32, e->W * 4, SDL_PIXELFORMAT_RGBA8888);
+	if (s == NULL) {
+		LOG(LM_MAIN, LL_ERROR, "cannot create surface: %s", SDL_GetError());
+	}
+	return s;
+}
+
+json_t *AssetPackReadJSON(const AssetPack *ap, const char *filename) {
+	const AssetPackEntry *e = AssetPackFind(ap, ASSET_SECTION_CLASSES,
+			filename);
+	if (e != NULL) {
+		const struct json_flat_node *nodes =
+				reinterpret_cast<const struct json_flat_node*>(
+						ap->data + e->DataOffset);
+		const size_t nodesSize = e->Nodes * sizeof *nodes;
+		json_t *root = NULL;
+		const enum json_error err = json_unflatten(&root, nodes, e->Nodes,
+				reinterpret_cast<const char*>(
+						ap->data + e->DataOffset + nodesSize),
+				(size_t) e->DataSize - nodesSize);
+		if (err == JSON_OK) {
+			return root;
+		}
+		LOG(LM_MAIN, LL_ERROR, "cannot rebuild %s from pack: error(%d)",
+				filename, (int) err);
+	}
+	char buf[CDOGS_PATH_MAX];
+	GetDataFilePath(buf, filename);
+	return JSONReadFile(buf);
+}
@@ -0,0 +1,148 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <SDL2/SDL_surface.h>
+
+#include "c_array.h"
+#include <json/json.h>
+
+// Assets baked offline by cdogs-bake so that start-up doesn't decode or
+// parse them: images decoded to pixels, class tables stored as flat JSON
+// nodes, and sounds decoded to PCM in the game's audio format. The game
+// maps the pack and uses it in place where it can.
+// Each section records the names, sizes and modification times of the
+// files it was baked from, and a hash of their contents. If the former
+// have changed, the contents are hashed to see if the section is stale, in
+// which case its files are loaded instead.
+#define ASSET_PACK_FILE "assets.pack"
+#define ASSET_PACK_VERSION 3
+#define GRAPHICS_DIR "graphics"
+#define SOUNDS_DIR "sounds"
+// Written in native byte order, to reject packs baked on another platform
+#define ASSET_PACK_BYTE_ORDER 0x01020304
+
+typedef enum {
+	ASSET_SECTION_IMAGES,
+	ASSET_SECTION_CLASSES,
+	ASSET_SECTION_SOUNDS,
+	ASSET_SECTION_COUNT
+} AssetSection;
+
+typedef struct {
+	uint64_t SourceHash;
+	uint64_t StatHash;
+	// Range of the section's entries, which are sorted by name
+	uint32_t Start;
+	uint32_t Count;
+} AssetPackSection;
+typedef struct {
+	char Magic[4];
+	uint32_t Version;
+	uint32_t ByteOrder;
+	// Sizes of the structs, to reject packs with a different layout
+	uint16_t HeaderSize;
+	uint16_t EntrySize;
+	// SDL audio spec the sounds were decoded to
+	int32_t AudioFrequency;
+	uint16_t AudioFormat;
+	uint16_t AudioChannels;
+	uint32_t Count;
+	uint32_t Reserved;
+	AssetPackSection Sections[ASSET_SECTION_COUNT];
+} AssetPackHeader;
+typedef struct {
+	uint64_t DataOffset;
+	uint64_t DataSize;
+	uint32_t NameOffset;
+	// Images: RGBA8888 rows without padding
+	int32_t W;
+	int32_t H;
+	// Class tables: number of json_flat_nodes, followed by their strings
+	uint32_t Nodes;
+} AssetPackEntry;
+
+typedef struct {
+	const uint8_t *data;
+	size_t size;
+	bool isMapped;
+	const AssetPackHeader *Header;
+	const AssetPackEntry *Entries;
+	// Stale sections are ignored
+	bool IsFresh[ASSET_SECTION_COUNT];
+} AssetPack;
+
+extern AssetPack gAssetPack;
+
+// File a section is baked from, and the name it has in the pack
+typedef struct {
+	char *Path;
+	char *Name;
+} AssetFile;
+
+// List files recursively; names are relative to path, without
+// extension, and start with prefix if given
+void AssetFilesList(CArray *files, const char *path, const char *prefix);
+// List the files a section is baked from; dataDir is the game's data dir
+// if NULL
+void AssetSectionFilesList(CArray *files, const AssetSection s,
+		const char *dataDir);
+void AssetFilesTerminate(CArray *files);
+// Hash of the files' names and contents, independent of listing order
+uint64_t AssetFilesHash(const CArray *files);
+// Hash of the files' names, sizes and modification times; cheap, as the
+// files aren't read
+uint64_t AssetFilesStatHash(const CArray *files);
+// Decode a PNG file to RGBA8888; returns NULL if not a PNG or on error
+SDL_Surface *AssetDecodePNG(const char *path);
+
+// Bake each section's files and write them as a pack; the audio device
+// must be open, as sounds are decoded to its format
+bool AssetPackWrite(const char *filename,
+		const CArray sectionFiles[ASSET_SECTION_COUNT]);
+
+bool AssetPackOpen(AssetPack *ap, const char *filename);
+void AssetPackClose(AssetPack *ap);
+// Open the game's pack and check which of its sections are fresh; the
+// pack is used in place, so it stays open until AssetPackClose
+void AssetPackInit(AssetPack *ap);
+
+// Entry of a fresh section with the name, or NULL
+const AssetPackEntry *AssetPackFind(const AssetPack *ap, const AssetSection s,
+		const char *name);
+// Surface pointing into the pack, valid until it is closed
+SDL_Surface *AssetPackGetImage(const AssetPack *ap, const int i,
+		const char **name);
+// Parse a data file, e.g. "data/guns.json", rebuilding it from the pack if
+// it was baked there; returns NULL on error
+json_t *AssetPackReadJSON(const AssetPack *ap, const char *filename);
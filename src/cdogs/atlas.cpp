@@ -0,0 +1,219 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "atlas.h"
+
+#include <string.h>
+
+#include "grafx.h"
+#include "log.h"
+#include "texture.h"
+#include "utils.h"
+
+void AtlasInit(Atlas *a) {
+	memset(a, 0, sizeof *a);
+	CArrayInit(&a->Pages, sizeof(AtlasPage));
+}
+void AtlasTerminate(Atlas *a) {
+	CA_FOREACH(AtlasPage, page, a->Pages)
+		SDL_DestroyTexture(page->Tex);
+		CArrayTerminate(&page->Skyline);
+	CA_FOREACH_END()
+	CArrayTerminate(&a->Pages);
+}
+void AtlasReset(Atlas *a) {
+	CA_FOREACH(AtlasPage, page, a->Pages)
+		CArrayTerminate(&page->Skyline);
+	CA_FOREACH_END()
+	CArrayClear(&a->Pages);
+}
+
+static void PageReset(AtlasPage *page) {
+	CArrayClear(&page->Skyline);
+	AtlasSkylineNode n = { 0, 0, ATLAS_PAGE_SIZE };
+	CArrayPushBack(&page->Skyline, &n);
+}
+static AtlasPage *AddPage(Atlas *a, const bool isCustom) {
+	if ((int) a->Pages.size >= ATLAS_MAX_PAGES) {
+		return NULL;
+	}
+	AtlasPage page;
+	memset(&page, 0, sizeof page);
+	page.IsCustom = isCustom;
+	page.Tex = TextureCreate(gGraphicsDevice.gameWindow.renderer,
+			SDL_TEXTUREACCESS_STATIC, svec2i(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE),
+			SDL_BLENDMODE_BLEND, 255);
+	if (page.Tex == NULL) {
+		return NULL;
+	}
+	// Static textures start undefined; clear so that padding is transparent
+	Uint32 *blank;
+	CCALLOC(blank, ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE * sizeof *blank);
+	if (SDL_UpdateTexture(page.Tex, NULL, blank,
+			ATLAS_PAGE_SIZE * sizeof *blank) != 0) {
+		LOG(LM_GFX, LL_ERROR, "cannot clear atlas page: %s", SDL_GetError());
+	}
+	CFREE(blank);
+	CArrayInit(&page.Skyline, sizeof(AtlasSkylineNode));
+	PageReset(&page);
+	CArrayPushBack(&a->Pages, &page);
+	LOG(LM_GFX, LL_DEBUG, "added atlas page %d custom(%s)",
+			(int) a->Pages.size - 1, isCustom ? "true" : "false");
+	return static_cast<AtlasPage*>(CArrayGet(&a->Pages, a->Pages.size - 1));
+}
+
+// Skyline bottom-left packing: the page's used area is described by its top
+// edge, a list of horizontal segments. A rect is placed on the segments where
+// its top would be lowest.
+static int SkylineFit(const AtlasPage *page, const int idx,
+		const struct vec2i size) {
+	const AtlasSkylineNode *n = static_cast<const AtlasSkylineNode*>(CArrayGet(
+			&page->Skyline, idx));
+	if (n->X + size.x > ATLAS_PAGE_SIZE) {
+		return -1;
+	}
+	int y = n->Y;
+	int widthLeft = size.x;
+	for (int i = idx; widthLeft > 0; i++) {
+		if (i == (int) page->Skyline.size) {
+			return -1;
+		}
+		n = static_cast<const AtlasSkylineNode*>(CArrayGet(&page->Skyline, i));
+		y = MAX(y, n->Y);
+		if (y + size.y > ATLAS_PAGE_SIZE) {
+			return -1;
+		}
+		widthLeft -= n->W;
+	}
+	return y;
+}
+static bool SkylineFind(const AtlasPage *page, const struct vec2i size,
+		int *bestIdx, struct vec2i *pos) {
+	int bestBottom = ATLAS_PAGE_SIZE + 1;
+	int bestWidth = ATLAS_PAGE_SIZE + 1;
+	*bestIdx = -1;
+	CA_FOREACH(const AtlasSkylineNode, n, page->Skyline)
+		const int y = SkylineFit(page, _ca_index, size);
+		if (y < 0) {
+			continue;
+		}
+		if (y + size.y < bestBottom
+				|| (y + size.y == bestBottom && n->W < bestWidth)) {
+			bestBottom = y + size.y;
+			bestWidth = n->W;
+			*bestIdx = _ca_index;
+			*pos = svec2i(n->X, y);
+		}
+	CA_FOREACH_END()
+	return *bestIdx >= 0;
+}
+static void SkylineInsert(AtlasPage *page, const int idx,
+		const struct vec2i pos, const struct vec2i size) {
+	AtlasSkylineNode n = { pos.x, pos.y + size.y, size.x };
+	CArrayInsert(&page->Skyline, idx, &n);
+	// Shrink or remove the segments now covered by the new one
+	for (int i = idx + 1; i < (int) page->Skyline.size; i++) {
+		const AtlasSkylineNode *prev =
+				static_cast<const AtlasSkylineNode*>(CArrayGet(&page->Skyline,
+						i - 1));
+		AtlasSkylineNode *cur = static_cast<AtlasSkylineNode*>(CArrayGet(
+				&page->Skyline, i));
+		const int overlap = prev->X + prev->W - cur->X;
+		if (overlap <= 0) {
+			break;
+		}
+		cur->X += overlap;
+		cur->W -= overlap;
+		if (cur->W > 0) {
+			break;
+		}
+		CArrayDelete(&page->Skyline, i);
+		i--;
+	}
+	// Merge neighbouring segments at the same height
+	for (int i = 0; i < (int) page->Skyline.size - 1; i++) {
+		AtlasSkylineNode *cur = static_cast<AtlasSkylineNode*>(CArrayGet(
+				&page->Skyline, i));
+		const AtlasSkylineNode *next =
+				static_cast<const AtlasSkylineNode*>(CArrayGet(&page->Skyline,
+						i + 1));
+		if (cur->Y == next->Y) {
+			cur->W += next->W;
+			CArrayDelete(&page->Skyline, i + 1);
+			i--;
+		}
+	}
+}
+
+bool AtlasAdd(Atlas *a, Pic *p, const bool isCustom) {
+	if (PicIsNone(p) || p->size.x > ATLAS_MAX_PIC_SIZE
+			|| p->size.y > ATLAS_MAX_PIC_SIZE) {
+		return false;
+	}
+	const struct vec2i padded = svec2i_add(p->size,
+			svec2i(ATLAS_PADDING, ATLAS_PADDING));
+	AtlasPage *page = NULL;
+	int idx = -1;
+	struct vec2i pos = svec2i_zero();
+	CA_FOREACH(AtlasPage, pg, a->Pages)
+		if (pg->IsCustom == isCustom && SkylineFind(pg, padded, &idx, &pos)) {
+			page = pg;
+			break;
+		}
+	CA_FOREACH_END()
+	if (page == NULL) {
+		page = AddPage(a, isCustom);
+		if (page == NULL || !SkylineFind(page, padded, &idx, &pos)) {
+			return false;
+		}
+	}
+	const SDL_Rect rect = { pos.x, pos.y, p->size.x, p->size.y };
+	if (SDL_UpdateTexture(page->Tex, &rect, p->Data,
+			p->size.x * sizeof *p->Data) != 0) {
+		LOG(LM_GFX, LL_ERROR, "cannot update atlas page: %s", SDL_GetError());
+		return false;
+	}
+	SkylineInsert(page, idx, pos, padded);
+
+	// Replace the pic's own texture
+	if (p->Tex != NULL && !p->InAtlas) {
+		SDL_DestroyTexture(p->Tex);
+	}
+	p->Tex = page->Tex;
+	p->InAtlas = true;
+	p->TexPos = pos;
+	return true;
+}
+
+void AtlasClearCustom(Atlas *a) {
+	CA_FOREACH(AtlasPage, page, a->Pages)
+		if (page->IsCustom) {
+			PageReset(page);
+		}
+	CA_FOREACH_END()
+}
@@ -0,0 +1,77 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL2/SDL_render.h>
+
+#include "c_array.h"
+#include "pic.h"
+
+#define ATLAS_PAGE_SIZE 1024
+#define ATLAS_MAX_PAGES 16
+// Gap between packed pics, so that filtered scaling doesn't bleed
+#define ATLAS_PADDING 1
+// Bigger pics keep their own texture
+#define ATLAS_MAX_PIC_SIZE 256
+
+typedef struct {
+	int X;
+	int Y;
+	int W;
+} AtlasSkylineNode;
+
+typedef struct {
+	SDL_Texture *Tex;
+	CArray Skyline;	// of AtlasSkylineNode
+	// Custom pages hold pics generated for the current campaign, and are
+	// emptied along with them
+	bool IsCustom;
+} AtlasPage;
+
+// Packs many pics into a few large textures, so that consecutive pic draws
+// share a texture and can be batched
+typedef struct {
+	CArray Pages;	// of AtlasPage
+} Atlas;
+
+void AtlasInit(Atlas *a);
+void AtlasTerminate(Atlas *a);
+// Forget all pages without destroying their textures, for when the renderer
+// that owned them has already been destroyed
+void AtlasReset(Atlas *a);
+
+// Copy the pic's pixels into a page, and point the pic at it instead of its
+// own texture. Returns false if the pic doesn't fit, in which case the pic
+// is unchanged.
+bool AtlasAdd(Atlas *a, Pic *p, const bool isCustom);
+// Make custom pages available for reuse; pics packed into them must no
+// longer be used
+void AtlasClearCustom(Atlas *a);
@@ -58,11 +58,13 @@
 #include "draw/drawtools.h"
 #include "font.h"
 #include "gamedata.h"
+#include "log.h"
 #include "map.h"
 #include "mission.h"
 #include "objs.h"
 #include "pic_manager.h"
 #include "pickup.h"
+#include "texture.h"
 
 #define MAP_FACTOR 2
 #define MASK_ALPHA 128;
@@ -179,50 +181,148 @@ void DrawDot(Thing *t, color_t color, struct vec2i pos, int scale) {
 	DrawRectangle(&gGraphicsDevice, pos, svec2i(scale, scale), color, false);
 }
 
+static color_t GetTileColor(Map *map, const struct vec2i pos,
+		const bool showAll) {
+	const Tile *tile = MapGetTile(map, pos);
+	const TileClass *tc = TileGetClass(tile);
+	if (tc->Pic == NULL || !(tile->isVisited || showAll)) {
+		return colorTransparent;
+	}
+	switch (tc->Type) {
+	case TILE_CLASS_WALL:
+		return colorWall;
+	case TILE_CLASS_DOOR:
+		return DoorColor(pos.x, pos.y);
+	case TILE_CLASS_FLOOR:
+		return tc->IsRoom ? colorRoom : colorFloor;
+	default:
+		CASSERT(false, "Unknown tile class type")
+		;
+		return colorTransparent;
+	}
+}
+
+AutomapCache gAutomapCache;
+
+void AutomapCacheInit(AutomapCache *ac) {
+	memset(ac, 0, sizeof *ac);
+	ac->All.ShowAll = true;
+}
+static void LayerTerminate(AutomapLayer *l) {
+	if (l->Tex != NULL) {
+		SDL_DestroyTexture(l->Tex);
+		l->Tex = NULL;
+	}
+	CFREE(l->pixels);
+	l->pixels = NULL;
+}
+void AutomapCacheTerminate(AutomapCache *ac) {
+	LayerTerminate(&ac->Explored);
+	LayerTerminate(&ac->All);
+	AutomapCacheInit(ac);
+}
+
+static void LayerInvalidateAll(AutomapLayer *l, const struct vec2i size);
+void AutomapCacheSetMapSize(AutomapCache *ac, const struct vec2i mapSize) {
+	AutomapCacheTerminate(ac);
+	ac->Size = mapSize;
+	LayerInvalidateAll(&ac->Explored, ac->Size);
+	LayerInvalidateAll(&ac->All, ac->Size);
+}
+static void LayerInvalidateAll(AutomapLayer *l, const struct vec2i size) {
+	l->Dirty = true;
+	l->dirtyStart = svec2i_zero();
+	l->dirtyEnd = svec2i_subtract(size, svec2i_one());
+}
+
+void AutomapCacheReset(AutomapCache *ac) {
+	ac->Explored.Tex = NULL;
+	ac->All.Tex = NULL;
+	LayerInvalidateAll(&ac->Explored, ac->Size);
+	LayerInvalidateAll(&ac->All, ac->Size);
+}
+
+static void LayerInvalidate(AutomapLayer *l, const struct vec2i pos) {
+	if (l->Dirty) {
+		l->dirtyStart = svec2i_min(l->dirtyStart, pos);
+		l->dirtyEnd = svec2i_max(l->dirtyEnd, pos);
+	} else {
+		l->dirtyStart = l->dirtyEnd = pos;
+		l->Dirty = true;
+	}
+}
+void AutomapCacheInvalidate(AutomapCache *ac, const struct vec2i tilePos) {
+	if (tilePos.x < 0 || tilePos.y < 0 || tilePos.x >= ac->Size.x
+			|| tilePos.y >= ac->Size.y) {
+		return;
+	}
+	LayerInvalidate(&ac->Explored, tilePos);
+	LayerInvalidate(&ac->All, tilePos);
+}
+
+// Bring the layer's texture up to date, creating it if needed.
+// Returns false if there is no texture to draw.
+static bool LayerUpdate(AutomapLayer *l, Map *map) {
+	if (svec2i_is_zero(map->Size)) {
+		return false;
+	}
+	if (l->Tex == NULL) {
+		l->Tex = TextureCreate(gGraphicsDevice.gameWindow.renderer,
+				SDL_TEXTUREACCESS_STREAMING, map->Size, SDL_BLENDMODE_BLEND,
+				255);
+		if (l->Tex == NULL) {
+			return false;
+		}
+		LayerInvalidateAll(l, map->Size);
+	}
+	if (!l->Dirty) {
+		return true;
+	}
+	if (l->pixels == NULL) {
+		CMALLOC(l->pixels, map->Size.x * map->Size.y * sizeof *l->pixels);
+	}
+	struct vec2i v;
+	for (v.y = l->dirtyStart.y; v.y <= l->dirtyEnd.y; v.y++) {
+		for (v.x = l->dirtyStart.x; v.x <= l->dirtyEnd.x; v.x++) {
+			const color_t c = GetTileColor(map, v, l->ShowAll);
+			l->pixels[v.x + v.y * map->Size.x] =
+					ColorEquals(c, colorTransparent) ? 0 : COLOR2PIXEL(c);
+		}
+	}
+	SDL_Rect rect;
+	rect.x = l->dirtyStart.x;
+	rect.y = l->dirtyStart.y;
+	rect.w = l->dirtyEnd.x - l->dirtyStart.x + 1;
+	rect.h = l->dirtyEnd.y - l->dirtyStart.y + 1;
+	if (SDL_UpdateTexture(l->Tex, &rect,
+			l->pixels + rect.x + rect.y * map->Size.x,
+			map->Size.x * sizeof *l->pixels) != 0) {
+		LOG(LM_GFX, LL_ERROR, "cannot update automap: %s", SDL_GetError());
+	}
+	l->Dirty = false;
+	return true;
+}
+
+static void DrawMapTiles(Map *map, const struct vec2i mapPos, const int scale,
+		const int flags);
 static void DrawMap(Map *map, struct vec2i center, struct vec2i centerOn,
 		struct vec2i size, int scale, int flags) {
-	int x, y;
 	struct vec2i mapPos = svec2i_add(center,
 			svec2i_scale(centerOn, (float) -scale));
-	for (y = 0; y < gMap.Size.y; y++) {
-		int i;
-		for (i = 0; i < scale; i++) {
-			for (x = 0; x < gMap.Size.x; x++) {
-				Tile *tile = MapGetTile(map, svec2i(x, y));
-				if (tile->Class->Pic != NULL
-						&& (tile->isVisited || (flags & AUTOMAP_FLAGS_SHOWALL))) {
-					int j;
-					for (j = 0; j < scale; j++) {
-						struct vec2i drawPos = svec2i(mapPos.x + x * scale + j,
-								mapPos.y + y * scale + i);
-						color_t color = colorTransparent;
-						switch (tile->Class->Type) {
-						case TILE_CLASS_WALL:
-							color = colorWall;
-							break;
-						case TILE_CLASS_DOOR:
-							color = DoorColor(x, y);
-							break;
-						case TILE_CLASS_FLOOR:
-							color = tile->Class->IsRoom ?
-									colorRoom : colorFloor;
-							break;
-						default:
-							CASSERT(false, "Unknown tile class type")
-							;
-							break;
-						}
-						if (!ColorEquals(color, colorTransparent)) {
-							if (flags & AUTOMAP_FLAGS_MASK) {
-								color.a = MASK_ALPHA
-								;
-							}
-							DrawPoint(drawPos, color);
-						}
-					}
-				}
-			}
+	AutomapLayer *l = (flags & AUTOMAP_FLAGS_SHOWALL) ?
+			&gAutomapCache.All : &gAutomapCache.Explored;
+	if (map == &gMap && LayerUpdate(l, map)) {
+		color_t mask = colorWhite;
+		if (flags & AUTOMAP_FLAGS_MASK) {
+			mask.a = MASK_ALPHA
+			;
 		}
+		TextureRender(l->Tex, gGraphicsDevice.gameWindow.renderer,
+				Rect2iNew(svec2i_zero(), map->Size),
+				Rect2iNew(mapPos, svec2i_scale(map->Size, (float) scale)),
+				mask, 0, SDL_FLIP_NONE);
+	} else {
+		DrawMapTiles(map, mapPos, scale, flags);
 	}
 	if (flags & AUTOMAP_FLAGS_MASK) {
 		const color_t color = { 255, 255, 255, 128 };
@@ -231,18 +331,59 @@ static void DrawMap(Map *map, struct vec2i center, struct vec2i centerOn,
 				color, false);
 	}
 }
+static void DrawMapTiles(Map *map, const struct vec2i mapPos, const int scale,
+		const int flags) {
+	struct vec2i v;
+	for (v.y = 0; v.y < map->Size.y; v.y++) {
+		for (v.x = 0; v.x < map->Size.x; v.x++) {
+			color_t color = GetTileColor(map, v,
+					flags & AUTOMAP_FLAGS_SHOWALL);
+			if (ColorEquals(color, colorTransparent)) {
+				continue;
+			}
+			if (flags & AUTOMAP_FLAGS_MASK) {
+				color.a = MASK_ALPHA
+				;
+			}
+			DrawRectangle(&gGraphicsDevice,
+					svec2i_add(mapPos, svec2i_scale(v, (float) scale)),
+					svec2i(scale, scale), color, false);
+		}
+	}
+}
 
 static void DrawThing(Thing *t, Tile *tile, struct vec2i pos, int scale,
 		int flags);
+static void MaybeDrawThing(Map *map, Thing *t, struct vec2i pos, int scale,
+		int flags);
+// Only objectives and keys are drawn, so go through the things that can be
+// those rather than every tile
 static void DrawObjectivesAndKeys(Map *map, struct vec2i pos, int scale,
 		int flags) {
-	for (int y = 0; y < map->Size.y; y++) {
-		for (int x = 0; x < map->Size.x; x++) {
-			Tile *tile = MapGetTile(map, svec2i(x, y));
-			CA_FOREACH(ThingId, tid, tile->things)
-				DrawThing(ThingIdGetThing(tid), tile, pos, scale, flags);
-			CA_FOREACH_END()
+	CA_FOREACH(TActor, a, gActors)
+		if (a->isInUse) {
+			MaybeDrawThing(map, &a->thing, pos, scale, flags);
 		}
+	CA_FOREACH_END()
+	CA_FOREACH(TObject, o, gObjs)
+		if (o->isInUse) {
+			MaybeDrawThing(map, &o->thing, pos, scale, flags);
+		}
+	CA_FOREACH_END()
+	CA_FOREACH(Pickup, p, gPickups)
+		if (p->isInUse) {
+			MaybeDrawThing(map, &p->thing, pos, scale, flags);
+		}
+	CA_FOREACH_END()
+}
+static void MaybeDrawThing(Map *map, Thing *t, struct vec2i pos, int scale,
+		int flags) {
+	if (!(t->flags & THING_OBJECTIVE) && t->kind != KIND_PICKUP) {
+		return;
+	}
+	Tile *tile = MapGetTile(map, Vec2ToTile(t->Pos));
+	if (tile != NULL) {
+		DrawThing(t, tile, pos, scale, flags);
 	}
 }
 static void DrawThing(Thing *t, Tile *tile, struct vec2i pos, int scale,
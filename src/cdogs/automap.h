@@ -34,6 +34,34 @@
 #define AUTOMAP_FLAGS_SHOWALL 0x01
 #define AUTOMAP_FLAGS_MASK 0x02
 
+// The map's tiles as a texture with one texel per tile, kept up to date as
+// tiles are explored or changed, so drawing the automap is one texture copy
+typedef struct {
+	SDL_Texture *Tex;
+	// Staging copy of the texels
+	Uint32 *pixels;
+	bool ShowAll;
+	bool Dirty;
+	struct vec2i dirtyStart;
+	struct vec2i dirtyEnd;
+} AutomapLayer;
+typedef struct {
+	struct vec2i Size;
+	AutomapLayer Explored;
+	AutomapLayer All;
+} AutomapCache;
+
+extern AutomapCache gAutomapCache;
+
+void AutomapCacheInit(AutomapCache *ac);
+void AutomapCacheTerminate(AutomapCache *ac);
+void AutomapCacheSetMapSize(AutomapCache *ac, const struct vec2i mapSize);
+// Forget the textures without destroying them, for when the renderer that
+// owned them has already been destroyed
+void AutomapCacheReset(AutomapCache *ac);
+// Call when a tile is explored or changes class
+void AutomapCacheInvalidate(AutomapCache *ac, const struct vec2i tilePos);
+
 void AutomapDraw(SDL_Renderer *renderer, const int flags, const bool showExit);
 void AutomapDrawRegion(SDL_Renderer *renderer, Map *map, struct vec2i pos,
 		const struct vec2i size, const struct vec2i mapCenter, const int flags,
@@ -79,17 +79,6 @@ color_t CharColorsGetChannelMask(const CharColors *c, const uint8_t alpha) {
 		return colorWhite;
 	}
 }
-void CharColorsGetMaskedName(char *buf, const char *base, const CharColors *c) {
-	char bufSkin[COLOR_STR_BUF], bufArms[COLOR_STR_BUF], bufBody[COLOR_STR_BUF],
-			bufLegs[COLOR_STR_BUF], bufHair[COLOR_STR_BUF];
-	ColorStr(bufSkin, c->Skin);
-	ColorStr(bufArms, c->Arms);
-	ColorStr(bufBody, c->Body);
-	ColorStr(bufLegs, c->Legs);
-	ColorStr(bufHair, c->Hair);
-	sprintf(buf, "%s/%s/%s/%s/%s/%s", base, bufSkin, bufArms, bufBody, bufLegs,
-			bufHair);
-}
 
 void BlitClearBuf(GraphicsDevice *g) {
 	memset(g->buf, 0, GraphicsGetMemSize(&g->cachedConfig));
@@ -56,7 +56,6 @@ void BlitUpdateFromBuf(GraphicsDevice *g, SDL_Texture *t);
 
 CharColors CharColorsFromOneColor(const color_t color);
 color_t CharColorsGetChannelMask(const CharColors *c, const uint8_t alpha);
-void CharColorsGetMaskedName(char *buf, const char *base, const CharColors *c);
 
 #define BLIT_BRIGHTNESS_MIN (-10)
 #define BLIT_BRIGHTNESS_MAX 10
@@ -235,7 +235,7 @@ static struct vec2 GetFollowPlayerPos(const struct vec2 lastPos,
 }
 
 static void DoBuffer(DrawBuffer *b, const struct vec2 center, const int w,
-		const struct vec2 noise, const struct vec2i offset);
+		const struct vec2 noise, const struct vec2i offset, const int view);
 void CameraDraw(Camera *camera, const HUDDrawData drawData) {
 	struct vec2i centerOffset = svec2i_zero();
 	const int w = gGraphicsDevice.cachedConfig.Res.x;
@@ -246,7 +246,7 @@ void CameraDraw(Camera *camera, const HUDDrawData drawData) {
 	GraphicsResetClip(gGraphicsDevice.gameWindow.renderer);
 	if (drawData.NumScreens == 0) {
 		DoBuffer(&camera->Buffer, camera->lastPosition,
-		X_TILES, noise, centerOffset);
+		X_TILES, noise, centerOffset, 0);
 	} else {
 		// Redo LOS if PVP, so that each split screen has its own LOS
 		if (IsPVP(gCampaign.Entry.Mode) && drawData.NumScreens > 0) {
@@ -268,7 +268,7 @@ void CameraDraw(Camera *camera, const HUDDrawData drawData) {
 			}
 
 			DoBuffer(&camera->Buffer, camera->lastPosition,
-			X_TILES, noise, centerOffset);
+			X_TILES, noise, centerOffset, 0);
 		} else if (drawData.NumScreens == 2) {
 			// side-by-side split
 			for (int i = 0; i < drawData.NumScreens; i++) {
@@ -291,7 +291,7 @@ void CameraDraw(Camera *camera, const HUDDrawData drawData) {
 
 				LOSCalcFrom(&gMap, Vec2ToTile(camera->lastPosition), false);
 				DoBuffer(&camera->Buffer, camera->lastPosition,
-				X_TILES_HALF, noise, centerOffsetPlayer);
+				X_TILES_HALF, noise, centerOffsetPlayer, i);
 			}
 			Draw_Line(w / 2 - 1, 0, w / 2 - 1, h - 1, colorBlack);
 			Draw_Line(w / 2, 0, w / 2, h - 1, colorBlack);
@@ -322,7 +322,7 @@ void CameraDraw(Camera *camera, const HUDDrawData drawData) {
 				}
 				LOSCalcFrom(&gMap, Vec2ToTile(camera->lastPosition), false);
 				DoBuffer(&camera->Buffer, camera->lastPosition,
-				X_TILES_HALF, noise, centerOffsetPlayer);
+				X_TILES_HALF, noise, centerOffsetPlayer, i);
 			}
 			Draw_Line(w / 2 - 1, 0, w / 2 - 1, h - 1, colorBlack);
 			Draw_Line(w / 2, 0, w / 2, h - 1, colorBlack);
@@ -335,7 +335,8 @@ void CameraDraw(Camera *camera, const HUDDrawData drawData) {
 	GraphicsResetClip(gGraphicsDevice.gameWindow.renderer);
 }
 static void DoBuffer(DrawBuffer *b, const struct vec2 center, const int w,
-		const struct vec2 noise, const struct vec2i offset) {
+		const struct vec2 noise, const struct vec2i offset, const int view) {
+	b->View = view;
 	DrawBufferSetFromMap(b, &gMap, svec2_add(center, noise), w);
 	if (gPlayerDatas.size > 0) {
 		DrawBufferFix(b);
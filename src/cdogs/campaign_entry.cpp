@@ -83,14 +83,16 @@ bool CampaignEntryTryLoad(CampaignEntry *entry, const char *path,
 	if (!IsCampaignOK(path, &buf, &numMissions)) {
 		return false;
 	}
+	CampaignEntryInitScanned(entry, path, mode, buf, numMissions);
+	CFREE(buf);
+	return true;
+}
+void CampaignEntryInitScanned(CampaignEntry *entry, const char *path,
+		const GameMode mode, const char *title, const int numMissions) {
 	// cap length of title
-	size_t maxLen = 70;
-	if (strlen(buf) > maxLen) {
-		buf[maxLen] = '\0';
-	}
-	char title[256];
-	sprintf(title, "%s (%d)", buf, numMissions);
-	CampaignEntryInit(entry, title, mode);
+	char info[256];
+	sprintf(info, "%.70s (%d)", title, numMissions);
+	CampaignEntryInit(entry, info, mode);
 	entry->Filename = static_cast<char*>(malloc(
 			strlen(PathGetBasename(path)) + 1));
 	if (entry->Filename == NULL && strlen(PathGetBasename(path)) + 1 > 0) {
@@ -112,8 +114,6 @@ bool CampaignEntryTryLoad(CampaignEntry *entry, const char *path,
 	strcpy(entry->Path, pathBuf);
 //	CSTRDUP(entry->Path, pathBuf);
 	entry->NumMissions = numMissions;
-	CFREE(buf);
-	return true;
 }
 void CampaignEntryTerminate(CampaignEntry *entry) {
 	CFREE(entry->Filename);
@@ -42,4 +42,7 @@ void CampaignEntryInit(CampaignEntry *entry, const char *title, GameMode mode);
 void CampaignEntryCopy(CampaignEntry *dst, CampaignEntry *src);
 bool CampaignEntryTryLoad(CampaignEntry *entry, const char *path,
 		GameMode mode);
+// Init from the results of scanning the campaign at path
+void CampaignEntryInitScanned(CampaignEntry *entry, const char *path,
+		const GameMode mode, const char *title, const int numMissions);
 void CampaignEntryTerminate(CampaignEntry *entry);
@@ -0,0 +1,293 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "campaign_index.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_cpuinfo.h>
+#include <SDL2/SDL_thread.h>
+
+#include "files.h"
+#include "json_utils.h"
+#include "log.h"
+#include "map_archive.h"
+#include "map_new.h"
+#include "utils.h"
+
+#ifndef S_ISDIR
+#define S_ISDIR(m) (((m) & S_IFMT) == S_IFDIR)
+#endif
+
+static void LoadEntries(CampaignIndex *ci, json_t *node);
+void CampaignIndexLoad(CampaignIndex *ci) {
+	memset(ci, 0, sizeof *ci);
+	ci->entries = hashmap_new();
+	json_t *root = NULL;
+	int version = 0;
+	int mapVersion = 0;
+	FILE *f = fopen(GetConfigFilePath(CAMPAIGN_INDEX_FILE), "r");
+	if (f == NULL) {
+		goto bail;
+	}
+	if (json_stream_parse(f, &root) != JSON_OK) {
+		LOG(LM_MAIN, LL_WARN, "cannot parse campaign index, rebuilding");
+		goto bail;
+	}
+	LoadInt(&version, root, "Version");
+	LoadInt(&mapVersion, root, "MapVersion");
+	// A newer map version may load campaigns that were rejected before
+	if (version != CAMPAIGN_INDEX_VERSION || mapVersion != MAP_VERSION_MAX) {
+		goto bail;
+	}
+	LoadEntries(ci, root);
+
+bail:
+	json_free_value(&root);
+	if (f != NULL) {
+		fclose(f);
+	}
+}
+static void LoadEntries(CampaignIndex *ci, json_t *node) {
+	const json_t *campaigns = json_find_first_label(node, "Campaigns");
+	if (campaigns == NULL || campaigns->child == NULL) {
+		return;
+	}
+	for (json_t *child = campaigns->child->child; child; child = child->next) {
+		char *path = NULL;
+		LoadStr(&path, child, "Path");
+		if (path == NULL) {
+			continue;
+		}
+		CampaignIndexEntry *e;
+		CCALLOC(e, sizeof *e);
+		double d = 0;
+		LoadDouble(&d, child, "Mtime");
+		e->Mtime = (int64_t) d;
+		d = 0;
+		LoadDouble(&d, child, "Size");
+		e->Size = (int64_t) d;
+		int mode = GAME_MODE_NORMAL;
+		LoadInt(&mode, child, "Mode");
+		e->Mode = (GameMode) mode;
+		LoadStr(&e->Title, child, "Title");
+		LoadInt(&e->NumMissions, child, "Missions");
+		if (hashmap_put(ci->entries, path, e) != MAP_OK) {
+			CFREE(e->Title);
+			CFREE(e);
+		}
+		CFREE(path);
+	}
+}
+
+static int SaveEntry(any_t data, any_t key);
+static void EntryDestroy(any_t data);
+void CampaignIndexTerminate(CampaignIndex *ci) {
+	if (ci->entries == NULL) {
+		return;
+	}
+	json_t *root = json_new_object();
+	json_t *campaigns = json_new_array();
+	// Also saves if files were removed, as their entries are dropped
+	const int length = hashmap_length(ci->entries);
+	void *saveData[] = { ci->entries, campaigns };
+	if (hashmap_iterate_keys(ci->entries, SaveEntry, saveData) != MAP_OK) {
+		CASSERT(false, "cannot save campaign index");
+	}
+	int numSaved = 0;
+	for (const json_t *c = campaigns->child; c; c = c->next) {
+		numSaved++;
+	}
+	if (ci->isDirty || numSaved != length) {
+		AddIntPair(root, "Version", CAMPAIGN_INDEX_VERSION);
+		AddIntPair(root, "MapVersion", MAP_VERSION_MAX);
+		json_insert_pair_into_object(root, "Campaigns", campaigns);
+		campaigns = NULL;
+		if (!TrySaveJSONFile(root, GetConfigFilePath(CAMPAIGN_INDEX_FILE))) {
+			LOG(LM_MAIN, LL_ERROR, "cannot save campaign index");
+		}
+	}
+	json_free_value(&campaigns);
+	json_free_value(&root);
+	hashmap_destroy(ci->entries, EntryDestroy);
+	memset(ci, 0, sizeof *ci);
+}
+static void AddInt64Pair(json_t *parent, const char *name, const int64_t n) {
+	char buf[32];
+	sprintf(buf, "%lld", (long long) n);
+	json_insert_pair_into_object(parent, name, json_new_number(buf));
+}
+static int SaveEntry(any_t data, any_t key) {
+	void **saveData = static_cast<void**>(data);
+	const map_t entries = static_cast<map_t>(saveData[0]);
+	json_t *campaigns = static_cast<json_t*>(saveData[1]);
+	CampaignIndexEntry *e;
+	const int error = hashmap_get(entries, (const char*) key, (any_t*) &e);
+	if (error != MAP_OK) {
+		return error;
+	}
+	if (!e->isSeen) {
+		return MAP_OK;
+	}
+	json_t *node = json_new_object();
+	AddStringPair(node, "Path", (const char*) key);
+	AddInt64Pair(node, "Mtime", e->Mtime);
+	AddInt64Pair(node, "Size", e->Size);
+	AddIntPair(node, "Mode", (int) e->Mode);
+	if (e->Title != NULL) {
+		AddStringPair(node, "Title", e->Title);
+		AddIntPair(node, "Missions", e->NumMissions);
+	}
+	json_insert_child(campaigns, node);
+	return MAP_OK;
+}
+static void EntryDestroy(any_t data) {
+	CampaignIndexEntry *e = static_cast<CampaignIndexEntry*>(data);
+	CFREE(e->Title);
+	CFREE(e);
+}
+
+typedef struct {
+	const char *path;
+	CampaignIndexEntry *entry;
+} CampaignScanJob;
+typedef struct {
+	CArray jobs;	// of CampaignScanJob
+	SDL_atomic_t next;
+} CampaignScanner;
+static bool StatCampaign(const char *path, int64_t *mtime, int64_t *size);
+static int ScanWorker(void *data);
+void CampaignIndexScan(CampaignIndex *ci, CArray *queries) {
+	CampaignScanner s;
+	memset(&s, 0, sizeof s);
+	CArrayInit(&s.jobs, sizeof(CampaignScanJob));
+	CA_FOREACH(CampaignIndexQuery, q, *queries)
+		q->Result = NULL;
+		int64_t mtime, size;
+		if (!StatCampaign(q->Path, &mtime, &size)) {
+			continue;
+		}
+		CampaignIndexEntry *e = NULL;
+		if (hashmap_get(ci->entries, q->Path, (any_t*) &e) == MAP_OK) {
+			if (e->Mtime == mtime && e->Size == size && e->Mode == q->Mode) {
+				e->isSeen = true;
+				q->Result = e;
+				continue;
+			}
+			CFREE(e->Title);
+		} else {
+			CCALLOC(e, sizeof *e);
+			if (hashmap_put(ci->entries, q->Path, e) != MAP_OK) {
+				CFREE(e);
+				continue;
+			}
+		}
+		e->Mtime = mtime;
+		e->Size = size;
+		e->Mode = q->Mode;
+		e->Title = NULL;
+		e->NumMissions = 0;
+		e->isSeen = true;
+		q->Result = e;
+		ci->isDirty = true;
+		const CampaignScanJob job = { q->Path, e };
+		CArrayPushBack(&s.jobs, &job);
+	CA_FOREACH_END()
+	if (s.jobs.size == 0) {
+		goto bail;
+	}
+
+	{
+		SDL_Thread *threads[CAMPAIGN_SCAN_MAX_THREADS];
+		int numThreads = 0;
+		const int wanted = CLAMP(SDL_GetCPUCount() - 1, 0,
+				CAMPAIGN_SCAN_MAX_THREADS);
+		for (; numThreads < MIN(wanted, (int) s.jobs.size - 1); numThreads++) {
+			threads[numThreads] = SDL_CreateThread(ScanWorker,
+					"campaign scan", &s);
+			if (threads[numThreads] == NULL) {
+				LOG(LM_MAIN, LL_WARN, "cannot create campaign scan thread: %s",
+						SDL_GetError());
+				break;
+			}
+		}
+		LOG(LM_MAIN, LL_INFO, "scanning %d of %d campaigns with %d threads",
+				(int) s.jobs.size, (int) queries->size, numThreads + 1);
+		ScanWorker(&s);
+		for (int i = 0; i < numThreads; i++) {
+			SDL_WaitThread(threads[i], NULL);
+		}
+	}
+
+bail:
+	CArrayTerminate(&s.jobs);
+}
+// Archives are folders, which aren't touched when a file inside them is
+// edited; key them on the campaign.json that is scanned instead
+static bool StatCampaign(const char *path, int64_t *mtime, int64_t *size) {
+	struct stat st;
+	if (stat(path, &st) != 0) {
+		return false;
+	}
+	if (S_ISDIR(st.st_mode)) {
+		char buf[CDOGS_PATH_MAX];
+		sprintf(buf, "%s/campaign.json", path);
+		if (stat(buf, &st) != 0) {
+			return false;
+		}
+	}
+	*mtime = (int64_t) st.st_mtime;
+	*size = (int64_t) st.st_size;
+	return true;
+}
+static int ScanWorker(void *data) {
+	CampaignScanner *s = static_cast<CampaignScanner*>(data);
+	for (;;) {
+		const int i = SDL_AtomicAdd(&s->next, 1);
+		if (i >= (int) s->jobs.size) {
+			break;
+		}
+		const CampaignScanJob *job = static_cast<const CampaignScanJob*>(
+				CArrayGet(&s->jobs, i));
+		char *title = NULL;
+		int numMissions = 0;
+		if (MapNewScan(job->path, &title, &numMissions) == 0) {
+			if (title == NULL) {
+				CSTRDUP(title, "");
+			}
+			job->entry->Title = title;
+			job->entry->NumMissions = numMissions;
+		} else {
+			CFREE(title);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "c_array.h"
+#include "c_hashmap/hashmap.h"
+#include "game_mode.h"
+
+// Persistent index of scanned campaign files, so that listing campaigns
+// at start-up only has to parse the ones that are new or have changed.
+// Entries are keyed by path and are stale if the file's mtime or size
+// differ from when it was scanned.
+#define CAMPAIGN_INDEX_FILE "campaigns.json"
+#define CAMPAIGN_INDEX_VERSION 1
+#define CAMPAIGN_SCAN_MAX_THREADS 8
+
+typedef struct {
+	int64_t Mtime;
+	int64_t Size;
+	GameMode Mode;
+	// NULL if the file is not a loadable campaign
+	char *Title;
+	int NumMissions;
+	bool isSeen;
+} CampaignIndexEntry;
+typedef struct {
+	map_t entries;	// of CampaignIndexEntry
+	bool isDirty;
+} CampaignIndex;
+
+typedef struct {
+	const char *Path;
+	GameMode Mode;
+	// Set by CampaignIndexScan; NULL if the file cannot be read
+	const CampaignIndexEntry *Result;
+} CampaignIndexQuery;
+
+void CampaignIndexLoad(CampaignIndex *ci);
+// Save if changed, dropping entries for files that weren't queried
+void CampaignIndexTerminate(CampaignIndex *ci);
+// Fill in the result of each query, rescanning stale ones in parallel
+void CampaignIndexScan(CampaignIndex *ci, CArray *queries);
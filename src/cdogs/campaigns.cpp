@@ -32,6 +32,7 @@
 
 #include <tinydir/tinydir.h>
 
+#include <cdogs/campaign_index.h>
 #include <cdogs/files.h>
 #include <cdogs/log.h>
 #include <cdogs/map_new.h>
@@ -84,10 +85,16 @@ static void CampaignListInit(campaign_list_t *list);
 static void CampaignListTerminate(campaign_list_t *list);
 static void LoadCampaignsFromFolder(campaign_list_t *list, const char *name,
 		const char *path, const GameMode mode);
+static void AddCampaignQueries(CArray *queries, const campaign_list_t *list);
+static void ResolveCampaignEntries(campaign_list_t *list,
+		const CArray *queries, int *index);
 static void LoadQuickPlayEntry(CampaignEntry *entry);
 
 void LoadAllCampaigns(custom_campaigns_t *campaigns) {
 	char buf[CDOGS_PATH_MAX];
+	CampaignIndex ci;
+	CArray queries;
+	int queryIndex = 0;
 
 	CampaignListInit(&campaigns->campaignList);
 	CampaignListInit(&campaigns->dogfightList);
@@ -102,6 +109,17 @@ void LoadAllCampaigns(custom_campaigns_t *campaigns) {
 	LoadCampaignsFromFolder(&campaigns->dogfightList, "", buf,
 			GAME_MODE_DOGFIGHT);
 
+	// Only campaigns that are new or changed since last time are scanned
+	CampaignIndexLoad(&ci);
+	CArrayInit(&queries, sizeof(CampaignIndexQuery));
+	AddCampaignQueries(&queries, &campaigns->campaignList);
+	AddCampaignQueries(&queries, &campaigns->dogfightList);
+	CampaignIndexScan(&ci, &queries);
+	ResolveCampaignEntries(&campaigns->campaignList, &queries, &queryIndex);
+	ResolveCampaignEntries(&campaigns->dogfightList, &queries, &queryIndex);
+	CArrayTerminate(&queries);
+	CampaignIndexTerminate(&ci);
+
 	LOG(LM_MAIN, LL_INFO, "Load quick play...");
 	LoadQuickPlayEntry(&campaigns->quickPlayEntry);
 }
@@ -169,15 +187,54 @@ static void LoadCampaignsFromFolder(campaign_list_t *list, const char *name,
 			LoadCampaignsFromFolder(&subFolder, file.name, file.path, mode);
 			CArrayPushBack(&list->subFolders, &subFolder);
 		} else if ((file.is_reg || isArchive) && file.name[0] != '~') {
+			// Placeholder with the full path; scanned and filled in by
+			// ResolveCampaignEntries
 			CampaignEntry entry;
-			if (CampaignEntryTryLoad(&entry, file.path, mode)) {
-				CArrayPushBack(&list->list, &entry);
-			}
+			memset(&entry, 0, sizeof entry);
+			CSTRDUP(entry.Path, file.path);
+			entry.Mode = mode;
+			CArrayPushBack(&list->list, &entry);
 		}
 	}
 
 	tinydir_close(&dir);
 }
+static void AddCampaignQueries(CArray *queries, const campaign_list_t *list) {
+	CA_FOREACH(const campaign_list_t, sublist, list->subFolders)
+		AddCampaignQueries(queries, sublist);
+	CA_FOREACH_END()
+	CA_FOREACH(const CampaignEntry, e, list->list)
+		CampaignIndexQuery q;
+		memset(&q, 0, sizeof q);
+		q.Path = e->Path;
+		q.Mode = e->Mode;
+		CArrayPushBack(queries, &q);
+	CA_FOREACH_END()
+}
+// Replace the placeholder entries with scanned ones, in the same order as
+// AddCampaignQueries, dropping files that aren't campaigns
+static void ResolveCampaignEntries(campaign_list_t *list,
+		const CArray *queries, int *index) {
+	CA_FOREACH(campaign_list_t, sublist, list->subFolders)
+		ResolveCampaignEntries(sublist, queries, index);
+	CA_FOREACH_END()
+	CArray entries;
+	CArrayInit(&entries, sizeof(CampaignEntry));
+	CA_FOREACH(CampaignEntry, e, list->list)
+		const CampaignIndexQuery *q = static_cast<const CampaignIndexQuery*>(
+				CArrayGet(queries, *index));
+		(*index)++;
+		if (q->Result != NULL && q->Result->Title != NULL) {
+			CampaignEntry entry;
+			CampaignEntryInitScanned(&entry, e->Path, e->Mode,
+					q->Result->Title, q->Result->NumMissions);
+			CArrayPushBack(&entries, &entry);
+		}
+		CampaignEntryTerminate(e);
+	CA_FOREACH_END()
+	CArrayTerminate(&list->list);
+	list->list = entries;
+}
 
 Mission* CampaignGetCurrentMission(CampaignOptions *campaign) {
 	if (campaign->MissionIndex >= (int) campaign->Setting.Missions.size) {
@@ -187,9 +244,11 @@ Mission* CampaignGetCurrentMission(CampaignOptions *campaign) {
 			campaign->MissionIndex));
 }
 
+int CampaignGetMissionSeed(const int missionIndex) {
+	return 10 * missionIndex + ConfigGetInt(&gConfig, "Game.RandomSeed");
+}
 void CampaignSeedRandom(const CampaignOptions *campaign) {
-	const int seed = 10 * campaign->MissionIndex
-			+ ConfigGetInt(&gConfig, "Game.RandomSeed");
+	const int seed = CampaignGetMissionSeed(campaign->MissionIndex);
 	LOG(LM_MAIN, LL_INFO, "Seeding with %d", seed);
 	srand((unsigned int) seed);
 }
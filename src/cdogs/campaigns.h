@@ -77,6 +77,8 @@ void LoadAllCampaigns(custom_campaigns_t *campaigns);
 void UnloadAllCampaigns(custom_campaigns_t *campaigns);
 
 Mission* CampaignGetCurrentMission(CampaignOptions *campaign);
+// Seed used to generate a mission, so that it is the same for every player
+int CampaignGetMissionSeed(const int missionIndex);
 void CampaignSeedRandom(const CampaignOptions *campaign);
 
 void CampaignAndMissionSetup(CampaignOptions *campaign,
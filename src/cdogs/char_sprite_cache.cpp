@@ -0,0 +1,237 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "char_sprite_cache.h"
+
+#include <string.h>
+
+#include "atlas.h"
+#include "draw/sprite_batch.h"
+#include "log.h"
+#include "texture.h"
+
+void CharSpriteCacheInit(CharSpriteCache *c) {
+	memset(c, 0, sizeof *c);
+}
+
+static void EntryDestroy(CharSpriteEntry *e, const bool destroyTex) {
+	if (destroyTex && e->Tex != NULL) {
+		// The batch may still be about to draw from this texture
+		SpriteBatchFlush(&gSpriteBatch);
+		SDL_DestroyTexture(e->Tex);
+	}
+	NamedSpritesFree(&e->Sprites);
+	CFREE(e);
+}
+static void ClearEntries(CharSpriteCache *c, const bool destroyTex) {
+	for (int i = 0; i < CHAR_SPRITE_CACHE_BUCKETS; i++) {
+		CharSpriteEntry *e = c->Buckets[i];
+		while (e != NULL) {
+			CharSpriteEntry *next = e->Next;
+			EntryDestroy(e, destroyTex);
+			e = next;
+		}
+		c->Buckets[i] = NULL;
+	}
+	c->Count = 0;
+	c->Bytes = 0;
+}
+void CharSpriteCacheClear(CharSpriteCache *c) {
+	ClearEntries(c, true);
+}
+void CharSpriteCacheReset(CharSpriteCache *c) {
+	ClearEntries(c, false);
+}
+
+static uint32_t HashMix(uint32_t h, uint32_t v) {
+	v *= 0xcc9e2d51u;
+	v = (v << 15) | (v >> 17);
+	h ^= v * 0x1b873593u;
+	h = (h << 13) | (h >> 19);
+	return h * 5 + 0xe6546b64u;
+}
+static uint32_t ColorToUint(const color_t c) {
+	return ((uint32_t) c.r << 24) | ((uint32_t) c.g << 16)
+			| ((uint32_t) c.b << 8) | c.a;
+}
+static uint32_t KeyHash(const CharSpriteKey *k) {
+	const uint64_t base = (uint64_t) (uintptr_t) k->Base;
+	uint32_t h = HashMix(0, (uint32_t) base);
+	h = HashMix(h, (uint32_t) (base >> 32));
+	h = HashMix(h, ColorToUint(k->Colors.Skin));
+	h = HashMix(h, ColorToUint(k->Colors.Arms));
+	h = HashMix(h, ColorToUint(k->Colors.Body));
+	h = HashMix(h, ColorToUint(k->Colors.Legs));
+	h = HashMix(h, ColorToUint(k->Colors.Hair));
+	// Final avalanche so that the low bits select buckets evenly
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+static bool KeyEqual(const CharSpriteKey *a, const CharSpriteKey *b) {
+	return a->Base == b->Base
+			&& memcmp(&a->Colors, &b->Colors, sizeof a->Colors) == 0;
+}
+
+static CharSpriteEntry *EntryNew(const CharSpriteKey *key,
+		const uint32_t hash);
+const NamedSprites *CharSpriteCacheGet(CharSpriteCache *c,
+		const NamedSprites *base, const CharColors *colors) {
+	CharSpriteKey key;
+	key.Base = base;
+	key.Colors = *colors;
+	const uint32_t hash = KeyHash(&key);
+	CharSpriteEntry **bucket = &c->Buckets[hash % CHAR_SPRITE_CACHE_BUCKETS];
+	for (CharSpriteEntry *e = *bucket; e != NULL; e = e->Next) {
+		if (e->Hash == hash && KeyEqual(&e->Key, &key)) {
+			e->LastUsed = c->counter++;
+			e->Frame = c->frame;
+			return &e->Sprites;
+		}
+	}
+
+	CharSpriteEntry *e = EntryNew(&key, hash);
+	e->LastUsed = c->counter++;
+	e->Frame = c->frame;
+	e->Next = *bucket;
+	*bucket = e;
+	c->Count++;
+	c->Bytes += e->Bytes;
+	// Don't evict here; sprites returned earlier this frame may still be
+	// about to be drawn
+	return &e->Sprites;
+}
+
+static void PackSheet(CharSpriteEntry *e);
+static CharSpriteEntry *EntryNew(const CharSpriteKey *key,
+		const uint32_t hash) {
+	CharSpriteEntry *e;
+	CCALLOC(e, sizeof *e);
+	e->Key = *key;
+	e->Hash = hash;
+	NamedSpritesInit(&e->Sprites, key->Base->name);
+	CA_FOREACH(const Pic, op, key->Base->pics)
+	Pic p = PicCopy(op);
+	p.Tex = NULL;
+	for (int i = 0; i < p.size.x * p.size.y; i++) {
+		if (op->Data[i] == 0) {
+			continue;
+		}
+		const color_t c = PIXEL2COLOR(op->Data[i]);
+		p.Data[i] = COLOR2PIXEL(
+				ColorMult(c, CharColorsGetChannelMask(&key->Colors, c.a)));
+	}
+	CArrayPushBack(&e->Sprites.pics, &p);
+	CA_FOREACH_END()
+	PackSheet(e);
+	return e;
+}
+// Lay out the pics in rows on one texture, so that they can be batched
+// together and evicted as one
+static void PackSheet(CharSpriteEntry *e) {
+	struct vec2i size = svec2i_zero();
+	struct vec2i pos = svec2i_zero();
+	int rowHeight = 0;
+	CA_FOREACH(Pic, p, e->Sprites.pics)
+	if (pos.x > 0 && pos.x + p->size.x > CHAR_SPRITE_SHEET_WIDTH) {
+		pos = svec2i(0, pos.y + rowHeight + ATLAS_PADDING);
+		rowHeight = 0;
+	}
+	p->TexPos = pos;
+	pos.x += p->size.x + ATLAS_PADDING;
+	rowHeight = MAX(rowHeight, p->size.y);
+	size = svec2i(MAX(size.x, pos.x), pos.y + rowHeight);
+	CA_FOREACH_END()
+	if (svec2i_is_zero(size)) {
+		return;
+	}
+
+	Uint32 *pixels;
+	CCALLOC(pixels, size.x * size.y * sizeof *pixels);
+	CA_FOREACH(const Pic, p, e->Sprites.pics)
+	for (int y = 0; y < p->size.y; y++) {
+		memcpy(pixels + p->TexPos.x + (p->TexPos.y + y) * size.x,
+				p->Data + y * p->size.x, p->size.x * sizeof *pixels);
+	}
+	CA_FOREACH_END()
+	e->Tex = TextureCreate(gGraphicsDevice.gameWindow.renderer,
+			SDL_TEXTUREACCESS_STATIC, size, SDL_BLENDMODE_BLEND, 255);
+	if (e->Tex != NULL && SDL_UpdateTexture(e->Tex, NULL, pixels,
+			size.x * sizeof *pixels) != 0) {
+		LOG(LM_GFX, LL_ERROR, "cannot update texture: %s", SDL_GetError());
+	}
+	CFREE(pixels);
+	e->Bytes = size.x * size.y * (int) sizeof *pixels;
+	CA_FOREACH(Pic, p, e->Sprites.pics)
+	p->Tex = e->Tex;
+	// Pics share the sheet texture, which is freed with the entry
+	p->InAtlas = e->Tex != NULL;
+	if (e->Tex == NULL) {
+		p->TexPos = svec2i_zero();
+	}
+	CA_FOREACH_END()
+}
+
+static bool EvictOldest(CharSpriteCache *c);
+void CharSpriteCacheEndFrame(CharSpriteCache *c) {
+	// If this frame alone used more than the limit, go over it rather than
+	// recolour the same sheets every frame
+	while (c->Bytes > CHAR_SPRITE_CACHE_MAX_BYTES) {
+		if (!EvictOldest(c)) {
+			break;
+		}
+	}
+	c->frame++;
+}
+// Evict the least recently used entry not used this frame; returns false
+// if there is none
+static bool EvictOldest(CharSpriteCache *c) {
+	CharSpriteEntry **oldest = NULL;
+	for (int i = 0; i < CHAR_SPRITE_CACHE_BUCKETS; i++) {
+		for (CharSpriteEntry **e = &c->Buckets[i]; *e != NULL;
+				e = &(*e)->Next) {
+			if ((*e)->Frame != c->frame
+					&& (oldest == NULL || (*e)->LastUsed < (*oldest)->LastUsed)) {
+				oldest = e;
+			}
+		}
+	}
+	if (oldest == NULL) {
+		return false;
+	}
+	CharSpriteEntry *e = *oldest;
+	*oldest = e->Next;
+	c->Count--;
+	c->Bytes -= e->Bytes;
+	LOG(LM_GFX, LL_DEBUG, "evicting char sprites %s", e->Sprites.name);
+	EntryDestroy(e, true);
+	return true;
+}
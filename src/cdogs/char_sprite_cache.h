@@ -0,0 +1,87 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <SDL2/SDL_render.h>
+
+#include "blit.h"
+#include "cpic.h"
+
+#define CHAR_SPRITE_CACHE_BUCKETS 256
+// Upper bound on texture memory used by recoloured sprites; at the end of
+// each frame the least recently used are evicted to stay under it, except
+// those used in that frame
+#define CHAR_SPRITE_CACHE_MAX_BYTES (16 * 1024 * 1024)
+// Recoloured sprites are packed into one texture per sheet, in rows up to
+// this wide
+#define CHAR_SPRITE_SHEET_WIDTH 512
+
+typedef struct {
+	const NamedSprites *Base;
+	CharColors Colors;
+} CharSpriteKey;
+
+typedef struct CharSpriteEntry {
+	CharSpriteKey Key;
+	uint32_t Hash;
+	NamedSprites Sprites;
+	SDL_Texture *Tex;
+	int Bytes;
+	uint64_t LastUsed;
+	uint64_t Frame;	// last frame the entry was used in
+	struct CharSpriteEntry *Next;
+} CharSpriteEntry;
+
+// Character sprite sheets recoloured for particular character colours,
+// looked up by base sheet and colours without building names.
+typedef struct {
+	CharSpriteEntry *Buckets[CHAR_SPRITE_CACHE_BUCKETS];
+	int Count;
+	int Bytes;
+	uint64_t counter;
+	uint64_t frame;
+} CharSpriteCache;
+
+void CharSpriteCacheInit(CharSpriteCache *c);
+// Destroy all entries; base sheets may be freed after this
+void CharSpriteCacheClear(CharSpriteCache *c);
+// Forget all textures without destroying them, for when the renderer that
+// owned them has already been destroyed
+void CharSpriteCacheReset(CharSpriteCache *c);
+
+// Get base recoloured with colors, generating it if needed. The sprites
+// stay valid until the end of the frame.
+const NamedSprites *CharSpriteCacheGet(CharSpriteCache *c,
+		const NamedSprites *base, const CharColors *colors);
+// Evict entries not used this frame until under the size limit; call once
+// everything has been drawn
+void CharSpriteCacheEndFrame(CharSpriteCache *c);
@@ -28,6 +28,7 @@
  */
 #include "character_class.h"
 
+#include "asset_pack.h"
 #include "json_utils.h"
 #include "log.h"
 
@@ -376,26 +377,12 @@ void CharacterClassesInitialize(CharacterClasses *c, const char *filename) {
 	CArrayInit(&c->Classes, sizeof(CharacterClass));
 	CArrayInit(&c->CustomClasses, sizeof(CharacterClass));
 
-	char buf[CDOGS_PATH_MAX];
-	GetDataFilePath(buf, filename);
-	FILE *f = fopen(buf, "r");
-	json_t *root = NULL;
-	// TODO this goto should go
-	enum json_error e;
-	if (f == NULL) {
-		LOG(LM_MAIN, LL_ERROR, "cannot load characters file %s", buf);
-		goto bail;
-	}
-	e = json_stream_parse(f, &root);
-	if (e != JSON_OK) {
-		LOG(LM_MAIN, LL_ERROR, "error parsing characters file %s", buf);
-		goto bail;
+	json_t *root = AssetPackReadJSON(&gAssetPack, filename);
+	if (root == NULL) {
+		LOG(LM_MAIN, LL_ERROR, "cannot load characters file %s", filename);
+		return;
 	}
 	CharacterClassesLoadJSON(&c->Classes, root);
-
-	bail: if (f != NULL) {
-		fclose(f);
-	}
 	json_free_value(&root);
 }
 static void LoadCharacterClass(CharacterClass *c, json_t *node);
@@ -282,7 +282,7 @@ static bool CheckOverlaps(const Thing *item, const struct vec2 pos,
 	struct vec2 colA, colB, normal;
 	// Check item collisions
 	if (func != NULL) {
-		const CArray *tileThings = &MapGetTile(&gMap, tilePos)->things;
+		const CArray *tileThings = TileGetThings(MapGetTile(&gMap, tilePos));
 		CA_FOREACH(const ThingId, tid, *tileThings)
 			Thing *ti = ThingIdGetThing(tid);
 			if (!CheckParams(params, item, ti)) {
@@ -641,6 +641,8 @@ Config ConfigDefault(void) {
 					GoreAmountStr));
 	ConfigGroupAdd(&gfx, ConfigNewBool("Brass", true));
 	ConfigGroupAdd(&gfx, ConfigNewBool("SecondWindow", false));
+	ConfigGroupAdd(&gfx, ConfigNewBool("SpriteBatching", true));
+	ConfigGroupAdd(&gfx, ConfigNewBool("SmoothFog", false));
 	ConfigGroupAdd(&root, gfx);
 
 	Config input = ConfigNewGroup("Input");
@@ -693,6 +695,8 @@ Config ConfigDefault(void) {
 
 	Config itf = ConfigNewGroup("Interface");
 	ConfigGroupAdd(&itf, ConfigNewBool("ShowFPS", false));
+	ConfigGroupAdd(&itf, ConfigNewBool("ShowNetStats", false));
+	ConfigGroupAdd(&itf, ConfigNewBool("ShowProfiler", false));
 	ConfigGroupAdd(&itf, ConfigNewBool("ShowTime", false));
 	ConfigGroupAdd(&itf, ConfigNewBool("ShowHUDMap", true));
 	ConfigGroupAdd(&itf,
@@ -755,6 +759,12 @@ Config ConfigDefault(void) {
 					StrQuickPlayQuantity, QuickPlayQuantityStr));
 	ConfigGroupAdd(&root, qp);
 
+	Config editor = ConfigNewGroup("Editor");
+	// Save static maps in the compact grid format, which older versions
+	// can't load
+	ConfigGroupAdd(&editor, ConfigNewBool("CompactMaps", false));
+	ConfigGroupAdd(&root, editor);
+
 	ConfigGroupAdd(&root, ConfigNewBool("StartServer", false));
 
 	return root;
@@ -140,8 +140,8 @@ void MapAddDoorGroup(MapBuilder *mb, const struct vec2i v, const int keyFlags) {
 				type);
 		const struct vec2i vI = svec2i_add(v, svec2i_scale(dv, (float) i));
 		Tile *tile = MapGetTile(mb->Map, vI);
-		tile->ClassAlt = doorClass;
-		tile->Class = doorClassOpen;
+		TileSetClassAlt(tile, doorClass);
+		TileSetClass(tile, doorClassOpen);
 		if (isHorizontal) {
 			const struct vec2i vB = svec2i_add(vI, dAside);
 			Tile *tileB = MapGetTile(mb->Map, vB);
@@ -153,9 +153,9 @@ void MapAddDoorGroup(MapBuilder *mb, const struct vec2i v, const int keyFlags) {
 			CASSERT(TileCanWalk(tileB),
 					"map gen error: entrance should be clear");
 			// Change the tile below to shadow, cast by this door
-			tileB->Class = TileClassesGetMaskedTile(tileB->Class,
-					tileB->Class->Style, "shadow", tileB->Class->Mask,
-					tileB->Class->MaskAlt);
+			const TileClass *tcB = TileGetClass(tileB);
+			TileSetClass(tileB, TileClassesGetMaskedTile(tcB, tcB->Style,
+					"shadow", tcB->Mask, tcB->MaskAlt));
 		}
 	}
 
@@ -236,17 +236,15 @@ static TWatch* CreateCloseDoorWatch(MapBuilder *mb, const struct vec2i v,
 	for (int i = 0; i < doorGroupCount; i++) {
 		const struct vec2i vI = svec2i_add(v, svec2i_scale(dv, (float) i));
 
-		a = WatchAddAction(w);
-		a->Type = ACTION_EVENT;
-		a->a.Event = GameEventNew(GAME_EVENT_TILE_SET);
-		a->a.Event.u.TileSet.Pos = Vec2i2Net(vI);
+		GameEvent e = GameEventNew(GAME_EVENT_TILE_SET);
+		e.u.TileSet.Pos = Vec2i2Net(vI);
 		const DoorType type = GetDoorType(isHorizontal, i, doorGroupCount);
-		DoorGetClassName(a->a.Event.u.TileSet.ClassName, door->Style, "open",
-				type);
+		DoorGetClassName(e.u.TileSet.ClassName, door->Style, "open", type);
 
 		char doorClassName[CDOGS_FILENAME_MAX];
 		DoorGetClassName(doorClassName, door->Style, doorKey, type);
-		strcpy(a->a.Event.u.TileSet.ClassAltName, doorClassName);
+		strcpy(e.u.TileSet.ClassAltName, doorClassName);
+		ActionSetEvent(WatchAddAction(w), &e);
 	}
 
 	// Add shadows below doors
@@ -254,20 +252,18 @@ static TWatch* CreateCloseDoorWatch(MapBuilder *mb, const struct vec2i v,
 		for (int i = 0; i < doorGroupCount; i++) {
 			const struct vec2i vI = svec2i_add(v, svec2i_scale(dv, (float) i));
 
-			a = WatchAddAction(w);
-			a->Type = ACTION_EVENT;
-			a->a.Event = GameEventNew(GAME_EVENT_TILE_SET);
+			GameEvent e = GameEventNew(GAME_EVENT_TILE_SET);
 			const struct vec2i vI2 = svec2i(vI.x + dAside.x, vI.y + dAside.y);
-			a->a.Event.u.TileSet.Pos = Vec2i2Net(vI2);
+			e.u.TileSet.Pos = Vec2i2Net(vI2);
 			const TileClass *t = MapBuilderGetTile(mb, vI2);
-			TileClassGetName(a->a.Event.u.TileSet.ClassName, t, t->Style,
-					"shadow", t->Mask, t->MaskAlt);
+			TileClassGetName(e.u.TileSet.ClassName, t, t->Style, "shadow",
+					t->Mask, t->MaskAlt);
+			ActionSetEvent(WatchAddAction(w), &e);
 		}
 	}
 
 	return w;
 }
-static void TileAddTrigger(Tile *t, Trigger *tr);
 static Trigger* CreateOpenDoorTrigger(MapBuilder *mb, const struct vec2i v,
 		const bool isHorizontal, const int doorGroupCount, const int keyFlags) {
 	// All tiles on either side of the door group use the same trigger
@@ -286,18 +282,16 @@ static Trigger* CreateOpenDoorTrigger(MapBuilder *mb, const struct vec2i v,
 	const TileClass *door = MapBuilderGetTile(mb, v);
 	for (int i = 0; i < doorGroupCount; i++) {
 		const struct vec2i vI = svec2i_add(v, svec2i_scale(dv, (float) i));
-		a = TriggerAddAction(t);
-		a->Type = ACTION_EVENT;
-		a->a.Event = GameEventNew(GAME_EVENT_TILE_SET);
-		a->a.Event.u.TileSet.Pos = Vec2i2Net(vI);
+		GameEvent e = GameEventNew(GAME_EVENT_TILE_SET);
+		e.u.TileSet.Pos = Vec2i2Net(vI);
 		const DoorType type = GetDoorType(isHorizontal, i, doorGroupCount);
-		DoorGetClassName(a->a.Event.u.TileSet.ClassName, door->Style, "open",
-				type);
+		DoorGetClassName(e.u.TileSet.ClassName, door->Style, "open", type);
 		if (type == DOORTYPE_TOP || type == DOORTYPE_V) {
 			// special door cavity picture
-			DoorGetClassName(a->a.Event.u.TileSet.ClassAltName, door->Style,
-					"wall", type);
+			DoorGetClassName(e.u.TileSet.ClassAltName, door->Style, "wall",
+					type);
 		}
+		ActionSetEvent(TriggerAddAction(t), &e);
 	}
 
 	// Change tiles below the doors
@@ -305,14 +299,13 @@ static Trigger* CreateOpenDoorTrigger(MapBuilder *mb, const struct vec2i v,
 		for (int i = 0; i < doorGroupCount; i++) {
 			const struct vec2i vI = svec2i_add(v, svec2i_scale(dv, (float) i));
 			const struct vec2i vIAside = svec2i_add(vI, dAside);
-			a = TriggerAddAction(t);
 			// Remove shadows below doors
-			a->Type = ACTION_EVENT;
-			a->a.Event = GameEventNew(GAME_EVENT_TILE_SET);
+			GameEvent e = GameEventNew(GAME_EVENT_TILE_SET);
 			const TileClass *tc = MapBuilderGetTile(mb, vIAside);
-			a->a.Event.u.TileSet.Pos = Vec2i2Net(vIAside);
-			TileClassGetName(a->a.Event.u.TileSet.ClassName, tc, tc->Style,
-					"normal", tc->Mask, tc->MaskAlt);
+			e.u.TileSet.Pos = Vec2i2Net(vIAside);
+			TileClassGetName(e.u.TileSet.ClassName, tc, tc->Style, "normal",
+					tc->Mask, tc->MaskAlt);
+			ActionSetEvent(TriggerAddAction(t), &e);
 		}
 	}
 
@@ -334,9 +327,6 @@ static Trigger* CreateOpenDoorTrigger(MapBuilder *mb, const struct vec2i v,
 
 	return t;
 }
-static void TileAddTrigger(Tile *t, Trigger *tr) {
-	CArrayPushBack(&t->triggers, &tr);
-}
 
 // Get the tile class of a door; if it doesn't exist create it
 // style: office/dungeon/blast/alien, or custom
@@ -30,9 +30,9 @@
 #include <tinydir/tinydir.h>
 
 #include "c_array.h"
+#include "json_utils.h"
 #include "log.h"
 #include "sys_config.h"
-#include "yajl_utils.h"
 
 #define VERSION 2
 
@@ -91,21 +91,21 @@ void CharSpriteClassesLoadDir(map_t classes, const char *path) {
 
 	bail: tinydir_close(&dir);
 }
-static map_t LoadFrameOffsets(yajl_val node, const char *path);
-static void LoadDirOffsets(struct vec2 *offsets, yajl_val node,
+static map_t LoadFrameOffsets(json_t *node, const char *path);
+static void LoadDirOffsets(struct vec2 *offsets, json_t *node,
 		const char *path);
 static CharSprites* CharSpritesLoadJSON(const char *name, const char *path) {
 	CharSprites *c = NULL;
 	// Try to find a data.json in this dir
 	tinydir_file dataFile;
-	yajl_val node = NULL; // TODO because of goto statment removed const
+	json_t *node = NULL; // TODO because of goto statment removed const
 	char buf[CDOGS_PATH_MAX];
 	sprintf(buf, "%s/data.json", path);
-	yajl_array order;
+	const json_t *order;
 	if (tinydir_file_open(&dataFile, buf) != 0) {
 		goto bail;
 	}
-	node = YAJLReadFile(buf);
+	node = JSONReadFile(buf);
 	if (node == NULL) {
 		LOG(LM_MAIN, LL_ERROR, "Error parsing char sprite JSON '%s'", buf);
 		goto bail;
@@ -121,13 +121,14 @@ static CharSprites* CharSpritesLoadJSON(const char *name, const char *path) {
 	}
 	strcpy(c->Name, name);
 //	CSTRDUP(c->Name, name);
-	order = YAJL_GET_ARRAY(YAJLFindNode(node, "Order"));
+	order = JSONFindNode(node, "Order")->child;
 	for (direction_e d = DIRECTION_UP; d < DIRECTION_COUNT; ++d) {
-		const yajl_array orderDir = YAJL_GET_ARRAY(order->values[d]);
+		const json_t *orderDir = order->child;
 		for (BodyPart bp = BODY_PART_HEAD; bp < BODY_PART_COUNT; ++bp) {
-			c->Order[d][bp] = StrBodyPart(
-					YAJL_GET_STRING(orderDir->values[bp]));
+			c->Order[d][bp] = StrBodyPart(orderDir->text);
+			orderDir = orderDir->next;
 		}
+		order = order->next;
 	}
 	c->Offsets.Frame[BODY_PART_HEAD] = LoadFrameOffsets(node,
 			"Offsets/Frame/Head");
@@ -145,14 +146,14 @@ static CharSprites* CharSpritesLoadJSON(const char *name, const char *path) {
 	LoadDirOffsets(c->Offsets.Dir[BODY_PART_LEGS], node, "Offsets/Dir/Legs");
 	LoadDirOffsets(c->Offsets.Dir[BODY_PART_GUN], node, "Offsets/Dir/Gun");
 
-	bail: yajl_tree_free(node);
+	bail: json_free_value(&node);
 	return c;
 }
-static map_t LoadFrameOffsets(yajl_val node, const char *path) {
+static map_t LoadFrameOffsets(json_t *node, const char *path) {
 	map_t offsets = hashmap_new();
-	const yajl_object obj = YAJL_GET_OBJECT(YAJLFindNode(node, path));
-	for (int i = 0; i < (int) obj->len; i++) {
-		const char *key = obj->keys[i];
+	const json_t *obj = JSONFindNode(node, path);
+	for (const json_t *label = obj->child; label; label = label->next) {
+		const char *key = label->text;
 		CArray *offsetVals;
 		offsetVals = static_cast<CArray*>(malloc(sizeof *offsetVals));
 		if (offsetVals == NULL && sizeof *offsetVals > 0) {
@@ -160,9 +161,9 @@ static map_t LoadFrameOffsets(yajl_val node, const char *path) {
 		}
 //		CMALLOC(offsetVals, sizeof *offsetVals);
 		CArrayInit(offsetVals, sizeof(struct vec2i));
-		const yajl_array offsetsArray = YAJL_GET_ARRAY(obj->values[i]);
-		for (int j = 0; j < (int) offsetsArray->len; j++) {
-			const struct vec2i offset = YAJL_GET_VEC2I(offsetsArray->values[j]);
+		for (const json_t *offsetNode = label->child->child; offsetNode;
+				offsetNode = offsetNode->next) {
+			const struct vec2i offset = JSONGetVec2i(offsetNode);
 			CArrayPushBack(offsetVals, &offset);
 		}
 		const int error = hashmap_put(offsets, key, offsetVals);
@@ -174,15 +175,16 @@ static map_t LoadFrameOffsets(yajl_val node, const char *path) {
 	}
 	return offsets;
 }
-static void LoadDirOffsets(struct vec2 *offsets, yajl_val node,
+static void LoadDirOffsets(struct vec2 *offsets, json_t *node,
 		const char *path) {
-	const yajl_array offsetsArray = YAJL_GET_ARRAY(YAJLFindNode(node, path));
-	if (offsetsArray == NULL) {
+	const json_t *offsetsArray = JSONFindNode(node, path);
+	if (offsetsArray == NULL || offsetsArray->type != JSON_ARRAY) {
 		return;
 	}
+	const json_t *offsetNode = offsetsArray->child;
 	for (direction_e d = DIRECTION_UP; d < DIRECTION_COUNT; ++d) {
-		offsets[d] = svec2_assign_vec2i(
-				YAJL_GET_VEC2I(offsetsArray->values[d]));
+		offsets[d] = svec2_assign_vec2i(JSONGetVec2i(offsetNode));
+		offsetNode = offsetNode->next;
 	}
 }
 
@@ -58,6 +58,8 @@
 #include "draw/draw.h"
 #include "draw/draw_actor.h"
 #include "draw/drawtools.h"
+#include "draw/fog_mask.h"
+#include "draw/tile_cache.h"
 #include "font.h"
 #include "game_events.h"
 #include "net_util.h"
@@ -65,6 +67,7 @@
 #include "pic_manager.h"
 #include "pickup.h"
 #include "pics.h"
+#include "profiler.h"
 #include "texture.h"
 
 //#define DEBUG_DRAW_HITBOXES
@@ -76,17 +79,25 @@
 typedef enum {
 	TILE_LOS_NORMAL, TILE_LOS_FOG, TILE_LOS_NONE
 } TileLOS;
-static TileLOS GetTileLOS(const Tile *tile, const bool useFog) {
+// How LOS is applied: by drawing the fog mask over the floor, or by tinting
+// each tile; walls, things and chatter always use the latter, see fog_mask.h
+typedef enum {
+	LOS_TINT_MASK, LOS_TINT_FOG, LOS_TINT_BLACK
+} LOSTint;
+static TileLOS GetTileLOS(const Tile *tile, const LOSTint tint) {
+	if (tint == LOS_TINT_MASK) {
+		return TILE_LOS_NORMAL;
+	}
 	if (!tile->isVisited) {
 		return TILE_LOS_NONE;
 	}
 	if (tile->outOfSight) {
-		return useFog ? TILE_LOS_FOG : TILE_LOS_NONE;
+		return tint == LOS_TINT_FOG ? TILE_LOS_FOG : TILE_LOS_NONE;
 	}
 	return TILE_LOS_NORMAL;
 }
-static color_t GetLOSMask(const Tile *tile, const bool useFog) {
-	switch (GetTileLOS(tile, useFog)) {
+static color_t GetLOSMask(const Tile *tile, const LOSTint tint) {
+	switch (GetTileLOS(tile, tint)) {
 	case TILE_LOS_NORMAL:
 		return colorWhite;
 	case TILE_LOS_FOG:
@@ -98,8 +109,8 @@ static color_t GetLOSMask(const Tile *tile, const bool useFog) {
 	}
 }
 static void DrawLOSPic(const Tile *tile, const Pic *pic, const struct vec2i pos,
-		const bool useFog) {
-	const color_t mask = GetLOSMask(tile, useFog);
+		const LOSTint tint) {
+	const color_t mask = GetLOSMask(tile, tint);
 	if (!ColorEquals(mask, colorTransparent)) {
 		PicRender(pic, gGraphicsDevice.gameWindow.renderer, pos, mask, 0,
 				svec2_one(), SDL_FLIP_NONE, Rect2iZero());
@@ -108,242 +119,292 @@ static void DrawLOSPic(const Tile *tile, const Pic *pic, const struct vec2i pos,
 
 static void DrawThing(DrawBuffer *b, const Thing *t, const struct vec2i offset);
 
-static void DrawTiles(DrawBuffer *b, const struct vec2i offset,
-		void (*drawTileFunc)(DrawBuffer*, const struct vec2i, const Tile*,
-				const struct vec2i, const bool)) {
-	const bool useFog = ConfigGetBool(&gConfig, "Game.Fog");
-	const Tile **tile = DrawBufferGetFirstTile(b);
-	struct vec2i pos;
-	int x, y;
-	for (y = 0, pos.y = b->dy + offset.y; y < Y_TILES;
-			y++, pos.y += TILE_HEIGHT) {
-		CArrayClear(&b->displaylist);
-		for (x = 0, pos.x = b->dx + offset.x; x < b->Size.x;
-				x++, tile++, pos.x += TILE_WIDTH) {
-			if (*tile == NULL)
-				continue;
-			drawTileFunc(b, offset, *tile, pos, useFog);
-		}
-		DrawBufferSortDisplayList(b);
-		CA_FOREACH(const Thing *, tp, b->displaylist)
-			DrawThing(b, *tp, offset);
-		CA_FOREACH_END()
-		tile += X_TILES - b->Size.x;
+static void DrawFloorPic(const Tile *t, const struct vec2i pos,
+		const LOSTint tint) {
+	const Pic *pic = TileGetFloorPic(t);
+	if (pic != NULL) {
+		DrawLOSPic(t, pic, pos, tint);
 	}
 }
-
-static void DrawFloor(DrawBuffer *b, const struct vec2i offset, const Tile *t,
-		const struct vec2i pos, const bool useFog);
-static void DrawThingsBelow(DrawBuffer *b, const struct vec2i offset,
-		const Tile *t, const struct vec2i pos, const bool useFog);
-static void DrawWallsAndThings(DrawBuffer *b, const struct vec2i offset,
-		const Tile *t, const struct vec2i pos, const bool useFog);
-static void DrawThingsAbove(DrawBuffer *b, const struct vec2i offset,
-		const Tile *t, const struct vec2i pos, const bool useFog);
-static void DrawObjectiveHighlights(DrawBuffer *b, const struct vec2i offset,
-		const Tile *t, const struct vec2i pos, const bool useFog);
-static void DrawChatters(DrawBuffer *b, const struct vec2i offset,
-		const Tile *t, const struct vec2i pos, const bool useFog);
-static void DrawExtra(DrawBuffer *b, struct vec2i offset,
-		GrafxDrawExtra *extra);
-
-void DrawBufferDraw(DrawBuffer *b, struct vec2i offset, GrafxDrawExtra *extra) {
-	// First draw the floor tiles (which do not obstruct anything)
-	DrawTiles(b, offset, DrawFloor);
-	// Then draw things that are below everything like debris (wrecks)
-	DrawTiles(b, offset, DrawThingsBelow);
-	// Now draw walls and (non-wreck) things in proper order
-	DrawTiles(b, offset, DrawWallsAndThings);
-	// Draw things that are above everything
-	DrawTiles(b, offset, DrawThingsAbove);
-	if (ConfigGetBool(&gConfig, "Graphics.ShowHUD")) {
-		// Draw objective highlights, for visible and always-visible objectives
-		DrawTiles(b, offset, DrawObjectiveHighlights);
-		// Draw actor chatter
-		DrawTiles(b, offset, DrawChatters);
-	}
-	// Draw editor-only things
-	if (extra) {
-		DrawExtra(b, offset, extra);
+static void DrawWallPic(const Tile *t, const struct vec2i pos,
+		const LOSTint tint) {
+	struct vec2i drawOffset;
+	const Pic *pic = TileGetWallPic(t, &drawOffset);
+	if (pic != NULL) {
+		DrawLOSPic(t, pic, svec2i_add(pos, drawOffset), tint);
 	}
 }
 
-static void DrawFloor(DrawBuffer *b, const struct vec2i offset, const Tile *t,
-		const struct vec2i pos, const bool useFog) {
-	UNUSED(b);
-	UNUSED(offset);
-	if (t->Class != NULL && t->Class->Pic != NULL && t->Class->Pic->Data != NULL
-			&& t->Class->Type != TILE_CLASS_WALL) {
-		DrawLOSPic(t, t->Class->Pic, pos, useFog);
+// Draw a row of tiles' floor or wall layer, using cached chunks where
+// possible, in runs of tiles with the same LOS
+static void DrawTileLayerRow(const DrawBuffer *b, const Tile **tile,
+		const int y, struct vec2i pos, const TileCacheLayer layer,
+		const LOSTint tint) {
+	int x = 0;
+	while (x < b->Size.x) {
+		const struct vec2i mapPos = svec2i(x + b->xStart, y + b->yStart);
+		const TileCacheChunk *c =
+				tile[x] == NULL ?
+						NULL : TileCacheGetChunk(&gTileCache, &gMap, mapPos);
+		if (c == NULL) {
+			if (tile[x] != NULL) {
+				if (layer == TILE_CACHE_LAYER_FLOOR) {
+					DrawFloorPic(tile[x], pos, tint);
+				} else {
+					DrawWallPic(tile[x], pos, tint);
+				}
+			}
+			x++;
+			pos.x += TILE_WIDTH;
+			continue;
+		}
+		const TileLOS los = GetTileLOS(tile[x], tint);
+		const int chunkX = mapPos.x / TILE_CACHE_CHUNK_SIZE;
+		int n = 1;
+		while (x + n < b->Size.x && tile[x + n] != NULL
+				&& (mapPos.x + n) / TILE_CACHE_CHUNK_SIZE == chunkX
+				&& GetTileLOS(tile[x + n], tint) == los) {
+			n++;
+		}
+		const color_t mask = GetLOSMask(tile[x], tint);
+		if (!ColorEquals(mask, colorTransparent)) {
+			TileCacheDrawRun(c, layer, mapPos, n, pos, mask);
+		}
+		x += n;
+		pos.x += n * TILE_WIDTH;
 	}
 }
 
-static void DrawThingsBelow(DrawBuffer *b, const struct vec2i offset,
-		const Tile *t, const struct vec2i pos, const bool useFog) {
-	UNUSED(pos);
-	UNUSED(offset);
-	UNUSED(useFog);
-	if (t->outOfSight) {
-		return;
-	}
-	CA_FOREACH(ThingId, tid, t->things)
-		const Thing *ti = ThingIdGetThing(tid);
-		if (ThingDrawBelow(ti)) {
-			CArrayPushBack(&b->displaylist, &ti);
-		}CA_FOREACH_END()
+static void PushItem(DrawBuffer *b, const DrawLayer layer, const Thing *ti,
+		const Tile *t, const int row) {
+	const DrawListItem item = { ti, t, row };
+	CArrayPushBack(&b->layers[layer], &item);
 }
-
-#define WALL_OFFSET_Y (-12)
-static void DrawWallsAndThings(DrawBuffer *b, const struct vec2i offset,
-		const Tile *t, const struct vec2i pos, const bool useFog) {
-	UNUSED(offset);
-	if (t->Class->Type == TILE_CLASS_WALL) {
-		DrawLOSPic(t, t->Class->Pic, svec2i_add(pos, svec2i(0, WALL_OFFSET_Y)),
-				useFog);
-	} else if (t->Class->Type == TILE_CLASS_DOOR && t->ClassAlt
-			&& t->ClassAlt->Pic) {
-		// Drawing doors
-		// Doors may be offset; vertical doors are drawn centered
-		// horizontal doors are bottom aligned
-		struct vec2i doorPos = pos;
-		const Pic *pic = t->ClassAlt->Pic;
-		doorPos.x += (TILE_WIDTH - pic->size.x) / 2;
-		if (pic->size.y > 16) {
-			doorPos.y += TILE_HEIGHT - (pic->size.y % TILE_HEIGHT);
+// Walk the buffer's tiles once, sorting their things into the layers they
+// are drawn in
+static void GatherLayers(DrawBuffer *b, const bool showHUD) {
+	for (int i = 0; i < DRAW_LAYER_COUNT; i++) {
+		CArrayClear(&b->layers[i]);
+	}
+	const Tile **tile = DrawBufferGetFirstTile(b);
+	for (int y = 0; y < Y_TILES; y++, tile += X_TILES) {
+		for (int x = 0; x < b->Size.x; x++) {
+			const Tile *t = tile[x];
+			if (t == NULL) {
+				continue;
+			}
+			CA_FOREACH(ThingId, tid, *TileGetThings(t))
+				const Thing *ti = ThingIdGetThing(tid);
+				// Only draw things that are in LOS
+				if (!t->outOfSight) {
+					const bool below = ThingDrawBelow(ti);
+					const bool above = ThingDrawAbove(ti);
+					if (below) {
+						PushItem(b, DRAW_LAYER_BELOW, ti, t, y);
+					}
+					if (above) {
+						PushItem(b, DRAW_LAYER_ABOVE, ti, t, y);
+					}
+					if (!below && !above) {
+						PushItem(b, DRAW_LAYER_THINGS, ti, t, y);
+					}
+					if (showHUD && ti->kind == KIND_CHARACTER) {
+						PushItem(b, DRAW_LAYER_CHATTER, ti, t, y);
+					}
+				}
+				// Highlights have their own LOS rules
+				if (showHUD && ((ti->flags & THING_OBJECTIVE)
+						|| ti->kind == KIND_PICKUP)) {
+					PushItem(b, DRAW_LAYER_HIGHLIGHTS, ti, t, y);
+				}
+			CA_FOREACH_END()
 		}
-		DrawLOSPic(t, pic, svec2i_add(doorPos, svec2i(0, WALL_OFFSET_Y)),
-				useFog);
 	}
+	DrawBufferSortLayer(b, &b->layers[DRAW_LAYER_BELOW]);
+	DrawBufferSortLayer(b, &b->layers[DRAW_LAYER_THINGS]);
+	DrawBufferSortLayer(b, &b->layers[DRAW_LAYER_ABOVE]);
+}
 
-	// Draw the items that are in LOS
-	if (t->outOfSight) {
-		return;
+static void DrawFloor(DrawBuffer *b, const struct vec2i offset,
+		const LOSTint tint) {
+	const Tile **tile = DrawBufferGetFirstTile(b);
+	struct vec2i pos = svec2i(b->dx + offset.x, b->dy + offset.y);
+	for (int y = 0; y < Y_TILES; y++, pos.y += TILE_HEIGHT) {
+		DrawTileLayerRow(b, tile, y, pos, TILE_CACHE_LAYER_FLOOR, tint);
+		tile += X_TILES;
 	}
-	CA_FOREACH(ThingId, tid, t->things)
-		const Thing *ti = ThingIdGetThing(tid);
-		if (ThingDrawBelow(ti) || ThingDrawAbove(ti)) {
-			continue;
-		}
-		CArrayPushBack(&b->displaylist, &ti);
-	CA_FOREACH_END()
 }
 
-static void DrawThingsAbove(DrawBuffer *b, const struct vec2i offset,
-		const Tile *t, const struct vec2i pos, const bool useFog) {
-	UNUSED(offset);
-	UNUSED(pos);
-	UNUSED(useFog);
-	if (t->outOfSight) {
-		return;
-	}
-	CA_FOREACH(ThingId, tid, t->things)
-		const Thing *ti = ThingIdGetThing(tid);
-		if (ThingDrawAbove(ti)) {
-			CArrayPushBack(&b->displaylist, &ti);
-		}CA_FOREACH_END()
+static void DrawThings(DrawBuffer *b, const DrawLayer layer,
+		const struct vec2i offset) {
+	CA_FOREACH(const DrawListItem, item, b->layers[layer])
+		DrawThing(b, item->t, offset);
+	CA_FOREACH_END()
 }
 
-static void DrawObjectiveHighlights(DrawBuffer *b, const struct vec2i offset,
-		const Tile *t, const struct vec2i pos, const bool useFog) {
-	UNUSED(pos);
-	UNUSED(useFog);
-	CA_FOREACH(ThingId, tid, t->things)
-		Thing *ti = ThingIdGetThing(tid);
-		const Pic *pic = NULL;
-		color_t color = colorWhite;
-		struct vec2i drawOffsetExtra = svec2i_zero();
-
-		if (ti->flags & THING_OBJECTIVE) {
-			// Objective
-			const int objective = ObjectiveFromThing(ti->flags);
-			const Objective *o = static_cast<const Objective*>(CArrayGet(
-					&gMission.missionData->Objectives, objective));
-			if (o->Flags & OBJECTIVE_HIDDEN) {
-				continue;
-			}
-			if (!(o->Flags & OBJECTIVE_POSKNOWN) && t->outOfSight) {
-				continue;
-			}
-			switch (o->Type) {
-			case OBJECTIVE_KILL:
-			case OBJECTIVE_DESTROY: // fallthrough
-				pic = PicManagerGetPic(&gPicManager, "hud/objective_kill");
-				break;
-			case OBJECTIVE_RESCUE:
-			case OBJECTIVE_COLLECT: // fallthrough
-				pic = PicManagerGetPic(&gPicManager, "hud/objective_collect");
+// Walls are drawn per row, before that row's things
+static void DrawWallsAndThings(DrawBuffer *b, const struct vec2i offset,
+		const LOSTint tint) {
+	const Tile **tile = DrawBufferGetFirstTile(b);
+	const CArray *things = &b->layers[DRAW_LAYER_THINGS];
+	int i = 0;
+	struct vec2i pos = svec2i(b->dx + offset.x, b->dy + offset.y);
+	for (int y = 0; y < Y_TILES; y++, pos.y += TILE_HEIGHT) {
+		DrawTileLayerRow(b, tile, y, pos, TILE_CACHE_LAYER_WALLS, tint);
+		for (; i < (int) things->size; i++) {
+			const DrawListItem *item = static_cast<const DrawListItem*>(
+					CArrayGet(things, i));
+			if (item->row != y) {
 				break;
-			default:
-				CASSERT(false, "unexpected objective to draw")
-				;
-				continue;
-			}
-			color = o->color;
-			if (ti->kind == KIND_CHARACTER) {
-				drawOffsetExtra.y -= 10;
-			}
-		} else if (ti->kind == KIND_PICKUP) {
-			// Require LOS for non-deathmatch modes
-			if (!IsPVP(gCampaign.Entry.Mode) && t->outOfSight) {
-				continue;
-			}
-			// Gun pickup
-			const Pickup *p = static_cast<const Pickup*>(CArrayGet(&gPickups,
-					ti->id));
-			if (!PickupIsManual(p)) {
-				continue;
 			}
-			pic = CPicGetPic(&p->thing.CPic, 0);
-			color = colorDarker;
-			color.a = (Uint8) Pulse256(gMission.time);
+			DrawThing(b, item->t, offset);
+		}
+		tile += X_TILES;
+	}
+}
+
+static void DrawObjectiveHighlight(DrawBuffer *b, const struct vec2i offset,
+		const DrawListItem *item) {
+	const Thing *ti = item->t;
+	const Pic *pic = NULL;
+	color_t color = colorWhite;
+	struct vec2i drawOffsetExtra = svec2i_zero();
+
+	if (ti->flags & THING_OBJECTIVE) {
+		// Objective
+		const int objective = ObjectiveFromThing(ti->flags);
+		const Objective *o = static_cast<const Objective*>(CArrayGet(
+				&gMission.missionData->Objectives, objective));
+		if (o->Flags & OBJECTIVE_HIDDEN) {
+			return;
 		}
+		if (!(o->Flags & OBJECTIVE_POSKNOWN) && item->tile->outOfSight) {
+			return;
+		}
+		switch (o->Type) {
+		case OBJECTIVE_KILL:
+		case OBJECTIVE_DESTROY: // fallthrough
+			pic = PicManagerGetPic(&gPicManager, "hud/objective_kill");
+			break;
+		case OBJECTIVE_RESCUE:
+		case OBJECTIVE_COLLECT: // fallthrough
+			pic = PicManagerGetPic(&gPicManager, "hud/objective_collect");
+			break;
+		default:
+			CASSERT(false, "unexpected objective to draw")
+			;
+			return;
+		}
+		color = o->color;
+		if (ti->kind == KIND_CHARACTER) {
+			drawOffsetExtra.y -= 10;
+		}
+	} else if (ti->kind == KIND_PICKUP) {
+		// Require LOS for non-deathmatch modes
+		if (!IsPVP(gCampaign.Entry.Mode) && item->tile->outOfSight) {
+			return;
+		}
+		// Gun pickup
+		const Pickup *p = static_cast<const Pickup*>(CArrayGet(&gPickups,
+				ti->id));
+		if (!PickupIsManual(p)) {
+			return;
+		}
+		pic = CPicGetPic(&p->thing.CPic, 0);
+		color = colorDarker;
+		color.a = (Uint8) Pulse256(gMission.time);
+	}
 
-		if (pic != NULL) {
-			const struct vec2i picPos = svec2i_add(
-					svec2i_subtract(svec2i_floor(ti->Pos),
-							svec2i(b->xTop, b->yTop)), offset);
-			color.a = (Uint8) Pulse256(gMission.time);
-			// Centre the drawing
-			const struct vec2i drawOffset = svec2i_scale_divide(pic->size, -2);
-			PicRender(pic, gGraphicsDevice.gameWindow.renderer,
-					svec2i_add(picPos, svec2i_add(drawOffset, drawOffsetExtra)),
-					color, 0, svec2_one(), SDL_FLIP_NONE, Rect2iZero());
-		}CA_FOREACH_END()
+	if (pic != NULL) {
+		const struct vec2i picPos = svec2i_add(
+				svec2i_subtract(svec2i_floor(ti->Pos),
+						svec2i(b->xTop, b->yTop)), offset);
+		color.a = (Uint8) Pulse256(gMission.time);
+		// Centre the drawing
+		const struct vec2i drawOffset = svec2i_scale_divide(pic->size, -2);
+		PicRender(pic, gGraphicsDevice.gameWindow.renderer,
+				svec2i_add(picPos, svec2i_add(drawOffset, drawOffsetExtra)),
+				color, 0, svec2_one(), SDL_FLIP_NONE, Rect2iZero());
+	}
 }
 
 #define ACTOR_HEIGHT 25
-static void DrawChatters(DrawBuffer *b, const struct vec2i offset,
-		const Tile *t, const struct vec2i pos, const bool useFog) {
-	UNUSED(pos);
-	UNUSED(useFog);
-	CA_FOREACH(ThingId, tid, t->things)
-	// Draw the items that are in LOS
-		if (t->outOfSight) {
-			continue;
-		}
-		const Thing *ti = ThingIdGetThing(tid);
-		if (ti->kind != KIND_CHARACTER) {
-			continue;
+static void DrawChatter(DrawBuffer *b, const struct vec2i offset,
+		const DrawListItem *item, const LOSTint tint) {
+	const TActor *a = static_cast<TActor*>(CArrayGet(&gActors, item->t->id));
+	// Draw character text
+	if (strlen(a->Chatter) > 0) {
+		const struct vec2i textPos = svec2i(
+				(int) a->thing.Pos.x - b->xTop + offset.x
+						- FontStrW(a->Chatter) / 2,
+				(int) a->thing.Pos.y - b->yTop + offset.y - ACTOR_HEIGHT);
+		const color_t mask = GetLOSMask(item->tile, tint);
+		if (!ColorEquals(mask, colorTransparent)) {
+			FontStrMask(a->Chatter, textPos, mask);
 		}
+	}
+}
 
-		const TActor *a = static_cast<TActor*>(CArrayGet(&gActors, ti->id));
-		// Draw character text
-		if (strlen(a->Chatter) > 0) {
-			const struct vec2i textPos = svec2i(
-					(int) a->thing.Pos.x - b->xTop + offset.x
-							- FontStrW(a->Chatter) / 2,
-					(int) a->thing.Pos.y - b->yTop + offset.y - ACTOR_HEIGHT);
-			const color_t mask = GetLOSMask(t, useFog);
-			if (!ColorEquals(mask, colorTransparent)) {
-				FontStrMask(a->Chatter, textPos, mask);
-			}
-		}CA_FOREACH_END()
+static void DrawExtra(DrawBuffer *b, struct vec2i offset,
+		GrafxDrawExtra *extra);
+
+void DrawBufferDraw(DrawBuffer *b, struct vec2i offset, GrafxDrawExtra *extra) {
+	const bool showHUD = ConfigGetBool(&gConfig, "Graphics.ShowHUD");
+	const bool useFog = ConfigGetBool(&gConfig, "Game.Fog");
+	PROFILE_BEGIN("gather");
+	GatherLayers(b, showHUD);
+	// Walls and things are taller than their tiles, so the tile-aligned
+	// mask would darken their tops by the LOS of the tile above; tint them
+	// by their own tile instead
+	const LOSTint tint = useFog ? LOS_TINT_FOG : LOS_TINT_BLACK;
+	FogMask *fm = &gFogMasks[b->View];
+	const LOSTint floorTint =
+			FogMaskUpdate(fm, b, useFog) ? LOS_TINT_MASK : tint;
+	PROFILE_END();
+	// First draw the floor tiles (which do not obstruct anything)
+	PROFILE_BEGIN("floor");
+	DrawFloor(b, offset, floorTint);
+	PROFILE_END();
+	// Darken the floor out of sight in one go
+	if (floorTint == LOS_TINT_MASK) {
+		PROFILE_SCOPE("fog");
+		FogMaskDraw(fm, b, offset,
+				ConfigGetBool(&gConfig, "Graphics.SmoothFog"));
+	}
+	// Then draw things that are below everything like debris (wrecks)
+	PROFILE_BEGIN("below");
+	DrawThings(b, DRAW_LAYER_BELOW, offset);
+	PROFILE_END();
+	// Now draw walls and (non-wreck) things in proper order
+	PROFILE_BEGIN("walls and things");
+	DrawWallsAndThings(b, offset, tint);
+	PROFILE_END();
+	// Draw things that are above everything
+	PROFILE_BEGIN("above");
+	DrawThings(b, DRAW_LAYER_ABOVE, offset);
+	PROFILE_END();
+	if (showHUD) {
+		PROFILE_SCOPE("highlights");
+		// Draw objective highlights, for visible and always-visible objectives
+		CA_FOREACH(const DrawListItem, item, b->layers[DRAW_LAYER_HIGHLIGHTS])
+			DrawObjectiveHighlight(b, offset, item);
+		CA_FOREACH_END()
+		// Draw actor chatter
+		CA_FOREACH(const DrawListItem, item, b->layers[DRAW_LAYER_CHATTER])
+			DrawChatter(b, offset, item, tint);
+		CA_FOREACH_END()
+	}
+	// Draw editor-only things
+	if (extra) {
+		DrawExtra(b, offset, extra);
+	}
 }
 
 static void DrawThing(DrawBuffer *b, const Thing *t,
 		const struct vec2i offset) {
 	const struct vec2i picPos = svec2i_add(
-			svec2i_subtract(svec2i_floor(svec2_add(t->Pos, t->drawShake)),
+			svec2i_subtract(svec2i_floor(svec2_add(svec2_add(t->Pos, t->drawShake),
+							t->drawCorrection)),
 					svec2i(b->xTop, b->yTop)), offset);
 
 	if (!svec2i_is_zero(t->ShadowSize)) {
@@ -425,7 +486,7 @@ static void DrawGuideImage(const DrawBuffer *b, const Pic *guideImage,
 	color_t mask = colorWhite;
 	mask.a = alpha;
 	TextureRender(guideImage->Tex, gGraphicsDevice.gameWindow.renderer,
-			Rect2iZero(),
+			Rect2iNew(guideImage->TexPos, guideImage->size),
 			Rect2iNew(pos,
 					svec2i((mint_t) MROUND(guideImage->size.x * xScale),
 							(mint_t) MROUND(guideImage->size.y * yScale))),
@@ -443,7 +504,7 @@ static void DrawObjectNames(DrawBuffer *b, const struct vec2i offset) {
 		for (int x = 0; x < b->Size.x; x++, tile++) {
 			if (*tile == NULL)
 				continue;
-			CA_FOREACH(ThingId, tid, (*tile)->things)
+			CA_FOREACH(ThingId, tid, *TileGetThings(*tile))
 				const Thing *ti = ThingIdGetThing(tid);
 				if (ti->flags & THING_OBJECTIVE) {
 					DrawObjectiveName(ti, b, offset);
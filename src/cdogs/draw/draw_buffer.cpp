@@ -49,6 +49,7 @@
 #include "draw/draw_buffer.h"
 
 #include <assert.h>
+#include <string.h>
 
 #include "algorithms.h"
 #include "log.h"
@@ -56,18 +57,27 @@
 
 void DrawBufferInit(DrawBuffer *b, struct vec2i size, GraphicsDevice *g) {
 	b->OrigSize = size;
+	b->View = 0;
 	CArrayInit(&b->tiles, sizeof(Tile*));
 	for (int i = 0; i < size.x * size.y; i++) {
 		const Tile *t = NULL;
 		CArrayPushBack(&b->tiles, &t);
 	}
 	b->g = g;
-	CArrayInit(&b->displaylist, sizeof(const Thing*));
-	CArrayReserve(&b->displaylist, 32);
+	for (int i = 0; i < DRAW_LAYER_COUNT; i++) {
+		CArrayInit(&b->layers[i], sizeof(DrawListItem));
+		CArrayReserve(&b->layers[i], 64);
+	}
+	CArrayInit(&b->sortKeys, sizeof(DrawSortKey));
+	CArrayInit(&b->sortItems, sizeof(DrawListItem));
 }
 void DrawBufferTerminate(DrawBuffer *b) {
 	CArrayTerminate(&b->tiles);
-	CArrayTerminate(&b->displaylist);
+	for (int i = 0; i < DRAW_LAYER_COUNT; i++) {
+		CArrayTerminate(&b->layers[i]);
+	}
+	CArrayTerminate(&b->sortKeys);
+	CArrayTerminate(&b->sortItems);
 }
 
 void DrawBufferSetFromMap(DrawBuffer *buffer, const Map *map,
@@ -120,20 +130,67 @@ void DrawBufferFix(DrawBuffer *buffer) {
 	}
 }
 
-static int CompareY(const void *v1, const void *v2);
-void DrawBufferSortDisplayList(DrawBuffer *buffer) {
-	qsort(buffer->displaylist.data, buffer->displaylist.size,
-			buffer->displaylist.elemSize, CompareY);
+// Map a float to an unsigned int with the same ordering
+static uint32_t FloatSortKey(float f) {
+	if (f == 0) {
+		// -0 and 0 compare equal
+		f = 0;
+	}
+	uint32_t u;
+	memcpy(&u, &f, sizeof u);
+	return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
 }
-static int CompareY(const void *v1, const void *v2) {
-	const Thing *const*t1 = static_cast<const Thing* const*>(v1);
-	const Thing *const*t2 = static_cast<const Thing* const*>(v2);
-	if ((*t1)->Pos.y < (*t2)->Pos.y) {
-		return -1;
-	} else if ((*t1)->Pos.y > (*t2)->Pos.y) {
-		return 1;
+// Stable sort of each row's things by Y, so that lower things are drawn over
+// higher ones. This is an LSD radix sort on (row, Y), a byte at a time;
+// bytes that are the same for every item, such as the high bytes of the
+// row, are skipped.
+void DrawBufferSortLayer(DrawBuffer *b, CArray *layer) {
+	const int n = (int) layer->size;
+	if (n < 2) {
+		return;
+	}
+	DrawListItem *items = static_cast<DrawListItem*>(layer->data);
+	CArrayResize(&b->sortKeys, n * 2, NULL);
+	DrawSortKey *src = static_cast<DrawSortKey*>(b->sortKeys.data);
+	DrawSortKey *dst = src + n;
+	for (int i = 0; i < n; i++) {
+		src[i].key = ((uint64_t) (uint32_t) items[i].row << 32)
+				| FloatSortKey(items[i].t->Pos.y);
+		src[i].index = i;
+	}
+	bool sorted = false;
+	for (int shift = 0; shift < 64; shift += 8) {
+		int counts[256];
+		memset(counts, 0, sizeof counts);
+		for (int i = 0; i < n; i++) {
+			counts[(src[i].key >> shift) & 0xff]++;
+		}
+		if (counts[(src[0].key >> shift) & 0xff] == n) {
+			continue;
+		}
+		int offset = 0;
+		for (int d = 0; d < 256; d++) {
+			const int c = counts[d];
+			counts[d] = offset;
+			offset += c;
+		}
+		for (int i = 0; i < n; i++) {
+			dst[counts[(src[i].key >> shift) & 0xff]++] = src[i];
+		}
+		DrawSortKey *tmp = src;
+		src = dst;
+		dst = tmp;
+		sorted = true;
+	}
+	if (!sorted) {
+		return;
+	}
+	CArrayResize(&b->sortItems, n, NULL);
+	DrawListItem *out = static_cast<DrawListItem*>(b->sortItems.data);
+	for (int i = 0; i < n; i++) {
+		out[i] = items[src[i].index];
 	}
-	return 0;
+	memcpy(items, out, n * sizeof *items);
 }
 
 const Tile** DrawBufferGetFirstTile(const DrawBuffer *b) {
@@ -50,6 +50,26 @@
 
 #include "map.h"
 
+// Things are gathered from the buffer's tiles into these layers, which are
+// drawn in this order
+typedef enum {
+	DRAW_LAYER_BELOW,	// e.g. wrecks
+	DRAW_LAYER_THINGS,	// drawn row by row, interleaved with walls
+	DRAW_LAYER_ABOVE,
+	DRAW_LAYER_HIGHLIGHTS,	// objectives and pickups
+	DRAW_LAYER_CHATTER,
+	DRAW_LAYER_COUNT
+} DrawLayer;
+typedef struct {
+	const Thing *t;
+	const Tile *tile;
+	int row;	// tile row in the buffer
+} DrawListItem;
+typedef struct {
+	uint64_t key;
+	int index;
+} DrawSortKey;
+
 typedef struct {
 	GraphicsDevice *g;
 	int xTop, yTop;	// offset from top/left in pixels
@@ -57,8 +77,13 @@ typedef struct {
 	int dx, dy;	// remainder pixel offset from starting tile
 	struct vec2i OrigSize;
 	struct vec2i Size;	// size in tiles
+	int View;	// split screen view, for its own fog mask
 	CArray tiles;	// of Tile *
-	CArray displaylist;	// of const Thing *, to determine draw order
+	// of DrawListItem; kept between frames to avoid reallocating
+	CArray layers[DRAW_LAYER_COUNT];
+	// Scratch space for sorting the layers
+	CArray sortKeys;	// of DrawSortKey, twice the layer size
+	CArray sortItems;	// of DrawListItem
 } DrawBuffer;
 
 void DrawBufferInit(DrawBuffer *b, struct vec2i size, GraphicsDevice *g);
@@ -67,5 +92,5 @@ void DrawBufferTerminate(DrawBuffer *b);
 void DrawBufferSetFromMap(DrawBuffer *buffer, const Map *map,
 		const struct vec2 origin, const int width);
 void DrawBufferFix(DrawBuffer *buffer);
-void DrawBufferSortDisplayList(DrawBuffer *buffer);
+void DrawBufferSortLayer(DrawBuffer *b, CArray *layer);
 const Tile** DrawBufferGetFirstTile(const DrawBuffer *b);
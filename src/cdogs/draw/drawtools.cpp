@@ -50,6 +50,7 @@
 #include "algorithms.h"
 #include "config.h"
 #include "draw/drawtools.h"
+#include "draw/sprite_batch.h"
 #include "log.h"
 #include "palette.h"
 #include "pic_manager.h"
@@ -59,6 +60,7 @@
 #include "grafx.h"
 
 void DrawPoint(const struct vec2i pos, const color_t c) {
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderDrawBlendMode(gGraphicsDevice.gameWindow.renderer,
 			SDL_BLENDMODE_BLEND) != 0) {
 		LOG(LM_GFX, LL_ERROR, "Failed to set draw blend mode: %s",
@@ -153,6 +155,7 @@ void Draw_Line(const int x1, const int y1, const int x2, const int y2,
 
 void DrawRectangle(GraphicsDevice *g, const struct vec2i pos,
 		const struct vec2i size, const color_t color, const bool filled) {
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderDrawBlendMode(g->gameWindow.renderer, SDL_BLENDMODE_BLEND)
 			!= 0) {
 		LOG(LM_GFX, LL_ERROR, "Failed to set draw blend mode: %s",
@@ -173,6 +176,7 @@ void DrawRectangle(GraphicsDevice *g, const struct vec2i pos,
 }
 
 void DrawCross(GraphicsDevice *g, const struct vec2i pos, const color_t c) {
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderDrawBlendMode(g->gameWindow.renderer, SDL_BLENDMODE_BLEND)
 			!= 0) {
 		LOG(LM_GFX, LL_ERROR, "Failed to set draw blend mode: %s",
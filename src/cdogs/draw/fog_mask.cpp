@@ -0,0 +1,189 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fog_mask.h"
+
+#include <string.h>
+
+#include <SDL2/SDL_version.h>
+
+#include "grafx.h"
+#include "log.h"
+#include "texture.h"
+
+FogMask gFogMasks[FOG_MASK_VIEWS];
+
+void FogMaskInit(FogMask *fm) {
+	memset(fm, 0, sizeof *fm);
+}
+void FogMaskTerminate(FogMask *fm) {
+	if (fm->Tex != NULL) {
+		SDL_DestroyTexture(fm->Tex);
+	}
+	CFREE(fm->pixels);
+	memset(fm, 0, sizeof *fm);
+}
+
+void FogMaskSetMapSize(FogMask *fm, const struct vec2i mapSize) {
+	FogMaskTerminate(fm);
+	if (svec2i_is_zero(mapSize)) {
+		return;
+	}
+	fm->Size = mapSize;
+	CCALLOC(fm->pixels, fm->Size.x * fm->Size.y * sizeof *fm->pixels);
+	fm->Dirty = true;
+}
+
+void FogMaskReset(FogMask *fm) {
+	fm->Tex = NULL;
+	fm->Dirty = true;
+}
+
+void FogMasksInit(void) {
+	for (int i = 0; i < FOG_MASK_VIEWS; i++) {
+		FogMaskInit(&gFogMasks[i]);
+	}
+}
+void FogMasksTerminate(void) {
+	for (int i = 0; i < FOG_MASK_VIEWS; i++) {
+		FogMaskTerminate(&gFogMasks[i]);
+	}
+}
+void FogMasksSetMapSize(const struct vec2i mapSize) {
+	for (int i = 0; i < FOG_MASK_VIEWS; i++) {
+		FogMaskSetMapSize(&gFogMasks[i], mapSize);
+	}
+}
+void FogMasksReset(void) {
+	for (int i = 0; i < FOG_MASK_VIEWS; i++) {
+		FogMaskReset(&gFogMasks[i]);
+	}
+}
+
+// Same darkening as drawing with colorFog
+#define FOG_PIXEL(_alpha) ((Uint32) (_alpha) << 24)
+static Uint32 GetTilePixel(const Tile *t, const bool useFog) {
+	if (!t->isVisited || (t->outOfSight && !useFog)) {
+		return FOG_PIXEL(255);
+	}
+	if (t->outOfSight) {
+		return FOG_PIXEL(255 - colorFog.r);
+	}
+	return FOG_PIXEL(0);
+}
+static bool CreateTexture(FogMask *fm);
+bool FogMaskUpdate(FogMask *fm, const DrawBuffer *b, const bool useFog) {
+	if (fm->pixels == NULL || (fm->Tex == NULL && !CreateTexture(fm))) {
+		return false;
+	}
+	// Track the changed texels' bounds
+	bool changed = false;
+	struct vec2i changedStart = svec2i_zero();
+	struct vec2i changedEnd = svec2i_zero();
+	const Tile **tile = DrawBufferGetFirstTile(b);
+	for (int y = 0; y < Y_TILES; y++, tile += X_TILES) {
+		for (int x = 0; x < b->Size.x; x++) {
+			if (tile[x] == NULL) {
+				continue;
+			}
+			const struct vec2i v = svec2i(x + b->xStart, y + b->yStart);
+			Uint32 *p = &fm->pixels[v.x + v.y * fm->Size.x];
+			const Uint32 pixel = GetTilePixel(tile[x], useFog);
+			if (*p == pixel) {
+				continue;
+			}
+			*p = pixel;
+			changedStart = changed ? svec2i_min(changedStart, v) : v;
+			changedEnd = changed ? svec2i_max(changedEnd, v) : v;
+			changed = true;
+		}
+	}
+	if (fm->Dirty) {
+		changedStart = svec2i_zero();
+		changedEnd = svec2i_subtract(fm->Size, svec2i_one());
+		fm->Dirty = false;
+	} else if (!changed) {
+		return true;
+	}
+	SDL_Rect rect;
+	rect.x = changedStart.x;
+	rect.y = changedStart.y;
+	rect.w = changedEnd.x - changedStart.x + 1;
+	rect.h = changedEnd.y - changedStart.y + 1;
+	if (SDL_UpdateTexture(fm->Tex, &rect,
+			fm->pixels + rect.x + rect.y * fm->Size.x,
+			fm->Size.x * sizeof *fm->pixels) != 0) {
+		LOG(LM_GFX, LL_ERROR, "cannot update fog mask: %s", SDL_GetError());
+	}
+	return true;
+}
+static bool CreateTexture(FogMask *fm) {
+	fm->Tex = TextureCreate(gGraphicsDevice.gameWindow.renderer,
+			SDL_TEXTUREACCESS_STREAMING, fm->Size, SDL_BLENDMODE_BLEND, 255);
+	if (fm->Tex == NULL) {
+		return false;
+	}
+	// Start hidden, as a new map is unexplored
+	for (int i = 0; i < fm->Size.x * fm->Size.y; i++) {
+		fm->pixels[i] = FOG_PIXEL(255);
+	}
+	fm->Dirty = true;
+	return true;
+}
+
+void FogMaskDraw(const FogMask *fm, const DrawBuffer *b,
+		const struct vec2i offset, const bool smooth) {
+	if (fm->Tex == NULL) {
+		return;
+	}
+	// Only the part of the buffer that is on the map
+	const struct vec2i start = svec2i_max(svec2i(b->xStart, b->yStart),
+			svec2i_zero());
+	const struct vec2i end = svec2i_min(
+			svec2i(b->xStart + b->Size.x, b->yStart + Y_TILES), fm->Size);
+	if (end.x <= start.x || end.y <= start.y) {
+		return;
+	}
+	const Rect2i src = Rect2iNew(start, svec2i_subtract(end, start));
+	const struct vec2i pos = svec2i(
+			b->dx + offset.x + (start.x - b->xStart) * TILE_WIDTH,
+			b->dy + offset.y + (start.y - b->yStart) * TILE_HEIGHT);
+#if SDL_VERSION_ATLEAST(2, 0, 12)
+	// Filtering blends the edges between tiles for soft fog
+	if (SDL_SetTextureScaleMode(fm->Tex,
+			smooth ? SDL_ScaleModeLinear : SDL_ScaleModeNearest) != 0) {
+		LOG(LM_GFX, LL_ERROR, "cannot set fog scale mode: %s",
+				SDL_GetError());
+	}
+#else
+	UNUSED(smooth);
+#endif
+	TextureRender(fm->Tex, gGraphicsDevice.gameWindow.renderer, src,
+			Rect2iNew(pos, svec2i(src.Size.x * TILE_WIDTH,
+					src.Size.y * TILE_HEIGHT)), colorWhite, 0, SDL_FLIP_NONE);
+}
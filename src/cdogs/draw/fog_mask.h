@@ -0,0 +1,76 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL2/SDL_render.h>
+
+#include "draw/draw_buffer.h"
+#include "player.h"
+
+// Line of sight as a texture with one texel per map tile: transparent where
+// in sight, partly black for fog and black where hidden. It is drawn over the
+// floor once per view, so floor tiles can be drawn without per-tile colour
+// modulation.
+// Only the floor is covered. Wall tops and sprites are drawn above their
+// own tile, over pixels that belong to other tiles, so no tile-aligned mask
+// or offset matches them; they are still tinted per tile. Covering them
+// would need a mask drawn from their sprites, at full resolution.
+typedef struct {
+	SDL_Texture *Tex;
+	struct vec2i Size;	// in tiles
+	// Copy of the texels, so only those that change are uploaded
+	Uint32 *pixels;
+	bool Dirty;
+} FogMask;
+
+// One per split screen view, as each view has its own LOS
+#define FOG_MASK_VIEWS MAX_LOCAL_PLAYERS
+extern FogMask gFogMasks[FOG_MASK_VIEWS];
+
+void FogMaskInit(FogMask *fm);
+void FogMaskTerminate(FogMask *fm);
+// Set up for a new map; everything starts hidden
+void FogMaskSetMapSize(FogMask *fm, const struct vec2i mapSize);
+// Forget the texture without destroying it, for when the renderer that
+// owned it has already been destroyed
+void FogMaskReset(FogMask *fm);
+// The above, for all views' masks
+void FogMasksInit(void);
+void FogMasksTerminate(void);
+void FogMasksSetMapSize(const struct vec2i mapSize);
+void FogMasksReset(void);
+
+// Update the texels under the buffer from its tiles' LOS.
+// Returns false if the mask is unavailable, in which case LOS needs to be
+// applied per tile.
+bool FogMaskUpdate(FogMask *fm, const DrawBuffer *b, const bool useFog);
+void FogMaskDraw(const FogMask *fm, const DrawBuffer *b,
+		const struct vec2i offset, const bool smooth);
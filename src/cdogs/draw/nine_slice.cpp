@@ -28,6 +28,7 @@
  */
 #include "nine_slice.h"
 
+#include "draw/sprite_batch.h"
 #include "log.h"
 #include "texture.h"
 
@@ -64,8 +65,13 @@ void Draw9Slice(GraphicsDevice *g, const Pic *pic, const Rect2i target,
 					if (dst.Pos.y + dst.Size.y > dstY[j + 1]) {
 						src.Size.y = dst.Size.y = dstY[j + 1] - dst.Pos.y;
 					}
-					TextureRender(pic->Tex, g->gameWindow.renderer, src, dst,
-							mask, 0, flip);
+					const Rect2i texSrc = Rect2iNew(
+							svec2i_add(src.Pos, pic->TexPos), src.Size);
+					if (!SpriteBatchAdd(&gSpriteBatch, g->gameWindow.renderer,
+							pic->Tex, texSrc, dst, mask, 0, flip)) {
+						TextureRender(pic->Tex, g->gameWindow.renderer, texSrc,
+								dst, mask, 0, flip);
+					}
 				}
 			}
 		}
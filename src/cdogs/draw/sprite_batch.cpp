@@ -0,0 +1,157 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "sprite_batch.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "log.h"
+#include "utils.h"
+
+SpriteBatch gSpriteBatch;
+
+void SpriteBatchInit(SpriteBatch *b, const bool enabled) {
+	memset(b, 0, sizeof *b);
+	b->Enabled = enabled && SPRITE_BATCH_SUPPORTED;
+#if SPRITE_BATCH_SUPPORTED
+	if (!b->Enabled) {
+		return;
+	}
+	CMALLOC(b->verts, SPRITE_BATCH_MAX_QUADS * 4 * sizeof *b->verts);
+	CMALLOC(b->indices, SPRITE_BATCH_MAX_QUADS * 6 * sizeof *b->indices);
+	// Quads are always two triangles with the same winding
+	for (int i = 0; i < SPRITE_BATCH_MAX_QUADS; i++) {
+		int *idx = &b->indices[i * 6];
+		idx[0] = i * 4;
+		idx[1] = i * 4 + 1;
+		idx[2] = i * 4 + 2;
+		idx[3] = i * 4;
+		idx[4] = i * 4 + 2;
+		idx[5] = i * 4 + 3;
+	}
+#endif
+}
+void SpriteBatchTerminate(SpriteBatch *b) {
+#if SPRITE_BATCH_SUPPORTED
+	CFREE(b->verts);
+#endif
+	CFREE(b->indices);
+	memset(b, 0, sizeof *b);
+}
+
+bool SpriteBatchAdd(SpriteBatch *b, SDL_Renderer *r, SDL_Texture *t,
+		const Rect2i src, const Rect2i dest, const color_t mask,
+		const double angle, const SDL_RendererFlip flip) {
+#if SPRITE_BATCH_SUPPORTED
+	if (!b->Enabled || t == NULL || Rect2iIsZero(src)) {
+		return false;
+	}
+	if (b->count == SPRITE_BATCH_MAX_QUADS || r != b->renderer
+			|| t != b->tex) {
+		SpriteBatchFlush(b);
+		b->renderer = r;
+		b->tex = t;
+		int w, h;
+		if (SDL_QueryTexture(t, NULL, NULL, &w, &h) != 0) {
+			LOG(LM_GFX, LL_ERROR, "cannot query texture: %s", SDL_GetError());
+			b->tex = NULL;
+			return false;
+		}
+		b->texSize = svec2((float) w, (float) h);
+	}
+
+	float u0 = src.Pos.x / b->texSize.x;
+	float u1 = (src.Pos.x + src.Size.x) / b->texSize.x;
+	float v0 = src.Pos.y / b->texSize.y;
+	float v1 = (src.Pos.y + src.Size.y) / b->texSize.y;
+	if (flip & SDL_FLIP_HORIZONTAL) {
+		const float tmp = u0;
+		u0 = u1;
+		u1 = tmp;
+	}
+	if (flip & SDL_FLIP_VERTICAL) {
+		const float tmp = v0;
+		v0 = v1;
+		v1 = tmp;
+	}
+	const struct vec2 uvs[4] = {
+		svec2(u0, v0), svec2(u1, v0), svec2(u1, v1), svec2(u0, v1)
+	};
+	// Corners relative to the centre, which is what SDL rotates about
+	const struct vec2 half = svec2(dest.Size.x / 2.0f, dest.Size.y / 2.0f);
+	const struct vec2 centre = svec2(dest.Pos.x + half.x, dest.Pos.y + half.y);
+	const struct vec2 corners[4] = {
+		svec2(-half.x, -half.y), svec2(half.x, -half.y), svec2(half.x, half.y),
+		svec2(-half.x, half.y)
+	};
+	const float rad = (float) (angle * MPI / 180.0);
+	const float c = angle == 0 ? 1.0f : cosf(rad);
+	const float s = angle == 0 ? 0.0f : sinf(rad);
+	const SDL_Color color = { mask.r, mask.g, mask.b, mask.a };
+	SDL_Vertex *v = &b->verts[b->count * 4];
+	for (int i = 0; i < 4; i++) {
+		v[i].position.x = centre.x + corners[i].x * c - corners[i].y * s;
+		v[i].position.y = centre.y + corners[i].x * s + corners[i].y * c;
+		v[i].color = color;
+		v[i].tex_coord.x = uvs[i].x;
+		v[i].tex_coord.y = uvs[i].y;
+	}
+	b->count++;
+	return true;
+#else
+	UNUSED(b);
+	UNUSED(r);
+	UNUSED(t);
+	UNUSED(src);
+	UNUSED(dest);
+	UNUSED(mask);
+	UNUSED(angle);
+	UNUSED(flip);
+	return false;
+#endif
+}
+
+void SpriteBatchFlush(SpriteBatch *b) {
+#if SPRITE_BATCH_SUPPORTED
+	if (b->count == 0) {
+		return;
+	}
+	// Vertex colours already carry the mask; TextureRender may have left a
+	// different one on the texture
+	SDL_SetTextureColorMod(b->tex, 255, 255, 255);
+	SDL_SetTextureAlphaMod(b->tex, 255);
+	if (SDL_RenderGeometry(b->renderer, b->tex, b->verts, b->count * 4,
+			b->indices, b->count * 6) != 0) {
+		LOG(LM_GFX, LL_ERROR, "cannot render geometry: %s", SDL_GetError());
+	}
+	b->count = 0;
+#else
+	UNUSED(b);
+#endif
+}
@@ -0,0 +1,72 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL2/SDL_render.h>
+#include <SDL2/SDL_version.h>
+
+#include "color.h"
+#include "vector.h"
+
+// SDL_RenderGeometry is needed to submit many quads at once
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define SPRITE_BATCH_SUPPORTED 1
+#else
+#define SPRITE_BATCH_SUPPORTED 0
+#endif
+
+#define SPRITE_BATCH_MAX_QUADS 4096
+
+// Collects consecutive textured quads that share a texture, and submits them
+// in one call. Any other drawing must flush the batch first so that draw
+// order is kept.
+typedef struct {
+	bool Enabled;
+	SDL_Renderer *renderer;
+	SDL_Texture *tex;
+	struct vec2 texSize;
+#if SPRITE_BATCH_SUPPORTED
+	SDL_Vertex *verts;
+#endif
+	int *indices;
+	int count;
+} SpriteBatch;
+
+extern SpriteBatch gSpriteBatch;
+
+void SpriteBatchInit(SpriteBatch *b, const bool enabled);
+void SpriteBatchTerminate(SpriteBatch *b);
+
+// Returns false if the quad could not be batched and must be drawn directly
+bool SpriteBatchAdd(SpriteBatch *b, SDL_Renderer *r, SDL_Texture *t,
+		const Rect2i src, const Rect2i dest, const color_t mask,
+		const double angle, const SDL_RendererFlip flip);
+void SpriteBatchFlush(SpriteBatch *b);
@@ -0,0 +1,284 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "tile_cache.h"
+
+#include <string.h>
+
+#include "draw/sprite_batch.h"
+#include "grafx.h"
+#include "log.h"
+#include "texture.h"
+
+TileCache gTileCache;
+
+void TileCacheInit(TileCache *tc) {
+	memset(tc, 0, sizeof *tc);
+	CArrayInit(&tc->Chunks, sizeof(TileCacheChunk));
+}
+static void ChunkDestroyTextures(TileCache *tc, TileCacheChunk *c);
+void TileCacheTerminate(TileCache *tc) {
+	CA_FOREACH(TileCacheChunk, c, tc->Chunks)
+		ChunkDestroyTextures(tc, c);
+	CA_FOREACH_END()
+	CArrayTerminate(&tc->Chunks);
+}
+static void ChunkDestroyTextures(TileCache *tc, TileCacheChunk *c) {
+	if (c->Floor == NULL) {
+		return;
+	}
+	SDL_DestroyTexture(c->Floor);
+	SDL_DestroyTexture(c->Walls);
+	c->Floor = c->Walls = NULL;
+	tc->NumRendered--;
+}
+
+void TileCacheSetMapSize(TileCache *tc, const struct vec2i mapSize) {
+	CA_FOREACH(TileCacheChunk, c, tc->Chunks)
+		ChunkDestroyTextures(tc, c);
+	CA_FOREACH_END()
+	tc->Size = svec2i(
+			(mapSize.x + TILE_CACHE_CHUNK_SIZE - 1) / TILE_CACHE_CHUNK_SIZE,
+			(mapSize.y + TILE_CACHE_CHUNK_SIZE - 1) / TILE_CACHE_CHUNK_SIZE);
+	TileCacheChunk c;
+	memset(&c, 0, sizeof c);
+	c.Dirty = true;
+	c.Cacheable = true;
+	CArrayResize(&tc->Chunks, tc->Size.x * tc->Size.y, &c);
+	CA_FOREACH(TileCacheChunk, cp, tc->Chunks)
+		*cp = c;
+	CA_FOREACH_END()
+	tc->NumRendered = 0;
+	tc->Enabled = true;
+}
+
+void TileCacheReset(TileCache *tc) {
+	CA_FOREACH(TileCacheChunk, c, tc->Chunks)
+		c->Floor = c->Walls = NULL;
+		c->Dirty = true;
+	CA_FOREACH_END()
+	tc->NumRendered = 0;
+	tc->Enabled = true;
+}
+
+static TileCacheChunk *GetChunk(const TileCache *tc,
+		const struct vec2i tilePos) {
+	const struct vec2i chunkPos = svec2i_scale_divide(tilePos,
+			TILE_CACHE_CHUNK_SIZE);
+	if (tilePos.x < 0 || tilePos.y < 0 || chunkPos.x >= tc->Size.x
+			|| chunkPos.y >= tc->Size.y) {
+		return NULL;
+	}
+	return static_cast<TileCacheChunk*>(CArrayGet(&tc->Chunks,
+			chunkPos.y * tc->Size.x + chunkPos.x));
+}
+
+void TileCacheInvalidate(TileCache *tc, const struct vec2i tilePos) {
+	TileCacheChunk *c = GetChunk(tc, tilePos);
+	if (c != NULL) {
+		c->Dirty = true;
+	}
+}
+
+static bool ChunkCreateTextures(TileCache *tc, TileCacheChunk *c);
+static void ChunkRender(TileCacheChunk *c, const Map *map,
+		const struct vec2i chunkStart);
+const TileCacheChunk *TileCacheGetChunk(TileCache *tc, const Map *map,
+		const struct vec2i tilePos) {
+	if (!tc->Enabled) {
+		return NULL;
+	}
+	TileCacheChunk *c = GetChunk(tc, tilePos);
+	if (c == NULL || (!c->Dirty && !c->Cacheable)) {
+		return NULL;
+	}
+	c->LastUsed = ++tc->counter;
+	if (c->Floor == NULL) {
+		if (!ChunkCreateTextures(tc, c)) {
+			return NULL;
+		}
+		c->Dirty = true;
+	}
+	if (c->Dirty) {
+		const struct vec2i chunkPos = svec2i_scale_divide(tilePos,
+				TILE_CACHE_CHUNK_SIZE);
+		ChunkRender(c, map, svec2i(chunkPos.x * TILE_CACHE_CHUNK_SIZE,
+				chunkPos.y * TILE_CACHE_CHUNK_SIZE));
+		c->Dirty = false;
+	}
+	return c->Cacheable ? c : NULL;
+}
+static bool ChunkCreateTextures(TileCache *tc, TileCacheChunk *c) {
+	if (tc->NumRendered >= TILE_CACHE_MAX_CHUNKS) {
+		// Recycle the least recently drawn chunk
+		TileCacheChunk *lru = NULL;
+		CA_FOREACH(TileCacheChunk, cp, tc->Chunks)
+			if (cp->Floor != NULL
+					&& (lru == NULL || cp->LastUsed < lru->LastUsed)) {
+				lru = cp;
+			}
+		CA_FOREACH_END()
+		if (lru == NULL) {
+			return false;
+		}
+		c->Floor = lru->Floor;
+		c->Walls = lru->Walls;
+		lru->Floor = lru->Walls = NULL;
+		lru->Dirty = true;
+		return true;
+	}
+	SDL_Renderer *r = gGraphicsDevice.gameWindow.renderer;
+	c->Floor = TextureCreate(r, SDL_TEXTUREACCESS_TARGET,
+			svec2i(TILE_CACHE_CHUNK_SIZE * TILE_WIDTH,
+					TILE_CACHE_CHUNK_SIZE * TILE_HEIGHT), SDL_BLENDMODE_BLEND,
+			255);
+	c->Walls = TextureCreate(r, SDL_TEXTUREACCESS_TARGET,
+			svec2i(TILE_CACHE_CHUNK_SIZE * TILE_WIDTH,
+					TILE_CACHE_CHUNK_SIZE * TILE_CACHE_WALL_HEIGHT),
+			SDL_BLENDMODE_BLEND, 255);
+	if (c->Floor == NULL || c->Walls == NULL) {
+		// Likely no render target support; draw tiles directly from now on
+		LOG(LM_GFX, LL_WARN, "cannot create tile cache textures; disabling");
+		SDL_DestroyTexture(c->Floor);
+		SDL_DestroyTexture(c->Walls);
+		c->Floor = c->Walls = NULL;
+		tc->Enabled = false;
+		return false;
+	}
+	tc->NumRendered++;
+	return true;
+}
+
+static void SetTarget(SDL_Renderer *r, SDL_Texture *t);
+static void RenderPicCopy(SDL_Renderer *r, const Pic *p,
+		const struct vec2i pos);
+static void ChunkRender(TileCacheChunk *c, const Map *map,
+		const struct vec2i chunkStart) {
+	SDL_Renderer *r = gGraphicsDevice.gameWindow.renderer;
+	SpriteBatchFlush(&gSpriteBatch);
+	SDL_Texture *oldTarget = SDL_GetRenderTarget(r);
+	const Rect2i oldClip = GraphicsGetClip(r);
+	const Rect2i chunkRect = Rect2iNew(chunkStart,
+			svec2i(TILE_CACHE_CHUNK_SIZE, TILE_CACHE_CHUNK_SIZE));
+	c->Cacheable = true;
+
+	SetTarget(r, c->Floor);
+	RECT_FOREACH(chunkRect)
+		const Tile *t = MapGetTile(map, _v);
+		const Pic *pic = t != NULL ? TileGetFloorPic(t) : NULL;
+		if (pic == NULL) {
+			continue;
+		}
+		if (pic->size.x > TILE_WIDTH || pic->size.y > TILE_HEIGHT) {
+			c->Cacheable = false;
+			continue;
+		}
+		const struct vec2i v = svec2i_subtract(_v, chunkStart);
+		RenderPicCopy(r, pic, svec2i(v.x * TILE_WIDTH, v.y * TILE_HEIGHT));
+	RECT_FOREACH_END()
+
+	SetTarget(r, c->Walls);
+	RECT_FOREACH(chunkRect)
+		const Tile *t = MapGetTile(map, _v);
+		struct vec2i offset;
+		const Pic *pic = t != NULL ? TileGetWallPic(t, &offset) : NULL;
+		if (pic == NULL) {
+			continue;
+		}
+		// Strip is from TILE_CACHE_WALL_TOP to the bottom of the tile
+		offset.y -= TILE_CACHE_WALL_TOP;
+		if (offset.x < 0 || offset.x + pic->size.x > TILE_WIDTH
+				|| offset.y < 0
+				|| offset.y + pic->size.y > TILE_CACHE_WALL_HEIGHT) {
+			c->Cacheable = false;
+			continue;
+		}
+		const struct vec2i v = svec2i_subtract(_v, chunkStart);
+		RenderPicCopy(r, pic, svec2i_add(offset,
+				svec2i(v.x * TILE_WIDTH, v.y * TILE_CACHE_WALL_HEIGHT)));
+	RECT_FOREACH_END()
+
+	SetTarget(r, oldTarget);
+	GraphicsSetClip(r, oldClip);
+}
+static void SetTarget(SDL_Renderer *r, SDL_Texture *t) {
+	SpriteBatchFlush(&gSpriteBatch);
+	if (SDL_SetRenderTarget(r, t) != 0) {
+		LOG(LM_GFX, LL_ERROR, "cannot set render target: %s", SDL_GetError());
+	}
+	if (t == NULL) {
+		return;
+	}
+	if (SDL_SetRenderDrawColor(r, 0, 0, 0, 0) != 0) {
+		LOG(LM_GFX, LL_ERROR, "Failed to set draw color: %s", SDL_GetError());
+	}
+	if (SDL_RenderClear(r) != 0) {
+		LOG(LM_GFX, LL_ERROR, "Failed to clear renderer: %s", SDL_GetError());
+	}
+}
+static void RenderPicCopy(SDL_Renderer *r, const Pic *p,
+		const struct vec2i pos) {
+	// Pics in a layer don't overlap, so copy them as-is including alpha;
+	// blending happens when the chunk is drawn
+	SDL_SetTextureBlendMode(p->Tex, SDL_BLENDMODE_NONE);
+	TextureRender(p->Tex, r, Rect2iNew(p->TexPos, p->size),
+			Rect2iNew(pos, p->size), colorWhite, 0, SDL_FLIP_NONE);
+	SDL_SetTextureBlendMode(p->Tex, SDL_BLENDMODE_BLEND);
+}
+
+void TileCacheDrawRun(const TileCacheChunk *c, const TileCacheLayer layer,
+		const struct vec2i tilePos, const int numTiles, const struct vec2i pos,
+		const color_t mask) {
+	const struct vec2i v = svec2i(tilePos.x % TILE_CACHE_CHUNK_SIZE,
+			tilePos.y % TILE_CACHE_CHUNK_SIZE);
+	SDL_Texture *t;
+	Rect2i src, dest;
+	switch (layer) {
+	case TILE_CACHE_LAYER_FLOOR:
+		t = c->Floor;
+		src = Rect2iNew(svec2i(v.x * TILE_WIDTH, v.y * TILE_HEIGHT),
+				svec2i(numTiles * TILE_WIDTH, TILE_HEIGHT));
+		dest = Rect2iNew(pos, src.Size);
+		break;
+	case TILE_CACHE_LAYER_WALLS:
+		t = c->Walls;
+		src = Rect2iNew(svec2i(v.x * TILE_WIDTH, v.y * TILE_CACHE_WALL_HEIGHT),
+				svec2i(numTiles * TILE_WIDTH, TILE_CACHE_WALL_HEIGHT));
+		dest = Rect2iNew(svec2i_add(pos, svec2i(0, TILE_CACHE_WALL_TOP)),
+				src.Size);
+		break;
+	default:
+		CASSERT(false, "unknown tile cache layer");
+		return;
+	}
+	SDL_Renderer *r = gGraphicsDevice.gameWindow.renderer;
+	if (!SpriteBatchAdd(&gSpriteBatch, r, t, src, dest, mask, 0,
+			SDL_FLIP_NONE)) {
+		TextureRender(t, r, src, dest, mask, 0, SDL_FLIP_NONE);
+	}
+}
@@ -0,0 +1,92 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <SDL2/SDL_render.h>
+
+#include "c_array.h"
+#include "color.h"
+#include "map.h"
+
+// Square chunk of map tiles whose floor and wall pics are pre-rendered
+#define TILE_CACHE_CHUNK_SIZE 16
+// Most chunks kept rendered at once; the least recently drawn are recycled
+#define TILE_CACHE_MAX_CHUNKS 48
+// Each tile row has a strip in the wall layer, tall enough for the wall and
+// door pics which extend up into the row above
+#define TILE_CACHE_WALL_TOP TILE_WALL_OFFSET_Y
+#define TILE_CACHE_WALL_HEIGHT (TILE_HEIGHT * 2)
+
+typedef enum {
+	TILE_CACHE_LAYER_FLOOR,
+	TILE_CACHE_LAYER_WALLS
+} TileCacheLayer;
+
+typedef struct {
+	SDL_Texture *Floor;
+	SDL_Texture *Walls;
+	bool Dirty;
+	// Chunks with oversized pics are always drawn tile by tile
+	bool Cacheable;
+	int LastUsed;
+} TileCacheChunk;
+
+// Pre-rendered floor and wall layers for map chunks, so that drawing the map
+// takes a few texture copies per row instead of one per tile.
+// Line of sight is not baked in but applied as a colour mask when drawing,
+// so that split screens with different views can share the same chunks.
+typedef struct {
+	bool Enabled;
+	struct vec2i Size;	// in chunks
+	CArray Chunks;	// of TileCacheChunk
+	int NumRendered;
+	int counter;
+} TileCache;
+
+extern TileCache gTileCache;
+
+void TileCacheInit(TileCache *tc);
+void TileCacheTerminate(TileCache *tc);
+// Set up for a new map; all chunks start dirty
+void TileCacheSetMapSize(TileCache *tc, const struct vec2i mapSize);
+// Forget all textures without destroying them, for when the renderer that
+// owned them has already been destroyed
+void TileCacheReset(TileCache *tc);
+// Call when a tile changes appearance, e.g. its class is set or a door opens
+void TileCacheInvalidate(TileCache *tc, const struct vec2i tilePos);
+
+// Get the up-to-date chunk containing a tile, rendering it if needed.
+// Returns NULL if the tile must be drawn directly.
+const TileCacheChunk *TileCacheGetChunk(TileCache *tc, const Map *map,
+		const struct vec2i tilePos);
+// Draw a horizontal run of tiles from a chunk layer; pos is the screen
+// position of the first tile
+void TileCacheDrawRun(const TileCacheChunk *c, const TileCacheLayer layer,
+		const struct vec2i tilePos, const int numTiles, const struct vec2i pos,
+		const color_t mask);
@@ -25,6 +25,7 @@
  */
 #include "font.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -36,6 +37,7 @@
 
 #include "blit.h"
 #include "pic.h"
+#include "pic_manager.h"
 #include "sys_config.h"
 #include "utils.h"
 
@@ -44,6 +46,41 @@
 
 Font gFont;
 
+// Laid out strings are cached, as most text is drawn unchanged frame after
+// frame; once full the cache is simply emptied
+#define LAYOUT_BUCKETS 64
+#define LAYOUT_MAX 256
+typedef struct {
+	int Idx;
+	struct vec2i Pos;
+} FontGlyph;
+typedef struct FontLayout {
+	uint32_t hash;
+	int width;
+	char *text;
+	CArray Glyphs;	// of FontGlyph
+	// Cursor position after the last glyph
+	struct vec2i End;
+	struct vec2i Size;
+	struct FontLayout *next;
+} FontLayout;
+static FontLayout *layouts[LAYOUT_BUCKETS];
+static int numLayouts = 0;
+static void LayoutsClear(void) {
+	for (int i = 0; i < LAYOUT_BUCKETS; i++) {
+		FontLayout *l = layouts[i];
+		while (l != NULL) {
+			FontLayout *next = l->next;
+			CFREE(l->text);
+			CArrayTerminate(&l->Glyphs);
+			CFREE(l);
+			l = next;
+		}
+		layouts[i] = NULL;
+	}
+	numLayouts = 0;
+}
+
 FontOpts FontOptsNew(void) {
 	FontOpts opts;
 	memset(&opts, 0, sizeof opts);
@@ -72,6 +109,7 @@ void FontLoad(Font *f, const char *imgPath, const bool isProportional,
 	}
 
 	CArrayInit(&f->Chars, sizeof(Pic));
+	LayoutsClear();
 
 	// Check that the image is big enough for the dimensions
 	step = svec2i(f->Size.x + f->Padding.Left + f->Padding.Right,
@@ -103,6 +141,10 @@ void FontLoad(Font *f, const char *imgPath, const bool isProportional,
 			} else if (isProportional) {
 				PicTrim(&p, true, false);
 			}
+			// Share pages with other pics so that strings draw in a batch
+			if (!PicIsNone(&p)) {
+				AtlasAdd(&gPicManager.atlas, &p, false);
+			}
 			CArrayPushBack(&f->Chars, &p);
 		}
 	}
@@ -111,6 +153,7 @@ void FontLoad(Font *f, const char *imgPath, const bool isProportional,
 	bail: SDL_FreeSurface(image);
 }
 void FontTerminate(Font *f) {
+	LayoutsClear();
 	CA_FOREACH(Pic, p, f->Chars)
 		PicFree(p);
 	CA_FOREACH_END()
@@ -178,8 +221,7 @@ int FontStrNumLines(const char *s) {
 struct vec2i FontCh(const char c, const struct vec2i pos) {
 	return FontChMask(c, pos, colorWhite);
 }
-struct vec2i FontChMask(const char c, const struct vec2i pos,
-		const color_t mask) {
+static int GetCharIdx(const char c) {
 	int idx = (int) c - FIRST_CHAR;
 	if (idx < 0) {
 		idx += 256;
@@ -188,52 +230,121 @@ struct vec2i FontChMask(const char c, const struct vec2i pos,
 		fprintf(stderr, "invalid char %d\n", idx);
 		idx = FIRST_CHAR;
 	}
-	const Pic *pic = static_cast<const Pic*>(CArrayGet(&gFont.Chars, idx));
+	return idx;
+}
+struct vec2i FontChMask(const char c, const struct vec2i pos,
+		const color_t mask) {
+	const Pic *pic = static_cast<const Pic*>(CArrayGet(&gFont.Chars,
+			GetCharIdx(c)));
 	PicRender(pic, gGraphicsDevice.gameWindow.renderer, pos, mask, 0,
 			svec2_one(), SDL_FLIP_NONE, Rect2iZero());
 	// Add gap between characters
 	return svec2i(pos.x + pic->size.x + gFont.Gap.x, pos.y);
 }
-struct vec2i FontStr(const char *s, struct vec2i pos) {
-	return FontStrMask(s, pos, colorWhite);
+
+static uint32_t LayoutHash(const char *s, const int width) {
+	// FNV-1a
+	uint32_t hash = 2166136261u ^ (uint32_t) width;
+	for (; *s; s++) {
+		hash = (hash ^ (uint8_t) *s) * 16777619u;
+	}
+	return hash;
 }
-struct vec2i FontStrMask(const char *s, struct vec2i pos, const color_t mask) {
-	if (s == NULL) {
-		return pos;
+static FontLayout *LayoutNew(const char *s, const int width,
+		const uint32_t hash);
+// Get the glyph positions of a string, wrapped to width if non-zero
+static const FontLayout *LayoutGet(const char *s, const int width) {
+	const uint32_t hash = LayoutHash(s, width);
+	FontLayout **bucket = &layouts[hash % LAYOUT_BUCKETS];
+	for (const FontLayout *l = *bucket; l != NULL; l = l->next) {
+		if (l->hash == hash && l->width == width && strcmp(l->text, s) == 0) {
+			return l;
+		}
 	}
-	int left = pos.x;
-	while (*s) {
+	if (numLayouts >= LAYOUT_MAX) {
+		LayoutsClear();
+	}
+	FontLayout *l = LayoutNew(s, width, hash);
+	l->next = *bucket;
+	*bucket = l;
+	numLayouts++;
+	return l;
+}
+static FontLayout *LayoutNew(const char *s, const int width,
+		const uint32_t hash) {
+	FontLayout *l;
+	CCALLOC(l, sizeof *l);
+	l->hash = hash;
+	l->width = width;
+	CSTRDUP(l->text, s);
+	CArrayInit(&l->Glyphs, sizeof(FontGlyph));
+	char buf[1024];
+	if (width > 0) {
+		CASSERT(strlen(s) < 1024, "string too long to wrap");
+		FontSplitLines(s, buf, width);
+		s = buf;
+	}
+	l->Size = FontStrSize(s);
+	struct vec2i pos = svec2i_zero();
+	for (; *s; s++) {
 		if (*s == '\n') {
-			pos.x = left;
+			pos.x = 0;
 			pos.y += FontH();
-		} else {
-			pos = FontChMask(*s, pos, mask);
+			continue;
 		}
-		s++;
+		FontGlyph g;
+		g.Idx = GetCharIdx(*s);
+		g.Pos = pos;
+		CArrayPushBack(&l->Glyphs, &g);
+		const Pic *pic = static_cast<const Pic*>(CArrayGet(&gFont.Chars,
+				g.Idx));
+		// Add gap between characters
+		pos.x += pic->size.x + gFont.Gap.x;
+	}
+	l->End = pos;
+	return l;
+}
+static struct vec2i LayoutDraw(const FontLayout *l, const struct vec2i pos,
+		const color_t mask) {
+	SDL_Renderer *r = gGraphicsDevice.gameWindow.renderer;
+	CA_FOREACH(const FontGlyph, g, l->Glyphs)
+		const Pic *pic = static_cast<const Pic*>(CArrayGet(&gFont.Chars,
+				g->Idx));
+		PicRender(pic, r, svec2i_add(pos, g->Pos), mask, 0, svec2_one(),
+				SDL_FLIP_NONE, Rect2iZero());
+	CA_FOREACH_END()
+	return svec2i_add(pos, l->End);
+}
+
+struct vec2i FontStr(const char *s, struct vec2i pos) {
+	return FontStrMask(s, pos, colorWhite);
+}
+struct vec2i FontStrMask(const char *s, struct vec2i pos, const color_t mask) {
+	if (s == NULL || *s == '\0') {
+		return pos;
 	}
-	return pos;
+	return LayoutDraw(LayoutGet(s, 0), pos, mask);
 }
 struct vec2i FontStrMaskWrap(const char *s, struct vec2i pos, color_t mask,
 		const int width) {
-	char buf[1024];
-	CASSERT(strlen(s) < 1024, "string too long to wrap");
-	FontSplitLines(s, buf, width);
-	return FontStrMask(buf, pos, mask);
+	if (*s == '\0') {
+		return pos;
+	}
+	return LayoutDraw(LayoutGet(s, width), pos, mask);
 }
-static struct vec2i GetStrPos(const char *s, struct vec2i pos,
+static struct vec2i GetStrPos(const struct vec2i textSize, struct vec2i pos,
 		const FontOpts opts);
 void FontStrOpt(const char *s, struct vec2i pos, const FontOpts opts) {
-	if (s == NULL) {
+	if (s == NULL || *s == '\0') {
 		return;
 	}
-	pos = GetStrPos(s, pos, opts);
-	FontStrMask(s, pos, opts.Mask);
+	const FontLayout *l = LayoutGet(s, 0);
+	LayoutDraw(l, GetStrPos(l->Size, pos, opts), opts.Mask);
 }
 static int GetAlign(const FontAlign align, const int pos, const int pad,
 		const int area, const int size);
-static struct vec2i GetStrPos(const char *s, struct vec2i pos,
+static struct vec2i GetStrPos(const struct vec2i textSize, struct vec2i pos,
 		const FontOpts opts) {
-	const struct vec2i textSize = FontStrSize(s);
 	return svec2i(
 			GetAlign(opts.HAlign, pos.x, opts.Pad.x, opts.Area.x, textSize.x),
 			GetAlign(opts.VAlign, pos.y, opts.Pad.y, opts.Area.y, textSize.y));
@@ -25,15 +25,15 @@
  */
 #include "font_utils.h"
 
+#include "json_utils.h"
 #include "log.h"
 #include "sys_config.h"
-#include "yajl_utils.h"
 
 void FontLoadFromJSON(Font *f, const char *imgPath, const char *jsonPath) {
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, jsonPath);
-	yajl_val node = YAJLReadFile(buf);
-	yajl_val paddingNode;
+	json_t *node = JSONReadFile(buf);
+	json_t *paddingNode;
 	bool proportional;
 	struct vec2i spaceSize;
 	if (node == NULL) {
@@ -43,29 +43,29 @@ void FontLoadFromJSON(Font *f, const char *imgPath, const char *jsonPath) {
 
 	memset(f, 0, sizeof *f);
 	// Load definitions from JSON data
-	YAJLVec2i(&f->Size, node, "Size");
-	YAJLInt(&f->Stride, node, "Stride");
+	LoadVec2i(&f->Size, node, "Size");
+	LoadInt(&f->Stride, node, "Stride");
 
 	// Padding order is: left/top/right/bottom
-	paddingNode = YAJLFindNode(node, "Padding");
-	if (YAJL_GET_ARRAY(paddingNode) != NULL) {
-		f->Padding.Left = (int) YAJL_GET_INTEGER(
-				YAJL_GET_ARRAY(paddingNode)->values[0]);
-		f->Padding.Top = (int) YAJL_GET_INTEGER(
-				YAJL_GET_ARRAY(paddingNode)->values[1]);
-		f->Padding.Right = (int) YAJL_GET_INTEGER(
-				YAJL_GET_ARRAY(paddingNode)->values[2]);
-		f->Padding.Bottom = (int) YAJL_GET_INTEGER(
-				YAJL_GET_ARRAY(paddingNode)->values[3]);
+	paddingNode = JSONFindNode(node, "Padding");
+	if (paddingNode != NULL && paddingNode->type == JSON_ARRAY) {
+		paddingNode = paddingNode->child;
+		f->Padding.Left = atoi(paddingNode->text);
+		paddingNode = paddingNode->next;
+		f->Padding.Top = atoi(paddingNode->text);
+		paddingNode = paddingNode->next;
+		f->Padding.Right = atoi(paddingNode->text);
+		paddingNode = paddingNode->next;
+		f->Padding.Bottom = atoi(paddingNode->text);
 	}
 
-	YAJLVec2i(&f->Gap, node, "Gap");
+	LoadVec2i(&f->Gap, node, "Gap");
 	proportional = false;
-	YAJLBool(&proportional, node, "Proportional");
+	LoadBool(&proportional, node, "Proportional");
 	spaceSize = f->Size;
-	YAJLVec2i(&spaceSize, node, "SpaceSize");
+	LoadVec2i(&spaceSize, node, "SpaceSize");
 
 	FontLoad(f, imgPath, proportional, spaceSize);
 
-	bail: yajl_tree_free(node);
+	bail: json_free_value(&node);
 }
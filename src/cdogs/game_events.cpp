@@ -129,6 +129,117 @@ static GameEventEntry sGameEventEntries[] =
 				{ GAME_EVENT_MISSION_PICKUP, true, false, true, true, NULL }, {
 						GAME_EVENT_MISSION_END, true, false, true, true,
 						NMissionEnd_fields } };
+const char* GameEventTypeStr(const GameEventType e) {
+	switch (e) {
+	T2S(GAME_EVENT_NONE, "None")
+		;
+	T2S(GAME_EVENT_CLIENT_CONNECT, "ClientConnect")
+		;
+	T2S(GAME_EVENT_CLIENT_ID, "ClientId")
+		;
+	T2S(GAME_EVENT_CAMPAIGN_DEF, "CampaignDef")
+		;
+	T2S(GAME_EVENT_PLAYER_DATA, "PlayerData")
+		;
+	T2S(GAME_EVENT_PLAYER_REMOVE, "PlayerRemove")
+		;
+	T2S(GAME_EVENT_TILE_SET, "TileSet")
+		;
+	T2S(GAME_EVENT_THING_DAMAGE, "ThingDamage")
+		;
+	T2S(GAME_EVENT_MAP_OBJECT_ADD, "MapObjectAdd")
+		;
+	T2S(GAME_EVENT_MAP_OBJECT_REMOVE, "MapObjectRemove")
+		;
+	T2S(GAME_EVENT_CLIENT_READY, "ClientReady")
+		;
+	T2S(GAME_EVENT_NET_GAME_START, "NetGameStart")
+		;
+	T2S(GAME_EVENT_CONFIG, "Config")
+		;
+	T2S(GAME_EVENT_SCORE, "Score")
+		;
+	T2S(GAME_EVENT_SOUND_AT, "SoundAt")
+		;
+	T2S(GAME_EVENT_SCREEN_SHAKE, "ScreenShake")
+		;
+	T2S(GAME_EVENT_SET_MESSAGE, "SetMessage")
+		;
+	T2S(GAME_EVENT_GAME_START, "GameStart")
+		;
+	T2S(GAME_EVENT_GAME_BEGIN, "GameBegin")
+		;
+	T2S(GAME_EVENT_ACTOR_ADD, "ActorAdd")
+		;
+	T2S(GAME_EVENT_ACTOR_MOVE, "ActorMove")
+		;
+	T2S(GAME_EVENT_ACTOR_STATE, "ActorState")
+		;
+	T2S(GAME_EVENT_ACTOR_DIR, "ActorDir")
+		;
+	T2S(GAME_EVENT_ACTOR_SLIDE, "ActorSlide")
+		;
+	T2S(GAME_EVENT_ACTOR_IMPULSE, "ActorImpulse")
+		;
+	T2S(GAME_EVENT_ACTOR_SWITCH_GUN, "ActorSwitchGun")
+		;
+	T2S(GAME_EVENT_ACTOR_PICKUP_ALL, "ActorPickupAll")
+		;
+	T2S(GAME_EVENT_ACTOR_REPLACE_GUN, "ActorReplaceGun")
+		;
+	T2S(GAME_EVENT_ACTOR_HEAL, "ActorHeal")
+		;
+	T2S(GAME_EVENT_ACTOR_ADD_AMMO, "ActorAddAmmo")
+		;
+	T2S(GAME_EVENT_ACTOR_USE_AMMO, "ActorUseAmmo")
+		;
+	T2S(GAME_EVENT_ACTOR_DIE, "ActorDie")
+		;
+	T2S(GAME_EVENT_ACTOR_MELEE, "ActorMelee")
+		;
+	T2S(GAME_EVENT_ADD_PICKUP, "AddPickup")
+		;
+	T2S(GAME_EVENT_REMOVE_PICKUP, "RemovePickup")
+		;
+	T2S(GAME_EVENT_BULLET_BOUNCE, "BulletBounce")
+		;
+	T2S(GAME_EVENT_REMOVE_BULLET, "RemoveBullet")
+		;
+	T2S(GAME_EVENT_PARTICLE_REMOVE, "ParticleRemove")
+		;
+	T2S(GAME_EVENT_GUN_FIRE, "GunFire")
+		;
+	T2S(GAME_EVENT_GUN_RELOAD, "GunReload")
+		;
+	T2S(GAME_EVENT_GUN_STATE, "GunState")
+		;
+	T2S(GAME_EVENT_ADD_BULLET, "AddBullet")
+		;
+	T2S(GAME_EVENT_ADD_PARTICLE, "AddParticle")
+		;
+	T2S(GAME_EVENT_TRIGGER, "Trigger")
+		;
+	T2S(GAME_EVENT_EXPLORE_TILES, "ExploreTiles")
+		;
+	T2S(GAME_EVENT_RESCUE_CHARACTER, "RescueCharacter")
+		;
+	T2S(GAME_EVENT_OBJECTIVE_UPDATE, "ObjectiveUpdate")
+		;
+	T2S(GAME_EVENT_ADD_KEYS, "AddKeys")
+		;
+	T2S(GAME_EVENT_MISSION_COMPLETE, "MissionComplete")
+		;
+	T2S(GAME_EVENT_MISSION_INCOMPLETE, "MissionIncomplete")
+		;
+	T2S(GAME_EVENT_MISSION_PICKUP, "MissionPickup")
+		;
+	T2S(GAME_EVENT_MISSION_END, "MissionEnd")
+		;
+	default:
+		return "";
+	}
+}
+
 GameEventEntry GameEventGetEntry(const GameEventType e) {
 	return sGameEventEntries[(int) e];
 }
@@ -103,8 +103,11 @@ typedef enum {
 	GAME_EVENT_MISSION_INCOMPLETE,
 	// In pickup area
 	GAME_EVENT_MISSION_PICKUP,
-	GAME_EVENT_MISSION_END
+	GAME_EVENT_MISSION_END,
+
+	GAME_EVENT_COUNT
 } GameEventType;
+const char* GameEventTypeStr(const GameEventType e);
 
 // Which game events should be passed along to server or client
 typedef struct {
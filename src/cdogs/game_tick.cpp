@@ -0,0 +1,325 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "game_tick.h"
+
+#include <SDL2/SDL_timer.h>
+
+#include "actors.h"
+#include "ai.h"
+#include "ai_coop.h"
+#include "ammo.h"
+#include "events.h"
+#include "game_events.h"
+#include "handle_game_events.h"
+#include "log.h"
+#include "los.h"
+#include "net_client.h"
+#include "net_predict.h"
+#include "objs.h"
+#include "particle.h"
+#include "pickup.h"
+#include "player.h"
+#include "profiler.h"
+#include "replay.h"
+#include "triggers.h"
+
+// Also the profiler zone names
+static const char *sectionNames[GAME_TICK_COUNT] = { "players", "los", "ai",
+		"actors", "objects", "bullets", "pickups", "particles", "triggers",
+		"mission", "events" };
+const char *GameTickSectionStr(const GameTickSection s) {
+	return sectionNames[s];
+}
+
+void GameTickInit(
+	GameTick *gt, struct MissionOptions *m, Map *map, Camera *camera) {
+	memset(gt, 0, sizeof *gt);
+	gt->m = m;
+	gt->map = map;
+	gt->camera = camera;
+	HealthSpawnerInit(&gt->healthSpawner, map);
+	CArrayInit(&gt->ammoSpawners, sizeof(PowerupSpawner));
+	for (int i = 0; i < AmmoGetNumClasses(&gAmmo); i++) {
+		PowerupSpawner ps;
+		AmmoSpawnerInit(&ps, map, i);
+		CArrayPushBack(&gt->ammoSpawners, &ps);
+	}
+}
+void GameTickTerminate(GameTick *gt) {
+	PowerupSpawnerTerminate(&gt->healthSpawner);
+	CA_FOREACH(PowerupSpawner, a, gt->ammoSpawners)
+		PowerupSpawnerTerminate(a);
+	CA_FOREACH_END()
+	CArrayTerminate(&gt->ammoSpawners);
+}
+
+static void SectionBegin(GameTick *gt, const GameTickSection s) {
+	PROFILE_BEGIN(sectionNames[s]);
+	if (gt->RecordTimes) {
+		gt->sectionStarts[s] = SDL_GetPerformanceCounter();
+	}
+}
+static void SectionEnd(GameTick *gt, const GameTickSection s) {
+	if (gt->RecordTimes) {
+		gt->SectionTimes[s] +=
+				SDL_GetPerformanceCounter() - gt->sectionStarts[s];
+	}
+	PROFILE_END();
+}
+
+static void UpdatePlayers(GameTick *gt, int *cmds, const int ticks);
+static void PullPlayersToCenter(void);
+static void CheckMissionCompletion(const struct MissionOptions *mo);
+void GameTickUpdate(GameTick *gt, int *cmds, const int ticks) {
+	if (gt->RecordTimes) {
+		memset(gt->SectionTimes, 0, sizeof gt->SectionTimes);
+	}
+
+	// Check if game can begin
+	if (!gt->m->HasBegun && MissionCanBegin()) {
+		GameEvent begin = GameEventNew(GAME_EVENT_GAME_BEGIN);
+		begin.u.GameBegin.MissionTime = gt->m->time;
+		GameEventsEnqueue(&gGameEvents, begin);
+	}
+
+	// Set mission complete and display exit if it is complete
+	MissionSetMessageIfComplete(gt->m);
+
+	SectionBegin(gt, GAME_TICK_PLAYERS);
+	UpdatePlayers(gt, cmds, ticks);
+	SectionEnd(gt, GAME_TICK_PLAYERS);
+
+	if (!gCampaign.IsClient) {
+		SectionBegin(gt, GAME_TICK_AI);
+		gt->aiUpdateCounter -= ticks;
+		if (gt->aiUpdateCounter <= 0) {
+			const int enemies = AICommand(ticks);
+			AIAddRandomEnemies(enemies, gt->m->missionData);
+			gt->aiUpdateCounter = 4;
+		} else {
+			AICommandLast(ticks);
+		}
+		SectionEnd(gt, GAME_TICK_AI);
+	}
+
+	PullPlayersToCenter();
+
+	SectionBegin(gt, GAME_TICK_ACTORS);
+	UpdateAllActors(ticks);
+	NetPredictUpdate(ticks);
+	SectionEnd(gt, GAME_TICK_ACTORS);
+	SectionBegin(gt, GAME_TICK_OBJECTS);
+	UpdateObjects(ticks);
+	SectionEnd(gt, GAME_TICK_OBJECTS);
+	SectionBegin(gt, GAME_TICK_BULLETS);
+	UpdateMobileObjects(ticks);
+	SectionEnd(gt, GAME_TICK_BULLETS);
+	SectionBegin(gt, GAME_TICK_PICKUPS);
+	PickupsUpdate(&gPickups, ticks);
+	SectionEnd(gt, GAME_TICK_PICKUPS);
+	SectionBegin(gt, GAME_TICK_PARTICLES);
+	ParticlesUpdate(&gParticles, ticks);
+	SectionEnd(gt, GAME_TICK_PARTICLES);
+
+	SectionBegin(gt, GAME_TICK_TRIGGERS);
+	UpdateWatches(&gt->map->triggers, ticks);
+	SectionEnd(gt, GAME_TICK_TRIGGERS);
+
+	SectionBegin(gt, GAME_TICK_MISSION);
+	PowerupSpawnerUpdate(&gt->healthSpawner, ticks);
+	CA_FOREACH(PowerupSpawner, a, gt->ammoSpawners)
+		PowerupSpawnerUpdate(a, ticks);
+	CA_FOREACH_END()
+
+	if (!gCampaign.IsClient) {
+		CheckMissionCompletion(gt->m);
+	} else if (!NetClientIsConnected(&gNetClient)) {
+		// Check if disconnected from server; end mission
+		const NMissionEnd me = NMissionEnd_init_zero;
+		MissionDone(gt->m, me);
+	}
+	SectionEnd(gt, GAME_TICK_MISSION);
+
+	SectionBegin(gt, GAME_TICK_EVENTS);
+	HandleGameEvents(&gGameEvents, gt->camera, &gt->healthSpawner,
+			&gt->ammoSpawners);
+	SectionEnd(gt, GAME_TICK_EVENTS);
+
+	gt->m->time += ticks;
+
+	ReplayEndTick(&gReplay);
+}
+
+static void PlayerSpecialCommands(TActor *actor, const int cmd);
+static void UpdatePlayers(GameTick *gt, int *cmds, const int ticks) {
+	if (gPlayerDatas.size == 0) {
+		return;
+	}
+	LOSReset(&gt->map->LOS);
+	for (int i = 0, idx = 0; i < (int) gPlayerDatas.size; i++, idx++) {
+		const PlayerData *p = static_cast<const PlayerData*>(CArrayGet(
+				&gPlayerDatas, i));
+		if (p->ActorUID == -1)
+			continue;
+		TActor *player = ActorGetByUID(p->ActorUID);
+		if (player->dead > DEATH_MAX)
+			continue;
+		// Calculate LOS for all players alive or dying
+		SectionBegin(gt, GAME_TICK_LOS);
+		LOSCalcFrom(gt->map, Vec2ToTile(player->thing.Pos),
+				!gCampaign.IsClient);
+		SectionEnd(gt, GAME_TICK_LOS);
+
+		if (player->dead)
+			continue;
+
+		// Only handle inputs/commands for local players
+		if (!p->IsLocal) {
+			idx--;
+			continue;
+		}
+		if (p->inputDevice == INPUT_DEVICE_AI) {
+			cmds[idx] = AICoopGetCmd(player, ticks);
+		}
+		ReplayCmd(&gReplay, &cmds[idx]);
+		PlayerSpecialCommands(player, cmds[idx]);
+		CommandActor(player, cmds[idx], ticks);
+		NetPredictRecordInput(player);
+	}
+}
+static void PlayerSpecialCommands(TActor *actor, const int cmd) {
+	if ((cmd & CMD_BUTTON2) && CMD_HAS_DIRECTION(cmd)) {
+		if (ConfigGetEnum(&gConfig, "Game.SwitchMoveStyle")
+				== SWITCHMOVE_SLIDE) {
+			SlideActor(actor, cmd);
+		}
+	} else if ((actor->lastCmd & CMD_BUTTON2) && !(cmd & CMD_BUTTON2)
+			&& !actor->specialCmdDir && !actor->CanPickupSpecial
+			&& !(ConfigGetEnum(&gConfig, "Game.SwitchMoveStyle")
+					== SWITCHMOVE_SLIDE && CMD_HAS_DIRECTION(cmd))) {
+		const PlayerData *p = PlayerDataGetByUID(actor->PlayerUID);
+		const bool allGuns = p == NULL || !PlayerHasGrenadeButton(p);
+		ActorTrySwitchWeapon(actor, allGuns);
+	}
+}
+
+// If split screen never and players are too close to the
+// edge of the screen, forcefully pull them towards the center
+static void PullPlayersToCenter(void) {
+	if (ConfigGetEnum(&gConfig, "Interface.Splitscreen") != SPLITSCREEN_NEVER
+			|| GetNumPlayers(PLAYER_ALIVE_OR_DYING, true, true) <= 1
+			|| IsPVP(gCampaign.Entry.Mode)) {
+		return;
+	}
+	const int w = gGraphicsDevice.cachedConfig.Res.x;
+	const int h = gGraphicsDevice.cachedConfig.Res.y;
+	const struct vec2i screen = svec2i_add(
+			svec2i_assign_vec2(PlayersGetMidpoint()),
+			svec2i(-w / 2, -h / 2));
+	CA_FOREACH(const PlayerData, pd, gPlayerDatas)
+		if (!pd->IsLocal || !IsPlayerAlive(pd)) {
+			continue;
+		}
+		const TActor *p = ActorGetByUID(pd->ActorUID);
+		const int pad = CAMERA_SPLIT_PADDING;
+		struct vec2 vel = svec2_zero();
+		if (screen.x + pad > p->thing.Pos.x && p->thing.Vel.x < 1) {
+			vel.x = screen.x + pad - p->thing.Pos.x;
+		} else if (screen.x + w - pad < p->thing.Pos.x
+				&& p->thing.Vel.x > -1) {
+			vel.x = screen.x + w - pad - p->thing.Pos.x;
+		}
+		if (screen.y + pad > p->thing.Pos.y && p->thing.Vel.y < 1) {
+			vel.y = screen.y + pad - p->thing.Pos.y;
+		} else if (screen.y + h - pad < p->thing.Pos.y
+				&& p->thing.Vel.y > -1) {
+			vel.y = screen.y + h - pad - p->thing.Pos.y;
+		}
+		if (!svec2_is_zero(vel)) {
+			GameEvent ei = GameEventNew(GAME_EVENT_ACTOR_IMPULSE);
+			ei.u.ActorImpulse.UID = p->uid;
+			ei.u.ActorImpulse.Vel = Vec2ToNet(svec2_scale(vel, 0.25f));
+			ei.u.ActorImpulse.Pos = Vec2ToNet(svec2_zero());
+			GameEventsEnqueue(&gGameEvents, ei);
+			LOG(LM_MAIN, LL_TRACE,
+					"playerUID(%d) pos(%f, %f) screen(%d, %d) impulse(%f, %f)",
+					p->uid, p->thing.Pos.x, p->thing.Pos.y, screen.x,
+					screen.y, ei.u.ActorImpulse.Vel.x,
+					ei.u.ActorImpulse.Vel.y);
+		}
+	CA_FOREACH_END()
+}
+
+static void CheckMissionCompletion(const struct MissionOptions *mo) {
+	// Check if we need to update explore objectives
+	CA_FOREACH(const Objective, o, mo->missionData->Objectives)
+		if (o->Type != OBJECTIVE_INVESTIGATE)
+			continue;
+		const int update = MapGetExploredPercentage(&gMap) - o->done;
+		if (update > 0 && !gCampaign.IsClient) {
+			GameEvent e = GameEventNew(GAME_EVENT_OBJECTIVE_UPDATE);
+			e.u.ObjectiveUpdate.ObjectiveId = _ca_index;
+			e.u.ObjectiveUpdate.Count = update;
+			GameEventsEnqueue(&gGameEvents, e);
+		}CA_FOREACH_END()
+
+	const bool isMissionComplete = GetNumPlayers(PLAYER_ALIVE_OR_DYING, false,
+			false) > 0 && IsMissionComplete(mo);
+	if (mo->state == MISSION_STATE_PLAY && isMissionComplete) {
+		GameEvent e = GameEventNew(GAME_EVENT_MISSION_PICKUP);
+		GameEventsEnqueue(&gGameEvents, e);
+	}
+	if (mo->state == MISSION_STATE_PICKUP && !isMissionComplete) {
+		GameEvent e = GameEventNew(GAME_EVENT_MISSION_INCOMPLETE);
+		GameEventsEnqueue(&gGameEvents, e);
+	}
+	if (mo->state == MISSION_STATE_PICKUP
+			&& mo->pickupTime + PICKUP_LIMIT <= mo->time) {
+		GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
+		GameEventsEnqueue(&gGameEvents, e);
+	}
+
+	// Check that all players have been destroyed
+	// If the server has no players at all, wait for a player to join
+	if (gPlayerDatas.size > 0) {
+		// Note: there's a period of time where players are dying
+		// Wait until after this period before ending the game
+		bool allPlayersDestroyed = true;
+		CA_FOREACH(const PlayerData, p, gPlayerDatas)
+			if (p->ActorUID != -1) {
+				allPlayersDestroyed = false;
+				break;
+			}CA_FOREACH_END()
+		if (allPlayersDestroyed && AreAllPlayersDeadAndNoLives()) {
+			GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
+			e.u.MissionEnd.Delay = GAME_OVER_DELAY;
+			GameEventsEnqueue(&gGameEvents, e);
+		}
+	}
+}
@@ -0,0 +1,82 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <SDL2/SDL_stdinc.h>
+
+#include "c_array.h"
+#include "camera.h"
+#include "map.h"
+#include "mission.h"
+#include "powerup.h"
+
+// One simulation tick of a running mission: player commands, AI, actors,
+// things, triggers, spawners, mission completion and game events.
+// The game and the headless benchmark both run missions through this, so
+// that what is measured is what is played.
+
+typedef enum {
+	GAME_TICK_PLAYERS,
+	// LOS is calculated per player inside the players section
+	GAME_TICK_LOS,
+	GAME_TICK_AI,
+	GAME_TICK_ACTORS,
+	GAME_TICK_OBJECTS,
+	GAME_TICK_BULLETS,
+	GAME_TICK_PICKUPS,
+	GAME_TICK_PARTICLES,
+	GAME_TICK_TRIGGERS,
+	GAME_TICK_MISSION,
+	GAME_TICK_EVENTS,
+	GAME_TICK_COUNT
+} GameTickSection;
+const char *GameTickSectionStr(const GameTickSection s);
+
+typedef struct {
+	struct MissionOptions *m;
+	Map *map;
+	Camera *camera;
+	// Only update AI every 4 ticks
+	int aiUpdateCounter;
+	PowerupSpawner healthSpawner;
+	CArray ammoSpawners;	// of PowerupSpawner
+	// If set, the time spent in each section of the last tick is recorded
+	// in SectionTimes, in performance counter units
+	bool RecordTimes;
+	Uint64 SectionTimes[GAME_TICK_COUNT];
+	Uint64 sectionStarts[GAME_TICK_COUNT];
+} GameTick;
+
+void GameTickInit(
+	GameTick *gt, struct MissionOptions *m, Map *map, Camera *camera);
+void GameTickTerminate(GameTick *gt);
+
+// Run one tick; cmds are the commands of the local players, in local player
+// order, and are overwritten for AI players and replays
+void GameTickUpdate(GameTick *gt, int *cmds, const int ticks);
@@ -61,6 +61,7 @@
 #include "defs.h"
 #include "keyboard.h"
 #include "log.h"
+#include "mission_arena.h"
 #include "music.h"
 #include "objs.h"
 #include "pickup.h"
@@ -122,6 +123,8 @@ void MissionOptionsTerminate(struct MissionOptions *mo) {
 	PickupsTerminate();
 	ParticlesTerminate(&gParticles);
 	WatchesTerminate();
+	// Everything above that came from the arena is gone now
+	MissionArenaReset(&gMissionArena);
 	CA_FOREACH(PlayerData, p, gPlayerDatas)
 		p->ActorUID = -1;
 	CA_FOREACH_END()
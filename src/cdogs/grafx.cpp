@@ -61,10 +61,14 @@
 #endif
 #include <SDL2/SDL_mouse.h>
 
+#include "automap.h"
 #include "blit.h"
 #include "config.h"
 #include "defs.h"
 #include "draw/drawtools.h"
+#include "draw/sprite_batch.h"
+#include "draw/fog_mask.h"
+#include "draw/tile_cache.h"
 #include "font_utils.h"
 #include "grafx_bg.h"
 #include "log.h"
@@ -78,6 +82,14 @@ void GraphicsInit(GraphicsDevice *device, Config *c) {
 	memset(device, 0, sizeof *device);
 	GraphicsConfigSetFromConfig(&device->cachedConfig, c);
 	device->cachedConfig.RestartFlags = RESTART_ALL;
+	SpriteBatchTerminate(&gSpriteBatch);
+	SpriteBatchInit(&gSpriteBatch, ConfigGetBool(c, "Graphics.SpriteBatching"));
+	TileCacheTerminate(&gTileCache);
+	TileCacheInit(&gTileCache);
+	FogMasksTerminate();
+	FogMasksInit();
+	AutomapCacheTerminate(&gAutomapCache);
+	AutomapCacheInit(&gAutomapCache);
 }
 
 // Initialises the video subsystem.
@@ -121,6 +133,7 @@ void GraphicsInitialize(GraphicsDevice *g) {
 			windowDim.Pos = svec2i_zero();
 		}
 		LOG(LM_GFX, LL_DEBUG, "destroying previous renderer");
+		SpriteBatchFlush(&gSpriteBatch);
 		WindowContextDestroy(&g->gameWindow);
 		WindowContextDestroy(&g->secondWindow);
 		SDL_FreeFormat(g->Format);
@@ -145,6 +158,9 @@ void GraphicsInitialize(GraphicsDevice *g) {
 
 		// Need to reload textures due to them tied to the renderer (window)
 		PicManagerReloadTextures(&gPicManager);
+		TileCacheReset(&gTileCache);
+		FogMasksReset();
+		AutomapCacheReset(&gAutomapCache);
 		FontLoadFromJSON(&gFont, "graphics/font.png", "graphics/font.json");
 	}
 
@@ -268,6 +284,10 @@ void GraphicsInitialize(GraphicsDevice *g) {
 }
 
 void GraphicsTerminate(GraphicsDevice *g) {
+	SpriteBatchTerminate(&gSpriteBatch);
+	TileCacheTerminate(&gTileCache);
+	FogMasksTerminate();
+	AutomapCacheTerminate(&gAutomapCache);
 	SDL_FreeSurface(g->icon);
 	WindowContextDestroy(&g->gameWindow);
 	WindowContextDestroy(&g->secondWindow);
@@ -328,6 +348,7 @@ void GraphicsConfigSetFromConfig(GraphicsConfig *gc, Config *c) {
 }
 
 void GraphicsSetClip(SDL_Renderer *renderer, const Rect2i r) {
+	SpriteBatchFlush(&gSpriteBatch);
 	const SDL_Rect rect = { r.Pos.x, r.Pos.y, r.Size.x, r.Size.y };
 	if (SDL_RenderSetClipRect(renderer, Rect2iIsZero(r) ? NULL : &rect) != 0) {
 		LOG(LM_MAIN, LL_ERROR, "Could not set clip rect: %s", SDL_GetError());
@@ -341,6 +362,7 @@ Rect2i GraphicsGetClip(SDL_Renderer *renderer) {
 }
 
 void GraphicsResetClip(SDL_Renderer *renderer) {
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_RenderSetClipRect(renderer, NULL) != 0) {
 		LOG(LM_MAIN, LL_ERROR, "Could not reset clip rect: %s", SDL_GetError());
 	}
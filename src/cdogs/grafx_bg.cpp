@@ -31,6 +31,7 @@
 #include "ai.h"
 #include "draw/draw.h"
 #include "draw/drawtools.h"
+#include "draw/sprite_batch.h"
 #include "game_events.h"
 #include "handle_game_events.h"
 #include "log.h"
@@ -86,11 +87,13 @@ static void DrawBackgroundWithRenderer(GraphicsDevice *g, WindowContext *wc,
 					"renderer does not support render to texture");
 		}
 	}
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderTarget(wc->renderer, target) != 0) {
 		LOG(LM_GFX, LL_ERROR, "cannot set render target: %s", SDL_GetError());
 	}
 	wc->bkgMask = ColorTint(colorWhite, tint);
 	DrawBackground(g, src, buffer, &gMap, pos, extra);
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderTarget(wc->renderer, NULL) != 0) {
 		LOG(LM_GFX, LL_ERROR, "cannot set render target: %s", SDL_GetError());
 	}
@@ -0,0 +1,165 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "grid_codec.h"
+
+#include <string.h>
+
+#include "utils.h"
+
+static const char base64Chars[] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static size_t PutVarint(uint8_t *out, unsigned int v) {
+	size_t n = 0;
+	while (v >= 0x80) {
+		out[n++] = (uint8_t) (v | 0x80);
+		v >>= 7;
+	}
+	out[n++] = (uint8_t) v;
+	return n;
+}
+static bool GetVarint(const uint8_t *in, const size_t len, size_t *pos,
+		unsigned int *v) {
+	*v = 0;
+	// Values are at most 32 bits, i.e. 5 bytes
+	for (int shift = 0; shift < 35; shift += 7) {
+		if (*pos >= len) {
+			return false;
+		}
+		const uint8_t b = in[(*pos)++];
+		*v |= (unsigned int) (b & 0x7f) << shift;
+		if (!(b & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+char *GridEncode(const uint16_t *values, const int count) {
+	// Worst case is a run per value, 5 + 3 bytes each
+	uint8_t *rle;
+	CMALLOC(rle, (size_t) count * 8 + 1);
+	size_t len = 0;
+	for (int i = 0; i < count;) {
+		int run = 1;
+		while (i + run < count && values[i + run] == values[i]) {
+			run++;
+		}
+		len += PutVarint(rle + len, (unsigned int) run);
+		len += PutVarint(rle + len, values[i]);
+		i += run;
+	}
+
+	char *text;
+	CMALLOC(text, (len + 2) / 3 * 4 + 1);
+	char *out = text;
+	for (size_t i = 0; i < len; i += 3) {
+		const unsigned int b = (unsigned int) rle[i] << 16
+				| (i + 1 < len ? (unsigned int) rle[i + 1] << 8 : 0)
+				| (i + 2 < len ? rle[i + 2] : 0);
+		*out++ = base64Chars[(b >> 18) & 0x3f];
+		*out++ = base64Chars[(b >> 12) & 0x3f];
+		*out++ = i + 1 < len ? base64Chars[(b >> 6) & 0x3f] : '=';
+		*out++ = i + 2 < len ? base64Chars[b & 0x3f] : '=';
+	}
+	*out = '\0';
+	CFREE(rle);
+	return text;
+}
+
+static int Base64Value(const char c) {
+	if (c >= 'A' && c <= 'Z') {
+		return c - 'A';
+	} else if (c >= 'a' && c <= 'z') {
+		return c - 'a' + 26;
+	} else if (c >= '0' && c <= '9') {
+		return c - '0' + 52;
+	} else if (c == '+') {
+		return 62;
+	} else if (c == '/') {
+		return 63;
+	}
+	return -1;
+}
+bool GridDecode(CArray *values, const char *text, const int count) {
+	const size_t textLen = strlen(text);
+	if (textLen % 4 != 0) {
+		return false;
+	}
+	bool ok = false;
+	const size_t startSize = values->size;
+	int remaining = count;
+	uint8_t *rle;
+	CMALLOC(rle, textLen / 4 * 3 + 1);
+	size_t len = 0;
+	for (size_t i = 0; i < textLen; i += 4) {
+		const int a = Base64Value(text[i]);
+		const int b = Base64Value(text[i + 1]);
+		const int c = text[i + 2] == '=' ? 0 : Base64Value(text[i + 2]);
+		const int d = text[i + 3] == '=' ? 0 : Base64Value(text[i + 3]);
+		const bool isPadded = text[i + 2] == '=' || text[i + 3] == '=';
+		if (a < 0 || b < 0 || c < 0 || d < 0
+				|| (isPadded && i + 4 < textLen)
+				|| (text[i + 2] == '=' && text[i + 3] != '=')) {
+			goto bail;
+		}
+		const unsigned int v = a << 18 | b << 12 | c << 6 | d;
+		rle[len++] = (uint8_t) (v >> 16);
+		if (text[i + 2] != '=') {
+			rle[len++] = (uint8_t) (v >> 8);
+		}
+		if (text[i + 3] != '=') {
+			rle[len++] = (uint8_t) v;
+		}
+	}
+
+	CArrayReserve(values, values->size + count);
+	for (size_t pos = 0; pos < len;) {
+		unsigned int run, value;
+		if (!GetVarint(rle, len, &pos, &run)
+				|| !GetVarint(rle, len, &pos, &value)
+				|| run == 0 || run > (unsigned int) remaining || value > 0xffff) {
+			goto bail;
+		}
+		const uint16_t v16 = (uint16_t) value;
+		for (unsigned int i = 0; i < run; i++) {
+			CArrayPushBack(values, &v16);
+		}
+		remaining -= (int) run;
+	}
+	ok = remaining == 0;
+
+bail:
+	if (!ok) {
+		// Don't leave a partial grid
+		CArrayResize(values, startSize, NULL);
+	}
+	CFREE(rle);
+	return ok;
+}
@@ -30,7 +30,9 @@
 #include "actor_placement.h"
 #include "actors.h"
 #include "ai_utils.h"
+#include "automap.h"
 #include "damage.h"
+#include "draw/tile_cache.h"
 #include "events.h"
 #include "game_events.h"
 #include "joystick.h"
@@ -77,8 +79,11 @@ static void HandleGameEvent(const GameEvent e, Camera *camera,
 		const TileClass *tileClassAlt = StrTileClass(e.u.TileSet.ClassAltName);
 		for (int i = 0; i <= e.u.TileSet.RunLength; i++) {
 			Tile *t = MapGetTile(&gMap, pos);
-			t->Class = tileClass;
-			t->ClassAlt = tileClassAlt;
+			TileSetClass(t, tileClass);
+			TileSetClassAlt(t, tileClassAlt);
+			WatchesOnTileChanged(pos);
+			TileCacheInvalidate(&gTileCache, pos);
+			AutomapCacheInvalidate(&gAutomapCache, pos);
 			pos.x++;
 			if (pos.x == gMap.Size.x) {
 				pos.x = 0;
@@ -433,7 +438,7 @@ static void HandleGameEvent(const GameEvent e, Camera *camera,
 		break;
 	case GAME_EVENT_TRIGGER: {
 		const Tile *t = MapGetTile(&gMap, Net2Vec2i(e.u.TriggerEvent.Tile));
-		CA_FOREACH(Trigger *, tp, t->triggers)
+		CA_FOREACH(Trigger *, tp, *TileGetTriggers(t))
 			if ((*tp)->id == (int) e.u.TriggerEvent.ID) {
 				TriggerActivate(*tp, &gMap.triggers);
 				break;
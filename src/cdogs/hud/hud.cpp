@@ -41,9 +41,11 @@
 #include "game_events.h"
 #include "hud_defs.h"
 #include "mission.h"
+#include "net_stats.h"
 #include "pic_manager.h"
 #include "player.h"
 #include "player_hud.h"
+#include "profiler.h"
 
 void HUDInit(HUD *hud, GraphicsDevice *device, struct MissionOptions *mission) {
 	memset(hud, 0, sizeof *hud);
@@ -117,6 +119,7 @@ static void DrawMissionTime(HUD *hud);
 static void DrawObjectiveCounts(HUD *hud);
 void HUDDraw(HUD *hud, const input_device_e pausingDevice,
 		const bool controllerUnplugged, const int numViews) {
+	PROFILE_SCOPE("hud");
 	if (ConfigGetBool(&gConfig, "Graphics.ShowHUD")) {
 		DrawPlayerAreas(hud, numViews);
 
@@ -125,6 +128,13 @@ void HUDDraw(HUD *hud, const input_device_e pausingDevice,
 		if (ConfigGetBool(&gConfig, "Interface.ShowFPS")) {
 			FPSCounterDraw(&hud->fpsCounter);
 		}
+		if (ConfigGetBool(&gConfig, "Interface.ShowNetStats")) {
+			NetStatsDraw(&gNetStats);
+		}
+		if (gProfiler.Enabled
+				&& ConfigGetBool(&gConfig, "Interface.ShowProfiler")) {
+			ProfilerDraw(&gProfiler);
+		}
 		if (ConfigGetBool(&gConfig, "Interface.ShowTime")) {
 			WallClockDraw(&hud->clock);
 		}
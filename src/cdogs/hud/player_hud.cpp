@@ -537,7 +537,7 @@ static void DrawObjectiveCompass(GraphicsDevice *g, const struct vec2 playerPos,
 	for (tilePos.y = 0; tilePos.y < map->Size.y; tilePos.y++) {
 		for (tilePos.x = 0; tilePos.x < map->Size.x; tilePos.x++) {
 			Tile *tile = MapGetTile(map, tilePos);
-			CA_FOREACH(ThingId, tid, tile->things)
+			CA_FOREACH(ThingId, tid, *TileGetThings(tile))
 				Thing *ti = ThingIdGetThing(tid);
 				if (!(ti->flags & THING_OBJECTIVE)) {
 					continue;
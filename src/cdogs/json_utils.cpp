@@ -117,10 +117,10 @@ void LoadVec2i(struct vec2i *value, json_t *node, const char *name) {
 if (!TryLoadValue(&node, name)) {
 	return;
 }
-node = node->child;
-value->x = atoi(node->text);
-node = node->next;
-value->y = atoi(node->text);
+*value = JSONGetVec2i(node);
+}
+struct vec2i JSONGetVec2i(const json_t *node) {
+return svec2i(atoi(node->child->text), atoi(node->child->next->text));
 }
 void LoadVec2(struct vec2 *value, json_t *node, const char *name) {
 if (!TryLoadValue(&node, name)) {
@@ -244,3 +244,22 @@ if (f != NULL)
 	fclose(f);
 return res;
 }
+
+json_t* JSONReadFile(const char *filename) {
+json_t *root = NULL;
+enum json_error e;
+FILE *f = fopen(filename, "r");
+if (f == NULL) {
+	LOG(LM_MAIN, LL_ERROR, "Error reading JSON file '%s': %s", filename,
+			strerror(errno));
+	return NULL;
+}
+e = json_stream_parse(f, &root);
+fclose(f);
+if (e != JSON_OK) {
+	LOG(LM_MAIN, LL_ERROR, "Error parsing JSON file '%s': error(%d)",
+			filename, (int)e);
+	return NULL;
+}
+return root;
+}
@@ -48,6 +48,8 @@ void LoadDouble(double *value, json_t *node, const char *name);
 void LoadFloat(float *value, json_t *node, const char *name);
 void LoadFullInt(float *value, json_t *node, const char *name);
 void LoadVec2i(struct vec2i *value, json_t *node, const char *name);
+// Read an [x, y] array node
+struct vec2i JSONGetVec2i(const json_t *node);
 void LoadVec2(struct vec2 *value, json_t *node, const char *name);
 void LoadIntArray(CArray *a, const json_t *node, const char *name);
 
@@ -81,3 +83,5 @@ bool TryLoadValue(json_t **node, const char *name);
 	}
 
 bool TrySaveJSONFile(json_t *node, const char *filename);
+// Parse a whole JSON file; returns NULL on error
+json_t* JSONReadFile(const char *filename);
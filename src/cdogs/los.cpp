@@ -32,21 +32,12 @@
 #include "game_events.h"
 #include "net_util.h"
 
+// The arrays are in the map's arena, and released with it
 void LOSInit(Map *map) {
-	CArrayInit(&map->LOS.LOS, sizeof(bool));
-	CArrayInit(&map->LOS.Explored, sizeof(bool));
-	struct vec2i v;
-	for (v.y = 0; v.y < map->Size.y; v.y++) {
-		for (v.x = 0; v.x < map->Size.x; v.x++) {
-			const bool f = false;
-			CArrayPushBack(&map->LOS.LOS, &f);
-			CArrayPushBack(&map->LOS.Explored, &f);
-		}
-	}
-}
-void LOSTerminate(LineOfSight *los) {
-	CArrayTerminate(&los->LOS);
-	CArrayTerminate(&los->Explored);
+	const size_t size = map->Size.x * map->Size.y;
+	MissionArenaAllocArray(&map->arena, &map->LOS.LOS, sizeof(bool), size);
+	MissionArenaAllocArray(&map->arena, &map->LOS.Explored, sizeof(bool),
+			size);
 }
 
 // Reset lines of sight by setting all cells to unseen
@@ -182,7 +173,7 @@ static void SetLOSVisible(Map *map, const struct vec2i pos,
 	}
 	// Mark any actors on this tile as visible
 	// This affects some AI
-	CA_FOREACH(ThingId, tid, t->things)
+	CA_FOREACH(ThingId, tid, *TileGetThings(t))
 		const Thing *ti = ThingIdGetThing(tid);
 		if (ti->kind == KIND_CHARACTER) {
 			TActor *a = static_cast<TActor*>(CArrayGet(&gActors, ti->id));
@@ -32,7 +32,6 @@
 #include "map.h"
 
 void LOSInit(Map *map);
-void LOSTerminate(LineOfSight *los);
 void LOSReset(LineOfSight *los);
 void LOSSetAllVisible(LineOfSight *los);
 void LOSCalcFrom(Map *map, const struct vec2i pos, const bool explore);
@@ -55,9 +55,12 @@
 #include "actors.h"
 #include "algorithms.h"
 #include "ammo.h"
+#include "automap.h"
 #include "collision/collision.h"
 #include "config.h"
 #include "door.h"
+#include "draw/fog_mask.h"
+#include "draw/tile_cache.h"
 #include "game_events.h"
 #include "gamedata.h"
 #include "log.h"
@@ -140,6 +143,8 @@ static Tile* MapGetTileOfItem(Map *map, Thing *t) {
 }
 
 static void AddItemToTile(Thing *t, Tile *tile);
+static void OnTileThingsChanged(const Map *map, const Thing *t,
+		const struct vec2i pos);
 bool MapTryMoveThing(Map *map, Thing *t, const struct vec2 pos) {
 	// Check if we can move to new position
 	if (!MapIsPosIn(map, pos)) {
@@ -162,6 +167,7 @@ bool MapTryMoveThing(Map *map, Thing *t, const struct vec2 pos) {
 	// ...move and add to new tile
 	t->Pos = pos;
 	AddItemToTile(t, MapGetTile(map, t2));
+	OnTileThingsChanged(map, t, t2);
 	return true;
 }
 static void AddItemToTile(Thing *t, Tile *tile) {
@@ -170,7 +176,7 @@ static void AddItemToTile(Thing *t, Tile *tile) {
 	tid.Kind = t->kind;
 	CASSERT(tid.Id >= 0, "invalid ThingId");
 	CASSERT(tid.Kind >= 0 && tid.Kind <= KIND_PICKUP, "unknown thing kind");
-	CArrayPushBack(&tile->things, &tid);
+	TileAddThing(tile, tid);
 }
 
 void MapRemoveThing(Map *map, Thing *t) {
@@ -178,12 +184,20 @@ void MapRemoveThing(Map *map, Thing *t) {
 		return;
 	}
 	Tile *tile = MapGetTileOfItem(map, t);
-	CA_FOREACH(ThingId, tid, tile->things)
-		if (tid->Id == t->id && tid->Kind == t->kind) {
-			CArrayDelete(&tile->things, _ca_index);
-			return;
-		}CA_FOREACH_END()
-	CASSERT(false, "Did not find element to delete");
+	ThingId tid;
+	tid.Id = t->id;
+	tid.Kind = t->kind;
+	if (!TileRemoveThing(tile, tid)) {
+		CASSERT(false, "Did not find element to delete");
+	}
+	OnTileThingsChanged(map, t, Vec2ToTile(t->Pos));
+}
+// Watch conditions subscribe to tiles becoming clear; particles don't count
+static void OnTileThingsChanged(const Map *map, const Thing *t,
+		const struct vec2i pos) {
+	if (map == &gMap && t->kind != KIND_PARTICLE) {
+		WatchesOnTileChanged(pos);
+	}
 }
 
 struct vec2i MapGetRandomTile(const Map *map) {
@@ -207,13 +221,13 @@ static void MapChangeFloor(Map *map, const struct vec2i pos,
 	const Tile *tAbove = MapGetTile(map, svec2i(pos.x, pos.y - 1));
 	const int canSeeTileAbove = !(pos.y > 0 && TileIsOpaque(tAbove));
 	Tile *t = MapGetTile(map, pos);
-	if (t->Class->Type != TILE_CLASS_FLOOR) {
+	if (TileGetClass(t)->Type != TILE_CLASS_FLOOR) {
 		return;
 	}
-	if (!canSeeTileAbove) {
-		t->Class = shadow;
-	} else {
-		t->Class = normal;
+	TileSetClass(t, canSeeTileAbove ? normal : shadow);
+	if (map == &gMap) {
+		TileCacheInvalidate(&gTileCache, pos);
+		AutomapCacheInvalidate(&gAutomapCache, pos);
 	}
 }
 
@@ -387,45 +401,48 @@ int MapGetDoorKeycardFlag(Map *map, struct vec2i pos) {
 	return MapGetAccessLevel(map, svec2i(pos.x, pos.y + 1));
 }
 
-void MapTerminate(Map *map) {
+// Release everything but the arena's blocks
+static void MapRelease(Map *map) {
 	CA_FOREACH(Trigger *, t, map->triggers)
 		TriggerTerminate(*t);
 	CA_FOREACH_END()
 	CArrayTerminate(&map->triggers);
-	struct vec2i v;
-	for (v.y = 0; v.y < map->Size.y; v.y++) {
-		for (v.x = 0; v.x < map->Size.x; v.x++) {
-			Tile *t = MapGetTile(map, v);
-			TileDestroy(t);
-		}
-	}
-	CArrayTerminate(&map->Tiles);
-	LOSTerminate(&map->LOS);
-	CArrayTerminate(&map->access);
+	CA_FOREACH(Tile, t, map->Tiles)
+		TileDestroy(t);
+	CA_FOREACH_END()
 	PathCacheTerminate(&gPathCache);
 }
+void MapTerminate(Map *map) {
+	MapRelease(map);
+	MissionArenaTerminate(&map->arena);
+	memset(map, 0, sizeof *map);
+}
 
 void MapInit(Map *map, const struct vec2i size) {
-	MapTerminate(map);
+	MapRelease(map);
 
-	// Init map
+	// Init map, keeping the arena
+	const MissionArena arena = map->arena;
 	memset(map, 0, sizeof *map);
-	CArrayInit(&map->Tiles, sizeof(Tile));
+	map->arena = arena;
+	if (map->arena.blocks.elemSize == 0) {
+		MissionArenaInit(&map->arena, "map");
+	} else {
+		MissionArenaReset(&map->arena);
+	}
 	map->Size = size;
+	// Arena memory is zeroed, the same as TileInit
+	MissionArenaAllocArray(&map->arena, &map->Tiles, sizeof(Tile),
+			size.x * size.y);
 	LOSInit(map);
-	CArrayInit(&map->access, sizeof(uint16_t));
-	CArrayResize(&map->access, size.x * size.y, NULL);
-	CArrayFillZero(&map->access);
+	MissionArenaAllocArray(&map->arena, &map->access, sizeof(uint16_t),
+			size.x * size.y);
 	CArrayInit(&map->triggers, sizeof(Trigger*));
 	PathCacheInit(&gPathCache, map);
-
-	struct vec2i v;
-	for (v.y = 0; v.y < map->Size.y; v.y++) {
-		for (v.x = 0; v.x < map->Size.x; v.x++) {
-			Tile t;
-			TileInit(&t);
-			CArrayPushBack(&map->Tiles, &t);
-		}
+	if (map == &gMap) {
+		TileCacheSetMapSize(&gTileCache, size);
+		FogMasksSetMapSize(size);
+		AutomapCacheSetMapSize(&gAutomapCache, size);
 	}
 }
 
@@ -443,7 +460,7 @@ void MapPrintDebug(const Map *m) {
 	struct vec2i v;
 	for (v.y = 0; v.y < m->Size.y; v.y++) {
 		for (v.x = 0; v.x < m->Size.x; v.x++) {
-			const TileClass *t = MapGetTile(m, v)->Class;
+			const TileClass *t = TileGetClass(MapGetTile(m, v));
 			switch (t->Type) {
 			case TILE_CLASS_FLOOR:
 				*bufP++ = t->IsRoom ? '-' : '.';
@@ -478,7 +495,7 @@ bool MapIsPosOKForPlayer(const Map *map, const struct vec2 pos,
 	}
 	const struct vec2i tilePos = Vec2ToTile(pos);
 	const Tile *tile = MapGetTile(map, tilePos);
-	if (tile->Class->Type == TILE_CLASS_FLOOR) {
+	if (TileGetClass(tile)->Type == TILE_CLASS_FLOOR) {
 		return true;
 	} else if (allowAllTiles) {
 		return TileCanWalk(tile);
@@ -507,10 +524,7 @@ bool MapIsTileAreaClear(Map *map, const struct vec2 pos,
 			if (!MapIsTileIn(map, dtv)) {
 				continue;
 			}
-			const CArray *tileThings = &MapGetTile(map, dtv)->things;
-			if (tileThings == NULL) {
-				continue;
-			}
+			const CArray *tileThings = TileGetThings(MapGetTile(map, dtv));
 			for (int i = 0; i < (int) tileThings->size; i++) {
 				const Thing *ti = ThingIdGetThing(
 						static_cast<const ThingId*>(CArrayGet(tileThings, i)));
@@ -529,6 +543,9 @@ void MapMarkAsVisited(Map *map, struct vec2i pos) {
 	if (!t->isVisited && TileCanWalk(t)) {
 		map->tilesSeen++;
 	}
+	if (!t->isVisited && map == &gMap) {
+		AutomapCacheInvalidate(&gAutomapCache, pos);
+	}
 	t->isVisited = true;
 }
 
@@ -587,7 +604,7 @@ bool MapTileIsUnexplored(Map *map, struct vec2i tile) {
 
 // Only creates the trigger, but does not place it
 Trigger* MapNewTrigger(Map *map) {
-	Trigger *t = TriggerNew();
+	Trigger *t = TriggerNew(&map->arena);
 	CArrayPushBack(&map->triggers, &t);
 	t->id = map->triggerId++;
 	return t;
@@ -51,6 +51,7 @@
 #include <stdbool.h>
 
 #include "map_object.h"
+#include "mission_arena.h"
 #include "pic.h"
 #include "thing.h"
 #include "tile.h"
@@ -81,6 +82,7 @@ typedef struct {
 } LineOfSight;
 
 struct Map {
+	// The grids are in the map arena; they cannot grow
 	CArray Tiles;	// of Tile
 	struct vec2i Size;
 
@@ -90,6 +92,10 @@ struct Map {
 	CArray triggers;	// of Trigger *; owner
 	int triggerId;
 
+	// Reset by MapInit, so that each map reuses the memory of the last;
+	// released by MapTerminate
+	MissionArena arena;
+
 	int tilesSeen;
 	int keyAccessCount;
 
@@ -41,6 +41,8 @@
 static char* ReadFileIntoBuf(const char *path, const char *mode, long *len);
 
 static json_t* ReadArchiveJSON(const char *archive, const char *filename);
+static json_t* ReadArchiveJSONStream(const char *archive,
+		const char *filename, const struct json_array_stream *stream);
 int MapNewScanArchive(const char *filename, char **title, int *numMissions) {
 	int err = 0;
 	json_t *root = ReadArchiveJSON(filename, "campaign.json");
@@ -60,6 +62,11 @@ int MapNewScanArchive(const char *filename, char **title, int *numMissions) {
 static void LoadArchiveSounds(SoundDevice *device, const char *archive,
 		const char *dirname);
 static void LoadArchivePics(PicManager *pm, map_t cc, const char *archive);
+typedef struct {
+	CArray *missions;
+	int version;
+} LoadMissionData;
+static void LoadMissionElement(json_t *node, void *data);
 int MapNewLoadArchive(const char *filename, CampaignSetting *c) {
 	LOG(LM_MAP, LL_DEBUG, "Loading archive map %s", filename);
 	int err = 0;
@@ -70,7 +77,7 @@ int MapNewLoadArchive(const char *filename, CampaignSetting *c) {
 	}
 	int version;
 	LoadInt(&version, root, "Version");
-	if (version > MAP_VERSION || version <= 2) {
+	if (version > MAP_VERSION_MAX || version <= 2) {
 		err = -1;
 		goto bail;
 	}
@@ -135,13 +142,19 @@ int MapNewLoadArchive(const char *filename, CampaignSetting *c) {
 	MapObjectsLoadAmmoAndGunSpawners(&gMapObjects, &gAmmo, &gWeaponClasses,
 			true);
 
-	root = ReadArchiveJSON(filename, "missions.json");
+	{
+		// Load the missions as they are parsed, so that the nodes of only
+		// one mission are held at a time
+		LoadMissionData data = { &c->Missions, version };
+		const struct json_array_stream stream = {
+			"Missions", LoadMissionElement, &data
+		};
+		root = ReadArchiveJSONStream(filename, "missions.json", &stream);
+	}
 	if (root == NULL) {
 		err = -1;
 		goto bail;
 	}
-	LoadMissions(&c->Missions, json_find_first_label(root, "Missions")->child,
-			version);
 	json_free_value(&root);
 
 	// Note: some campaigns don't have characters (e.g. dogfights)
@@ -154,25 +167,31 @@ int MapNewLoadArchive(const char *filename, CampaignSetting *c) {
 	return err;
 }
 
+static void LoadMissionElement(json_t *node, void *data) {
+	const LoadMissionData *lmd = static_cast<const LoadMissionData*>(data);
+	LoadMission(lmd->missions, node, lmd->version);
+}
+
 static json_t* ReadArchiveJSON(const char *archive, const char *filename) {
+	return ReadArchiveJSONStream(archive, filename, NULL);
+}
+static json_t* ReadArchiveJSONStream(const char *archive,
+		const char *filename, const struct json_array_stream *stream) {
 	json_t *root = NULL;
 	char path[CDOGS_PATH_MAX];
 	sprintf(path, "%s/%s", archive, filename);
 	long len;
 	char *buf = ReadFileIntoBuf(path, "rb", &len);
-	enum json_error e;
-	if (buf == NULL)
-		goto bail;
-	e = json_parse_document(&root, buf);
+	if (buf == NULL) {
+		return NULL;
+	}
+	// The document parses the buffer in place and frees it
+	const enum json_error e = json_parse_buffer(&root, buf, stream);
 	if (e != JSON_OK) {
 		LOG(LM_MAP, LL_ERROR, "Invalid syntax in JSON file (%s) error(%d)",
 				filename, (int )e);
-		root = NULL;
-		goto bail;
+		return NULL;
 	}
-
-	bail:
-	CFREE(buf);
 	return root;
 }
 
@@ -229,8 +248,9 @@ static char* ReadFileIntoBuf(const char *path, const char *mode, long *len) {
 	return buf;
 }
 
-static json_t* SaveMissions(CArray *a);
-int MapArchiveSave(const char *filename, CampaignSetting *c) {
+static json_t* SaveMissions(CArray *a, const int version);
+int MapArchiveSave(const char *filename, CampaignSetting *c,
+		const int version) {
 	int res = 1;
 	json_t *root = NULL;
 
@@ -248,7 +268,7 @@ int MapArchiveSave(const char *filename, CampaignSetting *c) {
 
 	// Campaign
 	root = json_new_object();
-	AddIntPair(root, "Version", MAP_VERSION);
+	AddIntPair(root, "Version", version);
 	AddStringPair(root, "Title", c->Title);
 	AddStringPair(root, "Author", c->Author);
 	AddStringPair(root, "Description", c->Description);
@@ -262,7 +282,8 @@ int MapArchiveSave(const char *filename, CampaignSetting *c) {
 
 	json_free_value(&root);
 	root = json_new_object();
-	json_insert_pair_into_object(root, "Missions", SaveMissions(&c->Missions));
+	json_insert_pair_into_object(root, "Missions",
+			SaveMissions(&c->Missions, version));
 	sprintf(buf2, "%s/missions.json", buf);
 	if (!TrySaveJSONFile(root, buf2)) {
 		res = 0;
@@ -284,7 +305,7 @@ static json_t* SaveMissionTileClasses(const MissionTileClasses *mtc);
 static json_t* SaveRooms(const RoomParams r);
 static json_t* SaveClassicDoors(Mission *m);
 static json_t* SaveClassicPillars(Mission *m);
-static json_t* SaveMissions(CArray *a) {
+static json_t* SaveMissions(CArray *a, const int version) {
 	json_t *missionsNode = json_new_array();
 	for (int i = 0; i < (int) a->size; i++) {
 		json_t *node = json_new_object();
@@ -337,7 +358,8 @@ static json_t* SaveMissions(CArray *a) {
 					SaveClassicPillars(mission));
 			break;
 		case MAPTYPE_STATIC:
-			MissionStaticSaveJSON(&mission->u.Static, mission->Size, node);
+			MissionStaticSaveJSON(&mission->u.Static, mission->Size, node,
+					version);
 			break;
 		case MAPTYPE_CAVE:
 			json_insert_pair_into_object(node, "TileClasses",
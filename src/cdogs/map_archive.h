@@ -29,10 +29,18 @@
 
 #include "campaigns.h"
 
+// Version saved by default
 #define MAP_VERSION 15
+// Static map grids stored compactly (see grid_codec.h); only saved if asked
+// for, as older builds can't load it
+#define MAP_VERSION_COMPACT_GRIDS 16
+// Newest version that can be loaded
+#define MAP_VERSION_MAX MAP_VERSION_COMPACT_GRIDS
 
 int MapNewScanArchive(const char *filename, char **title, int *numMissions);
 int MapNewLoadArchive(const char *filename, CampaignSetting *c);
-int MapArchiveSave(const char *filename, CampaignSetting *c);
+// version is MAP_VERSION or MAP_VERSION_COMPACT_GRIDS
+int MapArchiveSave(const char *filename, CampaignSetting *c,
+		const int version);
 
 json_t* MissionSaveTileClass(const TileClass *tc);
@@ -48,11 +48,14 @@
  */
 #include "map_build.h"
 
+#include "automap.h"
 #include "collision/collision.h"
 #include "door.h"
+#include "draw/tile_cache.h"
 #include "log.h"
 #include "map_cave.h"
 #include "map_classic.h"
+#include "map_layout.h"
 #include "map_static.h"
 #include "net_util.h"
 #include "objs.h"
@@ -62,6 +65,7 @@
 #define EXIT_WIDTH 8
 #define EXIT_HEIGHT 8
 
+static void MapBuilderCopyAccess(MapBuilder *mb);
 static void MapSetupTilesAndWalls(MapBuilder *mb);
 static void MapSetupDoors(MapBuilder *mb);
 static void MapAddDrains(MapBuilder *mb);
@@ -70,22 +74,31 @@ void MapBuild(Map *m, const Mission *mission, const CampaignOptions *co) {
 	MapBuilderInit(&mb, m, mission, co);
 	MapInit(mb.Map, mb.mission->Size);
 
+	const int seed = CampaignGetMissionSeed(co->MissionIndex);
 	switch (mb.mission->Type) {
 	case MAPTYPE_CLASSIC:
-		MapClassicLoad(&mb);
+		// TODO: multiple tile types
+		MissionSetupTileClasses(&gPicManager,
+				&mb.mission->u.Classic.TileClasses);
+		MapLayoutLoad(&mb, seed);
+		// Re-seed RNG so results are consistent, cached layout or not
+		CampaignSeedRandom(co);
 		break;
 	case MAPTYPE_STATIC:
 		MapStaticLoad(&mb);
 		break;
 	case MAPTYPE_CAVE:
-		MapCaveLoad(&mb);
+		// TODO: multiple tile types
+		MissionSetupTileClasses(&gPicManager, &mb.mission->u.Cave.TileClasses);
+		MapLayoutLoad(&mb, seed);
+		CampaignSeedRandom(co);
 		break;
 	default:
 		CASSERT(false, "unknown map type")
 		;
 		break;
 	}
-	CArrayCopy(&mb.Map->access, &mb.access);
+	MapBuilderCopyAccess(&mb);
 
 	MapSetupTilesAndWalls(&mb);
 	MapSetupDoors(&mb);
@@ -177,6 +190,8 @@ void MapBuilderInit(MapBuilder *mb, Map *m, const Mission *mission,
 	mb->Map = m;
 	mb->mission = mission;
 	mb->co = co;
+	mb->mode = co != NULL ? co->Entry.Mode : GAME_MODE_NORMAL;
+	MapBuilderSeedRandom(mb, 0);
 
 	const int mapSize = mission->Size.x * mission->Size.y;
 	CArrayInit(&mb->access, sizeof(uint16_t));
@@ -193,6 +208,14 @@ void MapBuilderTerminate(MapBuilder *mb) {
 	CArrayTerminate(&mb->leaveFree);
 }
 
+// The map's access grid is in its arena and cannot be resized, so copy
+// into it rather than over it
+static void MapBuilderCopyAccess(MapBuilder *mb) {
+	CArray *access = &mb->Map->access;
+	memcpy(access->data, mb->access.data,
+			MIN(access->size, mb->access.size) * access->elemSize);
+}
+
 uint16_t MapBuildGetAccess(const MapBuilder *mb, const struct vec2i pos) {
 	if (!MapIsTileIn(mb->Map, pos)) {
 		return 0;
@@ -214,6 +237,27 @@ void MapBuilderSetTile(MapBuilder *mb, struct vec2i pos, const TileClass *t) {
 	*(TileClass*) CArrayGet(&mb->tiles, pos.y * mb->Map->Size.x + pos.x) = *t;
 }
 
+void MapBuilderSeedRandom(MapBuilder *mb, const int seed) {
+	// xorshift32; scramble the seed so that nearby seeds diverge quickly,
+	// and avoid the all-zero state
+	mb->randState = (uint32_t) seed * 2654435761u ^ 0x9E3779B9u;
+	if (mb->randState == 0) {
+		mb->randState = 1;
+	}
+}
+int MapBuilderRand(MapBuilder *mb) {
+	uint32_t x = mb->randState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	mb->randState = x;
+	return (int) (x >> 1);
+}
+struct vec2i MapBuilderGetRandomTile(MapBuilder *mb) {
+	return svec2i(MapBuilderRand(mb) % mb->Map->Size.x,
+			MapBuilderRand(mb) % mb->Map->Size.y);
+}
+
 static bool IsTileOKStrict(const MapObject *obj, const Tile *tile,
 		const Tile *tileAbove, const Tile *tileBelow, const bool isLeaveFree,
 		const int numWallsAdjacent, const int numWallsAround);
@@ -263,10 +307,11 @@ static bool IsTileOKStrict(const MapObject *obj, const Tile *tile,
 		return false;
 	}
 
-	if (obj->Flags & (1 << PLACEMENT_OUTSIDE) && tile->Class->IsRoom) {
+	if (obj->Flags & (1 << PLACEMENT_OUTSIDE) && TileGetClass(tile)->IsRoom) {
 		return false;
 	}
-	if ((obj->Flags & (1 << PLACEMENT_INSIDE)) && !tile->Class->IsRoom) {
+	if ((obj->Flags & (1 << PLACEMENT_INSIDE))
+			&& !TileGetClass(tile)->IsRoom) {
 		return false;
 	}
 	if ((obj->Flags & (1 << PLACEMENT_NO_WALLS)) && numWallsAround != 0) {
@@ -421,7 +466,7 @@ static void MapPlaceCard(MapBuilder *mb, const int keyIndex,
 	for (;;) {
 		const struct vec2i v = MapGetRandomTile(mb->Map);
 		const Tile *t = MapGetTile(mb->Map, v);
-		if (t->Class->IsRoom && TileIsClear(t) && TileCanWalk(t)
+		if (TileGetClass(t)->IsRoom && TileIsClear(t) && TileCanWalk(t)
 				&& MapBuildGetAccess(mb, v) == mapAccess
 				&& TileIsClear(MapGetTile(mb->Map, svec2i(v.x, v.y + 1)))) {
 			MapPlaceKey(mb, v, keyIndex);
@@ -481,7 +526,13 @@ void MapBuildTile(Map *m, const Mission *mission, const struct vec2i pos,
 	RECT_FOREACH(Rect2iNew(svec2i_subtract(pos, svec2i(1, 1)), svec2i(3, 3)))
 				MapSetupTile(&mb, _v);
 			RECT_FOREACH_END()
-	CArrayCopy(&mb.Map->access, &mb.access);
+	if (m == &gMap) {
+		RECT_FOREACH(Rect2iNew(svec2i_subtract(pos, svec2i(2, 2)), svec2i(5, 5)))
+			TileCacheInvalidate(&gTileCache, _v);
+			AutomapCacheInvalidate(&gAutomapCache, _v);
+		RECT_FOREACH_END()
+	}
+	MapBuilderCopyAccess(&mb);
 	MapPrintDebug(mb.Map);
 	MapBuilderTerminate(&mb);
 }
@@ -510,16 +561,18 @@ static void MapSetupTilesAndWalls(MapBuilder *mb) {
 		const struct vec2i pos = MapGetRandomTile(mb->Map);
 		if (MapTileIsNormalFloor(mb, pos)) {
 			Tile *t = MapGetTile(mb->Map, pos);
-			t->Class = TileClassesGetMaskedTile(t->Class, t->Class->Style,
-					"alt1", t->Class->Mask, t->Class->MaskAlt);
+			const TileClass *tc = TileGetClass(t);
+			TileSetClass(t, TileClassesGetMaskedTile(tc, tc->Style, "alt1",
+					tc->Mask, tc->MaskAlt));
 		}
 	}
 	for (int i = 0; i < mb->Map->Size.x * mb->Map->Size.y / 16; i++) {
 		const struct vec2i pos = MapGetRandomTile(mb->Map);
 		if (MapTileIsNormalFloor(mb, pos)) {
 			Tile *t = MapGetTile(mb->Map, pos);
-			t->Class = TileClassesGetMaskedTile(t->Class, t->Class->Style,
-					"alt2", t->Class->Mask, t->Class->MaskAlt);
+			const TileClass *tc = TileGetClass(t);
+			TileSetClass(t, TileClassesGetMaskedTile(tc, tc->Style, "alt2",
+					tc->Mask, tc->MaskAlt));
 		}
 	}
 }
@@ -536,19 +589,19 @@ static void MapSetupTile(MapBuilder *mb, const struct vec2i pos) {
 	}
 	const TileClass *tc = MapBuilderGetTile(mb, pos);
 	if (tc->Type == TILE_CLASS_FLOOR) {
-		t->Class = TileClassesGetMaskedTile(tc, tc->Style,
-				canSeeTileAbove ? "normal" : "shadow", tc->Mask, tc->MaskAlt);
+		TileSetClass(t, TileClassesGetMaskedTile(tc, tc->Style,
+				canSeeTileAbove ? "normal" : "shadow", tc->Mask, tc->MaskAlt));
 	} else if (tc->Type == TILE_CLASS_WALL) {
-		t->Class = TileClassesGetMaskedTile(tc, tc->Style,
-				MapGetWallPic(mb, pos), tc->Mask, tc->MaskAlt);
+		TileSetClass(t, TileClassesGetMaskedTile(tc, tc->Style,
+				MapGetWallPic(mb, pos), tc->Mask, tc->MaskAlt));
 	} else if (tc->Type == TILE_CLASS_DOOR) {
-		t->Class = TileClassesGetMaskedTile(tc, tc->Style, "normal_h", tc->Mask,
-				tc->MaskAlt);
+		TileSetClass(t, TileClassesGetMaskedTile(tc, tc->Style, "normal_h",
+				tc->Mask, tc->MaskAlt));
 	} else if (tc->Type == TILE_CLASS_NOTHING) {
-		t->Class = &gTileNothing;
+		TileSetClass(t, &gTileNothing);
 	} else {
 		CASSERT(false, "cannot setup tile");
-		t->Class = &gTileNothing;
+		TileSetClass(t, &gTileNothing);
 	}
 }
 static bool W(const MapBuilder *mb, const int x, const int y);
@@ -629,13 +682,19 @@ static bool MapIsValidStartForWall(const MapBuilder *mb, const struct vec2i pos,
 	return true;
 }
 
-struct vec2i MapGetRoomSize(const RoomParams r, const int doorMin) {
+// Like RAND_INT but using the builder's RNG
+static int MapBuilderRandInt(MapBuilder *mb, const int low, const int high) {
+	return low == high ? low : low + MapBuilderRand(mb) % (high - low);
+}
+struct vec2i MapGetRoomSize(MapBuilder *mb, const RoomParams r,
+		const int doorMin) {
 	// Work out dimensions of room
 	// make sure room is large enough to accommodate doors
 	const int roomMin = MAX(r.Min, doorMin + 4);
 	const int roomMax = MAX(r.Max, doorMin + 4);
-	return svec2i(RAND_INT(roomMin, roomMax + 1),
-			RAND_INT(roomMin, roomMax + 1));
+	const int w = MapBuilderRandInt(mb, roomMin, roomMax + 1);
+	const int h = MapBuilderRandInt(mb, roomMin, roomMax + 1);
+	return svec2i(w, h);
 }
 
 static bool MapBuilderGetIsRoom(const MapBuilder *mb, const struct vec2i pos);
@@ -695,10 +754,11 @@ static void MapGrowWall(MapBuilder *mb, struct vec2i pos, const bool isRoom,
 		const int pad, const int d, int length, const TileClass *wall);
 bool MapTryBuildWall(MapBuilder *mb, const bool isRoom, const int pad,
 		const int wallLength, const TileClass *wall) {
-	const struct vec2i v = MapGetRandomTile(mb->Map);
+	const struct vec2i v = MapBuilderGetRandomTile(mb);
 	if (MapIsValidStartForWall(mb, v, isRoom, pad)) {
 		MapBuilderSetTile(mb, v, wall);
-		MapGrowWall(mb, v, isRoom, pad, rand() & 3, wallLength, wall);
+		MapGrowWall(mb, v, isRoom, pad, MapBuilderRand(mb) & 3, wallLength,
+				wall);
 		return true;
 	}
 	return false;
@@ -783,10 +843,10 @@ static void MapGrowWall(MapBuilder *mb, struct vec2i pos, const bool isRoom,
 	}
 	MapBuilderSetTile(mb, pos, wall);
 	length--;
-	if (length > 0 && (rand() & 3) == 0) {
+	if (length > 0 && (MapBuilderRand(mb) & 3) == 0) {
 		// Randomly try to grow the wall in a different direction
-		l = rand() % length;
-		MapGrowWall(mb, pos, isRoom, pad, rand() & 3, l, wall);
+		l = MapBuilderRand(mb) % length;
+		MapGrowWall(mb, pos, isRoom, pad, MapBuilderRand(mb) & 3, l, wall);
 		length -= l;
 	}
 	// Keep growing wall in same direction
@@ -859,7 +919,8 @@ void MapPlaceDoors(MapBuilder *mb, const Rect2i r, const bool hasDoors,
 	// Set the doors
 	if (doors[0]) {
 		int doorSize = MIN(
-				(doorMax > doorMin ? (rand() % (doorMax - doorMin + 1)) : 0)
+				(doorMax > doorMin ?
+						(MapBuilderRand(mb) % (doorMax - doorMin + 1)) : 0)
 						+ doorMin, r.Size.y - 4);
 		for (int i = -doorSize / 2; i < (doorSize + 1) / 2; i++) {
 			const struct vec2i v = svec2i(r.Pos.x, r.Pos.y + r.Size.y / 2 + i);
@@ -870,7 +931,8 @@ void MapPlaceDoors(MapBuilder *mb, const Rect2i r, const bool hasDoors,
 	}
 	if (doors[1]) {
 		int doorSize = MIN(
-				(doorMax > doorMin ? (rand() % (doorMax - doorMin + 1)) : 0)
+				(doorMax > doorMin ?
+						(MapBuilderRand(mb) % (doorMax - doorMin + 1)) : 0)
 						+ doorMin, r.Size.y - 4);
 		for (int i = -doorSize / 2; i < (doorSize + 1) / 2; i++) {
 			const struct vec2i v = svec2i(r.Pos.x + r.Size.x - 1,
@@ -882,7 +944,8 @@ void MapPlaceDoors(MapBuilder *mb, const Rect2i r, const bool hasDoors,
 	}
 	if (doors[2]) {
 		int doorSize = MIN(
-				(doorMax > doorMin ? (rand() % (doorMax - doorMin + 1)) : 0)
+				(doorMax > doorMin ?
+						(MapBuilderRand(mb) % (doorMax - doorMin + 1)) : 0)
 						+ doorMin, r.Size.x - 4);
 		for (int i = -doorSize / 2; i < (doorSize + 1) / 2; i++) {
 			const struct vec2i v = svec2i(r.Pos.x + r.Size.x / 2 + i, r.Pos.y);
@@ -893,7 +956,8 @@ void MapPlaceDoors(MapBuilder *mb, const Rect2i r, const bool hasDoors,
 	}
 	if (doors[3]) {
 		int doorSize = MIN(
-				(doorMax > doorMin ? (rand() % (doorMax - doorMin + 1)) : 0)
+				(doorMax > doorMin ?
+						(MapBuilderRand(mb) % (doorMax - doorMin + 1)) : 0)
 						+ doorMin, r.Size.x - 4);
 		for (int i = -doorSize / 2; i < (doorSize + 1) / 2; i++) {
 			const struct vec2i v = svec2i(r.Pos.x + r.Size.x / 2 + i,
@@ -1133,9 +1197,9 @@ void MapMakeSquare(MapBuilder *mb, const Rect2i r, const TileClass *tc) {
 			RECT_FOREACH_END()
 }
 
-uint16_t GenerateAccessMask(int *accessLevel) {
+uint16_t GenerateAccessMask(MapBuilder *mb, int *accessLevel) {
 	uint16_t accessMask = 0;
-	switch (rand() % 20) {
+	switch (MapBuilderRand(mb) % 20) {
 	case 0:
 		if (*accessLevel >= 4) {
 			accessMask = MAP_ACCESS_RED;
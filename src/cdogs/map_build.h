@@ -55,6 +55,11 @@ typedef struct {
 	struct Map *Map;
 	const Mission *mission;
 	const CampaignOptions *co;
+	// Game mode the map is built for; decides whether rooms get keys
+	GameMode mode;
+	// Private RNG for the map layout, so layouts can be generated away from
+	// the main thread without disturbing rand()
+	uint32_t randState;
 
 	// internal data structures to help build the map
 	CArray access;	  // of uint16_t
@@ -75,6 +80,11 @@ const TileClass* MapBuilderGetTile(const MapBuilder *mb,
 		const struct vec2i pos);
 void MapBuilderSetTile(MapBuilder *mb, struct vec2i pos, const TileClass *t);
 
+void MapBuilderSeedRandom(MapBuilder *mb, const int seed);
+// Random number in [0, 2^31) from the builder's own RNG
+int MapBuilderRand(MapBuilder *mb);
+struct vec2i MapBuilderGetRandomTile(MapBuilder *mb);
+
 // Mark a tile so that it is left free of other map objects
 void MapBuilderSetLeaveFree(MapBuilder *mb, const struct vec2i tile,
 		const bool value);
@@ -108,7 +118,8 @@ bool MapGetRoomOverlapSize(const MapBuilder *mb, const Rect2i r,
 bool MapIsLessThanTwoWallOverlaps(const MapBuilder *mb, struct vec2i pos,
 		struct vec2i size);
 void MapMakeSquare(MapBuilder *mb, const Rect2i r, const TileClass *tc);
-struct vec2i MapGetRoomSize(const RoomParams r, const int doorMin);
+struct vec2i MapGetRoomSize(MapBuilder *mb, const RoomParams r,
+		const int doorMin);
 void MapMakeRoom(MapBuilder *mb, const struct vec2i pos,
 		const struct vec2i size, const bool walls, const TileClass *wall,
 		const TileClass *room);
@@ -128,7 +139,7 @@ void MapPlaceDoors(MapBuilder *mb, const Rect2i r, const bool hasDoors,
 void MapBuildTile(Map *m, const Mission *mission, const struct vec2i pos,
 		const TileClass *tile);
 
-uint16_t GenerateAccessMask(int *accessLevel);
+uint16_t GenerateAccessMask(MapBuilder *mb, int *accessLevel);
 void MapGenerateRandomExitArea(Map *map);
 
 void SetupWallTileClasses(PicManager *pm, const TileClass *base);
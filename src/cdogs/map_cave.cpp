@@ -31,17 +31,16 @@
 #include "log.h"
 #include "map_build.h"
 
-static void CaveRep(MapBuilder *mb, const int r1, const int r2);
+static void CaveRep(MapBuilder *mb, const int r1, const int r2,
+		const int reps);
 static void LinkDisconnectedAreas(MapBuilder *mb);
 static void FixCorridors(MapBuilder *mb, const int corridorWidth);
 static void PlaceSquares(MapBuilder *mb, const int squares);
 static void PlaceRooms(MapBuilder *mb);
+static void CaveShuffle(MapBuilder *mb, CArray *a);
 void MapCaveLoad(MapBuilder *mb) {
-	// TODO: multiple tile types
-	MissionSetupTileClasses(&gPicManager, &mb->mission->u.Cave.TileClasses);
-
-	// Re-seed RNG so results are consistent
-	CampaignSeedRandom(mb->co);
+	// Only the builder's own RNG and tiles are used, so that this can run
+	// on a worker thread; see map_layout.h
 
 	// Randomly set a percentage of the tiles as walls
 	for (int i = 0;
@@ -53,10 +52,11 @@ void MapCaveLoad(MapBuilder *mb) {
 		MapBuilderSetTile(mb, pos, &mb->mission->u.Cave.TileClasses.Wall);
 	}
 	// Shuffle
-	CArrayShuffle(&mb->tiles);
+	CaveShuffle(mb, &mb->tiles);
 	// Repetitions
-	for (int i = 0; i < mb->mission->u.Cave.Repeat; i++) {
-		CaveRep(mb, mb->mission->u.Cave.R1, mb->mission->u.Cave.R2);
+	if (mb->mission->u.Cave.Repeat > 0) {
+		CaveRep(mb, mb->mission->u.Cave.R1, mb->mission->u.Cave.R2,
+				mb->mission->u.Cave.Repeat);
 	}
 
 	LinkDisconnectedAreas(mb);
@@ -68,49 +68,90 @@ void MapCaveLoad(MapBuilder *mb) {
 	PlaceRooms(mb);
 }
 
-// Perform one generation of cellular automata
+// Same as CArrayShuffle but with the builder's RNG
+static void CaveShuffle(MapBuilder *mb, CArray *a) {
+	void *buf;
+	CMALLOC(buf, a->elemSize);
+	CA_FOREACH(void, e, *a)
+		const int j = MapBuilderRand(mb) % (_ca_index + 1);
+		void *je = CArrayGet(a, j);
+		// Swap index and j elements
+		memcpy(buf, e, a->elemSize);
+		memcpy(e, je, a->elemSize);
+		memcpy(je, buf, a->elemSize);
+	CA_FOREACH_END()
+	CFREE(buf);
+}
+
+// Perform generations of cellular automata
 // If the number of walls within 1 distance is at least R1, OR
 // if the number of walls within 2 distance is at most R2, then the tile
 // becomes a wall; otherwise it is a floor
-static int CountWallsAround(const MapBuilder *mb, const struct vec2i pos,
-		const int d);
-static void CaveRep(MapBuilder *mb, const int r1, const int r2) {
-	CArray buf;
-	CArrayInit(&buf, mb->tiles.elemSize);
-	CArrayResize(&buf, mb->tiles.size, &mb->mission->u.Cave.TileClasses.Floor);
+// Tiles outside the map count as walls. The generations run on a wall map
+// with a 2 tile border of walls; the counts are box sums, computed
+// separably as sliding windows along rows and then down columns, instead
+// of visiting all 9 + 25 neighbours of each tile.
+static void CaveRep(MapBuilder *mb, const int r1, const int r2,
+		const int reps) {
+	const int pw = mb->Map->Size.x + 2 * CAVE_BORDER;
+	const int ph = mb->Map->Size.y + 2 * CAVE_BORDER;
+	uint8_t *walls;
+	CMALLOC(walls, pw * ph);
+	memset(walls, 1, pw * ph);
 	RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
-				TileClass *tile = static_cast<TileClass*>(CArrayGet(&buf, _i));
-				if (CountWallsAround(mb, _v, 1) >= r1
-						|| CountWallsAround(mb, _v, 2) <= r2) {
-					*tile = mb->mission->u.Cave.TileClasses.Wall;
-				} else {
-					*tile = mb->mission->u.Cave.TileClasses.Floor;
-				}RECT_FOREACH_END()
+		walls[(_v.y + CAVE_BORDER) * pw + _v.x + CAVE_BORDER] =
+				MapBuilderGetTile(mb, _v)->Type == TILE_CLASS_WALL;
+	RECT_FOREACH_END()
+
+	CaveRepWalls(walls, mb->Map->Size, r1, r2, reps);
+
 	RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
-				MapBuilderSetTile(mb, _v,
-						static_cast<const TileClass*>(CArrayGet(&buf, _i)));
-			RECT_FOREACH_END()
-	CArrayTerminate(&buf);
+		const bool isWall =
+				walls[(_v.y + CAVE_BORDER) * pw + _v.x + CAVE_BORDER];
+		MapBuilderSetTile(mb, _v, isWall ?
+				&mb->mission->u.Cave.TileClasses.Wall :
+				&mb->mission->u.Cave.TileClasses.Floor);
+	RECT_FOREACH_END()
+	CFREE(walls);
 }
-static int CountWallsAround(const MapBuilder *mb, const struct vec2i pos,
-		const int d) {
-	int c = 0;
-	RECT_FOREACH(
-			Rect2iNew(svec2i_subtract(pos, svec2i(d, d)), svec2i(2*d+1, 2*d+1)))
-		// Also count edge of maps
-				if (!MapIsTileIn(mb->Map, _v)
-						|| MapBuilderGetTile(mb, _v)->Type == TILE_CLASS_WALL) {
-					c++;
-				}RECT_FOREACH_END()
-	return c;
+void CaveRepWalls(uint8_t *walls, const struct vec2i size,
+		const int r1, const int r2, const int reps) {
+	const int pw = size.x + 2 * CAVE_BORDER;
+	const int ph = size.y + 2 * CAVE_BORDER;
+	// Row sums of radius 1 and 2, for every padded row
+	uint8_t *row1, *row2;
+	CMALLOC(row1, size.x * ph);
+	CMALLOC(row2, size.x * ph);
+	for (int i = 0; i < reps; i++) {
+		for (int y = 0; y < ph; y++) {
+			const uint8_t *w = &walls[y * pw + CAVE_BORDER];
+			uint8_t *h1 = &row1[y * size.x];
+			uint8_t *h2 = &row2[y * size.x];
+			for (int x = 0; x < size.x; x++) {
+				h1[x] = (uint8_t) (w[x - 1] + w[x] + w[x + 1]);
+				h2[x] = (uint8_t) (h1[x] + w[x - 2] + w[x + 2]);
+			}
+		}
+		for (int y = 0; y < size.y; y++) {
+			const uint8_t *h1 = &row1[(y + CAVE_BORDER) * size.x];
+			const uint8_t *h2 = &row2[(y + CAVE_BORDER) * size.x];
+			uint8_t *w = &walls[(y + CAVE_BORDER) * pw + CAVE_BORDER];
+			for (int x = 0; x < size.x; x++) {
+				const int c1 = h1[x - size.x] + h1[x] + h1[x + size.x];
+				const int c2 = h2[x - 2 * size.x] + h2[x - size.x] + h2[x]
+						+ h2[x + size.x] + h2[x + 2 * size.x];
+				w[x] = c1 >= r1 || c2 <= r2;
+			}
+		}
+	}
+	CFREE(row1);
+	CFREE(row2);
 }
 
-static void MapFloodFill(CArray *fl, const struct vec2i size, const int idx,
-		const int elem);
 static void AddCorridor(MapBuilder *mb, const struct vec2i v1,
 		const struct vec2i v2, const struct vec2i dInit, const TileClass *tile);
 static void LinkDisconnectedAreas(MapBuilder *mb) {
-	// Use flood fill to identify disconnected areas
+	// Label the disconnected areas
 	CArray fl;
 	CArrayInit(&fl, sizeof(int));
 	const int zero = 0;
@@ -121,15 +162,7 @@ static void LinkDisconnectedAreas(MapBuilder *mb) {
 				if (tile->Type == TILE_CLASS_WALL) {
 					*(int*) CArrayGet(&fl, _i) = -1;
 				}RECT_FOREACH_END()
-			// Then perform flood fill conditionally on the flood layer
-	int idx = 1;
-	CA_FOREACH(int, i, fl)
-		if (*i == 0) {
-			MapFloodFill(&fl, mb->Map->Size, _ca_index, idx);
-			idx++;
-		}CA_FOREACH_END()
-
-	const int numAreas = idx - 1;
+	const int numAreas = CaveLabelAreas(&fl, mb->Map->Size);
 	// Connect the disconnected areas, first to second, second to third etc.
 	// Select random tile from each area, using index shuffle
 	CArray areaTiles;
@@ -138,7 +171,7 @@ static void LinkDisconnectedAreas(MapBuilder *mb) {
 		UNUSED(i);
 		CArrayPushBack(&areaTiles, &_ca_index);
 	CA_FOREACH_END()
-	CArrayShuffle(&areaTiles);
+	CaveShuffle(mb, &areaTiles);
 	CArray areaStarts;
 	CArrayInit(&areaStarts, sizeof(int));
 	CArrayResize(&areaStarts, numAreas, &zero);
@@ -169,42 +202,56 @@ static void LinkDisconnectedAreas(MapBuilder *mb) {
 	CArrayTerminate(&areaStarts);
 }
 
-static void MapFloodFill(CArray *fl, const struct vec2i size, const int idx,
-		const int elem) {
-	CArray indices;
-	CArrayInit(&indices, sizeof(int));
-	CArrayPushBack(&indices, &idx);
-	const int floodTile = *(int*) CArrayGet(fl, idx);
-	*(int*) CArrayGet(fl, idx) = elem;
-	CA_FOREACH(int, i, indices)
-		const int x = *i % size.x;
-		const int y = *i / size.x;
-		int next;
-		// top
-		next = (y - 1) * size.x + x;
-		if (y > 0 && *(int*) CArrayGet(fl, next) == floodTile) {
-			CArrayPushBack(&indices, &next);
-			*(int*) CArrayGet(fl, next) = elem;
-		}
-		// bottom
-		next = (y + 1) * size.x + x;
-		if (y < size.y - 1 && *(int*) CArrayGet(fl, next) == floodTile) {
-			CArrayPushBack(&indices, &next);
-			*(int*) CArrayGet(fl, next) = elem;
+// Uses union-find with the lowest index as the root of each set, so that
+// the numbering is the same as flood filling each area in scan order.
+static int UnionFindRoot(int *parents, int i);
+static void UnionFindJoin(int *parents, const int a, const int b);
+int CaveLabelAreas(CArray *fl, const struct vec2i size) {
+	int *labels = static_cast<int*>(fl->data);
+	int *parents;
+	CMALLOC(parents, fl->size * sizeof *parents);
+	for (int y = 0; y < size.y; y++) {
+		for (int x = 0; x < size.x; x++) {
+			const int i = y * size.x + x;
+			parents[i] = i;
+			if (labels[i] != 0) {
+				continue;
+			}
+			if (x > 0 && labels[i - 1] == 0) {
+				UnionFindJoin(parents, i - 1, i);
+			}
+			if (y > 0 && labels[i - size.x] == 0) {
+				UnionFindJoin(parents, i - size.x, i);
+			}
 		}
-		// left
-		next = y * size.x + x - 1;
-		if (x > 0 && *(int*) CArrayGet(fl, next) == floodTile) {
-			CArrayPushBack(&indices, &next);
-			*(int*) CArrayGet(fl, next) = elem;
+	}
+	int numAreas = 0;
+	for (int i = 0; i < (int) fl->size; i++) {
+		if (labels[i] != 0) {
+			continue;
 		}
-		// right
-		next = y * size.x + x + 1;
-		if (x < size.x - 1 && *(int*) CArrayGet(fl, next) == floodTile) {
-			CArrayPushBack(&indices, &next);
-			*(int*) CArrayGet(fl, next) = elem;
-		}CA_FOREACH_END()
-	CArrayTerminate(&indices);
+		const int root = UnionFindRoot(parents, i);
+		// The root comes first so it is already labelled, unless it is i
+		labels[i] = root == i ? ++numAreas : labels[root];
+	}
+	CFREE(parents);
+	return numAreas;
+}
+static int UnionFindRoot(int *parents, int i) {
+	while (parents[i] != i) {
+		parents[i] = parents[parents[i]];
+		i = parents[i];
+	}
+	return i;
+}
+static void UnionFindJoin(int *parents, const int a, const int b) {
+	const int ra = UnionFindRoot(parents, a);
+	const int rb = UnionFindRoot(parents, b);
+	if (ra < rb) {
+		parents[rb] = ra;
+	} else if (rb < ra) {
+		parents[ra] = rb;
+	}
 }
 
 // Add an S-shaped corridor from one point to another, filling it with a
@@ -352,8 +399,9 @@ static void PlaceSquares(MapBuilder *mb, const int squares) {
 	// This can only be done if at least one tile in the square is a floor type
 	int count = 0;
 	for (int i = 0; i < 1000 && count < squares; i++) {
-		const struct vec2i v = MapGetRandomTile(mb->Map);
-		const struct vec2i size = svec2i(rand() % 9 + 8, rand() % 9 + 8);
+		const struct vec2i v = MapBuilderGetRandomTile(mb);
+		const struct vec2i size = svec2i(MapBuilderRand(mb) % 9 + 8,
+				MapBuilderRand(mb) % 9 + 8);
 		if (!MapIsAreaClearForCaveSquare(mb, v, size)) {
 			continue;
 		}
@@ -400,8 +448,8 @@ static void PlaceRooms(MapBuilder *mb) {
 			i < 1000 && (int) rooms.size < mb->mission->u.Cave.Rooms.Count;
 			i++) {
 		Rect2i room;
-		room.Pos = MapGetRandomTile(mb->Map);
-		room.Size = MapGetRoomSize(mb->mission->u.Cave.Rooms, 0);
+		room.Pos = MapBuilderGetRandomTile(mb);
+		room.Size = MapGetRoomSize(mb, mb->mission->u.Cave.Rooms, 0);
 		if (!MapIsAreaClearForCaveRoom(mb, room)) {
 			continue;
 		}
@@ -411,11 +459,11 @@ static void PlaceRooms(MapBuilder *mb) {
 				room.Size.x, room.Size.y);
 	}
 	// Set keys for rooms
-	if (AreKeysAllowed(gCampaign.Entry.Mode)
+	if (AreKeysAllowed(mb->mode)
 			&& mb->mission->u.Cave.DoorsEnabled) {
 		while (rooms.size > 0) {
 			// generate an access level for this room
-			const uint16_t accessMask = GenerateAccessMask(
+			const uint16_t accessMask = GenerateAccessMask(mb,
 					&mb->Map->keyAccessCount);
 			if (mb->Map->keyAccessCount < 1) {
 				mb->Map->keyAccessCount = 1;
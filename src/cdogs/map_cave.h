@@ -30,3 +30,15 @@
 #include "map_build.h"
 
 void MapCaveLoad(MapBuilder *mb);
+
+// Width of the wall border around the map that CaveRepWalls runs on
+#define CAVE_BORDER 2
+// Run reps generations of the cave automaton on walls, a 0/1 wall map of
+// (size.x + 2 * CAVE_BORDER) by (size.y + 2 * CAVE_BORDER) whose border
+// is all walls
+void CaveRepWalls(uint8_t *walls, const struct vec2i size,
+		const int r1, const int r2, const int reps);
+// Label the non-wall (0) tiles of fl, an int array of walls (-1) and
+// floors (0), with their 4-connected area, numbered from 1 in order of
+// each area's first tile; returns the number of areas
+int CaveLabelAreas(CArray *fl, const struct vec2i size);
@@ -78,12 +78,8 @@ void MapClassicLoad(MapBuilder *mb) {
 	// Sometimes it's impossible to place features, either because
 	// they overlap with other incompatible features, or it may
 	// create inaccessible areas on the map.
-
-	// TODO: multiple tile types
-	MissionSetupTileClasses(&gPicManager, &mb->mission->u.Classic.TileClasses);
-
-	// Re-seed RNG so results are consistent
-	CampaignSeedRandom(mb->co);
+	// Only the builder's own RNG and tiles are used, so that this can run
+	// on a worker thread; see map_layout.h
 
 	MapMakeSquare(mb, Rect2iNew(svec2i_zero(), mb->mission->Size),
 			&mb->mission->u.Classic.TileClasses.Floor);
@@ -104,10 +100,10 @@ void MapClassicLoad(MapBuilder *mb) {
 	// place rooms
 	count = 0;
 	for (i = 0; i < 1000 && count < mb->mission->u.Classic.Rooms.Count; i++) {
-		const struct vec2i v = MapGetRandomTile(mb->Map);
+		const struct vec2i v = MapBuilderGetRandomTile(mb);
 		const int doorMin = CLAMP(mb->mission->u.Classic.Doors.Min, 1, 6);
 		const int doorMax = CLAMP(mb->mission->u.Classic.Doors.Max, doorMin, 6);
-		const struct vec2i size = MapGetRoomSize(mb->mission->u.Classic.Rooms,
+		const struct vec2i size = MapGetRoomSize(mb, mb->mission->u.Classic.Rooms,
 				doorMin);
 		bool isOverlapRoom;
 		uint16_t overlapAccess;
@@ -116,7 +112,7 @@ void MapClassicLoad(MapBuilder *mb) {
 			continue;
 		}
 		MapBuildRoom(mb, v, size, doorMin, doorMax,
-				AreKeysAllowed(gCampaign.Entry.Mode), isOverlapRoom,
+				AreKeysAllowed(mb->mode), isOverlapRoom,
 				overlapAccess);
 		count++;
 	}
@@ -155,8 +151,9 @@ static void MapSetupPerimeter(MapBuilder *mb) {
 }
 
 static int MapTryBuildSquare(MapBuilder *mb) {
-	const struct vec2i v = MapGetRandomTile(mb->Map);
-	struct vec2i size = svec2i(rand() % 9 + 8, rand() % 9 + 8);
+	const struct vec2i v = MapBuilderGetRandomTile(mb);
+	struct vec2i size = svec2i(MapBuilderRand(mb) % 9 + 8,
+			MapBuilderRand(mb) % 9 + 8);
 	if (MapIsAreaClear(mb, v, size)) {
 		MapMakeSquare(mb, Rect2iNew(v, size),
 				&mb->mission->u.Cave.TileClasses.Floor);
@@ -222,7 +219,7 @@ static void MapBuildRoom(MapBuilder *mb, const struct vec2i pos,
 		const struct vec2i size, const int doorMin, const int doorMax,
 		const bool hasKeys, const bool isOverlapRoom,
 		const uint16_t overlapAccess) {
-	int doormask = rand() % 15 + 1;
+	int doormask = MapBuilderRand(mb) % 15 + 1;
 	bool doors[4];
 	int doorsUnplaced = 0;
 	int i;
@@ -265,7 +262,7 @@ static void MapBuildRoom(MapBuilder *mb, const struct vec2i pos,
 			accessMask = overlapAccess;
 		} else {
 			// Otherwise, generate an access level for this room
-			accessMask = GenerateAccessMask(&mb->Map->keyAccessCount);
+			accessMask = GenerateAccessMask(mb, &mb->Map->keyAccessCount);
 			if (mb->Map->keyAccessCount < 1) {
 				mb->Map->keyAccessCount = 1;
 			}
@@ -283,9 +280,10 @@ static void MapBuildRoom(MapBuilder *mb, const struct vec2i pos,
 static bool MapTryBuildPillar(MapBuilder *mb, const int pad) {
 	const int pillarMin = mb->mission->u.Classic.Pillars.Min;
 	const int pillarMax = mb->mission->u.Classic.Pillars.Max;
-	struct vec2i size = svec2i(rand() % (pillarMax - pillarMin + 1) + pillarMin,
-			rand() % (pillarMax - pillarMin + 1) + pillarMin);
-	const struct vec2i pos = MapGetRandomTile(mb->Map);
+	const int pillarRange = pillarMax - pillarMin + 1;
+	struct vec2i size = svec2i(MapBuilderRand(mb) % pillarRange + pillarMin,
+			MapBuilderRand(mb) % pillarRange + pillarMin);
+	const struct vec2i pos = MapBuilderGetRandomTile(mb);
 	struct vec2i clearPos = svec2i(pos.x - pad, pos.y - pad);
 	struct vec2i clearSize = svec2i(size.x + 2 * pad, size.y + 2 * pad);
 	int isEdge = 0;
@@ -0,0 +1,351 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "map_layout.h"
+
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_thread.h>
+
+#include "log.h"
+#include "map_cave.h"
+#include "map_classic.h"
+
+// Enough for the current and next missions, plus going back and forth in
+// the editor
+#define MAP_LAYOUT_CACHE_SIZE 4
+
+// Layout tiles are always copies of the mission's tile classes, so they are
+// stored as an index into this palette, one byte per tile
+typedef enum {
+	LAYOUT_TILE_NOTHING,
+	LAYOUT_TILE_WALL,
+	LAYOUT_TILE_FLOOR,
+	LAYOUT_TILE_ROOM,
+	LAYOUT_TILE_DOOR,
+	LAYOUT_TILE_COUNT
+} LayoutTile;
+
+typedef struct {
+	// Hash of the layout parameters, game mode and seed
+	unsigned int Hash;
+	MapType Type;
+	struct vec2i Size;
+	int Seed;
+	CArray Tiles;	// of uint8_t (LayoutTile)
+	CArray Access;	// of uint16_t
+	int KeyAccessCount;
+} MapLayout;
+
+typedef struct {
+	// Only the type, size and layout parameters are copied
+	Mission mission;
+	GameMode mode;
+	int seed;
+	unsigned int hash;
+	MapLayout result;
+	bool isOK;
+	SDL_Thread *thread;
+	SDL_atomic_t done;
+} MapLayoutJob;
+
+// Most recently used last
+static CArray sLayouts;	// of MapLayout
+// At most one prefetch runs at a time
+static MapLayoutJob *sJob = NULL;
+
+static unsigned int HashInt(unsigned int h, const int v) {
+	// FNV-1a, one byte at a time
+	for (int i = 0; i < 4; i++) {
+		h ^= (unsigned int) (v >> (i * 8)) & 0xff;
+		h *= 16777619u;
+	}
+	return h;
+}
+static unsigned int HashRooms(unsigned int h, const RoomParams *r) {
+	h = HashInt(h, r->Count);
+	h = HashInt(h, r->Min);
+	h = HashInt(h, r->Max);
+	h = HashInt(h, r->Edge);
+	h = HashInt(h, r->Overlap);
+	h = HashInt(h, r->Walls);
+	h = HashInt(h, r->WallLength);
+	return HashInt(h, r->WallPad);
+}
+static unsigned int HashTileClass(unsigned int h, const TileClass *tc) {
+	// The layout only looks at these; the rest is applied by index
+	h = HashInt(h, tc->Type);
+	return HashInt(h, tc->IsRoom);
+}
+static unsigned int HashTileClasses(unsigned int h,
+		const MissionTileClasses *mtc) {
+	h = HashTileClass(h, &mtc->Wall);
+	h = HashTileClass(h, &mtc->Floor);
+	h = HashTileClass(h, &mtc->Room);
+	return HashTileClass(h, &mtc->Door);
+}
+static unsigned int MapLayoutHash(const Mission *m, const GameMode mode,
+		const int seed) {
+	unsigned int h = 2166136261u;
+	h = HashInt(h, m->Type);
+	h = HashInt(h, m->Size.x);
+	h = HashInt(h, m->Size.y);
+	h = HashInt(h, AreKeysAllowed(mode));
+	h = HashInt(h, seed);
+	switch (m->Type) {
+	case MAPTYPE_CLASSIC:
+		h = HashTileClasses(h, &m->u.Classic.TileClasses);
+		h = HashInt(h, m->u.Classic.Walls);
+		h = HashInt(h, m->u.Classic.WallLength);
+		h = HashInt(h, m->u.Classic.CorridorWidth);
+		h = HashRooms(h, &m->u.Classic.Rooms);
+		h = HashInt(h, m->u.Classic.Squares);
+		h = HashInt(h, m->u.Classic.Doors.Enabled);
+		h = HashInt(h, m->u.Classic.Doors.Min);
+		h = HashInt(h, m->u.Classic.Doors.Max);
+		h = HashInt(h, m->u.Classic.Pillars.Count);
+		h = HashInt(h, m->u.Classic.Pillars.Min);
+		h = HashInt(h, m->u.Classic.Pillars.Max);
+		break;
+	case MAPTYPE_CAVE:
+		h = HashTileClasses(h, &m->u.Cave.TileClasses);
+		h = HashInt(h, m->u.Cave.FillPercent);
+		h = HashInt(h, m->u.Cave.Repeat);
+		h = HashInt(h, m->u.Cave.R1);
+		h = HashInt(h, m->u.Cave.R2);
+		h = HashInt(h, m->u.Cave.CorridorWidth);
+		h = HashRooms(h, &m->u.Cave.Rooms);
+		h = HashInt(h, m->u.Cave.Squares);
+		h = HashInt(h, m->u.Cave.DoorsEnabled);
+		break;
+	default:
+		break;
+	}
+	return h;
+}
+
+static const MissionTileClasses* LayoutTileClasses(const Mission *m) {
+	switch (m->Type) {
+	case MAPTYPE_CLASSIC:
+		return &m->u.Classic.TileClasses;
+	case MAPTYPE_CAVE:
+		return &m->u.Cave.TileClasses;
+	default:
+		CASSERT(false, "map type has no layout");
+		return NULL;
+	}
+}
+static void GetPalette(const TileClass *palette[LAYOUT_TILE_COUNT],
+		const Mission *m) {
+	const MissionTileClasses *mtc = LayoutTileClasses(m);
+	palette[LAYOUT_TILE_NOTHING] = &gTileNothing;
+	palette[LAYOUT_TILE_WALL] = &mtc->Wall;
+	palette[LAYOUT_TILE_FLOOR] = &mtc->Floor;
+	palette[LAYOUT_TILE_ROOM] = &mtc->Room;
+	palette[LAYOUT_TILE_DOOR] = &mtc->Door;
+}
+static bool TileClassIsSame(const TileClass *a, const TileClass *b) {
+	return a->Name == b->Name && a->Pic == b->Pic && a->Style == b->Style
+			&& a->StyleType == b->StyleType && ColorEquals(a->Mask, b->Mask)
+			&& ColorEquals(a->MaskAlt, b->MaskAlt) && a->canWalk == b->canWalk
+			&& a->isOpaque == b->isOpaque && a->shootable == b->shootable
+			&& a->IsRoom == b->IsRoom && a->Type == b->Type;
+}
+
+static void LayoutBuild(MapBuilder *mb, const int seed) {
+	MapBuilderSeedRandom(mb, seed);
+	switch (mb->mission->Type) {
+	case MAPTYPE_CLASSIC:
+		MapClassicLoad(mb);
+		break;
+	case MAPTYPE_CAVE:
+		MapCaveLoad(mb);
+		break;
+	default:
+		CASSERT(false, "map type has no layout")
+		;
+		break;
+	}
+}
+static bool LayoutFromBuilder(MapLayout *l, const MapBuilder *mb,
+		const unsigned int hash, const int seed) {
+	const TileClass *palette[LAYOUT_TILE_COUNT];
+	GetPalette(palette, mb->mission);
+	memset(l, 0, sizeof *l);
+	l->Hash = hash;
+	l->Type = mb->mission->Type;
+	l->Size = mb->Map->Size;
+	l->Seed = seed;
+	CArrayInit(&l->Tiles, sizeof(uint8_t));
+	CArrayResize(&l->Tiles, mb->tiles.size, NULL);
+	CA_FOREACH(const TileClass, tc, mb->tiles)
+		uint8_t id = LAYOUT_TILE_COUNT;
+		for (uint8_t i = 0; i < LAYOUT_TILE_COUNT; i++) {
+			if (TileClassIsSame(tc, palette[i])) {
+				id = i;
+				break;
+			}
+		}
+		if (id == LAYOUT_TILE_COUNT) {
+			LOG(LM_MAP, LL_WARN, "cannot store layout: unknown tile at %d",
+					(int) _ca_index);
+			CArrayTerminate(&l->Tiles);
+			return false;
+		}
+		*(uint8_t*) CArrayGet(&l->Tiles, _ca_index) = id;
+	CA_FOREACH_END()
+	CArrayCopy(&l->Access, &mb->access);
+	l->KeyAccessCount = mb->Map->keyAccessCount;
+	return true;
+}
+static void LayoutApply(const MapLayout *l, MapBuilder *mb) {
+	const TileClass *palette[LAYOUT_TILE_COUNT];
+	GetPalette(palette, mb->mission);
+	CA_FOREACH(const uint8_t, id, l->Tiles)
+		CArraySet(&mb->tiles, _ca_index, palette[*id]);
+	CA_FOREACH_END()
+	memcpy(mb->access.data, l->Access.data,
+			l->Access.size * l->Access.elemSize);
+	mb->Map->keyAccessCount = l->KeyAccessCount;
+}
+static void LayoutTerminate(MapLayout *l) {
+	CArrayTerminate(&l->Tiles);
+	CArrayTerminate(&l->Access);
+}
+
+static const MapLayout* CacheFind(const unsigned int hash, const Mission *m,
+		const int seed) {
+	CA_FOREACH(const MapLayout, l, sLayouts)
+		if (l->Hash != hash || l->Type != m->Type
+				|| !svec2i_is_equal(l->Size, m->Size) || l->Seed != seed) {
+			continue;
+		}
+		// Move to the back so it is evicted last
+		const MapLayout found = *l;
+		CArrayDelete(&sLayouts, _ca_index);
+		CArrayPushBack(&sLayouts, &found);
+		return static_cast<const MapLayout*>(CArrayGet(&sLayouts,
+				sLayouts.size - 1));
+	CA_FOREACH_END()
+	return NULL;
+}
+static void CacheAdd(const MapLayout *l) {
+	if (sLayouts.elemSize == 0) {
+		CArrayInit(&sLayouts, sizeof(MapLayout));
+	}
+	if (sLayouts.size >= MAP_LAYOUT_CACHE_SIZE) {
+		LayoutTerminate(static_cast<MapLayout*>(CArrayGet(&sLayouts, 0)));
+		CArrayDelete(&sLayouts, 0);
+	}
+	CArrayPushBack(&sLayouts, l);
+}
+
+static void JobCollect(const bool wait);
+void MapLayoutLoad(MapBuilder *mb, const int seed) {
+	const unsigned int hash = MapLayoutHash(mb->mission, mb->mode, seed);
+	// If this layout is being prefetched, waiting is quicker than starting
+	// over
+	JobCollect(sJob != NULL && sJob->hash == hash);
+	const MapLayout *l = CacheFind(hash, mb->mission, seed);
+	if (l != NULL) {
+		LOG(LM_MAP, LL_DEBUG, "using cached map layout %08x", hash);
+		LayoutApply(l, mb);
+		return;
+	}
+	LayoutBuild(mb, seed);
+	MapLayout built;
+	if (LayoutFromBuilder(&built, mb, hash, seed)) {
+		CacheAdd(&built);
+	}
+}
+// Move a finished prefetch into the cache
+static void JobCollect(const bool wait) {
+	if (sJob == NULL || (!wait && !SDL_AtomicGet(&sJob->done))) {
+		return;
+	}
+	SDL_WaitThread(sJob->thread, NULL);
+	if (sJob->isOK) {
+		CacheAdd(&sJob->result);
+	}
+	MissionTileClassesTerminate(MissionGetTileClasses(&sJob->mission));
+	CFREE(sJob);
+	sJob = NULL;
+}
+
+static int LayoutWorker(void *data);
+void MapLayoutPrefetch(const Mission *m, const GameMode mode, const int seed) {
+	if (m == NULL || (m->Type != MAPTYPE_CLASSIC && m->Type != MAPTYPE_CAVE)) {
+		return;
+	}
+	JobCollect(false);
+	const unsigned int hash = MapLayoutHash(m, mode, seed);
+	if (sJob != NULL || CacheFind(hash, m, seed) != NULL) {
+		return;
+	}
+
+	CCALLOC(sJob, sizeof *sJob);
+	sJob->mission.Type = m->Type;
+	sJob->mission.Size = m->Size;
+	memcpy(&sJob->mission.u, &m->u, sizeof sJob->mission.u);
+	MissionTileClassesCopy(MissionGetTileClasses(&sJob->mission),
+			LayoutTileClasses(m));
+	sJob->mode = mode;
+	sJob->seed = seed;
+	sJob->hash = hash;
+	SDL_AtomicSet(&sJob->done, 0);
+	sJob->thread = SDL_CreateThread(LayoutWorker, "map layout", sJob);
+	if (sJob->thread == NULL) {
+		LOG(LM_MAP, LL_WARN, "cannot create map layout thread: %s",
+				SDL_GetError());
+		MissionTileClassesTerminate(MissionGetTileClasses(&sJob->mission));
+		CFREE(sJob);
+		sJob = NULL;
+	}
+}
+static int LayoutWorker(void *data) {
+	MapLayoutJob *job = static_cast<MapLayoutJob*>(data);
+	// The layout only needs the map size; everything else is in the builder
+	Map map;
+	memset(&map, 0, sizeof map);
+	map.Size = job->mission.Size;
+	MapBuilder mb;
+	MapBuilderInit(&mb, &map, &job->mission, NULL);
+	mb.mode = job->mode;
+	LayoutBuild(&mb, job->seed);
+	job->isOK = LayoutFromBuilder(&job->result, &mb, job->hash, job->seed);
+	MapBuilderTerminate(&mb);
+	SDL_AtomicSet(&job->done, 1);
+	return 0;
+}
+
+void MapLayoutCacheTerminate(void) {
+	JobCollect(true);
+	CA_FOREACH(MapLayout, l, sLayouts)
+		LayoutTerminate(l);
+	CA_FOREACH_END()
+	CArrayTerminate(&sLayouts);
+}
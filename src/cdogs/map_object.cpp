@@ -48,6 +48,7 @@
  */
 #include "map_object.h"
 
+#include "asset_pack.h"
 #include "json_utils.h"
 #include "log.h"
 #include "map.h"
@@ -190,28 +191,16 @@ void MapObjectsInit(MapObjects *classes, const char *filename,
 	CArrayInit(&classes->Destructibles, sizeof(char*));
 	CArrayInit(&classes->Bloods, sizeof(char*));
 
-	char buf[CDOGS_PATH_MAX];
-	GetDataFilePath(buf, filename);
-	FILE *f = fopen(buf, "r");
-	json_t *root = NULL;
-	enum json_error e;
-	if (f == NULL) {
-		LOG(LM_MAIN, LL_ERROR, "Error: cannot load map objects file %s", buf);
-		goto bail;
-	}
-	e = json_stream_parse(f, &root);
-	if (e != JSON_OK) {
-		LOG(LM_MAIN, LL_ERROR, "Error parsing map objects file %s", buf);
-		goto bail;
+	json_t *root = AssetPackReadJSON(&gAssetPack, filename);
+	if (root == NULL) {
+		LOG(LM_MAIN, LL_ERROR, "Error: cannot load map objects file %s",
+				filename);
+		return;
 	}
 	MapObjectsLoadJSON(&classes->Classes, root);
 
 	// Load initial ammo/weapon spawners
 	MapObjectsLoadAmmoAndGunSpawners(classes, ammo, guns, false);
-
-	bail: if (f != NULL) {
-		fclose(f);
-	}
 	json_free_value(&root);
 }
 static bool TryLoadMapObject(MapObject *m, json_t *node, const int version);
@@ -489,7 +478,8 @@ bool MapObjectIsTileOK(const MapObject *obj, const Tile *tile,
 		return false;
 	}
 	if (MapObjectIsOnWall(obj)
-			&& (tileAbove == NULL || tileAbove->Class->Type != TILE_CLASS_WALL)) {
+			&& (tileAbove == NULL
+					|| TileGetClass(tileAbove)->Type != TILE_CLASS_WALL)) {
 		return false;
 	}
 	return true;
@@ -91,7 +91,8 @@ void MapStaticLoadTile(MapBuilder *mb, const struct vec2i v) {
 	if (!MapIsTileIn(mb->Map, v))
 		return;
 	const int idx = v.y * mb->Map->Size.x + v.x;
-	int tileAccess = *(int*) CArrayGet(&mb->mission->u.Static.Access, idx);
+	uint16_t tileAccess = *(const uint16_t*) CArrayGet(
+			&mb->mission->u.Static.Access, idx);
 	if (!AreKeysAllowed(gCampaign.Entry.Mode)) {
 		tileAccess = 0;
 	}
@@ -270,6 +270,97 @@ static void SetupWeapons(CArray *to, CArray *from) {
 	CArrayCopy(to, from);
 }
 
+static void PreloadWeaponSounds(const WeaponClass *wc) {
+	if (wc == NULL) {
+		return;
+	}
+	SoundPreload(&gSoundDevice, wc->Sound);
+	SoundPreload(&gSoundDevice, wc->ReloadSound);
+	SoundPreload(&gSoundDevice, wc->SwitchSound);
+	const BulletClass *b = wc->Bullet;
+	if (b != NULL) {
+		SoundPreloadName(&gSoundDevice, b->HitSound.Object);
+		SoundPreloadName(&gSoundDevice, b->HitSound.Flesh);
+		SoundPreloadName(&gSoundDevice, b->HitSound.Wall);
+	}
+	if (wc->AmmoId >= 0) {
+		SoundPreloadName(&gSoundDevice,
+				AmmoGetById(&gAmmo, wc->AmmoId)->Sound);
+	}
+}
+static void PreloadPickupSounds(const PickupClass *pc) {
+	if (pc == NULL) {
+		return;
+	}
+	switch (pc->Type) {
+	case PICKUP_JEWEL:
+		SoundPreloadName(&gSoundDevice, "pickup");
+		break;
+	case PICKUP_HEALTH:
+		SoundPreloadName(&gSoundDevice, "health");
+		break;
+	case PICKUP_AMMO:
+		SoundPreloadName(&gSoundDevice,
+				AmmoGetById(&gAmmo, pc->u.Ammo.Id)->Sound);
+		break;
+	case PICKUP_KEYCARD:
+		SoundPreloadName(&gSoundDevice, "key");
+		break;
+	case PICKUP_GUN:
+		PreloadWeaponSounds(IdWeaponClass(pc->u.GunId));
+		break;
+	default:
+		break;
+	}
+}
+static void PreloadMapObjectSounds(const MapObject *mo) {
+	if (mo == NULL) {
+		return;
+	}
+	if (mo->Health > 0) {
+		SoundPreloadName(&gSoundDevice, "bang");
+	}
+	CA_FOREACH(const WeaponClass *, wc, mo->DestroyGuns)
+		PreloadWeaponSounds(*wc);
+	CA_FOREACH_END()
+	if (mo->Type == MAP_OBJECT_TYPE_PICKUP_SPAWNER) {
+		SoundPreloadName(&gSoundDevice, "spawn_item");
+		PreloadPickupSounds(mo->u.PickupClass);
+	}
+	// Destroy spawns are health, or ammo for the players' guns, which are
+	// loaded with the mission's weapons
+}
+// Decode the mission's sounds now rather than on first use: weapons,
+// their bullets, and the sounds of its map objects and pickups
+static void PreloadSounds(const Mission *m, const CArray *weapons) {
+	CA_FOREACH(const WeaponClass *, wc, *weapons)
+		PreloadWeaponSounds(*wc);
+	CA_FOREACH_END()
+	CA_FOREACH(const Objective, o, m->Objectives)
+		if (o->Type == OBJECTIVE_DESTROY) {
+			PreloadMapObjectSounds(o->u.MapObject);
+		} else if (o->Type == OBJECTIVE_COLLECT) {
+			PreloadPickupSounds(o->u.Pickup);
+		}
+	CA_FOREACH_END()
+	if (m->Type == MAPTYPE_STATIC) {
+		CA_FOREACH(const MapObjectPositions, mop, m->u.Static.Items)
+			PreloadMapObjectSounds(mop->M);
+		CA_FOREACH_END()
+		if (m->u.Static.Keys.size > 0) {
+			SoundPreloadName(&gSoundDevice, "key");
+		}
+	} else {
+		CA_FOREACH(const MapObjectDensity, mod, m->MapObjectDensities)
+			PreloadMapObjectSounds(mod->M);
+		CA_FOREACH_END()
+		// Generated maps may place keys behind locked doors
+		SoundPreloadName(&gSoundDevice, "key");
+	}
+	// Health may be randomly spawned or dropped in any mission
+	SoundPreloadName(&gSoundDevice, "health");
+}
+
 void SetupMission(Mission *m, struct MissionOptions *mo, int missionIndex) {
 	MissionOptionsInit(mo);
 	mo->index = missionIndex;
@@ -284,6 +375,7 @@ void SetupMission(Mission *m, struct MissionOptions *mo, int missionIndex) {
 	SetupObjectives(m);
 	SetupBadguysForMission(m);
 	SetupWeapons(&mo->Weapons, &m->Weapons);
+	PreloadSounds(m, &mo->Weapons);
 }
 void MissionSetupTileClasses(PicManager *pm, const MissionTileClasses *mtc) {
 	SetupWallTileClasses(pm, &mtc->Wall);
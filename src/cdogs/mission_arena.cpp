@@ -0,0 +1,182 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "mission_arena.h"
+
+#include <string.h>
+
+#include "log.h"
+#include "utils.h"
+
+#define MISSION_ARENA_ALIGN 16
+
+typedef struct {
+	uint8_t *data;
+	size_t size;
+} MissionArenaBlock;
+
+MissionArena gMissionArena;
+
+// Live arenas, for stats
+static CArray sArenas;	// of MissionArena *
+
+void MissionArenaInit(MissionArena *a, const char *name) {
+	memset(a, 0, sizeof *a);
+	CArrayInit(&a->blocks, sizeof(MissionArenaBlock));
+	CArrayInit(&a->pools, sizeof(MissionPool*));
+	a->Stats.Name = name;
+	if (sArenas.elemSize == 0) {
+		CArrayInit(&sArenas, sizeof(MissionArena*));
+	}
+	CArrayPushBack(&sArenas, &a);
+}
+void MissionArenaTerminate(MissionArena *a) {
+	CA_FOREACH(MissionArena *, ap, sArenas)
+		if (*ap == a) {
+			CArrayDelete(&sArenas, _ca_index);
+			break;
+		}
+	CA_FOREACH_END()
+	if (sArenas.size == 0) {
+		CArrayTerminate(&sArenas);
+	}
+	CA_FOREACH(MissionPool *, p, a->pools)
+		// Initialise again if used later
+		memset(*p, 0, sizeof **p);
+	CA_FOREACH_END()
+	CArrayTerminate(&a->pools);
+	CA_FOREACH(MissionArenaBlock, b, a->blocks)
+		CFREE(b->data);
+	CA_FOREACH_END()
+	CArrayTerminate(&a->blocks);
+	memset(a, 0, sizeof *a);
+}
+
+static MissionArenaBlock *AddBlock(MissionArena *a, const size_t size);
+void *MissionArenaAlloc(MissionArena *a, const size_t size) {
+	CASSERT(a->blocks.elemSize > 0, "arena has not been initialised");
+	const size_t aligned = (size + MISSION_ARENA_ALIGN - 1)
+			& ~(size_t) (MISSION_ARENA_ALIGN - 1);
+	MissionArenaBlock *b = NULL;
+	// Use the first block from the current one that has room; blocks
+	// skipped here are reused after the next reset
+	for (; a->current < (int) a->blocks.size; a->current++) {
+		b = static_cast<MissionArenaBlock*>(CArrayGet(&a->blocks,
+				a->current));
+		if (a->offset + aligned <= b->size) {
+			break;
+		}
+		a->offset = 0;
+		b = NULL;
+	}
+	if (b == NULL) {
+		b = AddBlock(a, MAX(aligned, (size_t) MISSION_ARENA_BLOCK_SIZE));
+		a->current = (int) a->blocks.size - 1;
+		a->offset = 0;
+	}
+	void *ptr = b->data + a->offset;
+	a->offset += aligned;
+	memset(ptr, 0, size);
+
+	a->Stats.Used += aligned;
+	a->Stats.Peak = MAX(a->Stats.Peak, a->Stats.Used);
+	a->Stats.Allocs++;
+	return ptr;
+}
+void MissionArenaAllocArray(MissionArena *a, CArray *arr,
+		const size_t elemSize, const size_t size) {
+	arr->data = MissionArenaAlloc(a, elemSize * size);
+	arr->elemSize = elemSize;
+	arr->size = size;
+	arr->capacity = size;
+}
+static MissionArenaBlock *AddBlock(MissionArena *a, const size_t size) {
+	MissionArenaBlock b;
+	CMALLOC(b.data, size);
+	b.size = size;
+	CArrayPushBack(&a->blocks, &b);
+	a->Stats.Reserved += size;
+	LOG(LM_MAIN, LL_DEBUG, "arena %s: new block of %d bytes (%d reserved)",
+			a->Stats.Name, (int) size, (int) a->Stats.Reserved);
+	return static_cast<MissionArenaBlock*>(CArrayGet(&a->blocks,
+			a->blocks.size - 1));
+}
+
+void MissionArenaReset(MissionArena *a) {
+	CA_FOREACH(MissionPool *, p, a->pools)
+		(*p)->freeList = NULL;
+		(*p)->Live = 0;
+	CA_FOREACH_END()
+	a->current = 0;
+	a->offset = 0;
+	a->Stats.Used = 0;
+	a->Stats.Allocs = 0;
+	a->Stats.Resets++;
+}
+
+void MissionPoolInit(MissionPool *p, MissionArena *a, const size_t elemSize,
+		const char *name) {
+	memset(p, 0, sizeof *p);
+	p->arena = a;
+	p->Name = name;
+	// Freed objects hold the free list link
+	p->elemSize = MAX(elemSize, sizeof(void*));
+	CArrayPushBack(&a->pools, &p);
+}
+void *MissionPoolAlloc(MissionPool *p) {
+	void *ptr = p->freeList;
+	if (ptr != NULL) {
+		memcpy(&p->freeList, ptr, sizeof p->freeList);
+		memset(ptr, 0, p->elemSize);
+	} else {
+		ptr = MissionArenaAlloc(p->arena, p->elemSize);
+	}
+	p->Live++;
+	p->Peak = MAX(p->Peak, p->Live);
+	return ptr;
+}
+void MissionPoolFree(MissionPool *p, void *ptr) {
+	if (ptr == NULL) {
+		return;
+	}
+	memcpy(ptr, &p->freeList, sizeof p->freeList);
+	p->freeList = ptr;
+	p->Live--;
+}
+
+int MissionArenasGetStats(MissionArenaStats *out, const int max) {
+	int n = 0;
+	CA_FOREACH(MissionArena *, ap, sArenas)
+		if (n == max) {
+			break;
+		}
+		out[n] = (*ap)->Stats;
+		n++;
+	CA_FOREACH_END()
+	return n;
+}
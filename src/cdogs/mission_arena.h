@@ -0,0 +1,89 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stddef.h>
+
+#include "c_array.h"
+
+// Memory for data that lives as long as a mission or a map. It is handed
+// out from large blocks and released all at once, instead of object by
+// object. Blocks are kept on reset, so missions reuse the same memory.
+#define MISSION_ARENA_BLOCK_SIZE (64 * 1024)
+
+typedef struct {
+	const char *Name;
+	size_t Used;		// bytes handed out since the last reset
+	size_t Peak;		// most bytes handed out between resets
+	size_t Reserved;	// bytes held in blocks
+	int Allocs;			// allocations since the last reset
+	int Resets;
+} MissionArenaStats;
+
+typedef struct {
+	CArray blocks;	// of MissionArenaBlock
+	int current;	// block being allocated from
+	size_t offset;	// into the current block
+	CArray pools;	// of MissionPool *
+	MissionArenaStats Stats;
+} MissionArena;
+
+// Fixed-size objects from an arena; freed objects are reused until the
+// arena is reset
+typedef struct {
+	MissionArena *arena;
+	const char *Name;
+	size_t elemSize;
+	void *freeList;
+	int Live;
+	int Peak;
+} MissionPool;
+
+// Per-mission entity data; reset at the end of each mission
+extern MissionArena gMissionArena;
+
+void MissionArenaInit(MissionArena *a, const char *name);
+void MissionArenaTerminate(MissionArena *a);
+// Zeroed memory, aligned for any type
+void *MissionArenaAlloc(MissionArena *a, const size_t size);
+// Point arr at size zeroed elements from the arena. The array cannot grow
+// and is released with the arena, so it must not be terminated.
+void MissionArenaAllocArray(MissionArena *a, CArray *arr,
+		const size_t elemSize, const size_t size);
+// Release everything allocated from the arena and its pools at once
+void MissionArenaReset(MissionArena *a);
+
+// Pools are usually static; they are initialised on first use
+void MissionPoolInit(MissionPool *p, MissionArena *a, const size_t elemSize,
+		const char *name);
+void *MissionPoolAlloc(MissionPool *p);
+void MissionPoolFree(MissionPool *p, void *ptr);
+
+// Stats of all live arenas, for the profiler; returns the number written
+int MissionArenasGetStats(MissionArenaStats *out, const int max);
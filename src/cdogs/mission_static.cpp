@@ -28,6 +28,7 @@
 #include "mission_static.h"
 
 #include "algorithms.h"
+#include "grid_codec.h"
 #include "json_utils.h"
 #include "log.h"
 #include "map.h"
@@ -39,8 +40,8 @@
 static void MissionStaticInit(MissionStatic *m) {
 	memset(m, 0, sizeof *m);
 	m->TileClasses = hashmap_new();
-	CArrayInit(&m->Tiles, sizeof(int));
-	CArrayInit(&m->Access, sizeof(int));
+	CArrayInit(&m->Tiles, sizeof(uint16_t));
+	CArrayInit(&m->Access, sizeof(uint16_t));
 	CArrayInit(&m->Items, sizeof(MapObjectPositions));
 	CArrayInit(&m->Characters, sizeof(CharacterPositions));
 	CArrayInit(&m->Objectives, sizeof(ObjectivePositions));
@@ -60,8 +61,10 @@ static void LoadStaticCharacters(MissionStatic *m, json_t *node, char *name);
 static void LoadStaticObjectives(MissionStatic *m, json_t *node, char *name);
 static void LoadStaticKeys(MissionStatic *m, json_t *node, char *name);
 static void LoadStaticExit(MissionStatic *m, json_t *node, char *name);
+static bool LoadStaticGrid(CArray *values, const json_t *node,
+		const char *name, const struct vec2i size);
 bool MissionStaticTryLoadJSON(MissionStatic *m, json_t *node,
-		const int version) {
+		const int version, const struct vec2i size) {
 	MissionStaticInit(m);
 	if (version <= 14) {
 		MissionTileClasses mtc;
@@ -73,6 +76,8 @@ bool MissionStaticTryLoadJSON(MissionStatic *m, json_t *node,
 			// JSON array
 			json_t *tiles = json_find_first_label(node, "Tiles");
 			if (!tiles || !tiles->child) {
+				MissionTileClassesTerminate(&mtc);
+				MissionStaticTerminate(m);
 				return false;
 			}
 			tiles = tiles->child;
@@ -88,7 +93,7 @@ bool MissionStaticTryLoadJSON(MissionStatic *m, json_t *node,
 		}
 		// Convert old tiles to new
 		CA_FOREACH(uint16_t, t, oldTiles)
-			const int tileAccess = *t & MAP_ACCESSBITS;
+			const uint16_t tileAccess = *t & MAP_ACCESSBITS;
 			CArrayPushBack(&m->Access, &tileAccess);
 			*t &= MAP_MASKACCESS;
 			switch (*t) {
@@ -115,16 +120,27 @@ bool MissionStaticTryLoadJSON(MissionStatic *m, json_t *node,
 		// Tile class definitions
 		LoadTileClasses(m->TileClasses, node);
 
-		// CSV string per row
-		const json_t *tile = json_find_first_label(node, "Tiles")->child->child;
-		while (tile) {
-			LoadStaticTileCSV(&m->Tiles, tile->text);
-			tile = tile->next;
-		}
-		const json_t *a = json_find_first_label(node, "Access")->child->child;
-		while (a) {
-			LoadStaticTileCSV(&m->Access, a->text);
-			a = a->next;
+		if (version >= MAP_VERSION_COMPACT_GRIDS) {
+			// Compact encoded grids
+			if (!LoadStaticGrid(&m->Tiles, node, "Tiles", size)
+					|| !LoadStaticGrid(&m->Access, node, "Access", size)) {
+				MissionStaticTerminate(m);
+				return false;
+			}
+		} else {
+			// CSV string per row
+			const json_t *tile =
+					json_find_first_label(node, "Tiles")->child->child;
+			while (tile) {
+				LoadStaticTileCSV(&m->Tiles, tile->text);
+				tile = tile->next;
+			}
+			const json_t *a =
+					json_find_first_label(node, "Access")->child->child;
+			while (a) {
+				LoadStaticTileCSV(&m->Access, a->text);
+				a = a->next;
+			}
 		}
 	}
 
@@ -173,11 +189,21 @@ static void LoadOldStaticTileCSV(CArray *tiles, char *tileCSV) {
 static void LoadStaticTileCSV(CArray *tiles, char *tileCSV) {
 	char *pch = strtok(tileCSV, ",");
 	while (pch != NULL) {
-		const int n = atoi(pch);
+		const uint16_t n = (uint16_t) atoi(pch);
 		CArrayPushBack(tiles, &n);
 		pch = strtok(NULL, ",");
 	}
 }
+static bool LoadStaticGrid(CArray *values, const json_t *node,
+		const char *name, const struct vec2i size) {
+	const json_t *grid = json_find_first_label(node, name);
+	if (grid == NULL || grid->child == NULL || grid->child->text == NULL
+			|| !GridDecode(values, grid->child->text, size.x * size.y)) {
+		LOG(LM_MAP, LL_ERROR, "cannot decode static map %s", name);
+		return false;
+	}
+	return true;
+}
 static void ConvertOldTile(MissionStatic *m, const uint16_t t,
 		const TileClass *base) {
 	char keyBuf[6];
@@ -198,8 +224,7 @@ static void ConvertOldTile(MissionStatic *m, const uint16_t t,
 			CASSERT(false, "Failed to add tile class");
 		}
 	}
-	const int tile = (int) t;
-	CArrayPushBack(&m->Tiles, &tile);
+	CArrayPushBack(&m->Tiles, &t);
 }
 static const MapObject* LoadMapObjectRef(json_t *node, const int version);
 static const MapObject* LoadMapObjectWreckRef(json_t *itemNode,
@@ -409,10 +434,11 @@ void MissionStaticFromMap(MissionStatic *m, const Map *map) {
 				const Tile *t = MapGetTile(map, _v);
 				intptr_t tile;
 				char tcName[256];
-				TileClassGetBaseName(tcName, t->Class);
+				TileClassGetBaseName(tcName, TileGetClass(t));
 				if (hashmap_get(tileClassMap, tcName,
 						(any_t*) &tile) == MAP_MISSING) {
-					TileClass *tc = MissionStaticAddTileClass(m, t->Class);
+					TileClass *tc = MissionStaticAddTileClass(m,
+							TileGetClass(t));
 					if (tc == NULL) {
 						continue;
 					}
@@ -426,8 +452,8 @@ void MissionStaticFromMap(MissionStatic *m, const Map *map) {
 					}
 					LOG(LM_MAP, LL_DEBUG, "Added tile class (%s)", tcName);
 				}
-				const int tileInt = (int) tile;
-				CArrayPushBack(&m->Tiles, &tileInt);
+				const uint16_t tile16 = (uint16_t) tile;
+				CArrayPushBack(&m->Tiles, &tile16);
 				const uint16_t access = MapGetAccessLevel(map, _v);
 				CArrayPushBack(&m->Access, &access);
 			RECT_FOREACH_END()
@@ -446,17 +472,27 @@ void MissionStaticTerminate(MissionStatic *m) {
 
 static json_t* SaveStaticTileClasses(const MissionStatic *m);
 static json_t* SaveStaticCSV(const CArray *values, const struct vec2i size);
+static json_t* SaveStaticGrid(const CArray *values);
 static json_t* SaveStaticItems(const MissionStatic *m);
 static json_t* SaveStaticCharacters(const MissionStatic *m);
 static json_t* SaveStaticObjectives(const MissionStatic *m);
 static json_t* SaveStaticKeys(const MissionStatic *m);
 static json_t* SaveVec2i(struct vec2i v);
 void MissionStaticSaveJSON(const MissionStatic *m, const struct vec2i size,
-		json_t *node) {
+		json_t *node, const int version) {
 	json_insert_pair_into_object(node, "TileClasses", SaveStaticTileClasses(m));
-	json_insert_pair_into_object(node, "Tiles", SaveStaticCSV(&m->Tiles, size));
-	json_insert_pair_into_object(node, "Access",
-			SaveStaticCSV(&m->Access, size));
+	CASSERT((int )m->Tiles.size == size.x * size.y,
+			"static mission tiles size mismatch");
+	if (version >= MAP_VERSION_COMPACT_GRIDS) {
+		json_insert_pair_into_object(node, "Tiles", SaveStaticGrid(&m->Tiles));
+		json_insert_pair_into_object(node, "Access",
+				SaveStaticGrid(&m->Access));
+	} else {
+		json_insert_pair_into_object(node, "Tiles",
+				SaveStaticCSV(&m->Tiles, size));
+		json_insert_pair_into_object(node, "Access",
+				SaveStaticCSV(&m->Access, size));
+	}
 	json_insert_pair_into_object(node, "StaticItems", SaveStaticItems(m));
 	json_insert_pair_into_object(node, "StaticCharacters",
 			SaveStaticCharacters(m));
@@ -504,17 +540,14 @@ static json_t* SaveStaticCSV(const CArray *values, const struct vec2i size) {
 	// The buffer will contain n*5 chars (tiles, allow 5 chars each),
 	// and n - 1 commas, so 6n total
 	char *rowBuf;
-	rowBuf = static_cast<char*>(malloc(size.x * 6));
-	if (rowBuf == NULL && size.x * 6 > 0) {
-		exit(1);
-	}
-//	CMALLOC(rowBuf, size.x * 6);
+	CMALLOC(rowBuf, size.x * 6 + 1);
 	for (int i = 0; i < size.y; i++) {
 		char *pBuf = rowBuf;
 		*pBuf = '\0';
 		for (int j = 0; j < size.x; j++) {
 			char buf[6];
-			snprintf(buf, 6, "%d", *(int*) CArrayGet(values, i * size.x + j));
+			snprintf(buf, 6, "%d",
+					*(const uint16_t*) CArrayGet(values, i * size.x + j));
 			strcpy(pBuf, buf);
 			pBuf += strlen(buf);
 			if (j < size.x - 1) {
@@ -526,6 +559,13 @@ static json_t* SaveStaticCSV(const CArray *values, const struct vec2i size) {
 	CFREE(rowBuf);
 	return rows;
 }
+static json_t* SaveStaticGrid(const CArray *values) {
+	char *text = GridEncode(static_cast<const uint16_t*>(values->data),
+			(int) values->size);
+	json_t *node = json_new_string(text);
+	CFREE(text);
+	return node;
+}
 static json_t* SaveStaticItems(const MissionStatic *m) {
 	json_t *items = json_new_array();
 	CA_FOREACH(MapObjectPositions, mop, m->Items)
@@ -676,7 +716,7 @@ int MissionStaticGetTile(const MissionStatic *m, const struct vec2i size,
 			"static mission tiles size mismatch");
 	CASSERT(Rect2iIsInside(Rect2iNew(svec2i_zero(), size), pos),
 			"position outside static map");
-	return *(int*) CArrayGet(&m->Tiles, size.x * pos.y + pos.x);
+	return *(const uint16_t*) CArrayGet(&m->Tiles, size.x * pos.y + pos.x);
 }
 const TileClass* MissionStaticGetTileClass(const MissionStatic *m,
 		const struct vec2i size, const struct vec2i pos) {
@@ -737,7 +777,8 @@ bool MissionStaticTrySetTile(MissionStatic *m, const struct vec2i size,
 		break;
 	}
 	const int idx = pos.y * size.x + pos.x;
-	CArraySet(&m->Tiles, idx, &tile);
+	const uint16_t tile16 = (uint16_t) tile;
+	CArraySet(&m->Tiles, idx, &tile16);
 	return true;
 }
 void MissionStaticClearTile(MissionStatic *m, const struct vec2i size,
@@ -785,9 +826,9 @@ bool MissionStaticRemoveTileClass(MissionStatic *m, const int tile) {
 	int i;
 	for (i = 0; MissionStaticIdTileClass(m, i) == NULL; i++)
 		;
-	CA_FOREACH(int, t, m->Tiles)
+	CA_FOREACH(uint16_t, t, m->Tiles)
 		if (*t == tile) {
-			*t = i;
+			*t = (uint16_t) i;
 		}CA_FOREACH_END()
 	return true;
 }
@@ -833,10 +874,11 @@ void MissionStaticLayout(MissionStatic *m, const struct vec2i size,
 	CArrayInit(&oldAccess, m->Access.elemSize);
 	CArrayCopy(&oldTiles, &m->Tiles);
 	CArrayCopy(&oldAccess, &m->Access);
-	const int firstTile = MissionStaticGetTile(m, oldSize, svec2i_zero());
+	const uint16_t firstTile =
+			(uint16_t) MissionStaticGetTile(m, oldSize, svec2i_zero());
 	CArrayResize(&m->Tiles, size.x * size.y, &firstTile);
 	CArrayFillZero(&m->Tiles);
-	const int noAccess = 0;
+	const uint16_t noAccess = 0;
 	CArrayResize(&m->Access, size.x * size.y, &noAccess);
 	CArrayFillZero(&m->Access);
 
@@ -846,15 +888,16 @@ void MissionStaticLayout(MissionStatic *m, const struct vec2i size,
 					MissionStaticClearTile(m, size, _v);
 				} else {
 					const int idx = _v.y * oldSize.x + _v.x;
-					const int *tile = static_cast<const int*>(CArrayGet(
-							&oldTiles, idx));
+					const uint16_t *tile = static_cast<const uint16_t*>(
+							CArrayGet(&oldTiles, idx));
 					MissionStaticTrySetTile(m, size, _v, *tile);
-					const int *a = static_cast<const int*>(CArrayGet(&oldAccess,
-							idx));
+					const uint16_t *a = static_cast<const uint16_t*>(
+							CArrayGet(&oldAccess, idx));
 					CArraySet(&m->Access, _v.y * size.x + _v.x, a);
 				}RECT_FOREACH_END()
 
 	CArrayTerminate(&oldTiles);
+	CArrayTerminate(&oldAccess);
 
 	m->Start = svec2i_clamp(m->Start, svec2i_zero(),
 			svec2i_subtract(size, svec2i_one()));
@@ -1079,7 +1122,7 @@ bool MissionStaticTryRemoveKeyAt(MissionStatic *m, const struct vec2i pos) {
 typedef struct {
 	MissionStatic *m;
 	struct vec2i size;
-	int tileAccess;
+	uint16_t tileAccess;
 } MissionFloodFillData;
 static void FloodFillSetAccess(void *data, const struct vec2i v);
 static bool FloodFillIsAccessSame(void *data, const struct vec2i v);
@@ -1101,8 +1144,8 @@ static void FloodFillSetAccess(void *data, const struct vec2i v) {
 }
 static bool FloodFillIsAccessSame(void *data, const struct vec2i v) {
 	MissionFloodFillData *mData = static_cast<MissionFloodFillData*>(data);
-	const int tileAccess = *(int*) CArrayGet(&mData->m->Access,
-			mData->size.x * v.y + v.x);
+	const uint16_t tileAccess = *(const uint16_t*) CArrayGet(
+			&mData->m->Access, mData->size.x * v.y + v.x);
 	const TileClass *tc = MissionStaticGetTileClass(mData->m, mData->size, v);
 	return tc->Type == TILE_CLASS_DOOR && tileAccess != mData->tileAccess;
 }
@@ -37,8 +37,8 @@
 
 typedef struct {
 	map_t TileClasses;	// of TileClass
-	CArray Tiles;		// of int (tile ids)
-	CArray Access;		// of int
+	CArray Tiles;		// of uint16_t (tile ids)
+	CArray Access;		// of uint16_t
 	CArray Items;		// of MapObjectPositions
 	CArray Characters;	// of CharacterPositions
 	CArray Objectives;	// of ObjectivePositions
@@ -51,11 +51,12 @@ typedef struct {
 } MissionStatic;
 
 bool MissionStaticTryLoadJSON(MissionStatic *m, json_t *node,
-		const int version);
+		const int version, const struct vec2i size);
 void MissionStaticFromMap(MissionStatic *m, const Map *map);
 void MissionStaticTerminate(MissionStatic *m);
+// Grids are saved compactly from MAP_VERSION_COMPACT_GRIDS, as CSV before
 void MissionStaticSaveJSON(const MissionStatic *m, const struct vec2i size,
-		json_t *node);
+		json_t *node, const int version);
 
 void MissionStaticCopy(MissionStatic *dst, const MissionStatic *src);
 
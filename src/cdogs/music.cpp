@@ -42,15 +42,18 @@
 #include "log.h"
 #include "sounds.h"
 
-Mix_Music* MusicLoad(const char *path) {
+bool MusicIsFile(const char *path) {
 	// Only load music from known extensions
 	const char *ext = strrchr(path, '.');
-	if (ext == NULL
-			|| !(strcmp(ext, ".it") == 0 || strcmp(ext, ".IT") == 0
+	return ext != NULL
+			&& (strcmp(ext, ".it") == 0 || strcmp(ext, ".IT") == 0
 					|| strcmp(ext, ".mod") == 0 || strcmp(ext, ".MOD") == 0
 					|| strcmp(ext, ".ogg") == 0 || strcmp(ext, ".OGG") == 0
 					|| strcmp(ext, ".s3m") == 0 || strcmp(ext, ".S3M") == 0
-					|| strcmp(ext, ".xm") == 0 || strcmp(ext, ".XM") == 0)) {
+					|| strcmp(ext, ".xm") == 0 || strcmp(ext, ".XM") == 0);
+}
+Mix_Music* MusicLoad(const char *path) {
+	if (!MusicIsFile(path)) {
 		return NULL;
 	}
 	LOG(LM_MAIN, LL_TRACE, "loading music file %s", path);
@@ -120,14 +123,16 @@ void MusicPlay(SoundDevice *device, const MusicType type,
 		if (tracks->size == 0) {
 			return;
 		}
-		device->music = *(Mix_Music**) CArrayGet(tracks, 0);
+		// Tracks are loaded when played and freed when stopped
+		const char *path = *(char **) CArrayGet(tracks, 0);
 		// Shuffle tracks
 		if (tracks->size > 1) {
-			while (device->music == *(Mix_Music**) CArrayGet(tracks, 0)) {
+			while (path == *(char **) CArrayGet(tracks, 0)) {
 				CArrayShuffle(tracks);
 			}
 		}
-		PlayMusic(device);
+		Play(device, path);
+		device->musicIsDynamic = true;
 	}
 }
 
@@ -50,6 +50,7 @@
 
 #include "sounds.h"
 
+bool MusicIsFile(const char *path);
 Mix_Music* MusicLoad(const char *path);
 void MusicPlay(SoundDevice *device, const MusicType type,
 		const char *missionPath, const char *music);
@@ -37,7 +37,9 @@
 #include "game_events.h"
 #include "gamedata.h"
 #include "log.h"
+#include "net_predict.h"
 #include "net_server.h"
+#include "net_stats.h"
 #include "player.h"
 #include "utils.h"
 
@@ -166,6 +168,9 @@ bool NetClientTryConnect(NetClient *n, const ENetAddress addr) {
 	// Set disconnect timeout ms
 	enet_peer_timeout(n->peer, 0, 0, TIMEOUT_MS);
 
+	// Don't carry stats over from a previous connection
+	NetStatsReset(&gNetStats);
+
 	// Tell the server that this is a proper connection request
 	NetClientSendMsg(n, GAME_EVENT_CLIENT_CONNECT, NULL);
 
@@ -271,6 +276,7 @@ void NetClientPoll(NetClient *n) {
 				break;
 			case ENET_EVENT_TYPE_DISCONNECT:
 				LOG(LM_NET, LL_INFO, "disconnected");
+				NetStatsOnDisconnect(&gNetStats, NET_STATS_PEER_SERVER);
 				NetClientDisconnect(n);
 				return;
 			default:
@@ -280,6 +286,10 @@ void NetClientPoll(NetClient *n) {
 			}
 		}
 	} while (check > 0);
+
+	if (n->peer != NULL) {
+		NetStatsSamplePeer(&gNetStats, NET_STATS_PEER_SERVER, n->peer);
+	}
 }
 static void Scanning(NetClient *n) {
 	// If it's been too long, stop scanning
@@ -325,6 +335,7 @@ static void Scanning(NetClient *n) {
 static void OnReceive(NetClient *n, ENetEvent event) {
 	const GameEventType msg = (GameEventType) *(uint32_t*) event.packet->data;
 	LOG(LM_NET, LL_TRACE, "recv msg(%u)", msg);
+	NetStatsOnRecv(&gNetStats, NET_STATS_PEER_SERVER, msg, event.packet);
 	const GameEventEntry gee = GameEventGetEntry(msg);
 	if (gee.Enqueue) {
 		if (gee.GameStart && !gMission.HasStarted) {
@@ -387,7 +398,13 @@ static void OnReceive(NetClient *n, ENetEvent event) {
 			if (actorUID >= 0) {
 				actorIsLocal = ActorIsLocalPlayer(actorUID);
 			}
-			if (actorIsLocal) {
+			if (actorIsLocal && gee.Type == GAME_EVENT_ACTOR_MOVE) {
+				// Authoritative position for a predicted actor
+				TActor *a = ActorGetByUID(actorUID);
+				if (a != NULL && a->isInUse) {
+					NetPredictReconcile(a, e.u.ActorMove);
+				}
+			} else if (actorIsLocal) {
 				LOG(LM_NET, LL_TRACE,
 						"game event is for local player, ignoring");
 			} else {
@@ -461,7 +478,9 @@ void NetClientSendMsg(NetClient *n, const GameEventType e, const void *data) {
 	}
 
 	LOG(LM_NET, LL_TRACE, "NetClient: send msg type %d", (int )e);
-	enet_peer_send(n->peer, 0, NetEncode(e, data));
+	ENetPacket *packet = NetEncode(e, data);
+	NetStatsOnSend(&gNetStats, NET_STATS_PEER_SERVER, e, packet);
+	enet_peer_send(n->peer, 0, packet);
 }
 
 bool NetClientIsConnected(const NetClient *n) {
@@ -0,0 +1,233 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "net_predict.h"
+
+#include "config.h"
+#include "defs.h"
+#include "game_events.h"
+#include "log.h"
+#include "map.h"
+#include "net_server.h"
+#include "net_util.h"
+#include "player.h"
+#include "utils.h"
+
+static int sSyncCounter = 0;
+
+static NetActorState *GetState(TActor *a) {
+	if (a->netState == NULL) {
+		CCALLOC(a->netState, sizeof *a->netState);
+	}
+	return a->netState;
+}
+
+void NetPredictReset(void) {
+	// Sync on the first tick of the game
+	sSyncCounter = 0;
+}
+
+void NetActorStateDestroy(NetActorState *s) {
+	if (s == NULL) {
+		return;
+	}
+	CFREE(s->inputs);
+	CFREE(s);
+}
+
+// Sequence numbers wrap; compare using the signed difference
+static int SeqDiff(const uint32_t a, const uint32_t b) {
+	return (int) (int32_t) (a - b);
+}
+// Index of the i'th oldest entry in a ring buffer
+static int RingIndex(const int head, const int count, const int size,
+		const int i) {
+	return (head - count + i + size) % size;
+}
+
+void NetPredictRecordInput(TActor *a) {
+	if (!gCampaign.IsClient) {
+		return;
+	}
+	NetActorState *s = GetState(a);
+	if (s->inputs == NULL) {
+		CCALLOC(s->inputs, sizeof *s->inputs * NET_PREDICT_INPUTS);
+	}
+	NetInput *in = &s->inputs[s->inputHead];
+	in->Seq = a->InputSeq;
+	in->Pos = a->Pos;
+	in->MoveVel = a->MoveVel;
+	in->Vel = a->thing.Vel;
+	s->inputHead = (s->inputHead + 1) % NET_PREDICT_INPUTS;
+	s->inputCount = MIN(s->inputCount + 1, NET_PREDICT_INPUTS);
+}
+
+void NetPredictReconcile(TActor *a, const NActorMove am) {
+	NetActorState *s = a->netState;
+	if (s == NULL || s->inputs == NULL) {
+		return;
+	}
+
+	// Drop inputs the server has already moved past
+	while (s->inputCount > 0) {
+		const NetInput *in = &s->inputs[RingIndex(s->inputHead,
+				s->inputCount, NET_PREDICT_INPUTS, 0)];
+		if (SeqDiff(in->Seq, am.Seq) >= 0) {
+			break;
+		}
+		s->inputCount--;
+	}
+	if (s->inputCount == 0) {
+		return;
+	}
+	const NetInput *acked = &s->inputs[RingIndex(s->inputHead, s->inputCount,
+			NET_PREDICT_INPUTS, 0)];
+	if (acked->Seq != am.Seq) {
+		// Stale move, or one for an input we no longer have
+		return;
+	}
+	const struct vec2 authPos = NetToVec2(am.Pos);
+	if (svec2_distance(authPos, acked->Pos) <= NET_PREDICT_EPSILON) {
+		return;
+	}
+	LOG(LM_NET, LL_DEBUG, "reconcile actor uid(%d) seq(%u) error(%f)", a->uid,
+			am.Seq, svec2_distance(authPos, acked->Pos));
+
+	// Rewind to the authoritative position and replay unacknowledged inputs
+	struct vec2 pos = authPos;
+	for (int i = 0; i < s->inputCount; i++) {
+		NetInput *in = &s->inputs[RingIndex(s->inputHead, s->inputCount,
+				NET_PREDICT_INPUTS, i)];
+		in->Pos = pos;
+		const struct vec2 to = svec2_add(pos, svec2_add(in->MoveVel, in->Vel));
+		if (!svec2_is_nearly_equal(pos, to, EPSILON_POS)) {
+			pos = ActorGetConstrainedPos(a, pos, to);
+		}
+	}
+
+	// Keep drawing from where we were and ease towards the corrected position,
+	// unless the error is so large that it is better to snap
+	const struct vec2 error = svec2_subtract(a->Pos, pos);
+	if (svec2_length(error) > NET_PREDICT_SNAP_DISTANCE) {
+		a->thing.drawCorrection = svec2_zero();
+	} else {
+		a->thing.drawCorrection = svec2_add(a->thing.drawCorrection, error);
+	}
+	a->Pos = pos;
+	MapTryMoveThing(&gMap, &a->thing, a->Pos);
+}
+
+static int InterpDelayTicks(void) {
+	const int fps = ConfigGetInt(&gConfig, "Game.FPS");
+	return CLAMP(NET_INTERP_DELAY_MS * fps / 1000, 1, NET_INTERP_HISTORY - 1);
+}
+
+void NetInterpOnMove(TActor *a, const struct vec2 oldPos) {
+	NetActorState *s = a->netState;
+	if (s == NULL || s->historyCount == 0) {
+		return;
+	}
+	const struct vec2 error = svec2_subtract(a->Pos, oldPos);
+	if (svec2_length(error) > NET_PREDICT_SNAP_DISTANCE) {
+		// Teleported; start the path afresh
+		s->historyCount = 0;
+		return;
+	}
+	// Spread the correction over the positions that are yet to be drawn,
+	// so that the drawn path bends towards the corrected one
+	const int window = MIN(InterpDelayTicks(), s->historyCount);
+	for (int i = 0; i < window; i++) {
+		const int idx = RingIndex(s->historyHead, s->historyCount,
+				NET_INTERP_HISTORY, s->historyCount - window + i);
+		s->history[idx] = svec2_add(s->history[idx],
+				svec2_scale(error, (float) (i + 1) / (window + 1)));
+	}
+}
+
+static void ClientUpdate(void);
+static void ServerUpdate(const int ticks);
+void NetPredictUpdate(const int ticks) {
+	if (gCampaign.IsClient) {
+		ClientUpdate();
+	} else if (gNetServer.server != NULL) {
+		ServerUpdate(ticks);
+	}
+}
+static void ClientUpdate(void) {
+	const int delay = InterpDelayTicks();
+	CA_FOREACH(TActor, a, gActors)
+		if (!a->isInUse || ActorIsLocalPlayer(a->uid)) {
+			continue;
+		}
+		// Actors that have never moved have nothing to interpolate; most
+		// enemies wait in place until they see a player
+		if (a->netState == NULL && svec2_is_zero(a->MoveVel)
+				&& svec2_is_zero(a->thing.Vel)) {
+			continue;
+		}
+		NetActorState *s = GetState(a);
+		s->history[s->historyHead] = a->Pos;
+		s->historyHead = (s->historyHead + 1) % NET_INTERP_HISTORY;
+		s->historyCount = MIN(s->historyCount + 1, NET_INTERP_HISTORY);
+		const int back = MIN(delay, s->historyCount - 1);
+		const struct vec2 drawPos = s->history[RingIndex(s->historyHead,
+				s->historyCount, NET_INTERP_HISTORY,
+				s->historyCount - 1 - back)];
+		a->thing.drawCorrection = svec2_subtract(drawPos, a->Pos);
+	CA_FOREACH_END()
+}
+static void ServerUpdate(const int ticks) {
+	sSyncCounter -= ticks;
+	const bool sync = sSyncCounter <= 0;
+	if (sync) {
+		sSyncCounter = NET_PREDICT_SYNC_TICKS;
+	}
+	CA_FOREACH(TActor, a, gActors)
+		if (!a->isInUse || a->PlayerUID < 0 || PlayerIsLocal(a->PlayerUID)) {
+			continue;
+		}
+		// Each server tick consumes a tick of the client's last input
+		a->InputSeq += ticks;
+		if (!sync || a->dead) {
+			continue;
+		}
+		if (svec2_is_zero(a->MoveVel) && svec2_is_zero(a->thing.Vel)) {
+			continue;
+		}
+		// Send directly rather than as a game event; the server must not
+		// apply its own correction on top of newer client moves that are
+		// already queued
+		NActorMove am = NActorMove_init_zero;
+		am.UID = a->uid;
+		am.Pos = Vec2ToNet(a->Pos);
+		am.MoveVel = Vec2ToNet(a->MoveVel);
+		am.Seq = a->InputSeq;
+		NetServerSendMsg(&gNetServer, NET_SERVER_BCAST, GAME_EVENT_ACTOR_MOVE,
+				&am);
+	CA_FOREACH_END()
+}
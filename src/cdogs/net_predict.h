@@ -0,0 +1,94 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "actors.h"
+#include "proto/msg.pb.h"
+
+// Client-side prediction and server reconciliation
+//
+// Local player actors on clients are simulated immediately from input.
+// Every tick of input is tagged with a sequence number and kept in a rolling
+// buffer until the server acknowledges it. Authoritative moves from the
+// server carry the sequence they correspond to; the client rewinds to the
+// authoritative position, replays the unacknowledged inputs, and hides the
+// resulting error by easing the drawn position towards the new one.
+//
+// Remote actors on clients are drawn slightly in the past, from a buffer of
+// simulated positions, so that corrections can be blended into the path
+// before they are displayed.
+
+// Number of unacknowledged inputs kept per local actor; about 1.8s at 70 FPS
+#define NET_PREDICT_INPUTS 128
+// Errors smaller than this are ignored
+#define NET_PREDICT_EPSILON 0.5f
+// Errors larger than this are snapped instead of smoothed
+#define NET_PREDICT_SNAP_DISTANCE 32.0f
+// How often the server sends authoritative positions for remote players
+#define NET_PREDICT_SYNC_TICKS 10
+// How far in the past remote actors are drawn
+#define NET_INTERP_DELAY_MS 100
+#define NET_INTERP_HISTORY 32
+
+typedef struct {
+	uint32_t Seq;
+	// Position before this input was applied
+	struct vec2 Pos;
+	struct vec2 MoveVel;
+	struct vec2 Vel;
+} NetInput;
+
+typedef struct NetActorState {
+	// Local actors: ring buffer of inputs not yet acknowledged by the server
+	// Only allocated for actors that are predicted
+	NetInput *inputs;
+	int inputHead;
+	int inputCount;
+	// Remote actors: ring buffer of simulated positions, one per tick
+	struct vec2 history[NET_INTERP_HISTORY];
+	int historyHead;
+	int historyCount;
+} NetActorState;
+
+void NetActorStateDestroy(NetActorState *s);
+// Call at the start of each game
+void NetPredictReset(void);
+
+// Record the input applied to a local actor this tick (clients only)
+void NetPredictRecordInput(TActor *a);
+// Reconcile a local actor against an authoritative move from the server
+void NetPredictReconcile(TActor *a, const NActorMove am);
+// Blend a correction to a remote actor into its drawn path
+void NetInterpOnMove(TActor *a, const struct vec2 oldPos);
+// Called once per tick after actors are updated:
+// - clients sample remote actor positions and set their draw offsets
+// - servers advance remote player sequences and send authoritative positions
+void NetPredictUpdate(const int ticks);
@@ -41,6 +41,7 @@
 #include "handle_game_events.h"
 #include "log.h"
 #include "los.h"
+#include "net_stats.h"
 #include "pickup.h"
 #include "player.h"
 #include "sys_config.h"
@@ -69,6 +70,8 @@ void NetServerOpen(NetServer *n) {
 	if (n->server == NULL) {
 		return;
 	}
+	// Don't carry stats over from a previous game
+	NetStatsReset(&gNetStats);
 
 	// Start listen socket, to respond to UDP scans
 	if (!ListenSocketTryOpen(&n->listen)) {
@@ -181,6 +184,14 @@ void NetServerPoll(NetServer *n) {
 		}
 	} while (check > 0);
 
+	for (int i = 0; i < (int) n->server->peerCount; i++) {
+		const ENetPeer *peer = n->server->peers + i;
+		if (peer->state == ENET_PEER_STATE_CONNECTED && peer->data != NULL) {
+			NetStatsSamplePeer(&gNetStats, ((NetPeerData*) peer->data)->Id,
+					peer);
+		}
+	}
+
 	NetServerFlush(n);
 }
 static void PollListener(NetServer *n) {
@@ -239,6 +250,7 @@ static void OnReceive(NetServer *n, ENetEvent event) {
 		peerId = ((NetPeerData*) event.peer->data)->Id;
 		LOG(LM_NET, LL_TRACE, "recv message from peerId(%d) msg(%d)", peerId,
 				(int )msg);
+		NetStatsOnRecv(&gNetStats, peerId, msg, event.packet);
 	}
 	const GameEventEntry gee = GameEventGetEntry(msg);
 	if (gee.Enqueue) {
@@ -341,6 +353,7 @@ static void OnDisconnect(const ENetEvent event) {
 		peerId = ((NetPeerData*) event.peer->data)->Id;
 		CFREE(event.peer->data);
 		event.peer->data = NULL;
+		NetStatsOnDisconnect(&gNetStats, peerId);
 	}
 	CASSERT(peerId >= 0, "Cannot find disconnected peer id");
 	char buf[256];
@@ -420,7 +433,7 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId) {
 		for (pos.x = 0; pos.x < gMap.Size.x; pos.x++) {
 			const Tile *t = MapGetTile(&gMap, pos);
 			// Use RLE, so check if the current tile is the same as the last
-			if (tLast != NULL && t->Class == tLast->Class) {
+			if (tLast != NULL && t->classIndex == tLast->classIndex) {
 				ts.RunLength++;
 			} else {
 				// Send the last run
@@ -430,8 +443,9 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId) {
 				// Begin the next run
 				memset(&ts, 0, sizeof ts);
 				ts.Pos = Vec2i2Net(pos);
-				if (t->Class != NULL && t->Class->Name) {
-					strcpy(ts.ClassName, t->Class->Name);
+				const TileClass *tc = TileGetClass(t);
+				if (tc != NULL && tc->Name) {
+					strcpy(ts.ClassName, tc->Name);
 				}
 				ts.RunLength = 0;
 			}
@@ -499,35 +513,7 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId) {
 }
 static void SendConfig(Config *config, const char *name, NetServer *n,
 		const int peerId) {
-	NConfig msg = NConfig_init_default;
-	const Config *c = ConfigGet(config, name);
-	strcpy(msg.Name, name);
-	switch (c->Type) {
-	case CONFIG_TYPE_STRING:
-		CASSERT(false, "unimplemented")
-		;
-		break;
-	case CONFIG_TYPE_INT:
-		sprintf(msg.Value, "%d", c->u.Int.Value);
-		break;
-	case CONFIG_TYPE_FLOAT:
-		sprintf(msg.Value, "%f", c->u.Float.Value);
-		break;
-	case CONFIG_TYPE_BOOL:
-		strcpy(msg.Value, c->u.Bool.Value ? "true" : "false");
-		break;
-	case CONFIG_TYPE_ENUM:
-		sprintf(msg.Value, "%d", (int) c->u.Enum.Value);
-		break;
-	case CONFIG_TYPE_GROUP:
-		CASSERT(false, "Cannot send groups over net")
-		;
-		break;
-	default:
-		CASSERT(false, "Unknown config type")
-		;
-		break;
-	}
+	const NConfig msg = NMakeConfig(config, name);
 	NetServerSendMsg(n, peerId, GAME_EVENT_CONFIG, &msg);
 }
 
@@ -544,7 +530,9 @@ void NetServerSendMsg(NetServer *n, const int peerId, const GameEventType e,
 			ENetPeer *peer = n->server->peers + i;
 			if (peer->data != NULL
 					&& ((NetPeerData*) peer->data)->Id == peerId) {
-				enet_peer_send(peer, 0, NetEncode(e, data));
+				ENetPacket *packet = NetEncode(e, data);
+				NetStatsOnSend(&gNetStats, peerId, e, packet);
+				enet_peer_send(peer, 0, packet);
 				return;
 			}
 		}
@@ -552,6 +540,15 @@ void NetServerSendMsg(NetServer *n, const int peerId, const GameEventType e,
 	} else {
 		LOG(LM_NET, LL_TRACE, "bcast msg(%d) to peers(%d)", (int )e,
 				(int )n->server->connectedPeers);
-		enet_host_broadcast(n->server, 0, NetEncode(e, data));
+		ENetPacket *packet = NetEncode(e, data);
+		for (int i = 0; i < (int) n->server->peerCount; i++) {
+			const ENetPeer *peer = n->server->peers + i;
+			if (peer->state == ENET_PEER_STATE_CONNECTED
+					&& peer->data != NULL) {
+				NetStatsOnSend(&gNetStats, ((NetPeerData*) peer->data)->Id, e,
+						packet);
+			}
+		}
+		enet_host_broadcast(n->server, 0, packet);
 	}
 }
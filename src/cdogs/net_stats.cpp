@@ -0,0 +1,268 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "net_stats.h"
+
+#include <string.h>
+
+#include "font.h"
+#include "grafx.h"
+#include "log.h"
+#include "utils.h"
+
+#define NET_STATS_TOP_TYPES 3
+
+NetStats gNetStats;
+
+void NetStatsInit(NetStats *n) {
+	memset(n, 0, sizeof *n);
+	CArrayInit(&n->Peers, sizeof(NetPeerStats));
+	n->DumpIntervalMs = NET_STATS_DUMP_INTERVAL_MS;
+}
+void NetStatsTerminate(NetStats *n) {
+	CArrayTerminate(&n->Peers);
+	if (n->dumpFile != NULL) {
+		fclose(n->dumpFile);
+		n->dumpFile = NULL;
+	}
+}
+void NetStatsReset(NetStats *n) {
+	CArrayClear(&n->Peers);
+}
+
+bool NetStatsOpenDump(NetStats *n, const char *filename, const int intervalMs) {
+	if (n->dumpFile != NULL) {
+		fclose(n->dumpFile);
+	}
+	n->dumpFile = fopen(filename, "w");
+	if (n->dumpFile == NULL) {
+		LOG(LM_NET, LL_ERROR, "cannot open net stats file %s", filename);
+		return false;
+	}
+	n->dumpJSON = StrEndsWith(filename, ".json");
+	n->DumpIntervalMs = intervalMs > 0 ? intervalMs : NET_STATS_DUMP_INTERVAL_MS;
+	if (!n->dumpJSON) {
+		fprintf(n->dumpFile, "ticks,peer,type,sent_msgs,sent_bytes,"
+				"recv_msgs,recv_bytes,packets,resends,rtt,queue\n");
+	}
+	LOG(LM_NET, LL_INFO, "writing net stats to %s every %dms", filename,
+			n->DumpIntervalMs);
+	return true;
+}
+
+static NetPeerStats* GetPeer(NetStats *n, const int peerId) {
+	CA_FOREACH(NetPeerStats, ps, n->Peers)
+		if (ps->PeerId == peerId) {
+			return ps;
+		}
+	CA_FOREACH_END()
+	NetPeerStats ps;
+	memset(&ps, 0, sizeof ps);
+	ps.PeerId = peerId;
+	ps.IsConnected = true;
+	CArrayPushBack(&n->Peers, &ps);
+	return static_cast<NetPeerStats*>(CArrayGet(&n->Peers, n->Peers.size - 1));
+}
+
+void NetStatsOnSend(NetStats *n, const int peerId, const GameEventType e,
+		const ENetPacket *packet) {
+	if ((int) e < 0 || e >= GAME_EVENT_COUNT) {
+		return;
+	}
+	NetPeerStats *ps = GetPeer(n, peerId);
+	ps->Sent[e].Msgs++;
+	ps->Sent[e].Bytes += (int) packet->dataLength;
+}
+void NetStatsOnRecv(NetStats *n, const int peerId, const GameEventType e,
+		const ENetPacket *packet) {
+	if ((int) e < 0 || e >= GAME_EVENT_COUNT) {
+		return;
+	}
+	NetPeerStats *ps = GetPeer(n, peerId);
+	ps->Recv[e].Msgs++;
+	ps->Recv[e].Bytes += (int) packet->dataLength;
+}
+static int CounterDelta(const enet_uint32 value, const enet_uint32 last);
+void NetStatsSamplePeer(NetStats *n, const int peerId, const ENetPeer *peer) {
+	NetPeerStats *ps = GetPeer(n, peerId);
+	ps->IsConnected = true;
+	ps->RTT = (int) peer->roundTripTime;
+	ps->RTTVariance = (int) peer->roundTripTimeVariance;
+	ps->QueueDepth = (int) enet_list_size(
+			const_cast<ENetList*>(&peer->outgoingReliableCommands));
+	ps->DataInTransit = (int) peer->reliableDataInTransit;
+	// ENet counts a lost packet every time a reliable command is resent
+	ps->Packets += CounterDelta(peer->packetsSent, ps->lastPacketsSent);
+	ps->Resends += CounterDelta(peer->packetsLost, ps->lastPacketsLost);
+	ps->lastPacketsSent = peer->packetsSent;
+	ps->lastPacketsLost = peer->packetsLost;
+}
+static int CounterDelta(const enet_uint32 value, const enet_uint32 last) {
+	// If the value went backwards, the counter has been reset
+	return (int) (value >= last ? value - last : value);
+}
+void NetStatsOnDisconnect(NetStats *n, const int peerId) {
+	GetPeer(n, peerId)->IsConnected = false;
+}
+
+static void RollRates(NetStats *n);
+static void Dump(NetStats *n, const Uint32 ticksNow);
+void NetStatsUpdate(NetStats *n, const Uint32 ticksNow) {
+	if (ticksNow - n->windowStart >= 1000) {
+		RollRates(n);
+		n->windowStart = ticksNow;
+	}
+	if (n->dumpFile != NULL
+			&& (int) (ticksNow - n->lastDump) >= n->DumpIntervalMs) {
+		Dump(n, ticksNow);
+		n->lastDump = ticksNow;
+	}
+}
+static void RollRates(NetStats *n) {
+	CA_FOREACH(NetPeerStats, ps, n->Peers)
+		for (int i = 0; i < GAME_EVENT_COUNT; i++) {
+			ps->SentRate[i].Msgs = ps->Sent[i].Msgs - ps->sentLast[i].Msgs;
+			ps->SentRate[i].Bytes = ps->Sent[i].Bytes - ps->sentLast[i].Bytes;
+			ps->RecvRate[i].Msgs = ps->Recv[i].Msgs - ps->recvLast[i].Msgs;
+			ps->RecvRate[i].Bytes = ps->Recv[i].Bytes - ps->recvLast[i].Bytes;
+		}
+		memcpy(ps->sentLast, ps->Sent, sizeof ps->sentLast);
+		memcpy(ps->recvLast, ps->Recv, sizeof ps->recvLast);
+	CA_FOREACH_END()
+}
+static void Dump(NetStats *n, const Uint32 ticksNow) {
+	CA_FOREACH(const NetPeerStats, ps, n->Peers)
+		if (n->dumpJSON) {
+			fprintf(n->dumpFile,
+					"{\"ticks\":%u,\"peer\":%d,\"connected\":%s,"
+							"\"packets\":%d,\"resends\":%d,\"rtt\":%d,"
+							"\"rttVariance\":%d,\"queue\":%d,\"inTransit\":%d,"
+							"\"types\":{", ticksNow, ps->PeerId,
+					ps->IsConnected ? "true" : "false", ps->Packets,
+					ps->Resends, ps->RTT, ps->RTTVariance, ps->QueueDepth,
+					ps->DataInTransit);
+			bool first = true;
+			for (int i = 0; i < GAME_EVENT_COUNT; i++) {
+				if (ps->Sent[i].Msgs == 0 && ps->Recv[i].Msgs == 0) {
+					continue;
+				}
+				fprintf(n->dumpFile,
+						"%s\"%s\":{\"sentMsgs\":%d,\"sentBytes\":%d,"
+								"\"recvMsgs\":%d,\"recvBytes\":%d}",
+						first ? "" : ",", GameEventTypeStr((GameEventType) i),
+						ps->Sent[i].Msgs, ps->Sent[i].Bytes, ps->Recv[i].Msgs,
+						ps->Recv[i].Bytes);
+				first = false;
+			}
+			fprintf(n->dumpFile, "}}\n");
+		} else {
+			for (int i = 0; i < GAME_EVENT_COUNT; i++) {
+				if (ps->Sent[i].Msgs == 0 && ps->Recv[i].Msgs == 0) {
+					continue;
+				}
+				fprintf(n->dumpFile, "%u,%d,%s,%d,%d,%d,%d,%d,%d,%d,%d\n",
+						ticksNow, ps->PeerId,
+						GameEventTypeStr((GameEventType) i), ps->Sent[i].Msgs,
+						ps->Sent[i].Bytes, ps->Recv[i].Msgs, ps->Recv[i].Bytes,
+						ps->Packets, ps->Resends, ps->RTT, ps->QueueDepth);
+			}
+		}
+	CA_FOREACH_END()
+	fflush(n->dumpFile);
+}
+
+static void DrawLine(const char *s, int *line);
+void NetStatsDraw(const NetStats *n) {
+	// Draw from the bottom up, above the FPS counter
+	int line = 1;
+	char buf[256];
+	int sentTotal = 0;
+	int recvTotal = 0;
+	CA_FOREACH(const NetPeerStats, ps, n->Peers)
+		if (!ps->IsConnected) {
+			continue;
+		}
+		int sent = 0;
+		int recv = 0;
+		// Find the message types that use the most bandwidth
+		int top[NET_STATS_TOP_TYPES];
+		for (int i = 0; i < NET_STATS_TOP_TYPES; i++) {
+			top[i] = -1;
+		}
+		for (int i = 0; i < GAME_EVENT_COUNT; i++) {
+			const int bytes = ps->SentRate[i].Bytes + ps->RecvRate[i].Bytes;
+			sent += ps->SentRate[i].Bytes;
+			recv += ps->RecvRate[i].Bytes;
+			if (bytes == 0) {
+				continue;
+			}
+			for (int j = 0; j < NET_STATS_TOP_TYPES; j++) {
+				if (top[j] == -1
+						|| bytes
+								> ps->SentRate[top[j]].Bytes
+										+ ps->RecvRate[top[j]].Bytes) {
+					memmove(&top[j + 1], &top[j],
+							(NET_STATS_TOP_TYPES - j - 1) * sizeof top[0]);
+					top[j] = i;
+					break;
+				}
+			}
+		}
+		sentTotal += sent;
+		recvTotal += recv;
+		for (int j = NET_STATS_TOP_TYPES - 1; j >= 0; j--) {
+			if (top[j] == -1) {
+				continue;
+			}
+			const int t = top[j];
+			sprintf(buf, "  %s: %dB/s (%d/s)", GameEventTypeStr((GameEventType) t),
+					ps->SentRate[t].Bytes + ps->RecvRate[t].Bytes,
+					ps->SentRate[t].Msgs + ps->RecvRate[t].Msgs);
+			DrawLine(buf, &line);
+		}
+		if (ps->PeerId == NET_STATS_PEER_SERVER) {
+			strcpy(buf, "server");
+		} else {
+			sprintf(buf, "peer %d", ps->PeerId);
+		}
+		sprintf(buf + strlen(buf), ": rtt %d+-%dms resend %d queue %d",
+				ps->RTT, ps->RTTVariance, ps->Resends, ps->QueueDepth);
+		DrawLine(buf, &line);
+	CA_FOREACH_END()
+	sprintf(buf, "Net out %dB/s in %dB/s", sentTotal, recvTotal);
+	DrawLine(buf, &line);
+}
+static void DrawLine(const char *s, int *line) {
+	FontOpts opts = FontOptsNew();
+	opts.HAlign = ALIGN_END;
+	opts.VAlign = ALIGN_END;
+	opts.Area = gGraphicsDevice.cachedConfig.Res;
+	opts.Pad = svec2i(10, 22 + FontH() * *line);
+	FontStrOpt(s, svec2i_zero(), opts);
+	(*line)++;
+}
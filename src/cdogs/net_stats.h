@@ -0,0 +1,103 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <SDL2/SDL_stdinc.h>
+
+#include <enet/enet.h>
+
+#include "c_array.h"
+#include "game_events.h"
+
+// Peer id used by clients to record traffic with the server
+#define NET_STATS_PEER_SERVER -1
+#define NET_STATS_DUMP_INTERVAL_MS 1000
+
+typedef struct {
+	int Msgs;
+	int Bytes;
+} NetStatsCounter;
+
+// Per-peer, per-message-type traffic counters, plus connection state
+// sampled from the ENet peer
+typedef struct {
+	int PeerId;
+	bool IsConnected;
+	NetStatsCounter Sent[GAME_EVENT_COUNT];
+	NetStatsCounter Recv[GAME_EVENT_COUNT];
+	// Traffic over the last whole second
+	NetStatsCounter SentRate[GAME_EVENT_COUNT];
+	NetStatsCounter RecvRate[GAME_EVENT_COUNT];
+	int Packets;
+	int Resends;
+	int RTT;
+	int RTTVariance;
+	// Reliable commands queued but not yet sent
+	int QueueDepth;
+	int DataInTransit;
+	// ENet resets its packet counters every loss interval; keep the last
+	// samples so we can accumulate across resets
+	enet_uint32 lastPacketsSent;
+	enet_uint32 lastPacketsLost;
+	NetStatsCounter sentLast[GAME_EVENT_COUNT];
+	NetStatsCounter recvLast[GAME_EVENT_COUNT];
+} NetPeerStats;
+
+typedef struct {
+	CArray Peers;	// of NetPeerStats
+	Uint32 windowStart;
+	Uint32 lastDump;
+	int DumpIntervalMs;
+	FILE *dumpFile;
+	bool dumpJSON;
+} NetStats;
+
+extern NetStats gNetStats;
+
+void NetStatsInit(NetStats *n);
+void NetStatsTerminate(NetStats *n);
+void NetStatsReset(NetStats *n);
+
+// Periodically write stats to a file; format is JSON (one object per line)
+// if the filename ends with .json, otherwise CSV
+bool NetStatsOpenDump(NetStats *n, const char *filename, const int intervalMs);
+
+void NetStatsOnSend(NetStats *n, const int peerId, const GameEventType e,
+		const ENetPacket *packet);
+void NetStatsOnRecv(NetStats *n, const int peerId, const GameEventType e,
+		const ENetPacket *packet);
+void NetStatsSamplePeer(NetStats *n, const int peerId, const ENetPeer *peer);
+void NetStatsOnDisconnect(NetStats *n, const int peerId);
+
+// Roll per-second rates and write periodic dumps
+void NetStatsUpdate(NetStats *n, const Uint32 ticksNow);
+void NetStatsDraw(const NetStats *n);
@@ -84,6 +84,38 @@ NCampaignDef NMakeCampaignDef(const CampaignOptions *co) {
 	def.Mission = co->MissionIndex;
 	return def;
 }
+NConfig NMakeConfig(Config *config, const char *name) {
+	NConfig msg = NConfig_init_default;
+	const Config *c = ConfigGet(config, name);
+	strcpy(msg.Name, name);
+	switch (c->Type) {
+	case CONFIG_TYPE_STRING:
+		CASSERT(false, "unimplemented")
+		;
+		break;
+	case CONFIG_TYPE_INT:
+		sprintf(msg.Value, "%d", c->u.Int.Value);
+		break;
+	case CONFIG_TYPE_FLOAT:
+		sprintf(msg.Value, "%f", c->u.Float.Value);
+		break;
+	case CONFIG_TYPE_BOOL:
+		strcpy(msg.Value, c->u.Bool.Value ? "true" : "false");
+		break;
+	case CONFIG_TYPE_ENUM:
+		sprintf(msg.Value, "%d", (int) c->u.Enum.Value);
+		break;
+	case CONFIG_TYPE_GROUP:
+		CASSERT(false, "Cannot send groups over net")
+		;
+		break;
+	default:
+		CASSERT(false, "Unknown config type")
+		;
+		break;
+	}
+	return msg;
+}
 NMissionComplete NMakeMissionComplete(const struct MissionOptions *mo,
 		const Map *map) {
 	NMissionComplete mc;
@@ -34,13 +34,14 @@
 #include <enet/enet.h>
 
 #include "campaigns.h"
+#include "config.h"
 #include "game_events.h"
 #include "map.h"
 #include "player.h"
 
 #define NET_LISTEN_PORT 34219
 
-#define NET_PROTOCOL_VERSION 7
+#define NET_PROTOCOL_VERSION 8
 
 // Messages
 
@@ -52,6 +53,7 @@ bool NetDecode(ENetPacket *packet, void *dest, const pb_field_t *fields);
 
 NPlayerData NMakePlayerData(const PlayerData *p);
 NCampaignDef NMakeCampaignDef(const CampaignOptions *co);
+NConfig NMakeConfig(Config *config, const char *name);
 NMissionComplete NMakeMissionComplete(const struct MissionOptions *mo,
 		const Map *map);
 
@@ -27,6 +27,7 @@
  */
 #include "particle.h"
 
+#include "asset_pack.h"
 #include "campaigns.h"
 #include "collision/collision.h"
 #include "font.h"
@@ -55,25 +56,13 @@ void ParticleClassesInit(ParticleClasses *classes, const char *filename) {
 	CArrayInit(&classes->Classes, sizeof(ParticleClass));
 	CArrayInit(&classes->CustomClasses, sizeof(ParticleClass));
 
-	char buf[CDOGS_PATH_MAX];
-	GetDataFilePath(buf, filename);
-	FILE *f = fopen(buf, "r");
-	json_t *root = NULL;
-	enum json_error e;
-	if (f == NULL) {
-		LOG(LM_MAIN, LL_ERROR, "Error: cannot load particles file %s", buf);
-		goto bail;
-	}
-	e = json_stream_parse(f, &root);
-	if (e != JSON_OK) {
-		LOG(LM_MAIN, LL_ERROR, "Error parsing particles file %s", buf);
-		goto bail;
+	json_t *root = AssetPackReadJSON(&gAssetPack, filename);
+	if (root == NULL) {
+		LOG(LM_MAIN, LL_ERROR, "Error: cannot load particles file %s",
+				filename);
+		return;
 	}
 	ParticleClassesLoadJSON(&classes->Classes, root);
-
-	bail: if (f != NULL) {
-		fclose(f);
-	}
 	json_free_value(&root);
 }
 void ParticleClassesLoadJSON(CArray *classes, json_t *root) {
@@ -30,12 +30,13 @@
 
 #include "c_hashmap/hashmap.h"
 #include "defs.h"
+#include "draw/sprite_batch.h"
 #include "grafx.h"
 #include "log.h"
 #include "texture.h"
 #include "utils.h"
 
-Pic picNone = { { 0, 0 }, { 0, 0 }, NULL, NULL };
+Pic picNone = { { 0, 0 }, { 0, 0 }, NULL, NULL, false, { 0, 0 } };
 map_t textureDebugger = NULL;
 
 color_t PixelToColor(const SDL_PixelFormat *f, const Uint8 aShift,
@@ -94,6 +95,12 @@ bool PicTryMakeTex(Pic *p) {
 	if (textureDebugger == NULL) {
 		textureDebugger = hashmap_new();
 	}
+	// Atlas pages are shared; give this pic its own texture instead
+	if (p->InAtlas) {
+		p->Tex = NULL;
+		p->InAtlas = false;
+		p->TexPos = svec2i_zero();
+	}
 	if (p->Tex != NULL) {
 		LOG(LM_GFX, LL_TRACE, "destroying texture %p data(%p)", p->Tex,
 				p->Data);
@@ -152,12 +159,14 @@ Pic PicCopy(const Pic *src) {
 	CMALLOC(p.Data, size);
 	memcpy(p.Data, src->Data, size);
 	p.Tex = NULL;
+	p.InAtlas = false;
+	p.TexPos = svec2i_zero();
 	return p;
 }
 
 void PicFree(Pic *pic) {
 	pic->size = svec2i_zero();
-	if (pic->Tex != NULL) {
+	if (pic->Tex != NULL && !pic->InAtlas) {
 		LOG(LM_GFX, LL_TRACE, "freeing texture %p data(%p)", pic->Tex,
 				pic->Data);
 		SDL_DestroyTexture(pic->Tex);
@@ -284,5 +293,9 @@ void PicRender(const Pic *p, SDL_Renderer *r, const struct vec2i pos,
 		dest.Size.y = (mint_t) MROUND(src.Size.y * scale.y);
 	}
 	const double angle = ToDegrees(radians);
-	TextureRender(p->Tex, r, src, dest, mask, angle, flip);
+	src.Pos = svec2i_add(src.Pos, p->TexPos);
+	if (!SpriteBatchAdd(&gSpriteBatch, r, p->Tex, src, dest, mask, angle,
+			flip)) {
+		TextureRender(p->Tex, r, src, dest, mask, angle, flip);
+	}
 }
@@ -34,6 +34,10 @@ struct Pic {
 	struct vec2i offset;
 	Uint32 *Data;
 	SDL_Texture *Tex;
+	// If packed into an atlas, Tex is the atlas page and this is where the
+	// pic is within it
+	bool InAtlas;
+	struct vec2i TexPos;
 };
 
 extern Pic picNone;
@@ -27,14 +27,16 @@
  */
 #include "pic_manager.h"
 
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_cpuinfo.h>
 #include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
 
-#include <tinydir/tinydir.h>
-
+#include "asset_pack.h"
 #include "files.h"
 #include "log.h"
-
-#define GRAPHICS_DIR "graphics"
+#include "profiler.h"
 
 PicManager gPicManager;
 
@@ -54,13 +56,16 @@ void PicManagerInit(PicManager *pm) {
 	CArrayInit(&pm->exitStyleNames, sizeof(char*));
 	CArrayInit(&pm->doorStyleNames, sizeof(char*));
 	CArrayInit(&pm->keyStyleNames, sizeof(char*));
+	AtlasInit(&pm->atlas);
+	CharSpriteCacheInit(&pm->charSprites);
 }
 
 static NamedPic* AddNamedPic(map_t pics, const char *name, const Pic *p);
 static NamedSprites* AddNamedSprites(map_t sprites, const char *name);
 static void AfterAdd(PicManager *pm);
+// Add an image, which must be RGBA8888 and is freed
 static void PicManagerAdd(map_t pics, map_t sprites, const char *name,
-		SDL_Surface *imageIn) {
+		SDL_Surface *image) {
 	char buf[CDOGS_FILENAME_MAX];
 	const char *dot = strrchr(name, '.');
 	if (dot) {
@@ -73,14 +78,14 @@ static void PicManagerAdd(map_t pics, map_t sprites, const char *name,
 	// Special case: if the file name is in the form foobar_WxH.ext,
 	// this is a spritesheet where each sprite is W wide by H high
 	// Load multiple images from this single sheet
-	struct vec2i size = svec2i(imageIn->w, imageIn->h);
+	struct vec2i size = svec2i(image->w, image->h);
 	bool isSpritesheet = false;
 	char *underscore = strrchr(buf, '_');
 	const char *x = strrchr(buf, 'x');
 	if (underscore != NULL && x != NULL && underscore + 1 < x
 			&& x + 1 < buf + strlen(buf)) {
 		if (sscanf(underscore, "_%dx%d", &size.x, &size.y) != 2) {
-			size = svec2i(imageIn->w, imageIn->h);
+			size = svec2i(image->w, image->h);
 		} else {
 			*underscore = '\0';
 			isSpritesheet = true;
@@ -93,10 +98,6 @@ static void PicManagerAdd(map_t pics, map_t sprites, const char *name,
 	} else {
 		np = AddNamedPic(pics, buf, NULL);
 	}
-	// Use 32-bit image
-	SDL_Surface *image = SDL_ConvertSurfaceFormat(imageIn,
-			SDL_PIXELFORMAT_RGBA8888, 0);
-	SDL_FreeSurface(imageIn);
 	SDL_LockSurface(image);
 	struct vec2i offset;
 	for (offset.y = 0; offset.y < image->h; offset.y += size.y) {
@@ -155,66 +156,188 @@ static void PicManagerAdd(map_t pics, map_t sprites, const char *name,
 	}
 	SDL_UnlockSurface(image);
 	SDL_FreeSurface(image);
-
-	AfterAdd(&gPicManager);
 }
 
+// Images are loaded in a pipeline: the directory tree is listed, worker
+// threads decode the files, and the main thread adds them in listing order
+// as they become ready, since textures can only be made there.
+typedef struct {
+	SDL_Surface *image;
+	SDL_atomic_t done;
+} PicLoadJob;
+typedef struct {
+	CArray files;	// of AssetFile
+	CArray jobs;	// of PicLoadJob, one per file
+	SDL_atomic_t next;
+	SDL_sem *done;
+} PicLoader;
+static int DecodeWorker(void *data);
+static bool DecodeNext(PicLoader *l);
 void PicManagerLoadDir(PicManager *pm, const char *path, const char *prefix,
 		map_t pics, map_t sprites) {
-	tinydir_dir dir;
-	if (tinydir_open(&dir, path) == -1) {
-		if (errno != ENOENT) {
-			LOG(LM_MAIN, LL_ERROR, "Error opening image dir '%s': %s", path,
-					strerror(errno));
-		}
+	PicLoader l;
+	memset(&l, 0, sizeof l);
+	SDL_Thread *threads[PIC_LOAD_MAX_THREADS];
+	int numThreads = 0;
+	CArrayInit(&l.files, sizeof(AssetFile));
+	CArrayInit(&l.jobs, sizeof(PicLoadJob));
+	AssetFilesList(&l.files, path, prefix);
+	if (l.files.size == 0) {
 		goto bail;
 	}
+	CArrayResize(&l.jobs, l.files.size, NULL);
+	CArrayFillZero(&l.jobs);
 
-	for (; dir.has_next; tinydir_next(&dir)) {
-		tinydir_file file;
-		if (tinydir_readfile(&dir, &file) == -1) {
-			LOG(LM_MAIN, LL_ERROR, "Cannot read file '%s': %s", file.path,
-					strerror(errno));
-			goto bail;
-		}
-		if (file.is_reg) {
-			SDL_RWops *rwops = SDL_RWFromFile(file.path, "rb");
-			const bool isPng = IMG_isPNG(rwops);
-			if (isPng) {
-				SDL_Surface *data = IMG_Load_RW(rwops, 0);
-				if (!data) {
-					LOG(LM_MAIN, LL_ERROR, "Cannot load image IMG_Load: %s",
-							IMG_GetError());
-				} else {
-					char buf[CDOGS_PATH_MAX];
-					if (prefix) {
-						char buf1[CDOGS_PATH_MAX];
-						sprintf(buf1, "%s/%s", prefix, file.name);
-						PathGetWithoutExtension(buf, buf1);
-					} else {
-						PathGetBasenameWithoutExtension(buf, file.name);
-					}
-					PicManagerAdd(pics, sprites, buf, data);
-				}
+	l.done = SDL_CreateSemaphore(0);
+	if (l.done != NULL) {
+		const int wanted = CLAMP(SDL_GetCPUCount() - 1, 0,
+				PIC_LOAD_MAX_THREADS);
+		for (; numThreads < MIN(wanted, (int) l.jobs.size); numThreads++) {
+			threads[numThreads] = SDL_CreateThread(DecodeWorker,
+					"pic decode", &l);
+			if (threads[numThreads] == NULL) {
+				LOG(LM_MAIN, LL_WARN, "cannot create pic decode thread: %s",
+						SDL_GetError());
+				break;
 			}
-			rwops->close(rwops);
-		} else if (file.is_dir && file.name[0] != '.') {
-			if (prefix) {
-				char buf[CDOGS_PATH_MAX];
-				sprintf(buf, "%s/%s", prefix, file.name);
-				PicManagerLoadDir(pm, file.path, buf, pics, sprites);
-			} else {
-				PicManagerLoadDir(pm, file.path, file.name, pics, sprites);
+		}
+	}
+	LOG(LM_MAIN, LL_DEBUG, "loading %d images from %s with %d threads",
+			(int) l.jobs.size, path, numThreads);
+
+	CA_FOREACH(PicLoadJob, job, l.jobs)
+		// Help decode while waiting; if all are taken, wait for any to finish
+		while (!SDL_AtomicGet(&job->done)) {
+			if (!DecodeNext(&l)) {
+				SDL_SemWait(l.done);
 			}
 		}
+		if (job->image != NULL) {
+			const AssetFile *af = static_cast<const AssetFile*>(
+					CArrayGet(&l.files, _ca_index));
+			PicManagerAdd(pics, sprites, af->Name, job->image);
+		}
+		if ((_ca_index + 1) % 100 == 0) {
+			LOG(LM_MAIN, LL_DEBUG, "loaded %d/%d images", _ca_index + 1,
+					(int) l.jobs.size);
+		}
+	CA_FOREACH_END()
+
+	for (int i = 0; i < numThreads; i++) {
+		SDL_WaitThread(threads[i], NULL);
 	}
+	AfterAdd(pm);
 
-	bail: tinydir_close(&dir);
+bail:
+	if (l.done != NULL) {
+		SDL_DestroySemaphore(l.done);
+	}
+	AssetFilesTerminate(&l.files);
+	CArrayTerminate(&l.jobs);
+}
+static int DecodeWorker(void *data) {
+	PicLoader *l = static_cast<PicLoader*>(data);
+	while (DecodeNext(l)) {
+	}
+	return 0;
+}
+// Take the next undecoded job and decode it.
+// Returns false if there are none left.
+static bool DecodeNext(PicLoader *l) {
+	const int i = SDL_AtomicAdd(&l->next, 1);
+	if (i >= (int) l->jobs.size) {
+		return false;
+	}
+	PicLoadJob *job = static_cast<PicLoadJob*>(CArrayGet(&l->jobs, i));
+	const AssetFile *af = static_cast<const AssetFile*>(
+			CArrayGet(&l->files, i));
+	job->image = AssetDecodePNG(af->Path);
+	SDL_AtomicSet(&job->done, 1);
+	if (l->done != NULL) {
+		SDL_SemPost(l->done);
+	}
+	return true;
 }
+static void PackAtlas(PicManager *pm, map_t pics, map_t sprites,
+		const bool isCustom, const bool remakeTex);
+static bool LoadPack(PicManager *pm);
 void PicManagerLoad(PicManager *pm) {
-	char buf[CDOGS_PATH_MAX];
-	GetDataFilePath(buf, GRAPHICS_DIR);
-	PicManagerLoadDir(pm, buf, NULL, pm->pics, pm->sprites);
+	PROFILE_SCOPE("load pics");
+	if (!LoadPack(pm)) {
+		char buf[CDOGS_PATH_MAX];
+		GetDataFilePath(buf, GRAPHICS_DIR);
+		PicManagerLoadDir(pm, buf, NULL, pm->pics, pm->sprites);
+	}
+	PackAtlas(pm, pm->pics, pm->sprites, false, false);
+}
+
+// Add the pics baked by cdogs-bake, if they are fresh
+static bool LoadPack(PicManager *pm) {
+	const AssetPack *ap = &gAssetPack;
+	if (!ap->IsFresh[ASSET_SECTION_IMAGES]) {
+		return false;
+	}
+	const AssetPackSection *s = &ap->Header->Sections[ASSET_SECTION_IMAGES];
+	for (int i = (int) s->Start; i < (int) (s->Start + s->Count); i++) {
+		const char *name;
+		SDL_Surface *image = AssetPackGetImage(ap, i, &name);
+		if (image != NULL) {
+			PicManagerAdd(pm->pics, pm->sprites, name, image);
+		}
+	}
+	AfterAdd(pm);
+	LOG(LM_MAIN, LL_DEBUG, "loaded %d images from %s", (int) s->Count,
+			ASSET_PACK_FILE);
+	return true;
+}
+
+static int AddPicPtr(any_t data, any_t item);
+static int AddSpritesPicPtrs(any_t data, any_t item);
+static int ComparePicPtrSize(const void *v1, const void *v2);
+// Move pics into atlas pages, biggest first so they pack tightly.
+// Pics that don't fit keep their own texture; if remakeTex is set, that
+// texture is recreated.
+static void PackAtlas(PicManager *pm, map_t pics, map_t sprites,
+		const bool isCustom, const bool remakeTex) {
+	CArray picPtrs;
+	CArrayInit(&picPtrs, sizeof(Pic*));
+	hashmap_iterate(pics, AddPicPtr, &picPtrs);
+	hashmap_iterate(sprites, AddSpritesPicPtrs, &picPtrs);
+	qsort(picPtrs.data, picPtrs.size, picPtrs.elemSize, ComparePicPtrSize);
+	int numPacked = 0;
+	CA_FOREACH(Pic *, p, picPtrs)
+		if (AtlasAdd(&pm->atlas, *p, isCustom)) {
+			numPacked++;
+		} else if (remakeTex && !PicTryMakeTex(*p)) {
+			LOG(LM_MAIN, LL_ERROR, "failed to reload pic texture");
+			(*p)->Tex = NULL;
+		}
+	CA_FOREACH_END()
+	LOG(LM_GFX, LL_DEBUG, "packed %d/%d pics into %d atlas pages",
+			numPacked, (int) picPtrs.size, (int) pm->atlas.Pages.size);
+	CArrayTerminate(&picPtrs);
+}
+static int AddPicPtr(any_t data, any_t item) {
+	CArray *picPtrs = static_cast<CArray*>(data);
+	Pic *p = &static_cast<NamedPic*>(item)->pic;
+	CArrayPushBack(picPtrs, &p);
+	return MAP_OK;
+}
+static int AddSpritesPicPtrs(any_t data, any_t item) {
+	CArray *picPtrs = static_cast<CArray*>(data);
+	NamedSprites *ns = static_cast<NamedSprites*>(item);
+	CA_FOREACH(Pic, p, ns->pics)
+		CArrayPushBack(picPtrs, &p);
+	CA_FOREACH_END()
+	return MAP_OK;
+}
+static int ComparePicPtrSize(const void *v1, const void *v2) {
+	const Pic *p1 = *static_cast<Pic * const *>(v1);
+	const Pic *p2 = *static_cast<Pic * const *>(v2);
+	if (p1->size.y != p2->size.y) {
+		return p2->size.y - p1->size.y;
+	}
+	return p2->size.x - p1->size.x;
 }
 
 static void FindStylePics(PicManager *pm, CArray *styleNames,
@@ -364,11 +487,14 @@ static int MaybeAddTilePicName(any_t data, any_t item) {
 static void NamedPicDestroy(any_t data);
 static void NamedSpritesDestroy(any_t data);
 void PicManagerClearCustom(PicManager *pm) {
+	CharSpriteCacheClear(&pm->charSprites);
 	hashmap_clear(pm->customPics, NamedPicDestroy);
 	hashmap_clear(pm->customSprites, NamedSpritesDestroy);
+	AtlasClearCustom(&pm->atlas);
 	AfterAdd(pm);
 }
 static void PicManagerUnload(PicManager *pm) {
+	CharSpriteCacheClear(&pm->charSprites);
 	hashmap_clear(pm->pics, NamedPicDestroy);
 	hashmap_clear(pm->sprites, NamedSpritesDestroy);
 	hashmap_clear(pm->customPics, NamedPicDestroy);
@@ -389,6 +515,7 @@ void PicManagerTerminate(PicManager *pm) {
 	StyleNamesDestroy(&pm->exitStyleNames);
 	StyleNamesDestroy(&pm->doorStyleNames);
 	StyleNamesDestroy(&pm->keyStyleNames);
+	AtlasTerminate(&pm->atlas);
 	IMG_Quit();
 }
 static void NamedPicDestroy(any_t data) {
@@ -401,33 +528,12 @@ static void NamedSpritesDestroy(any_t data) {
 	NamedSpritesFree(n);
 	CFREE(n);
 }
-static int ReloadTexture(any_t data, any_t item);
-static int ReloadSpriteTexture(any_t data, any_t item);
 void PicManagerReloadTextures(PicManager *pm) {
-	hashmap_iterate(pm->pics, ReloadTexture, pm);
-	hashmap_iterate(pm->customPics, ReloadTexture, pm);
-	hashmap_iterate(pm->sprites, ReloadSpriteTexture, pm);
-	hashmap_iterate(pm->customSprites, ReloadSpriteTexture, pm);
-}
-static int ReloadTexture(any_t data, any_t item) {
-	UNUSED(data);
-	NamedPic *n = static_cast<NamedPic*>(item);
-	if (!PicTryMakeTex(&n->pic)) {
-		LOG(LM_MAIN, LL_ERROR, "failed to reload pic texture");
-		n->pic.Tex = NULL;
-	}
-	return MAP_OK;
-}
-static int ReloadSpriteTexture(any_t data, any_t item) {
-	UNUSED(data);
-	NamedSprites *n = static_cast<NamedSprites*>(item);
-	CA_FOREACH(Pic, op, n->pics)
-	if (!PicTryMakeTex(op)) {
-		LOG(LM_MAIN, LL_ERROR, "failed to reload pic texture");
-		op->Tex = NULL;
-	}
-	CA_FOREACH_END()
-	return MAP_OK;
+	// The old pages went with the old renderer
+	AtlasReset(&pm->atlas);
+	CharSpriteCacheReset(&pm->charSprites);
+	PackAtlas(pm, pm->pics, pm->sprites, false, true);
+	PackAtlas(pm, pm->customPics, pm->customSprites, true, true);
 }
 
 NamedPic* PicManagerGetNamedPic(const PicManager *pm, const char *name) {
@@ -511,7 +617,7 @@ static void PicManagerGenerateMaskedPic(PicManager *pm, const char *name,
 		p.Data[i] = COLOR2PIXEL(c);
 		// TODO: more channels
 	}
-	if (!PicTryMakeTex(&p)) {
+	if (!AtlasAdd(&pm->atlas, &p, true) && !PicTryMakeTex(&p)) {
 		p.Tex = NULL;
 	}
 	AddNamedPic(pm->customPics, maskedName, &p);
@@ -528,36 +634,14 @@ void PicManagerGenerateMaskedStylePic(PicManager *pm, const char *name,
 
 const NamedSprites* PicManagerGetCharSprites(PicManager *pm, const char *name,
 		const CharColors *colors) {
-	char buf[CDOGS_PATH_MAX];
-	CharColorsGetMaskedName(buf, name, colors);
-	// Get or generate masked sprites
-	const NamedSprites *ns = PicManagerGetSprites(&gPicManager, buf);
-	if (ns != NULL) {
-		return ns;
-	}
-	const NamedSprites *ons = PicManagerGetSprites(pm, name);
-	if (ons == NULL) {
+	const NamedSprites *base = PicManagerGetSprites(pm, name);
+	if (base == NULL) {
 		return NULL;
 	}
-	NamedSprites *nsp = AddNamedSprites(pm->customSprites, buf);
-	CA_FOREACH(Pic, op, ons->pics)
-	Pic p = PicCopy(op);
-	p.Tex = NULL;
-	for (int i = 0; i < p.size.x * p.size.y; i++) {
-		if (op->Data[i] == 0) {
-			continue;
-		}
-		const color_t c = PIXEL2COLOR(op->Data[i]);
-		p.Data[i] = COLOR2PIXEL(
-				ColorMult(c, CharColorsGetChannelMask(colors, c.a)));
-	}
-	if (!PicTryMakeTex(&p)) {
-		p.Tex = NULL;
-	}
-	CArrayPushBack(&nsp->pics, &p);
-	CA_FOREACH_END()
-	AfterAdd(pm);
-	return nsp;
+	return CharSpriteCacheGet(&pm->charSprites, base, colors);
+}
+void PicManagerEndFrame(PicManager *pm) {
+	CharSpriteCacheEndFrame(&pm->charSprites);
 }
 
 static void GetMaskedName(char *buf, const char *name, const color_t mask,
@@ -28,10 +28,15 @@
 #ifndef SRC_CDOGS_PIC_MANAGER_H_
 #define SRC_CDOGS_PIC_MANAGER_H_
 
+#include "atlas.h"
 #include "c_hashmap/hashmap.h"
+#include "char_sprite_cache.h"
 #include "cpic.h"
 #include "pics.h"
 
+// Most threads used to decode images in PicManagerLoadDir
+#define PIC_LOAD_MAX_THREADS 16
+
 struct PicManager {
 	map_t pics;	// of NamedPic
 	map_t sprites;	// of NamedSprites
@@ -44,6 +49,9 @@ struct PicManager {
 	CArray exitStyleNames;	// of char *
 	CArray doorStyleNames;	// of char *
 	CArray keyStyleNames;	// of char *
+
+	Atlas atlas;
+	CharSpriteCache charSprites;
 };
 
 extern PicManager gPicManager;
@@ -72,9 +80,11 @@ NamedPic* PicManagerGetMaskedStylePic(const PicManager *pm, const char *name,
 void PicManagerGenerateMaskedStylePic(PicManager *pm, const char *name,
 		const char *style, const char *type, const color_t mask,
 		const color_t maskAlt, const bool noAltMask);
-// Get masked character pics
+// Get masked character pics; valid until PicManagerEndFrame
 const NamedSprites* PicManagerGetCharSprites(PicManager *pm, const char *name,
 		const CharColors *colors);
+// Call after each frame is presented
+void PicManagerEndFrame(PicManager *pm);
 
 int PicManagerGetWallStyleIndex(PicManager *pm, const char *style);
 int PicManagerGetTileStyleIndex(PicManager *pm, const char *style);
@@ -28,6 +28,7 @@
 #include "pickup.h"
 
 #include "ammo.h"
+#include "asset_pack.h"
 #include "game_events.h"
 #include "json_utils.h"
 #include "log.h"
@@ -131,28 +132,15 @@ void PickupClassesInit(PickupClasses *classes, const char *filename,
 	CArrayInit(&classes->CustomClasses, sizeof(PickupClass));
 	CArrayInit(&classes->KeyClasses, sizeof(PickupClass));
 
-	char buf[CDOGS_PATH_MAX];
-	GetDataFilePath(buf, filename);
-	FILE *f = fopen(buf, "r");
-	json_t *root = NULL;
-	enum json_error e;
-	if (f == NULL) {
-		LOG(LM_MAIN, LL_ERROR, "Error: cannot load pickups file %s", buf);
-		goto bail;
-	}
-	e = json_stream_parse(f, &root);
-	if (e != JSON_OK) {
-		LOG(LM_MAIN, LL_ERROR, "Error parsing pickups file %s", buf);
-		goto bail;
+	json_t *root = AssetPackReadJSON(&gAssetPack, filename);
+	if (root == NULL) {
+		LOG(LM_MAIN, LL_ERROR, "Error: cannot load pickups file %s", filename);
+		return;
 	}
 	PickupClassesLoadJSON(&classes->Classes, root);
 	PickupClassesLoadAmmo(&classes->Classes, &ammo->Ammo);
 	PickupClassesLoadGuns(&classes->Classes, &guns->Guns);
 	PickupClassesLoadKeys(&classes->KeyClasses);
-
-	bail: if (f != NULL) {
-		fclose(f);
-	}
 	json_free_value(&root);
 }
 static bool TryLoadPickupclass(PickupClass *c, json_t *node, const int version);
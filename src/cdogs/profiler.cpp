@@ -0,0 +1,361 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "profiler.h"
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL2/SDL_thread.h>
+#include <SDL2/SDL_timer.h>
+
+#include "config.h"
+#include "font.h"
+#include "grafx.h"
+#include "log.h"
+#include "mission_arena.h"
+#include "utils.h"
+
+#define PROFILER_AVG_WEIGHT 0.1
+#define PROFILER_MAX_ARENAS 8
+
+Profiler gProfiler;
+
+// Each thread writes to its own buffer so recording needs no locks
+// The buffer is released for reuse when the thread exits
+static void ReleaseThread(ProfilerThread *t);
+typedef struct ProfilerThreadSlot {
+	ProfilerThread *t;
+	~ProfilerThreadSlot() {
+		ReleaseThread(t);
+	}
+} ProfilerThreadSlot;
+static thread_local ProfilerThreadSlot sSlot = { NULL };
+
+static ProfilerThread *AddThread(Profiler *p);
+void ProfilerInit(Profiler *p) {
+	memset(p, 0, sizeof *p);
+	p->Frequency = SDL_GetPerformanceFrequency();
+	p->Epoch = SDL_GetPerformanceCounter();
+	CArrayInit(&p->Threads, sizeof(ProfilerThread*));
+	p->lock = SDL_CreateMutex();
+	// The thread that initialises the profiler is the main thread
+	sSlot.t = AddThread(p);
+}
+static void CloseTrace(Profiler *p);
+void ProfilerTerminate(Profiler *p) {
+	CloseTrace(p);
+	CA_FOREACH(ProfilerThread *, t, p->Threads)
+		CFREE(*t);
+	CA_FOREACH_END()
+	CArrayTerminate(&p->Threads);
+	SDL_DestroyMutex(p->lock);
+	sSlot.t = NULL;
+	memset(p, 0, sizeof *p);
+}
+static ProfilerThread *AddThread(Profiler *p) {
+	ProfilerThread *t = NULL;
+	SDL_LockMutex(p->lock);
+	CA_FOREACH(ProfilerThread *, tp, p->Threads)
+		if ((*tp)->isFree) {
+			// Keep the ring and read positions; unread zones of the old
+			// thread are still written out
+			t = *tp;
+			t->isFree = false;
+			t->nameWritten = false;
+			t->Depth = 0;
+			break;
+		}
+	CA_FOREACH_END()
+	if (t == NULL && p->Threads.size < PROFILER_MAX_THREADS) {
+		CCALLOC(t, sizeof *t);
+		t->Id = (int) p->Threads.size;
+		CArrayPushBack(&p->Threads, &t);
+	}
+	if (t != NULL) {
+		if (t->Id == 0) {
+			strcpy(t->Name, "main");
+		} else {
+			sprintf(t->Name, "thread %lu", SDL_ThreadID());
+		}
+	}
+	SDL_UnlockMutex(p->lock);
+	return t;
+}
+static void ReleaseThread(ProfilerThread *t) {
+	// The profiler may already be gone
+	if (t == NULL || gProfiler.lock == NULL) {
+		return;
+	}
+	SDL_LockMutex(gProfiler.lock);
+	t->isFree = true;
+	SDL_UnlockMutex(gProfiler.lock);
+}
+
+bool ProfilerOpenTrace(Profiler *p, const char *filename) {
+	CloseTrace(p);
+	p->traceFile = fopen(filename, "w");
+	if (p->traceFile == NULL) {
+		LOG(LM_MAIN, LL_ERROR, "Cannot open trace file %s", filename);
+		return false;
+	}
+	fputs("{\"traceEvents\":[\n", p->traceFile);
+	p->traceHasEvents = false;
+	// Record from now on, including asset loading before the first frame
+	p->Enabled = true;
+	return true;
+}
+static void WriteTrace(Profiler *p);
+static void CloseTrace(Profiler *p) {
+	if (p->traceFile == NULL) {
+		return;
+	}
+	WriteTrace(p);
+	fputs("\n]}\n", p->traceFile);
+	fclose(p->traceFile);
+	p->traceFile = NULL;
+	if (p->Dropped > 0) {
+		LOG(LM_MAIN, LL_WARN, "Profiler dropped %d zones", p->Dropped);
+	}
+}
+
+void ProfilerBegin(const char *name) {
+	if (sSlot.t == NULL) {
+		sSlot.t = AddThread(&gProfiler);
+		if (sSlot.t == NULL) {
+			return;
+		}
+	}
+	ProfilerThread *t = sSlot.t;
+	if (t->Depth < PROFILER_MAX_DEPTH) {
+		t->Stack[t->Depth].Name = name;
+		t->Stack[t->Depth].Start = SDL_GetPerformanceCounter();
+	}
+	t->Depth++;
+}
+void ProfilerEnd(void) {
+	ProfilerThread *t = sSlot.t;
+	// Zones opened before the profiler was enabled are ignored
+	if (t == NULL || t->Depth == 0) {
+		return;
+	}
+	t->Depth--;
+	if (t->Depth >= PROFILER_MAX_DEPTH) {
+		return;
+	}
+	const int head = SDL_AtomicGet(&t->Head);
+	ProfilerEvent *e = &t->Ring[head % PROFILER_RING_SIZE];
+	e->Name = t->Stack[t->Depth].Name;
+	e->Start = t->Stack[t->Depth].Start;
+	e->End = SDL_GetPerformanceCounter();
+	e->Depth = t->Depth;
+	// Publish the event only after it has been written
+	SDL_AtomicSet(&t->Head, head + 1);
+}
+
+// Get the range of unread events, skipping any that have been overwritten
+static int ReadStart(Profiler *p, const int head, int *read) {
+	if (head - *read > PROFILER_RING_SIZE) {
+		p->Dropped += head - *read - PROFILER_RING_SIZE;
+		*read = head - PROFILER_RING_SIZE;
+	}
+	return *read;
+}
+
+static void UpdateStats(Profiler *p, ProfilerThread *t);
+void ProfilerFrameEnd(Profiler *p) {
+	if (p->Enabled && p->Threads.size > 0) {
+		ProfilerThread *t = *(ProfilerThread**) CArrayGet(&p->Threads, 0);
+		UpdateStats(p, t);
+		WriteTrace(p);
+	}
+	// Only change state between frames, so that zones are balanced
+	const bool enabled = p->traceFile != NULL
+			|| ConfigGetBool(&gConfig, "Interface.ShowProfiler");
+	if (enabled && !p->Enabled) {
+		memset(p->Zones, 0, sizeof p->Zones);
+		p->NumZones = 0;
+		p->windowFrames = 0;
+	}
+	p->Enabled = enabled;
+}
+static ProfilerZoneStats *FindZone(Profiler *p, const ProfilerEvent *e);
+static void UpdateStats(Profiler *p, ProfilerThread *t) {
+	const int head = SDL_AtomicGet(&t->Head);
+	for (int i = ReadStart(p, head, &t->statsRead); i < head; i++) {
+		const ProfilerEvent *e = &t->Ring[i % PROFILER_RING_SIZE];
+		ProfilerZoneStats *z = FindZone(p, e);
+		if (z == NULL) {
+			continue;
+		}
+		if (z->frameCalls == 0 || e->Start < z->frameStart) {
+			z->frameStart = e->Start;
+		}
+		z->frameTicks += e->End - e->Start;
+		z->frameCalls++;
+	}
+	t->statsRead = head;
+
+	p->windowFrames++;
+	for (int i = 0; i < p->NumZones; i++) {
+		ProfilerZoneStats *z = &p->Zones[i];
+		const double ms = (double) z->frameTicks * 1000.0
+				/ (double) p->Frequency;
+		z->AvgMs = z->AvgMs * (1 - PROFILER_AVG_WEIGHT)
+				+ ms * PROFILER_AVG_WEIGHT;
+		z->windowPeakMs = MAX(z->windowPeakMs, ms);
+		if (p->windowFrames >= PROFILER_WINDOW_FRAMES) {
+			z->PeakMs = z->windowPeakMs;
+			z->windowPeakMs = 0;
+		}
+		z->Calls = z->frameCalls;
+		z->frameTicks = 0;
+		z->frameCalls = 0;
+	}
+	if (p->windowFrames >= PROFILER_WINDOW_FRAMES) {
+		p->windowFrames = 0;
+	}
+}
+static ProfilerZoneStats *FindZone(Profiler *p, const ProfilerEvent *e) {
+	for (int i = 0; i < p->NumZones; i++) {
+		ProfilerZoneStats *z = &p->Zones[i];
+		if (z->Depth == e->Depth
+				&& (z->Name == e->Name || strcmp(z->Name, e->Name) == 0)) {
+			return z;
+		}
+	}
+	if (p->NumZones == PROFILER_MAX_ZONES) {
+		return NULL;
+	}
+	ProfilerZoneStats *z = &p->Zones[p->NumZones];
+	memset(z, 0, sizeof *z);
+	z->Name = e->Name;
+	z->Depth = e->Depth;
+	p->NumZones++;
+	return z;
+}
+
+static double TicksToUs(const Profiler *p, const Uint64 ticks) {
+	return (double) ticks * 1000000.0 / (double) p->Frequency;
+}
+static void WriteTraceEvent(Profiler *p, const char *fmt, ...);
+static void WriteTrace(Profiler *p) {
+	if (p->traceFile == NULL) {
+		return;
+	}
+	// Arena usage as counter tracks, sampled once per frame
+	MissionArenaStats arenas[PROFILER_MAX_ARENAS];
+	const int numArenas = MissionArenasGetStats(arenas, PROFILER_MAX_ARENAS);
+	const double ts = TicksToUs(p, SDL_GetPerformanceCounter() - p->Epoch);
+	for (int i = 0; i < numArenas; i++) {
+		WriteTraceEvent(p, "{\"name\":\"arena %s\",\"ph\":\"C\",\"ts\":%.3f,"
+				"\"pid\":1,\"args\":{\"used\":%d,\"reserved\":%d}}",
+				arenas[i].Name, ts, (int) arenas[i].Used,
+				(int) arenas[i].Reserved);
+	}
+	SDL_LockMutex(p->lock);
+	CA_FOREACH(ProfilerThread *, tp, p->Threads)
+		ProfilerThread *t = *tp;
+		if (!t->nameWritten && SDL_AtomicGet(&t->Head) > t->traceRead) {
+			t->nameWritten = true;
+			WriteTraceEvent(p, "{\"name\":\"thread_name\",\"ph\":\"M\","
+					"\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", t->Id,
+					t->Name);
+		}
+		const int head = SDL_AtomicGet(&t->Head);
+		for (int i = ReadStart(p, head, &t->traceRead); i < head; i++) {
+			const ProfilerEvent *e = &t->Ring[i % PROFILER_RING_SIZE];
+			WriteTraceEvent(p, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+					"\"dur\":%.3f,\"pid\":1,\"tid\":%d}", e->Name,
+					TicksToUs(p, e->Start - p->Epoch),
+					TicksToUs(p, e->End - e->Start), t->Id);
+		}
+		t->traceRead = head;
+	CA_FOREACH_END()
+	SDL_UnlockMutex(p->lock);
+}
+static void WriteTraceEvent(Profiler *p, const char *fmt, ...) {
+	if (p->traceHasEvents) {
+		fputs(",\n", p->traceFile);
+	}
+	va_list args;
+	va_start(args, fmt);
+	vfprintf(p->traceFile, fmt, args);
+	va_end(args);
+	p->traceHasEvents = true;
+}
+
+static int CompareZoneStart(const void *v1, const void *v2);
+void ProfilerDraw(const Profiler *p) {
+	// Show zones in the order they ran, indented by depth
+	const ProfilerZoneStats *zones[PROFILER_MAX_ZONES];
+	for (int i = 0; i < p->NumZones; i++) {
+		zones[i] = &p->Zones[i];
+	}
+	qsort(zones, p->NumZones, sizeof zones[0], CompareZoneStart);
+
+	FontOpts opts = FontOptsNew();
+	opts.Area = gGraphicsDevice.cachedConfig.Res;
+	opts.Pad = svec2i(10, 10);
+	FontStrOpt("zone            avg   peak  calls", svec2i_zero(), opts);
+	for (int i = 0; i < p->NumZones; i++) {
+		const ProfilerZoneStats *z = zones[i];
+		char buf[128];
+		sprintf(buf, "%*s%-*.*s %5.2f %6.2f %5d", z->Depth, "",
+				14 - z->Depth, 14 - z->Depth, z->Name, z->AvgMs, z->PeakMs,
+				z->Calls);
+		opts.Pad.y += FontH();
+		FontStrOpt(buf, svec2i_zero(), opts);
+	}
+
+	MissionArenaStats arenas[PROFILER_MAX_ARENAS];
+	const int numArenas = MissionArenasGetStats(arenas, PROFILER_MAX_ARENAS);
+	if (numArenas > 0) {
+		opts.Pad.y += FontH();
+		FontStrOpt("arena        used   peak  rsrvd allocs", svec2i_zero(),
+				opts);
+	}
+	for (int i = 0; i < numArenas; i++) {
+		const MissionArenaStats *s = &arenas[i];
+		char buf[128];
+		sprintf(buf, "%-10.10s %5dK %5dK %5dK %6d", s->Name,
+				(int) (s->Used / 1024), (int) (s->Peak / 1024),
+				(int) (s->Reserved / 1024), s->Allocs);
+		opts.Pad.y += FontH();
+		FontStrOpt(buf, svec2i_zero(), opts);
+	}
+}
+static int CompareZoneStart(const void *v1, const void *v2) {
+	const ProfilerZoneStats *z1 = *(const ProfilerZoneStats* const*) v1;
+	const ProfilerZoneStats *z2 = *(const ProfilerZoneStats* const*) v2;
+	if (z1->frameStart != z2->frameStart) {
+		return z1->frameStart < z2->frameStart ? -1 : 1;
+	}
+	return z1->Depth - z2->Depth;
+}
@@ -0,0 +1,142 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_stdinc.h>
+
+#include "c_array.h"
+
+// Completed zones per thread kept for the trace writer; older ones are
+// overwritten if the buffer isn't drained in time
+#define PROFILER_RING_SIZE 16384
+// Threads beyond this many at once are not recorded; buffers of finished
+// threads are reused
+#define PROFILER_MAX_THREADS 16
+#define PROFILER_MAX_DEPTH 32
+#define PROFILER_MAX_ZONES 64
+// Frames over which the overlay's peak times are taken
+#define PROFILER_WINDOW_FRAMES 60
+
+typedef struct {
+	const char *Name;
+	Uint64 Start;
+	Uint64 End;
+	int Depth;
+} ProfilerEvent;
+
+typedef struct {
+	const char *Name;
+	Uint64 Start;
+} ProfilerOpenZone;
+
+typedef struct {
+	int Id;
+	char Name[32];
+	ProfilerEvent Ring[PROFILER_RING_SIZE];
+	// Written only by the owning thread; read by the main thread at the
+	// end of each frame
+	SDL_atomic_t Head;
+	int traceRead;
+	int statsRead;
+	ProfilerOpenZone Stack[PROFILER_MAX_DEPTH];
+	int Depth;
+	// The owning thread has exited; the buffer can be given to a new one
+	bool isFree;
+	bool nameWritten;
+} ProfilerThread;
+
+// Main thread zone times, for the overlay
+typedef struct {
+	const char *Name;
+	int Depth;
+	Uint64 frameStart;
+	Uint64 frameTicks;
+	int frameCalls;
+	double AvgMs;
+	double PeakMs;
+	double windowPeakMs;
+	int Calls;
+} ProfilerZoneStats;
+
+typedef struct {
+	// Zones are only recorded when enabled; this is checked inline so that
+	// disabled zones cost one branch
+	bool Enabled;
+	Uint64 Frequency;
+	Uint64 Epoch;
+	CArray Threads;	// of ProfilerThread *
+	SDL_mutex *lock;
+	ProfilerZoneStats Zones[PROFILER_MAX_ZONES];
+	int NumZones;
+	int windowFrames;
+	int Dropped;
+	FILE *traceFile;
+	bool traceHasEvents;
+} Profiler;
+
+extern Profiler gProfiler;
+
+void ProfilerInit(Profiler *p);
+void ProfilerTerminate(Profiler *p);
+
+// Write all zones in Chrome trace event format (about://tracing, Perfetto)
+bool ProfilerOpenTrace(Profiler *p, const char *filename);
+
+void ProfilerBegin(const char *name);
+void ProfilerEnd(void);
+
+// Call once per frame on the main thread: updates the overlay stats,
+// drains the per-thread buffers into the trace, and picks up config changes
+void ProfilerFrameEnd(Profiler *p);
+void ProfilerDraw(const Profiler *p);
+
+// Zone names must be string literals (or otherwise outlive the profiler)
+#define PROFILE_BEGIN(_name)\
+	do { if (gProfiler.Enabled) ProfilerBegin(_name); } while (0)
+#define PROFILE_END()\
+	do { if (gProfiler.Enabled) ProfilerEnd(); } while (0)
+
+// Zone that ends when the enclosing scope exits
+typedef struct ProfilerScope {
+	bool active;
+	ProfilerScope(const char *name) : active(gProfiler.Enabled) {
+		if (active) ProfilerBegin(name);
+	}
+	~ProfilerScope() {
+		if (active) ProfilerEnd();
+	}
+} ProfilerScope;
+#define PROFILE_SCOPE_CAT(_a, _b) _a ## _b
+#define PROFILE_SCOPE_VAR(_line) PROFILE_SCOPE_CAT(_profilerScope, _line)
+#define PROFILE_SCOPE(_name) ProfilerScope PROFILE_SCOPE_VAR(__LINE__)(_name)
@@ -200,12 +200,14 @@ PB_FIELD( 4, INT32 , REQUIRED, STATIC , OTHER, NActorAdd, Health, Direction, 0),
 				ThingFlags, &NVec2_fields),
 PB_LAST_FIELD };
 
-const pb_field_t NActorMove_fields[4] = {
+const pb_field_t NActorMove_fields[5] = {
 PB_FIELD( 1, UINT32 , REQUIRED, STATIC , FIRST, NActorMove, UID, UID, 0),
 		PB_FIELD(2, MESSAGE, REQUIRED, STATIC, OTHER, NActorMove, Pos, UID,
 				&NVec2_fields),
 		PB_FIELD(3, MESSAGE, REQUIRED, STATIC, OTHER, NActorMove, MoveVel, Pos,
 				&NVec2_fields),
+		PB_FIELD(4, UINT32, REQUIRED, STATIC, OTHER, NActorMove, Seq, MoveVel,
+				0),
 PB_LAST_FIELD };
 
 const pb_field_t NActorState_fields[3] = {
@@ -221,6 +221,7 @@ typedef struct _NActorMove {
 	uint32_t UID;
 	NVec2 Pos;
 	NVec2 MoveVel;
+	uint32_t Seq;
 	/* @@protoc_insertion_point(struct:NActorMove) */
 } NActorMove;
 
@@ -410,7 +411,7 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NVec2_init_default                       {0, 0}
 #define NGameBegin_init_default                  {0}
 #define NActorAdd_init_default                   {0, 0, 4, 0, -1, 0, NVec2_init_default}
-#define NActorMove_init_default                  {0, NVec2_init_default, NVec2_init_default}
+#define NActorMove_init_default                  {0, NVec2_init_default, NVec2_init_default, 0}
 #define NActorState_init_default                 {0, 0}
 #define NActorDir_init_default                   {0, 0}
 #define NActorSlide_init_default                 {0, NVec2_init_default}
@@ -458,7 +459,7 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NVec2_init_zero                          {0, 0}
 #define NGameBegin_init_zero                     {0}
 #define NActorAdd_init_zero                      {0, 0, 0, 0, 0, 0, NVec2_init_zero}
-#define NActorMove_init_zero                     {0, NVec2_init_zero, NVec2_init_zero}
+#define NActorMove_init_zero                     {0, NVec2_init_zero, NVec2_init_zero, 0}
 #define NActorState_init_zero                    {0, 0}
 #define NActorDir_init_zero                      {0, 0}
 #define NActorSlide_init_zero                    {0, NVec2_init_zero}
@@ -574,6 +575,7 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NActorMove_UID_tag                       1
 #define NActorMove_Pos_tag                       2
 #define NActorMove_MoveVel_tag                   3
+#define NActorMove_Seq_tag                       4
 #define NActorSlide_UID_tag                      1
 #define NActorSlide_Vel_tag                      2
 #define NAddBullet_UID_tag                       1
@@ -678,7 +680,7 @@ extern const pb_field_t NVec2i_fields[3];
 extern const pb_field_t NVec2_fields[3];
 extern const pb_field_t NGameBegin_fields[2];
 extern const pb_field_t NActorAdd_fields[8];
-extern const pb_field_t NActorMove_fields[4];
+extern const pb_field_t NActorMove_fields[5];
 extern const pb_field_t NActorState_fields[3];
 extern const pb_field_t NActorDir_fields[3];
 extern const pb_field_t NActorSlide_fields[3];
@@ -728,7 +730,7 @@ extern const pb_field_t NMissionEnd_fields[4];
 #define NVec2_size                               10
 #define NGameBegin_size                          11
 #define NActorAdd_size                           63
-#define NActorMove_size                          30
+#define NActorMove_size                          36
 #define NActorState_size                         17
 #define NActorDir_size                           17
 #define NActorSlide_size                         18
@@ -0,0 +1,504 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "replay.h"
+
+#include <string.h>
+#include <time.h>
+
+#include <SDL2/SDL_timer.h>
+
+#include "actors.h"
+#include "config.h"
+#include "game_events.h"
+#include "gamedata.h"
+#include "handle_game_events.h"
+#include "log.h"
+#include "net_util.h"
+#include "objs.h"
+#include "player.h"
+#include "proto/nanopb/pb_decode.h"
+#include "proto/nanopb/pb_encode.h"
+#include "utils.h"
+#include "weapon_class.h"
+
+Replay gReplay;
+
+// Records in a replay file are a one-byte type followed by the payload
+typedef enum {
+	REPLAY_REC_CAMPAIGN = 1,	// NCampaignDef
+	REPLAY_REC_CONFIG,			// NConfig
+	REPLAY_REC_PLAYER,			// NPlayerData, uint8 is AI
+	REPLAY_REC_WEAPON,			// string
+	REPLAY_REC_START,			// end of header
+	REPLAY_REC_CMD,				// uint16 command
+	REPLAY_REC_TICK,			// uint32 state hash
+	REPLAY_REC_END
+} ReplayRecord;
+
+#define REPLAY_PB_BUFFER_SIZE 8192
+
+void ReplayInit(Replay *r) {
+	memset(r, 0, sizeof *r);
+}
+
+void ReplaySetRecord(Replay *r, const char *filename) {
+	r->Mode = REPLAY_MODE_RECORD;
+	strcpy(r->Filename, filename);
+}
+
+void ReplaySetPlayback(Replay *r, const char *filename, const bool isFast) {
+	r->Mode = REPLAY_MODE_PLAY;
+	strcpy(r->Filename, filename);
+	r->IsFast = isFast;
+}
+
+bool ReplayIsActive(const Replay *r) {
+	return r->f != NULL;
+}
+bool ReplayIsPlaying(const Replay *r) {
+	return r->Mode == REPLAY_MODE_PLAY && r->f != NULL;
+}
+bool ReplayHasEnded(const Replay *r) {
+	return ReplayIsPlaying(r) && r->Ended;
+}
+
+static void WriteU8(FILE *f, const uint8_t v) {
+	fwrite(&v, sizeof v, 1, f);
+}
+static void WriteU16(FILE *f, const uint16_t v) {
+	fwrite(&v, sizeof v, 1, f);
+}
+static void WriteU32(FILE *f, const uint32_t v) {
+	fwrite(&v, sizeof v, 1, f);
+}
+static void WriteString(FILE *f, const char *s) {
+	const uint16_t len = (uint16_t) strlen(s);
+	WriteU16(f, len);
+	fwrite(s, 1, len, f);
+}
+static void WritePB(FILE *f, const pb_field_t *fields, const void *data) {
+	uint8_t buf[REPLAY_PB_BUFFER_SIZE];
+	pb_ostream_t stream = pb_ostream_from_buffer(buf, sizeof buf);
+	const bool status = pb_encode(&stream, fields, data);
+	CASSERT(status, "Failed to encode pb");
+	WriteU16(f, (uint16_t) stream.bytes_written);
+	fwrite(buf, 1, stream.bytes_written, f);
+}
+static bool ReadU8(FILE *f, uint8_t *v) {
+	return fread(v, sizeof *v, 1, f) == 1;
+}
+static bool ReadU16(FILE *f, uint16_t *v) {
+	return fread(v, sizeof *v, 1, f) == 1;
+}
+static bool ReadU32(FILE *f, uint32_t *v) {
+	return fread(v, sizeof *v, 1, f) == 1;
+}
+static bool ReadString(FILE *f, char *buf, const size_t size) {
+	uint16_t len;
+	if (!ReadU16(f, &len) || len >= size) {
+		return false;
+	}
+	buf[len] = '\0';
+	return fread(buf, 1, len, f) == len;
+}
+static bool ReadPB(FILE *f, const pb_field_t *fields, void *dest) {
+	uint8_t buf[REPLAY_PB_BUFFER_SIZE];
+	uint16_t len;
+	if (!ReadU16(f, &len) || len > sizeof buf
+			|| fread(buf, 1, len, f) != len) {
+		return false;
+	}
+	pb_istream_t stream = pb_istream_from_buffer(buf, len);
+	return pb_decode(&stream, fields, dest);
+}
+
+static bool ReadHeader(FILE *f, CampaignOptions *co,
+		struct MissionOptions *mo);
+bool ReplayLoad(Replay *r, CampaignOptions *co, struct MissionOptions *mo) {
+	if (r->Mode != REPLAY_MODE_PLAY) {
+		return false;
+	}
+	r->f = fopen(r->Filename, "rb");
+	if (r->f == NULL) {
+		LOG(LM_MAIN, LL_ERROR, "Cannot open replay file %s", r->Filename);
+		goto bail;
+	}
+	char magic[4];
+	uint32_t version;
+	if (fread(magic, 1, sizeof magic, r->f) != sizeof magic
+			|| memcmp(magic, REPLAY_MAGIC, sizeof magic) != 0
+			|| !ReadU32(r->f, &version) || !ReadU32(r->f, &r->Seed)) {
+		LOG(LM_MAIN, LL_ERROR, "Not a replay file %s", r->Filename);
+		goto bail;
+	}
+	if (version != REPLAY_VERSION) {
+		LOG(LM_MAIN, LL_ERROR, "Unsupported replay version %u (expected %d)",
+				version, REPLAY_VERSION);
+		goto bail;
+	}
+	if (!ReadHeader(r->f, co, mo)) {
+		LOG(LM_MAIN, LL_ERROR, "Failed to read replay header %s",
+				r->Filename);
+		goto bail;
+	}
+	LOG(LM_MAIN, LL_INFO, "Playing replay %s%s", r->Filename,
+			r->IsFast ? " (fast)" : "");
+	return true;
+
+bail:
+	if (r->f != NULL) {
+		fclose(r->f);
+		r->f = NULL;
+	}
+	r->Mode = REPLAY_MODE_NONE;
+	return false;
+}
+static bool ReadHeaderRecord(FILE *f, const uint8_t rec, CampaignOptions *co,
+		CArray *weapons, CArray *aiPlayers);
+static bool ReadHeader(FILE *f, CampaignOptions *co,
+		struct MissionOptions *mo) {
+	// Config and players are applied through game events, the same way that
+	// net clients receive them
+	GameEventsInit(&gGameEvents);
+	CArray weapons;
+	CArrayInit(&weapons, sizeof(const WeaponClass*));
+	CArray aiPlayers;
+	CArrayInit(&aiPlayers, sizeof(int));
+	bool ok = false;
+	for (;;) {
+		uint8_t rec;
+		if (!ReadU8(f, &rec)) {
+			break;
+		}
+		if (rec == REPLAY_REC_START) {
+			ok = co->IsLoaded;
+			break;
+		}
+		if (!ReadHeaderRecord(f, rec, co, &weapons, &aiPlayers)) {
+			break;
+		}
+	}
+	if (ok) {
+		HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
+		CA_FOREACH(const int, uid, aiPlayers)
+			PlayerData *p = PlayerDataGetByUID(*uid);
+			if (p != NULL) {
+				p->inputDevice = INPUT_DEVICE_AI;
+			}
+		CA_FOREACH_END()
+
+		CampaignAndMissionSetup(co, mo);
+		CArrayCopy(&mo->Weapons, &weapons);
+		co->OptionsSet = true;
+	}
+	CArrayTerminate(&weapons);
+	CArrayTerminate(&aiPlayers);
+	return ok;
+}
+static bool TryLoadCampaign(CampaignOptions *co, const NCampaignDef def);
+static bool ReadHeaderRecord(FILE *f, const uint8_t rec, CampaignOptions *co,
+		CArray *weapons, CArray *aiPlayers) {
+	switch (rec) {
+	case REPLAY_REC_CAMPAIGN: {
+		NCampaignDef def = NCampaignDef_init_default;
+		return ReadPB(f, NCampaignDef_fields, &def)
+				&& TryLoadCampaign(co, def);
+	}
+	case REPLAY_REC_CONFIG: {
+		GameEvent e = GameEventNew(GAME_EVENT_CONFIG);
+		if (!ReadPB(f, NConfig_fields, &e.u.Config)) {
+			return false;
+		}
+		GameEventsEnqueue(&gGameEvents, e);
+		return true;
+	}
+	case REPLAY_REC_PLAYER: {
+		GameEvent e = GameEventNew(GAME_EVENT_PLAYER_DATA);
+		uint8_t isAI;
+		if (!ReadPB(f, NPlayerData_fields, &e.u.PlayerData)
+				|| !ReadU8(f, &isAI)) {
+			return false;
+		}
+		GameEventsEnqueue(&gGameEvents, e);
+		if (isAI) {
+			const int uid = (int) e.u.PlayerData.UID;
+			CArrayPushBack(aiPlayers, &uid);
+		}
+		return true;
+	}
+	case REPLAY_REC_WEAPON: {
+		char name[256];
+		if (!ReadString(f, name, sizeof name)) {
+			return false;
+		}
+		const WeaponClass *wc = StrWeaponClass(name);
+		if (wc != NULL) {
+			CArrayPushBack(weapons, &wc);
+		}
+		return true;
+	}
+	default:
+		LOG(LM_MAIN, LL_ERROR, "Unexpected replay record %d", (int )rec);
+		return false;
+	}
+}
+static bool TryLoadCampaign(CampaignOptions *co, const NCampaignDef def) {
+	co->Entry.Mode = (GameMode) def.GameMode;
+	CampaignEntry entry;
+	bool loaded = CampaignEntryTryLoad(&entry, def.Path, GAME_MODE_NORMAL);
+	if (!loaded) {
+		// Try the path relative to the data dir, like net clients do
+		char buf[CDOGS_PATH_MAX];
+		GetDataFilePath(buf, def.Path);
+		loaded = CampaignEntryTryLoad(&entry, buf, GAME_MODE_NORMAL);
+	}
+	if (!loaded || !CampaignLoad(co, &entry)) {
+		LOG(LM_MAIN, LL_ERROR, "Failed to load replay campaign %s", def.Path);
+		return false;
+	}
+	co->MissionIndex = def.Mission;
+	return true;
+}
+
+static void WriteConfigs(FILE *f, Config *group, const char *prefix);
+void ReplayStart(Replay *r, const CampaignOptions *co,
+		const struct MissionOptions *mo) {
+	r->Ticks = 0;
+	r->Divergences = 0;
+	r->Ended = false;
+	r->startTicks = SDL_GetTicks();
+	if (r->Mode != REPLAY_MODE_RECORD || r->f != NULL) {
+		return;
+	}
+	if (co->IsClient || GetNumPlayers(PLAYER_ANY, false, false)
+			!= GetNumPlayers(PLAYER_ANY, false, true)) {
+		LOG(LM_MAIN, LL_WARN, "Cannot record replay of a net game");
+		r->Mode = REPLAY_MODE_NONE;
+		return;
+	}
+	r->f = fopen(r->Filename, "wb");
+	if (r->f == NULL) {
+		LOG(LM_MAIN, LL_ERROR, "Cannot open replay file %s for writing",
+				r->Filename);
+		r->Mode = REPLAY_MODE_NONE;
+		return;
+	}
+	r->Seed = (unsigned int) time(NULL);
+
+	fwrite(REPLAY_MAGIC, 1, strlen(REPLAY_MAGIC), r->f);
+	WriteU32(r->f, REPLAY_VERSION);
+	WriteU32(r->f, r->Seed);
+
+	const NCampaignDef def = NMakeCampaignDef(co);
+	WriteU8(r->f, REPLAY_REC_CAMPAIGN);
+	WritePB(r->f, NCampaignDef_fields, &def);
+
+	WriteConfigs(r->f, ConfigGet(&gConfig, "Game"), "Game");
+
+	CA_FOREACH(const PlayerData, p, gPlayerDatas)
+		const NPlayerData pd = NMakePlayerData(p);
+		WriteU8(r->f, REPLAY_REC_PLAYER);
+		WritePB(r->f, NPlayerData_fields, &pd);
+		WriteU8(r->f, p->inputDevice == INPUT_DEVICE_AI);
+	CA_FOREACH_END()
+
+	CA_FOREACH(const WeaponClass *, wc, mo->Weapons)
+		WriteU8(r->f, REPLAY_REC_WEAPON);
+		WriteString(r->f, (*wc)->name);
+	CA_FOREACH_END()
+
+	WriteU8(r->f, REPLAY_REC_START);
+	LOG(LM_MAIN, LL_INFO, "Recording replay %s", r->Filename);
+}
+static void WriteConfigs(FILE *f, Config *group, const char *prefix) {
+	CA_FOREACH(Config, c, group->u.Group)
+		char name[256];
+		sprintf(name, "%s.%s", prefix, c->Name);
+		switch (c->Type) {
+		case CONFIG_TYPE_GROUP:
+			WriteConfigs(f, c, name);
+			break;
+		case CONFIG_TYPE_STRING:
+			// Not supported by config game events
+			break;
+		default: {
+			const NConfig nc = NMakeConfig(&gConfig, name);
+			WriteU8(f, REPLAY_REC_CONFIG);
+			WritePB(f, NConfig_fields, &nc);
+		}
+			break;
+		}
+	CA_FOREACH_END()
+}
+
+static void Diverged(Replay *r, const char *reason);
+static void Ended(Replay *r);
+void ReplayCmd(Replay *r, int *cmd) {
+	if (r->f == NULL) {
+		return;
+	}
+	if (r->Mode == REPLAY_MODE_RECORD) {
+		WriteU8(r->f, REPLAY_REC_CMD);
+		WriteU16(r->f, (uint16_t) *cmd);
+		return;
+	}
+	if (r->Ended) {
+		*cmd = 0;
+		return;
+	}
+	uint8_t rec;
+	uint16_t c;
+	if (!ReadU8(r->f, &rec)) {
+		Diverged(r, "unexpected end of replay");
+		Ended(r);
+		*cmd = 0;
+		return;
+	}
+	if (rec == REPLAY_REC_END) {
+		Ended(r);
+		*cmd = 0;
+		return;
+	}
+	if (rec != REPLAY_REC_CMD || !ReadU16(r->f, &c)) {
+		Diverged(r, "missing command");
+		*cmd = 0;
+		return;
+	}
+	*cmd = (int) c;
+}
+
+void ReplayEndTick(Replay *r) {
+	if (r->f == NULL || r->Ended) {
+		return;
+	}
+	const uint32_t hash = ReplayHashState();
+	if (r->Mode == REPLAY_MODE_RECORD) {
+		WriteU8(r->f, REPLAY_REC_TICK);
+		WriteU32(r->f, hash);
+	} else {
+		uint8_t rec;
+		uint32_t recHash;
+		// Skip over commands that were not consumed
+		do {
+			if (!ReadU8(r->f, &rec)) {
+				Diverged(r, "unexpected end of replay");
+				Ended(r);
+				return;
+			}
+			if (rec == REPLAY_REC_CMD) {
+				uint16_t c;
+				ReadU16(r->f, &c);
+				Diverged(r, "extra command");
+			}
+		} while (rec == REPLAY_REC_CMD);
+		if (rec == REPLAY_REC_END) {
+			Ended(r);
+			return;
+		} else if (rec != REPLAY_REC_TICK || !ReadU32(r->f, &recHash)) {
+			Diverged(r, "corrupt tick record");
+		} else if (recHash != hash) {
+			Diverged(r, "state hash mismatch");
+		}
+	}
+	r->Ticks++;
+}
+static void Diverged(Replay *r, const char *reason) {
+	// Only log the first divergence; everything after is likely to differ
+	if (r->Divergences == 0) {
+		LOG(LM_MAIN, LL_ERROR, "Replay diverged at tick %d: %s", r->Ticks,
+				reason);
+	}
+	r->Divergences++;
+}
+// Stop reading; the game quits once it sees ReplayHasEnded
+static void Ended(Replay *r) {
+	LOG(LM_MAIN, LL_INFO, "Replay ended at tick %d", r->Ticks);
+	r->Ended = true;
+}
+
+void ReplayStop(Replay *r) {
+	if (r->f == NULL) {
+		return;
+	}
+	const Uint32 elapsed = SDL_GetTicks() - r->startTicks;
+	if (r->Mode == REPLAY_MODE_RECORD) {
+		WriteU8(r->f, REPLAY_REC_END);
+		LOG(LM_MAIN, LL_INFO, "Recorded %d ticks to %s", r->Ticks,
+				r->Filename);
+	} else {
+		LOG(LM_MAIN, LL_INFO,
+				"Replayed %d ticks in %ums (%.1f ticks/s), %d divergences",
+				r->Ticks, elapsed,
+				elapsed > 0 ? r->Ticks * 1000.0 / elapsed : 0.0,
+				r->Divergences);
+	}
+	fclose(r->f);
+	r->f = NULL;
+	r->Mode = REPLAY_MODE_NONE;
+}
+
+// FNV-1a
+#define HASH_INIT 2166136261u
+static uint32_t HashBytes(uint32_t h, const void *data, const size_t len) {
+	const uint8_t *p = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < len; i++) {
+		h ^= p[i];
+		h *= 16777619u;
+	}
+	return h;
+}
+#define HASH(_h, _v) _h = HashBytes(_h, &(_v), sizeof(_v))
+uint32_t ReplayHashState(void) {
+	uint32_t h = HASH_INIT;
+	HASH(h, gMission.time);
+	CA_FOREACH(const TActor, a, gActors)
+		if (!a->isInUse) {
+			continue;
+		}
+		HASH(h, a->uid);
+		HASH(h, a->Pos);
+		HASH(h, a->health);
+		HASH(h, a->dead);
+	CA_FOREACH_END()
+	CA_FOREACH(const TObject, o, gObjs)
+		if (!o->isInUse) {
+			continue;
+		}
+		HASH(h, o->uid);
+		HASH(h, o->Health);
+	CA_FOREACH_END()
+	CA_FOREACH(const TMobileObject, m, gMobObjs)
+		if (!m->isInUse) {
+			continue;
+		}
+		HASH(h, m->UID);
+		HASH(h, m->thing.Pos);
+	CA_FOREACH_END()
+	return h;
+}
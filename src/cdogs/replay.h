@@ -0,0 +1,97 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <SDL2/SDL_stdinc.h>
+
+#include "campaigns.h"
+#include "mission.h"
+#include "sys_config.h"
+
+// Deterministic input recording and playback
+//
+// A replay records everything needed to re-simulate a mission: the
+// campaign and mission, the random seed, game config, players and allowed
+// weapons, followed by the local player commands for every game tick.
+// A hash of the game state is stored with each tick so that playback can
+// detect when the simulation diverges.
+//
+// Only local games can be replayed; remote player input is not recorded.
+
+#define REPLAY_MAGIC "CDRP"
+#define REPLAY_VERSION 1
+
+typedef enum {
+	REPLAY_MODE_NONE,
+	REPLAY_MODE_RECORD,
+	REPLAY_MODE_PLAY
+} ReplayMode;
+
+typedef struct {
+	ReplayMode Mode;
+	char Filename[CDOGS_PATH_MAX];
+	// Playback only: update as fast as possible without drawing
+	bool IsFast;
+	FILE *f;
+	unsigned int Seed;
+	int Ticks;
+	int Divergences;
+	// Playback only: the end of the recording has been reached
+	bool Ended;
+	Uint32 startTicks;
+} Replay;
+
+extern Replay gReplay;
+
+void ReplayInit(Replay *r);
+// Set up recording of the next mission played
+void ReplaySetRecord(Replay *r, const char *filename);
+// Set up playback of a replay file; use ReplayLoad once game data is loaded
+void ReplaySetPlayback(Replay *r, const char *filename, const bool isFast);
+// Load the campaign, mission, config and players from a replay file for
+// playback; afterwards the game can be run
+bool ReplayLoad(Replay *r, CampaignOptions *co, struct MissionOptions *mo);
+bool ReplayIsActive(const Replay *r);
+bool ReplayIsPlaying(const Replay *r);
+bool ReplayHasEnded(const Replay *r);
+
+// Call at the start of a mission; starts recording if requested
+void ReplayStart(Replay *r, const CampaignOptions *co,
+		const struct MissionOptions *mo);
+// Record, or replace with the recorded, command for the next local player
+void ReplayCmd(Replay *r, int *cmd);
+// Call at the end of each game tick; records or verifies the state hash
+void ReplayEndTick(Replay *r);
+void ReplayStop(Replay *r);
+
+uint32_t ReplayHashState(void);
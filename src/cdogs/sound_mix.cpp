@@ -0,0 +1,191 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "sound_mix.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SOUND_MIX_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SOUND_MIX_NEON
+#endif
+
+#include "utils.h"
+
+void SoundMixerInit(SoundMixer *m, const int maxFrames) {
+	m->maxFrames = maxFrames;
+	CCALLOC(m->acc, maxFrames * 2 * sizeof *m->acc);
+	CCALLOC(m->muffled, maxFrames * 2 * sizeof *m->muffled);
+}
+void SoundMixerTerminate(SoundMixer *m) {
+	CFREE(m->acc);
+	CFREE(m->muffled);
+	memset(m, 0, sizeof *m);
+}
+
+bool SoundMixVoiceIsPlaying(const SoundMixVoice *v) {
+	return v->samples != NULL && v->played < v->frames;
+}
+
+// Average each sample with the same channel's next two frames; the last
+// two frames of the sound are left as is
+static void Muffle(int16_t *dst, const int16_t *src, const int n,
+		const int available) {
+	int i = 0;
+#if defined(SOUND_MIX_SSE2)
+	// (x * 21845) >> 16 is x / 3
+	const __m128i third = _mm_set1_epi16(21845);
+	for (; i + 8 <= n && i + 12 <= available; i += 8) {
+		const __m128i a = _mm_loadu_si128((const __m128i*) (src + i));
+		const __m128i b = _mm_loadu_si128((const __m128i*) (src + i + 2));
+		const __m128i c = _mm_loadu_si128((const __m128i*) (src + i + 4));
+		const __m128i sum = _mm_adds_epi16(
+				_mm_adds_epi16(_mm_mulhi_epi16(a, third),
+						_mm_mulhi_epi16(b, third)), _mm_mulhi_epi16(c, third));
+		_mm_storeu_si128((__m128i*) (dst + i), sum);
+	}
+#elif defined(SOUND_MIX_NEON)
+	for (; i + 8 <= n && i + 12 <= available; i += 8) {
+		const int16x8_t a = vld1q_s16(src + i);
+		const int16x8_t b = vld1q_s16(src + i + 2);
+		const int16x8_t c = vld1q_s16(src + i + 4);
+		const int16x8_t sum = vqaddq_s16(
+				vqaddq_s16(vqdmulhq_n_s16(a, 10923), vqdmulhq_n_s16(b, 10923)),
+				vqdmulhq_n_s16(c, 10923));
+		vst1q_s16(dst + i, sum);
+	}
+#endif
+	for (; i < n; i++) {
+		if (i + 4 < available) {
+			dst[i] = (int16_t) (((int) src[i] + src[i + 2] + src[i + 4]) / 3);
+		} else {
+			dst[i] = src[i];
+		}
+	}
+}
+
+// acc += src * gains, over n interleaved samples
+static void Accumulate(int32_t *acc, const int16_t *src, const int n,
+		const int16_t *gains) {
+	int i = 0;
+#if defined(SOUND_MIX_SSE2)
+	const __m128i g = _mm_set_epi16(gains[1], gains[0], gains[1], gains[0],
+			gains[1], gains[0], gains[1], gains[0]);
+	for (; i + 8 <= n; i += 8) {
+		const __m128i x = _mm_loadu_si128((const __m128i*) (src + i));
+		const __m128i lo = _mm_mullo_epi16(x, g);
+		const __m128i hi = _mm_mulhi_epi16(x, g);
+		__m128i *a = (__m128i*) (acc + i);
+		_mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a),
+				_mm_unpacklo_epi16(lo, hi)));
+		_mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1),
+				_mm_unpackhi_epi16(lo, hi)));
+	}
+#elif defined(SOUND_MIX_NEON)
+	const int16_t g4[4] = { gains[0], gains[1], gains[0], gains[1] };
+	const int16x4_t g = vld1_s16(g4);
+	for (; i + 8 <= n; i += 8) {
+		const int16x8_t x = vld1q_s16(src + i);
+		vst1q_s32(acc + i, vmlal_s16(vld1q_s32(acc + i), vget_low_s16(x), g));
+		vst1q_s32(acc + i + 4,
+				vmlal_s16(vld1q_s32(acc + i + 4), vget_high_s16(x), g));
+	}
+#endif
+	for (; i < n; i++) {
+		acc[i] += (int32_t) src[i] * gains[i & 1];
+	}
+}
+
+// stream += acc, scaled back from fixed point and saturated
+static void Resolve(int16_t *stream, const int32_t *acc, const int n) {
+	int i = 0;
+#if defined(SOUND_MIX_SSE2)
+	for (; i + 8 <= n; i += 8) {
+		__m128i *s = (__m128i*) (stream + i);
+		const __m128i x = _mm_loadu_si128(s);
+		// Sign-extend the stream so it is added before saturating
+		const __m128i x0 = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+		const __m128i x1 = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+		const __m128i a0 = _mm_srai_epi32(
+				_mm_loadu_si128((const __m128i*) (acc + i)),
+				SOUND_MIX_GAIN_SHIFT);
+		const __m128i a1 = _mm_srai_epi32(
+				_mm_loadu_si128((const __m128i*) (acc + i + 4)),
+				SOUND_MIX_GAIN_SHIFT);
+		_mm_storeu_si128(s, _mm_packs_epi32(_mm_add_epi32(a0, x0),
+				_mm_add_epi32(a1, x1)));
+	}
+#elif defined(SOUND_MIX_NEON)
+	for (; i + 8 <= n; i += 8) {
+		const int16x8_t x = vld1q_s16(stream + i);
+		const int32x4_t a0 = vaddw_s16(
+				vshrq_n_s32(vld1q_s32(acc + i), SOUND_MIX_GAIN_SHIFT),
+				vget_low_s16(x));
+		const int32x4_t a1 = vaddw_s16(
+				vshrq_n_s32(vld1q_s32(acc + i + 4), SOUND_MIX_GAIN_SHIFT),
+				vget_high_s16(x));
+		vst1q_s16(stream + i, vcombine_s16(vqmovn_s32(a0), vqmovn_s32(a1)));
+	}
+#endif
+	for (; i < n; i++) {
+		const int32_t s = stream[i] + (acc[i] >> SOUND_MIX_GAIN_SHIFT);
+		stream[i] = (int16_t) CLAMP(s, INT16_MIN, INT16_MAX);
+	}
+}
+
+void SoundMixerMix(SoundMixer *m, int16_t *stream, const int frames,
+		SoundMixVoice *const *voices, const int numVoices) {
+	for (int start = 0; start < frames; start += m->maxFrames) {
+		const int blockFrames = MIN(frames - start, m->maxFrames);
+		bool any = false;
+		for (int i = 0; i < numVoices; i++) {
+			SoundMixVoice *v = voices[i];
+			if (!SoundMixVoiceIsPlaying(v)) {
+				continue;
+			}
+			if (!any) {
+				memset(m->acc, 0, blockFrames * 2 * sizeof *m->acc);
+				any = true;
+			}
+			const int n = MIN(blockFrames, v->frames - v->played);
+			const int16_t *src = v->samples + v->played * 2;
+			if (v->isMuffled) {
+				Muffle(m->muffled, src, n * 2, (v->frames - v->played) * 2);
+				src = m->muffled;
+			}
+			Accumulate(m->acc, src, n * 2, v->gains);
+			v->played += n;
+		}
+		if (any) {
+			Resolve(stream + start * 2, m->acc, blockFrames * 2);
+		}
+	}
+}
@@ -0,0 +1,63 @@
+/*
+ C-Dogs SDL
+ A port of the legendary (and fun) action/arcade cdogs.
+
+ Copyright (c) 2026, Cong Xu
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Mixes sound effect voices into an interleaved stereo int16 stream,
+// applying per-voice gain, pan and a low-pass muffle in one pass.
+// Uses SSE2 or NEON where available.
+
+// Gains are fixed point with this as 1; low enough that 256 full-scale
+// voices can be summed in 32 bits
+#define SOUND_MIX_GAIN_SHIFT 8
+#define SOUND_MIX_GAIN_ONE (1 << SOUND_MIX_GAIN_SHIFT)
+
+typedef struct {
+	const int16_t *samples;	// interleaved stereo; NULL if not playing
+	int frames;
+	int played;
+	int16_t gains[2];		// left, right
+	bool isMuffled;
+} SoundMixVoice;
+
+typedef struct {
+	int32_t *acc;
+	int16_t *muffled;
+	int maxFrames;
+} SoundMixer;
+
+void SoundMixerInit(SoundMixer *m, const int maxFrames);
+void SoundMixerTerminate(SoundMixer *m);
+// Add the voices to the stream and advance them
+void SoundMixerMix(SoundMixer *m, int16_t *stream, const int frames,
+		SoundMixVoice *const *voices, const int numVoices);
+
+bool SoundMixVoiceIsPlaying(const SoundMixVoice *v);
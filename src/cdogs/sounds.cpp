@@ -61,10 +61,12 @@
 #include <tinydir/tinydir.h>
 
 #include "algorithms.h"
+#include "asset_pack.h"
 #include "files.h"
 #include "log.h"
 #include "map.h"
 #include "music.h"
+#include "profiler.h"
 #include "vector.h"
 
 SoundDevice gSoundDevice;
@@ -95,9 +97,12 @@ int OpenAudio(int frequency, Uint16 format, int channels, int chunkSize) {
 	return 0;
 }
 
-static Mix_Chunk* LoadSound(const char *path);
+static SoundChunk* SoundChunkNew(const char *path, const AssetPack *pack,
+		const char *packName);
 static void AddSound(map_t sounds, const char *name, SoundData *sound);
-static void SoundLoad(map_t sounds, const char *name, const char *path) {
+// pack, if not NULL, has the samples of the sounds by name without extension
+static void SoundLoad(map_t sounds, const char *name, const char *path,
+		const AssetPack *pack) {
 	// If the sound basename is a number, it is part of a group of random sounds
 	char basename[CDOGS_FILENAME_MAX];
 	PathGetBasenameWithoutExtension(basename, name);
@@ -120,7 +125,7 @@ static void SoundLoad(map_t sounds, const char *name, const char *path) {
 		SoundData *sound;
 		CCALLOC(sound, sizeof *sound);
 		sound->Type = SOUND_RANDOM;
-		CArrayInit(&sound->u.random.sounds, sizeof(Mix_Chunk*));
+		CArrayInit(&sound->u.random.sounds, sizeof(SoundChunk*));
 		// Remove "0.<ext>" from path
 		const char *ext = StrGetFileExt(path);
 		const int len = (int) (ext - path - 2);
@@ -128,19 +133,26 @@ static void SoundLoad(map_t sounds, const char *name, const char *path) {
 		strncpy(fmt, path, len);
 		// Create format string path/to/sound/%d.<ext>
 		sprintf(fmt + len, "%%d.%s", ext);
+		// Remove "/0" from name
+		*strrchr(nameNoExt, '/') = '\0';
 		for (int i = 0;; i++) {
 			char buf[CDOGS_PATH_MAX];
 			sprintf(buf, fmt, i);
-			Mix_Chunk *data = LoadSound(buf);
-			if (data == NULL)
+			struct stat st;
+			if (stat(buf, &st) != 0) {
+				break;
+			}
+			char packName[CDOGS_PATH_MAX];
+			sprintf(packName, "%s/%d", nameNoExt, i);
+			SoundChunk *data = SoundChunkNew(buf, pack, packName);
+			if (data == NULL) {
 				break;
+			}
 			CArrayPushBack(&sound->u.random.sounds, &data);
 		}
-		// Remove "/0" from name and add
-		*strrchr(nameNoExt, '/') = '\0';
 		AddSound(sounds, nameNoExt, sound);
 	} else {
-		Mix_Chunk *data = LoadSound(path);
+		SoundChunk *data = SoundChunkNew(path, pack, nameNoExt);
 		if (data != NULL) {
 			SoundData *sound;
 			CMALLOC(sound, sizeof *sound);
@@ -150,16 +162,123 @@ static void SoundLoad(map_t sounds, const char *name, const char *path) {
 		}
 	}
 }
-static Mix_Chunk* LoadSound(const char *path) {
+bool SoundIsFile(const char *path) {
 	// Only load sounds from known extensions
 	const char *ext = strrchr(path, '.');
-	if (ext == NULL
-			|| !(strcmp(ext, ".ogg") == 0 || strcmp(ext, ".OGG") == 0
-					|| strcmp(ext, ".wav") == 0 || strcmp(ext, ".WAV") == 0)) {
+	return ext != NULL
+			&& (strcmp(ext, ".ogg") == 0 || strcmp(ext, ".OGG") == 0
+					|| strcmp(ext, ".wav") == 0 || strcmp(ext, ".WAV") == 0);
+}
+static SoundChunk* SoundChunkNew(const char *path, const AssetPack *pack,
+		const char *packName) {
+	if (!SoundIsFile(path)) {
 		return NULL;
 	}
-	LOG(LM_MAIN, LL_TRACE, "loading sound file %s", path);
-	return Mix_LoadWAV(path);
+	SoundChunk *sc;
+	CCALLOC(sc, sizeof *sc);
+	sc->chunk.volume = MIX_MAX_VOLUME;
+	CSTRDUP(sc->path, path);
+	const AssetPackEntry *e =
+			pack != NULL ?
+					AssetPackFind(pack, ASSET_SECTION_SOUNDS, packName) : NULL;
+	if (e != NULL) {
+		// Only read by the mixer, so it can stay in the read-only mapping
+		sc->chunk.abuf = const_cast<Uint8*>(pack->data + e->DataOffset);
+		sc->chunk.alen = (Uint32) e->DataSize;
+	}
+	return sc;
+}
+static bool SoundChunkIsPlaying(const SoundDevice *s, const SoundChunk *sc) {
+	for (int i = 0; i < s->channels; i++) {
+		const SoundVoice *v = &s->voices[i];
+		if (v->chunk == &sc->chunk && SoundMixVoiceIsPlaying(&v->mix)) {
+			return true;
+		}
+	}
+	return false;
+}
+static void SoundChunkUnload(SoundDevice *s, const int idx);
+// Unload the least recently used idle sounds until under budget
+static void EvictChunks(SoundDevice *s, const SoundChunk *keep) {
+	SDL_LockMutex(s->voiceLock);
+	while (s->loadedBytes > SOUND_CACHE_MAX_BYTES) {
+		int oldest = -1;
+		int oldestUsed = 0;
+		CA_FOREACH(SoundChunk *, sc, s->loadedChunks)
+			if (*sc == keep || SoundChunkIsPlaying(s, *sc)) {
+				continue;
+			}
+			if (oldest < 0 || (*sc)->lastUsed < oldestUsed) {
+				oldest = _ca_index;
+				oldestUsed = (*sc)->lastUsed;
+			}
+		CA_FOREACH_END()
+		if (oldest < 0) {
+			break;
+		}
+		SoundChunkUnload(s, oldest);
+	}
+	SDL_UnlockMutex(s->voiceLock);
+}
+// Decode the sound's samples into its chunk if not already
+static bool SoundChunkLoad(SoundDevice *s, SoundChunk *sc) {
+	sc->lastUsed = ++s->chunkUseCount;
+	if (sc->chunk.abuf != NULL) {
+		return true;
+	}
+	if (sc->path == NULL) {
+		return false;
+	}
+	LOG(LM_SOUND, LL_TRACE, "loading sound file %s", sc->path);
+	Mix_Chunk *data = Mix_LoadWAV(sc->path);
+	if (data == NULL) {
+		LOG(LM_SOUND, LL_ERROR, "cannot load sound %s: %s", sc->path,
+				Mix_GetError());
+		// Don't try again
+		CFREE(sc->path);
+		sc->path = NULL;
+		return false;
+	}
+	// Take the samples, keeping our chunk in place
+	sc->chunk.allocated = data->allocated;
+	sc->chunk.abuf = data->abuf;
+	sc->chunk.alen = data->alen;
+	data->allocated = 0;
+	Mix_FreeChunk(data);
+	CArrayPushBack(&s->loadedChunks, &sc);
+	s->loadedBytes += sc->chunk.alen;
+	EvictChunks(s, sc);
+	return true;
+}
+// Must hold the voice lock
+static void SoundChunkUnload(SoundDevice *s, const int idx) {
+	SoundChunk *sc = *(SoundChunk **) CArrayGet(&s->loadedChunks, idx);
+	for (int i = 0; i < s->channels; i++) {
+		SoundVoice *v = &s->voices[i];
+		if (v->chunk == &sc->chunk) {
+			memset(v, 0, sizeof *v);
+		}
+	}
+	s->loadedBytes -= sc->chunk.alen;
+	if (sc->chunk.allocated) {
+		SDL_free(sc->chunk.abuf);
+	}
+	sc->chunk.allocated = 0;
+	sc->chunk.abuf = NULL;
+	sc->chunk.alen = 0;
+	CArrayDelete(&s->loadedChunks, idx);
+}
+static void SoundChunkTerminate(SoundDevice *s, SoundChunk *sc) {
+	SDL_LockMutex(s->voiceLock);
+	CA_FOREACH(SoundChunk *, loaded, s->loadedChunks)
+		if (*loaded == sc) {
+			SoundChunkUnload(s, _ca_index);
+			break;
+		}
+	CA_FOREACH_END()
+	SDL_UnlockMutex(s->voiceLock);
+	CFREE(sc->path);
+	CFREE(sc);
 }
 static void SoundDataTerminate(any_t data);
 static void AddSound(map_t sounds, const char *name, SoundData *sound) {
@@ -170,23 +289,58 @@ static void AddSound(map_t sounds, const char *name, SoundData *sound) {
 	}
 }
 
+static void LoadDir(map_t sounds, const char *path, const char *prefix,
+		const AssetPack *pack);
+static bool PackMatchesDevice(const AssetPack *pack);
 static void SoundLoadMusic(CArray *tracks, const char *path);
 void SoundInitialize(SoundDevice *device, const char *path) {
+	PROFILE_SCOPE("load sounds");
 	memset(device, 0, sizeof *device);
+	device->voiceLock = SDL_CreateMutex();
+	SoundMixerInit(&device->mixer, SOUND_MIX_FRAMES);
 	SoundReopen(device);
 
 	device->sounds = hashmap_new();
 	device->customSounds = hashmap_new();
+	CArrayInit(&device->loadedChunks, sizeof(SoundChunk*));
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, path);
-	SoundLoadDir(device->sounds, buf, NULL);
+	// Baked sounds are only those under the sounds dir
+	const bool usePack = strcmp(path, SOUNDS_DIR) == 0
+			&& PackMatchesDevice(&gAssetPack);
+	LoadDir(device->sounds, buf, NULL, usePack ? &gAssetPack : NULL);
 
 	// Load music
 	SoundLoadMusic(&device->musicTracks[MUSIC_MENU], "music/menu");
 	SoundLoadMusic(&device->musicTracks[MUSIC_BRIEFING], "music/briefing");
 	SoundLoadMusic(&device->musicTracks[MUSIC_GAME], "music/game");
 }
+// Whether the pack has sounds in the format the device was opened with
+static bool PackMatchesDevice(const AssetPack *pack) {
+	if (!pack->IsFresh[ASSET_SECTION_SOUNDS]) {
+		return false;
+	}
+	int frequency;
+	Uint16 format;
+	int channels;
+	if (Mix_QuerySpec(&frequency, &format, &channels) == 0) {
+		return false;
+	}
+	if (frequency != pack->Header->AudioFrequency
+			|| format != pack->Header->AudioFormat
+			|| channels != (int) pack->Header->AudioChannels) {
+		LOG(LM_SOUND, LL_INFO,
+				"sounds in %s are in another format; loading their files",
+				ASSET_PACK_FILE);
+		return false;
+	}
+	return true;
+}
 void SoundLoadDir(map_t sounds, const char *path, const char *prefix) {
+	LoadDir(sounds, path, prefix, NULL);
+}
+static void LoadDir(map_t sounds, const char *path, const char *prefix,
+		const AssetPack *pack) {
 	tinydir_dir dir;
 	if (tinydir_open(&dir, path) == -1) {
 		if (errno != ENOENT) {
@@ -211,16 +365,16 @@ void SoundLoadDir(map_t sounds, const char *path, const char *prefix) {
 			strcpy(buf, file.name);
 		}
 		if (file.is_reg) {
-			SoundLoad(sounds, buf, file.path);
+			SoundLoad(sounds, buf, file.path, pack);
 		} else if (file.is_dir) {
-			SoundLoadDir(sounds, file.path, buf);
+			LoadDir(sounds, file.path, buf, pack);
 		}
 	}
 
 	bail: tinydir_close(&dir);
 }
 static void SoundLoadMusic(CArray *tracks, const char *path) {
-	CArrayInit(tracks, sizeof(Mix_Music*));
+	CArrayInit(tracks, sizeof(char*));
 	tinydir_dir dir;
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, path);
@@ -231,25 +385,31 @@ static void SoundLoadMusic(CArray *tracks, const char *path) {
 	}
 
 	for (; dir.has_next; tinydir_next(&dir)) {
-		Mix_Music *m;
 		tinydir_file file;
 		if (tinydir_readfile(&dir, &file) == -1) {
 			goto bail;
 		}
-		if (!file.is_reg) {
+		if (!file.is_reg || !MusicIsFile(file.path)) {
 			continue;
 		}
 
-		m = MusicLoad(file.path);
-		if (m == NULL) {
-			continue;
-		}
+		char *m;
+		CSTRDUP(m, file.path);
 		CArrayPushBack(tracks, &m);
 	}
 
 	bail: tinydir_close(&dir);
 }
 
+static bool IsAnyVoicePlaying(SoundDevice *s) {
+	bool playing = false;
+	SDL_LockMutex(s->voiceLock);
+	for (int i = 0; i < s->channels && !playing; i++) {
+		playing = SoundMixVoiceIsPlaying(&s->voices[i].mix);
+	}
+	SDL_UnlockMutex(s->voiceLock);
+	return playing;
+}
 static void SoundClose(SoundDevice *s, const bool waitForSoundsComplete) {
 	if (!s->isInitialised) {
 		return;
@@ -257,11 +417,12 @@ static void SoundClose(SoundDevice *s, const bool waitForSoundsComplete) {
 
 	if (waitForSoundsComplete) {
 		Uint32 waitStart = SDL_GetTicks();
-		while (Mix_Playing(-1) > 0 && SDL_GetTicks() - waitStart < 1000)
+		while (IsAnyVoicePlaying(s) && SDL_GetTicks() - waitStart < 1000)
 			;
 		// Don't stop the music unless we're reopening
 		MusicStop(s);
 	}
+	Mix_SetPostMix(NULL, NULL);
 	while (Mix_Init(0)) {
 		Mix_Quit();
 	}
@@ -271,13 +432,8 @@ static void SoundClose(SoundDevice *s, const bool waitForSoundsComplete) {
 void SoundReconfigure(SoundDevice *s) {
 	s->isInitialised = false;
 
-	if (Mix_AllocateChannels(s->channels) != s->channels) {
-		printf("Couldn't allocate channels!\n");
-		return;
-	}
-
-	const int sVol = ConfigGetInt(&gConfig, "Sound.SoundVolume");
-	Mix_Volume(-1, sVol);
+	// Sound effects are mixed by us, not in SDL_mixer's channels
+	s->volume = ConfigGetInt(&gConfig, "Sound.SoundVolume");
 	const int mVol = ConfigGetInt(&gConfig, "Sound.MusicVolume");
 	Mix_VolumeMusic(mVol);
 	if (mVol > 0) {
@@ -289,13 +445,30 @@ void SoundReconfigure(SoundDevice *s) {
 	s->isInitialised = true;
 }
 
+// Mix the sound effect voices over the music, on the audio thread
+static void PostMix(void *udata, Uint8 *stream, int len) {
+	SoundDevice *s = static_cast<SoundDevice*>(udata);
+	SoundMixVoice *voices[SOUND_CHANNELS];
+	int numVoices = 0;
+	SDL_LockMutex(s->voiceLock);
+	for (int i = 0; i < s->channels; i++) {
+		if (SoundMixVoiceIsPlaying(&s->voices[i].mix)) {
+			voices[numVoices++] = &s->voices[i].mix;
+		}
+	}
+	SoundMixerMix(&s->mixer, (int16_t*) stream, len / 4, voices, numVoices);
+	SDL_UnlockMutex(s->voiceLock);
+}
 void SoundReopen(SoundDevice *s) {
 	SoundClose(s, false);
-	if (OpenAudio(44100, AUDIO_S16, 2, 1024) != 0) {
+	if (OpenAudio(SOUND_FREQUENCY, SOUND_FORMAT, SOUND_OUTPUT_CHANNELS, 1024)
+			!= 0) {
 		return;
 	}
 
-	s->channels = 64;
+	s->channels = SOUND_CHANNELS;
+	memset(s->voices, 0, sizeof s->voices);
+	Mix_SetPostMix(PostMix, s);
 	SoundReconfigure(s);
 }
 
@@ -305,9 +478,13 @@ void SoundClear(map_t sounds) {
 static void SoundUnloadMusic(CArray *tracks);
 void SoundTerminate(SoundDevice *device, const bool waitForSoundsComplete) {
 	SoundClose(device, waitForSoundsComplete);
+	MusicStop(device);
 
 	hashmap_destroy(device->sounds, SoundDataTerminate);
 	hashmap_destroy(device->customSounds, SoundDataTerminate);
+	CArrayTerminate(&device->loadedChunks);
+	SoundMixerTerminate(&device->mixer);
+	SDL_DestroyMutex(device->voiceLock);
 
 	for (MusicType type = MUSIC_MENU; type < MUSIC_COUNT; ++type) {
 		SoundUnloadMusic(&device->musicTracks[type]);
@@ -317,11 +494,11 @@ static void SoundDataTerminate(any_t data) {
 	SoundData *s = static_cast<SoundData*>(data);
 	switch (s->Type) {
 	case SOUND_NORMAL:
-		Mix_FreeChunk(s->u.normal);
+		SoundChunkTerminate(&gSoundDevice, s->u.normal);
 		break;
 	case SOUND_RANDOM:
-		CA_FOREACH(Mix_Chunk *, chunk, s->u.random.sounds)
-		Mix_FreeChunk(*chunk);
+		CA_FOREACH(SoundChunk *, chunk, s->u.random.sounds)
+		SoundChunkTerminate(&gSoundDevice, *chunk);
 		CA_FOREACH_END()
 		CArrayTerminate(&s->u.random.sounds);
 		break;
@@ -333,130 +510,120 @@ static void SoundDataTerminate(any_t data) {
 	CFREE(s);
 }
 static void SoundUnloadMusic(CArray *tracks) {
-	CA_FOREACH(Mix_Music *, m, *tracks)
-	Mix_FreeMusic(*m);
+	CA_FOREACH(char *, m, *tracks)
+	CFREE(*m);
 	CA_FOREACH_END()
 	CArrayTerminate(tracks);
 }
 
 #define OUT_OF_SIGHT_DISTANCE_PLUS 100
-static int GetChannel(SoundDevice *s, Mix_Chunk *data);
-static void MuffleEffect(int chan, void *stream, int len, void *udata) {
-	UNUSED(chan);
-	UNUSED(udata);
-	const int channels = 2;
-	const int chunk = channels * 2;
-	for (int i = 0; i < len / chunk - 2; i++) {
-		int16_t *samples = (int16_t*) ((char*) stream + i * chunk);
-		samples[0] = (samples[0] + samples[2] + samples[4]) / 3;
-		samples[1] = (samples[1] + samples[3] + samples[5]) / 3;
-	}
-}
-static void SetSoundEffect(const int channel, const Sint16 bearingDegrees,
-		const Uint8 distance, const bool isMuffled);
-static void SoundPlayAtPosition(SoundDevice *device, Mix_Chunk *data,
-		const struct vec2 dp, const bool isMuffled) {
+// How loud a sound is in each speaker, and how far away it seems
+typedef struct {
+	float gains[2];
+	int distance;
+	bool isMuffled;
+} Hearing;
+static int GetChannel(SoundDevice *s, Mix_Chunk *data,
+		const struct vec2 pos, const int distance);
+static void PlayVoice(SoundDevice *device, Mix_Chunk *data,
+		const struct vec2 pos, const Hearing *h) {
 	if (!device->isInitialised || data == NULL) {
 		return;
 	}
+	LOG(LM_SOUND, LL_TRACE, "distance(%d) gains(%.2f, %.2f)", h->distance,
+			h->gains[0], h->gains[1]);
 
-	int distance = 0;
-	Sint16 bearingDegrees = 0;
-	const float screen = (float) gGraphicsDevice.cachedConfig.Res.x;
-	const float halfScreen = screen / 2;
-	if (!svec2_is_zero(dp)) {
-		// Calculate distance and bearing
-		// Sound position is calculated from an imaginary camera that's half as
-		// distant from the centre of the screen as the screen width, i.e.
-		//
-		//         centre-+
-		//                v
-		// Screen: |------+------|
-		//                |
-		//                |
-		//     camera---> +
-		// Calculate real distance using Pythagoras
-		const float d = svec2_length(dp);
-		// Scale so that sounds more than a full screen from centre have
-		// maximum distance (255)
-		const float maxDistance = sqrtf(
-				screen * screen + halfScreen * halfScreen);
-		distance = (int) (d * 255 / maxDistance);
-
-		// Calculate bearing
-		const double bearing = atan((double) dp.x / halfScreen);
-		bearingDegrees = (Sint16) (bearing * 180 / MPI);
-		if (bearingDegrees < 0) {
-			bearingDegrees += 360;
-		}
-	}
-	if (isMuffled) {
-		distance += OUT_OF_SIGHT_DISTANCE_PLUS;
-	}
-	// Don't play anything if it's too distant
-	// This means we don't waste sound channels
-	if (distance > 255) {
+	if (!SoundChunkLoad(device, reinterpret_cast<SoundChunk*>(data))) {
 		return;
 	}
 
-	LOG(LM_SOUND, LL_TRACE, "distance(%d) bearing(%d)", distance,
-			bearingDegrees);
-
+	SDL_LockMutex(device->voiceLock);
 	// Get sound channel to play sound
-	const int channel = GetChannel(device, data);
-	if (channel < 0) {
-		return;
+	const int channel = GetChannel(device, data, pos, h->distance);
+	if (channel >= 0) {
+		SoundVoice *v = &device->voices[channel];
+		v->chunk = data;
+		v->pos = pos;
+		v->distance = h->distance;
+		v->started = device->tick;
+		v->mix.samples = reinterpret_cast<const int16_t*>(data->abuf);
+		v->mix.frames = (int) data->alen / 4;
+		v->mix.played = 0;
+		for (int i = 0; i < 2; i++) {
+			v->mix.gains[i] = (int16_t) (h->gains[i] * device->volume
+					* SOUND_MIX_GAIN_ONE / MIX_MAX_VOLUME);
+		}
+		v->mix.isMuffled = h->isMuffled;
 	}
-
-	SetSoundEffect(channel, bearingDegrees, (Uint8) distance, isMuffled);
+	SDL_UnlockMutex(device->voiceLock);
+}
+// Whether voice a should be stolen before voice b
+static bool IsVoiceWeaker(const SoundVoice *a, const SoundVoice *b) {
+	if (a->distance != b->distance) {
+		return a->distance > b->distance;
+	}
+	return a->started < b->started;
 }
-static int GetChannel(SoundDevice *s, Mix_Chunk *data) {
-	for (;;) {
-		const int channel = Mix_PlayChannel(-1, data, 0);
-		if (channel >= 0 || s->channels > 128) {
-			return channel;
+// Pick a channel from the fixed pool: a free one if there is one, otherwise
+// steal the quietest voice if it is quieter than the new sound.
+// Returns -1 if the sound should not play.
+static int GetChannel(SoundDevice *s, Mix_Chunk *data,
+		const struct vec2 pos, const int distance) {
+	int freeChannel = -1;
+	int quietest = -1;
+	int quietestSame = -1;
+	int sameCount = 0;
+	for (int i = 0; i < s->channels; i++) {
+		const SoundVoice *v = &s->voices[i];
+		if (!SoundMixVoiceIsPlaying(&v->mix)) {
+			if (freeChannel < 0) {
+				freeChannel = i;
+			}
+			continue;
 		}
-		// Check if we cannot play the sound; allocate more channels
-		s->channels *= 2;
-		if (Mix_AllocateChannels(s->channels) != s->channels) {
-			LOG(LM_SOUND, LL_ERROR, "Cannot allocate channels");
-			return -1;
+		if (v->chunk == data) {
+			// Merge with the same sound started nearby this tick, e.g. a
+			// shotgun spread hitting one wall
+			if (v->started == s->tick
+					&& svec2_distance_squared(v->pos, pos)
+							<= SOUND_MERGE_DISTANCE * SOUND_MERGE_DISTANCE) {
+				return -1;
+			}
+			sameCount++;
+			if (quietestSame < 0
+					|| IsVoiceWeaker(v, &s->voices[quietestSame])) {
+				quietestSame = i;
+			}
+		}
+		if (quietest < 0 || IsVoiceWeaker(v, &s->voices[quietest])) {
+			quietest = i;
 		}
-		// When allocating new channels, need to reset their volume
-		Mix_Volume(-1, ConfigGetInt(&gConfig, "Sound.SoundVolume"));
 	}
-}
-static void SetSoundEffect(const int channel, const Sint16 bearingDegrees,
-		const Uint8 distance, const bool isMuffled) {
-#ifndef __EMSCRIPTEN__
-	Mix_SetPosition(channel, bearingDegrees, (Uint8) distance);
-	if (isMuffled) {
-		if (!Mix_RegisterEffect(channel, MuffleEffect, NULL, NULL)) {
-			fprintf(stderr, "Mix_RegisterEffect: %s\n", Mix_GetError());
+	int channel = freeChannel;
+	if (sameCount >= SOUND_MAX_VOICES_PER_SOUND) {
+		channel = quietestSame;
+	} else if (channel < 0) {
+		channel = quietest;
+	}
+	if (channel < 0) {
+		return -1;
+	}
+	if (SoundMixVoiceIsPlaying(&s->voices[channel].mix)) {
+		if (s->voices[channel].distance < distance) {
+			return -1;
 		}
+		LOG(LM_SOUND, LL_TRACE, "stealing channel %d", channel);
 	}
-#else
-	// Mix_SetPosition and Mix_RegisterEffect not supported by emscripten;
-	// use plain panning instead
-
-	// Calculate left/right channel as values from 0-180
-	int left;
-	if (bearingDegrees < 90) left = 90 - bearingDegrees;
-	else if (bearingDegrees < 270) left = bearingDegrees - 90;
-	else left = 450 - bearingDegrees;
-	const int right = 180 - left;
-	Mix_SetPanning(
-		channel,
-		(Uint8)(left * distance / 180), (Uint8)(right * distance / 180));
-#endif
+	return channel;
 }
 
 void SoundPlay(SoundDevice *device, Mix_Chunk *data) {
-	if (!device->isInitialised) {
-		return;
-	}
+	const Hearing h = { { 1, 1 }, 0, false };
+	PlayVoice(device, data, svec2_zero(), &h);
+}
 
-	SoundPlayAtPosition(device, data, svec2_zero(), false);
+void SoundTick(SoundDevice *device) {
+	device->tick++;
 }
 
 void SoundSetEar(const bool isLeft, const int idx, const struct vec2 pos) {
@@ -493,37 +660,125 @@ static bool IsPosNoSee(void *data, struct vec2i pos) {
 	const Tile *t = MapGetTile(static_cast<const Map*>(data), Vec2iToTile(pos));
 	return t != NULL && TileIsOpaque(t);
 }
+// How a listener at ear hears a sound at pos; side is -1 or 1 for the
+// left or right views in split screen, which are panned to that side.
+// Returns false if the sound is too far away to hear.
+static bool Hear(Hearing *h, const struct vec2 ear, const struct vec2 pos,
+		const int plusDistance, const int side) {
+	// Sound position is calculated from an imaginary camera that's half as
+	// distant from the centre of the screen as the screen width, i.e.
+	//
+	//         centre-+
+	//                v
+	// Screen: |------+------|
+	//                |
+	//                |
+	//     camera---> +
+	const float screen = (float) gGraphicsDevice.cachedConfig.Res.x;
+	const float halfScreen = screen / 2;
+	const struct vec2 dp = svec2_subtract(pos, ear);
+	const float dx = dp.x;
+	const float dy = fabsf(dp.y) + plusDistance;
+	// Scale so that sounds more than a full screen from centre have
+	// maximum distance (255)
+	const float maxDistance = sqrtf(screen * screen + halfScreen * halfScreen);
+	h->distance = (int) (sqrtf(dx * dx + dy * dy) * 255 / maxDistance);
+
+	HasClearLineData lineData;
+	lineData.IsBlocked = IsPosNoSee;
+	lineData.data = &gMap;
+	h->isMuffled = !HasClearLineJMRaytrace(svec2i_assign_vec2(pos),
+			svec2i_assign_vec2(ear), &lineData);
+	if (h->isMuffled) {
+		h->distance += OUT_OF_SIGHT_DISTANCE_PLUS;
+	}
+	// Don't play anything if it's too distant
+	// This means we don't waste sound channels
+	if (h->distance > 255) {
+		return false;
+	}
+
+	// Pan by the sine of the bearing from the camera
+	float pan = dx / sqrtf(dx * dx + halfScreen * halfScreen);
+	if (side != 0) {
+		pan = (pan + side) / 2;
+	}
+	const float gain = (float) (255 - h->distance) / 255;
+	h->gains[0] = gain * MIN(1.0f, 1 - pan);
+	h->gains[1] = gain * MIN(1.0f, 1 + pan);
+	return true;
+}
 void SoundPlayAtPlusDistance(SoundDevice *device, Mix_Chunk *data,
 		const struct vec2 pos, const int plusDistance) {
-	struct vec2 closestLeftEar, closestRightEar;
-
-	// Find closest set of ears to the sound
-	if (svec2_distance_squared(pos, device->earLeft1)
-			< svec2_distance_squared(pos, device->earLeft2)) {
-		closestLeftEar = device->earLeft1;
-	} else {
-		closestLeftEar = device->earLeft2;
+	if (!device->isInitialised || data == NULL) {
+		return;
 	}
-	if (svec2_distance_squared(pos, device->earRight1)
-			< svec2_distance_squared(pos, device->earRight2)) {
-		closestRightEar = device->earRight1;
-	} else {
-		closestRightEar = device->earRight2;
+	// Every view's ears hear the sound; in split screen, the left views are
+	// heard on the left speaker and the right views on the right
+	const struct vec2 ears[4] = {
+		device->earLeft1, device->earLeft2, device->earRight1, device->earRight2
+	};
+	const bool isSplit = !svec2_is_equal(ears[0], ears[2])
+			|| !svec2_is_equal(ears[1], ears[3]);
+	Hearing h;
+	memset(&h, 0, sizeof h);
+	h.distance = -1;
+	for (int i = 0; i < 4; i++) {
+		const int side = isSplit ? (i < 2 ? -1 : 1) : 0;
+		bool isDuplicate = false;
+		for (int j = 0; j < i; j++) {
+			const int sideJ = isSplit ? (j < 2 ? -1 : 1) : 0;
+			if (side == sideJ && svec2_is_equal(ears[i], ears[j])) {
+				isDuplicate = true;
+				break;
+			}
+		}
+		Hearing hi;
+		if (isDuplicate || !Hear(&hi, ears[i], pos, plusDistance, side)) {
+			continue;
+		}
+		// Loudest of all the listeners in each speaker
+		h.gains[0] = MAX(h.gains[0], hi.gains[0]);
+		h.gains[1] = MAX(h.gains[1], hi.gains[1]);
+		if (h.distance < 0 || hi.distance < h.distance) {
+			h.distance = hi.distance;
+			h.isMuffled = hi.isMuffled;
+		}
+	}
+	if (h.distance < 0) {
+		return;
 	}
+	PlayVoice(device, data, pos, &h);
+}
 
-	const struct vec2 origin = CalcClosestPointOnLineSegmentToPoint(
-			closestLeftEar, closestRightEar, pos);
-	HasClearLineData lineData;
-	lineData.IsBlocked = IsPosNoSee;
-	lineData.data = &gMap;
-	bool isMuffled = false;
-	if (!HasClearLineJMRaytrace(svec2i_assign_vec2(pos),
-			svec2i_assign_vec2(origin), &lineData)) {
-		isMuffled = true;
+void SoundPreload(SoundDevice *device, Mix_Chunk *data) {
+	if (!device->isInitialised || data == NULL) {
+		return;
+	}
+	SoundChunkLoad(device, reinterpret_cast<SoundChunk*>(data));
+}
+static SoundData* GetSoundData(SoundDevice *device, const char *name);
+void SoundPreloadName(SoundDevice *device, const char *name) {
+	if (!device->isInitialised || name == NULL) {
+		return;
+	}
+	SoundData *sound = GetSoundData(device, name);
+	if (sound == NULL) {
+		return;
+	}
+	switch (sound->Type) {
+	case SOUND_NORMAL:
+		SoundChunkLoad(device, sound->u.normal);
+		break;
+	case SOUND_RANDOM:
+		CA_FOREACH(SoundChunk *, sc, sound->u.random.sounds)
+			SoundChunkLoad(device, *sc);
+		CA_FOREACH_END()
+		break;
+	default:
+		CASSERT(false, "Unknown sound data type");
+		break;
 	}
-	const struct vec2 dp = svec2_subtract(pos, origin);
-	SoundPlayAtPosition(&gSoundDevice, data,
-			svec2(dp.x, fabsf(dp.y) + plusDistance), isMuffled);
 }
 
 static Mix_Chunk* SoundDataGet(SoundData *s);
@@ -531,21 +786,23 @@ Mix_Chunk* StrSound(const char *s) {
 	if (s == NULL || strlen(s) == 0 || !gSoundDevice.isInitialised) {
 		return NULL;
 	}
+	SoundData *sound = GetSoundData(&gSoundDevice, s);
+	return sound != NULL ? SoundDataGet(sound) : NULL;
+}
+static SoundData* GetSoundData(SoundDevice *device, const char *name) {
 	SoundData *sound;
-	int error = hashmap_get(gSoundDevice.customSounds, s, (any_t*) &sound);
-	if (error == MAP_OK) {
-		return SoundDataGet(sound);
+	if (hashmap_get(device->customSounds, name, (any_t*) &sound) == MAP_OK) {
+		return sound;
 	}
-	error = hashmap_get(gSoundDevice.sounds, s, (any_t*) &sound);
-	if (error == MAP_OK) {
-		return SoundDataGet(sound);
+	if (hashmap_get(device->sounds, name, (any_t*) &sound) == MAP_OK) {
+		return sound;
 	}
 	return NULL;
 }
 static Mix_Chunk* SoundDataGet(SoundData *s) {
 	switch (s->Type) {
 	case SOUND_NORMAL:
-		return s->u.normal;
+		return &s->u.normal->chunk;
 	case SOUND_RANDOM:
 		if (s->u.random.sounds.size == 0) {
 			return NULL;
@@ -556,10 +813,10 @@ static Mix_Chunk* SoundDataGet(SoundData *s) {
 					&& idx == s->u.random.lastPlayed) {
 				idx = rand() % s->u.random.sounds.size;
 			}
-			Mix_Chunk **sound = static_cast<Mix_Chunk**>(CArrayGet(
+			SoundChunk **sound = static_cast<SoundChunk**>(CArrayGet(
 					&s->u.random.sounds, idx));
 			s->u.random.lastPlayed = idx;
-			return *sound;
+			return &(*sound)->chunk;
 		}
 	default:
 		CASSERT(false, "Unknown sound data type")
@@ -53,11 +53,13 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
+#include <SDL2/SDL_mutex.h>
 
 #include "c_array.h"
 #include "c_hashmap/hashmap.h"
 #include "defs.h"
 #include "mathc/mathc.h"
+#include "sound_mix.h"
 #include "sys_config.h"
 #include "utils.h"
 #include "vector.h"
@@ -66,17 +68,57 @@ typedef enum {
 	SOUND_NORMAL, SOUND_RANDOM
 } SoundType;
 
+// Upper bound on decoded sound memory; the least recently played sounds
+// are unloaded to stay under it
+#define SOUND_CACHE_MAX_BYTES (16 * 1024 * 1024)
+
+// Sounds are decoded from their file when first played or preloaded, unless
+// they were baked into the asset pack, in which case they point into it and
+// aren't counted against the cache, as the mapping is paged by the OS.
+// The Mix_Chunk * handed out points to the chunk member, so it stays valid
+// while its samples are unloaded and reloaded.
+typedef struct {
+	Mix_Chunk chunk;	// must be first
+	char *path;			// NULL if the file failed to load
+	int lastUsed;
+} SoundChunk;
+
 typedef struct {
 	SoundType Type;
 	union {
-		Mix_Chunk *normal;
+		SoundChunk *normal;
 		struct {
-			CArray sounds;	// of Mix_Chunk *
+			CArray sounds;	// of SoundChunk *
 			int lastPlayed;
 		} random;
 	} u;
 } SoundData;
 
+// Format the audio device is opened with, and sounds are decoded to
+#define SOUND_FREQUENCY 44100
+#define SOUND_FORMAT AUDIO_S16
+#define SOUND_OUTPUT_CHANNELS 2
+
+// Fixed pool of voices; voices are stolen when it is full
+#define SOUND_CHANNELS 64
+// Frames mixed at a time in the post-mix callback
+#define SOUND_MIX_FRAMES 1024
+// Most voices of the same sound playing at once
+#define SOUND_MAX_VOICES_PER_SOUND 4
+// Identical sounds started in the same tick and this close (in pixels)
+// to a playing one are merged into it
+#define SOUND_MERGE_DISTANCE 32
+
+// A sound effect being played by our mixer, with what it is for merging
+// and stealing voices
+typedef struct {
+	SoundMixVoice mix;
+	const Mix_Chunk *chunk;
+	struct vec2 pos;	// zero for sounds without a position
+	int distance;		// 0-255, muffled sounds count as further
+	Uint32 started;		// tick
+} SoundVoice;
+
 enum MusicType {
 	MUSIC_MENU, MUSIC_BRIEFING, MUSIC_GAME, MUSIC_COUNT
 };
@@ -85,9 +127,18 @@ typedef struct {
 	int isInitialised;
 	Mix_Music *music;
 	bool musicIsDynamic;
-	CArray musicTracks[MUSIC_COUNT];	// of Mix_Music *
+	CArray musicTracks[MUSIC_COUNT];	// of char *, paths loaded when played
 	char musicErrorMessage[128];
 	int channels;
+	// Sound effects are mixed in a post-mix callback on the audio thread;
+	// the voices are shared with it under the lock
+	SoundVoice voices[SOUND_CHANNELS];
+	SoundMixer mixer;
+	SDL_mutex *voiceLock;
+	int volume;
+	// Game loop updates so far; sounds are merged by this rather than by
+	// time so that fast-forward and slow frames don't change merging
+	Uint32 tick;
 
 	// Two sets of ears for 4-player split screen
 	struct vec2 earLeft1;
@@ -97,6 +148,9 @@ typedef struct {
 
 	map_t sounds;		// of SoundData
 	map_t customSounds;	// of SoundData
+	CArray loadedChunks;	// of SoundChunk *, decoded
+	size_t loadedBytes;
+	int chunkUseCount;
 } SoundDevice;
 
 extern SoundDevice gSoundDevice;
@@ -117,6 +171,7 @@ typedef struct {
 	char *Wall;
 } HitSounds;
 
+bool SoundIsFile(const char *path);
 void SoundInitialize(SoundDevice *device, const char *path);
 void SoundLoadDir(map_t sounds, const char *path, const char *prefix);
 void SoundReconfigure(SoundDevice *s);
@@ -124,6 +179,8 @@ void SoundReopen(SoundDevice *s);
 void SoundClear(map_t sounds);
 void SoundTerminate(SoundDevice *device, const bool waitForSoundsComplete);
 void SoundPlay(SoundDevice *device, Mix_Chunk *data);
+// Call once per game loop update
+void SoundTick(SoundDevice *device);
 void SoundSetEarsSide(const bool isLeft, const struct vec2 pos);
 void SoundSetEar(const bool isLeft, const int idx, const struct vec2 pos);
 void SoundSetEars(const struct vec2 pos);
@@ -134,5 +191,9 @@ void SoundPlayAt(SoundDevice *device, Mix_Chunk *data, const struct vec2 pos);
 void SoundPlayAtPlusDistance(SoundDevice *device, Mix_Chunk *data,
 		const struct vec2 pos, const int plusDistance);
 
+// Decode sounds ahead of playing them, e.g. while loading a mission
+void SoundPreload(SoundDevice *device, Mix_Chunk *data);
+void SoundPreloadName(SoundDevice *device, const char *name);
+
 Mix_Chunk* StrSound(const char *s);
 #endif
@@ -25,6 +25,7 @@
  */
 #include "texture.h"
 
+#include "draw/sprite_batch.h"
 #include "log.h"
 
 SDL_Texture* TextureCreate(SDL_Renderer *renderer,
@@ -55,6 +56,8 @@ SDL_Texture* TextureCreate(SDL_Renderer *renderer,
 void TextureRender(SDL_Texture *t, SDL_Renderer *r, const Rect2i src,
 		const Rect2i dest, const color_t mask, const double angle,
 		const SDL_RendererFlip flip) {
+	// Keep draw order with any batched sprites queued before this
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetTextureColorMod(t, mask.r, mask.g, mask.b) != 0) {
 		LOG(LM_MAIN, LL_ERROR, "Failed to set texture mask: %s",
 				SDL_GetError());
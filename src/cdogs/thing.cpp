@@ -44,6 +44,7 @@
 #define DRAW_SHAKE_MAX 2.0f
 #define DRAW_SHAKE_FACTOR 0.3f
 #define DRAW_SHAKE_DECAY 0.8f
+#define DRAW_CORRECTION_DECAY 0.85f
 #define ZERO_DRAW_SHAKE svec2(\
 	RAND_FLOAT(-DRAW_SHAKE_MAX, DRAW_SHAKE_MAX) * 0.7f,\
 	RAND_FLOAT(-DRAW_SHAKE_MAX, DRAW_SHAKE_MAX) * 0.7f)
@@ -75,6 +76,14 @@ void ThingUpdate(Thing *t, const int ticks) {
 			break;
 		}
 	}
+	for (int i = 0; i < ticks; i++) {
+		t->drawCorrection = svec2_scale(t->drawCorrection,
+				DRAW_CORRECTION_DECAY);
+		if (svec2_length_squared(t->drawCorrection) < 0.0625f) {
+			t->drawCorrection = svec2_zero();
+			break;
+		}
+	}
 	CPicUpdate(&t->CPic, ticks);
 }
 
@@ -73,6 +73,8 @@ typedef struct {
 	struct CPic CPic;
 	DrawCPicFunc CPicFunc;
 	struct vec2 drawShake;
+	// Offset from Pos to draw at, to smooth over network corrections
+	struct vec2 drawCorrection;
 	struct vec2i ShadowSize;
 	int SoundLock;
 } Thing;
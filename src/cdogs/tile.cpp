@@ -48,55 +48,206 @@
  */
 #include "tile.h"
 
-#include "triggers.h"
-#include "thing.h"
+// Things and triggers of a tile. Most tiles have neither, so these are kept
+// in a side table instead of in every tile, and only for tiles that need
+// them.
+typedef struct {
+	CArray things;		// of ThingId
+	CArray triggers;	// of Trigger *
+} TileLists;
+// Entries are allocated in chunks so they never move; callers may hold on
+// to the arrays while things are added to other tiles.
+#define TILE_LISTS_CHUNK 256
+static CArray sListChunks;	// of TileLists *
+static CArray sListsFree;	// of uint32_t
+static const CArray sListsEmpty = { NULL, 0, 0, 0 };
+
+static TileLists* GetLists(const uint32_t idx) {
+	// Indices start from 1 so that 0 means none
+	TileLists *chunk = *static_cast<TileLists**>(CArrayGet(&sListChunks,
+			(idx - 1) / TILE_LISTS_CHUNK));
+	return &chunk[(idx - 1) % TILE_LISTS_CHUNK];
+}
+static TileLists* AllocLists(Tile *t) {
+	if (t->lists != 0) {
+		return GetLists(t->lists);
+	}
+	if (sListChunks.elemSize == 0) {
+		CArrayInit(&sListChunks, sizeof(TileLists*));
+		CArrayInit(&sListsFree, sizeof(uint32_t));
+	}
+	if (sListsFree.size == 0) {
+		// Add a chunk's worth of free entries
+		TileLists *chunk;
+		CMALLOC(chunk, TILE_LISTS_CHUNK * sizeof *chunk);
+		for (int i = 0; i < TILE_LISTS_CHUNK; i++) {
+			CArrayInit(&chunk[i].things, sizeof(ThingId));
+			CArrayInit(&chunk[i].triggers, sizeof(Trigger*));
+		}
+		CArrayPushBack(&sListChunks, &chunk);
+		for (int i = TILE_LISTS_CHUNK - 1; i >= 0; i--) {
+			const uint32_t idx = (uint32_t) ((sListChunks.size - 1)
+					* TILE_LISTS_CHUNK + i + 1);
+			CArrayPushBack(&sListsFree, &idx);
+		}
+	}
+	t->lists = *static_cast<uint32_t*>(CArrayGet(&sListsFree,
+			sListsFree.size - 1));
+	CArrayDelete(&sListsFree, sListsFree.size - 1);
+	return GetLists(t->lists);
+}
+// Return the tile's entry to the free list if it has nothing left;
+// the arrays keep their memory for the next tile that uses the entry
+static void ReleaseLists(Tile *t, const bool force) {
+	if (t->lists == 0) {
+		return;
+	}
+	TileLists *tl = GetLists(t->lists);
+	if (!force && (tl->things.size > 0 || tl->triggers.size > 0)) {
+		return;
+	}
+	CArrayClear(&tl->things);
+	CArrayClear(&tl->triggers);
+	CArrayPushBack(&sListsFree, &t->lists);
+	t->lists = 0;
+}
 
 Tile TileNone(void) {
 	Tile t;
 	TileInit(&t);
-	t.Class = &gTileNothing;
+	TileSetClass(&t, &gTileNothing);
 	return t;
 }
 void TileInit(Tile *t) {
 	memset(t, 0, sizeof *t);
-	CArrayInit(&t->triggers, sizeof(Trigger*));
-	CArrayInit(&t->things, sizeof(ThingId));
 }
 void TileDestroy(Tile *t) {
-	CArrayTerminate(&t->triggers);
-	CArrayTerminate(&t->things);
+	ReleaseLists(t, true);
+}
+
+const TileClass *TileGetClass(const Tile *t) {
+	return TileClassFromIndex(t->classIndex);
+}
+void TileSetClass(Tile *t, const TileClass *tc) {
+	t->classIndex = TileClassToIndex(tc);
+}
+const TileClass *TileGetClassAlt(const Tile *t) {
+	return TileClassFromIndex(t->classAltIndex);
+}
+void TileSetClassAlt(Tile *t, const TileClass *tc) {
+	t->classAltIndex = TileClassToIndex(tc);
+}
+
+const CArray *TileGetThings(const Tile *t) {
+	return t->lists != 0 ? &GetLists(t->lists)->things : &sListsEmpty;
+}
+const CArray *TileGetTriggers(const Tile *t) {
+	return t->lists != 0 ? &GetLists(t->lists)->triggers : &sListsEmpty;
+}
+void TileAddThing(Tile *t, const ThingId tid) {
+	CArrayPushBack(&AllocLists(t)->things, &tid);
+}
+bool TileRemoveThing(Tile *t, const ThingId tid) {
+	if (t->lists == 0) {
+		return false;
+	}
+	CArray *things = &GetLists(t->lists)->things;
+	CA_FOREACH(const ThingId, tt, *things)
+		if (tt->Id == tid.Id && tt->Kind == tid.Kind) {
+			CArrayDelete(things, _ca_index);
+			ReleaseLists(t, false);
+			return true;
+		}
+	CA_FOREACH_END()
+	return false;
+}
+void TileAddTrigger(Tile *t, Trigger *tr) {
+	CArrayPushBack(&AllocLists(t)->triggers, &tr);
+}
+void TileListsTerminate(void) {
+	CA_FOREACH(TileLists *, chunk, sListChunks)
+		for (int i = 0; i < TILE_LISTS_CHUNK; i++) {
+			CArrayTerminate(&(*chunk)[i].things);
+			CArrayTerminate(&(*chunk)[i].triggers);
+		}
+		CFREE(*chunk);
+	CA_FOREACH_END()
+	CArrayTerminate(&sListChunks);
+	CArrayTerminate(&sListsFree);
+}
+size_t TileListsMemSize(void) {
+	size_t size = sListChunks.size * sizeof(TileLists*)
+			+ sListsFree.capacity * sizeof(uint32_t);
+	CA_FOREACH(TileLists *, chunk, sListChunks)
+		for (int i = 0; i < TILE_LISTS_CHUNK; i++) {
+			const TileLists *tl = &(*chunk)[i];
+			size += sizeof *tl + tl->things.capacity * tl->things.elemSize
+					+ tl->triggers.capacity * tl->triggers.elemSize;
+		}
+	CA_FOREACH_END()
+	return size;
 }
 
-// t->ClassAlt->Name == NULL for nothing tiles
+// The door's class if it has one, otherwise the tile's class
+// (ClassAlt->Name == NULL for nothing tiles)
+static const TileClass *TileGetDoorOrClass(const Tile *t) {
+	const TileClass *tc = TileGetClass(t);
+	const TileClass *alt = TileGetClassAlt(t);
+	return (tc->Type == TILE_CLASS_DOOR && alt && alt->Name) ? alt : tc;
+}
 bool TileIsOpaque(const Tile *t) {
-	return (t->Class->Type == TILE_CLASS_DOOR && t->ClassAlt
-			&& t->ClassAlt->Name) ? t->ClassAlt->isOpaque : t->Class->isOpaque;
+	return TileGetDoorOrClass(t)->isOpaque;
 }
 
 bool TileIsShootable(const Tile *t) {
-	return (t->Class->Type == TILE_CLASS_DOOR && t->ClassAlt
-			&& t->ClassAlt->Name) ? t->ClassAlt->shootable : t->Class->shootable;
+	return TileGetDoorOrClass(t)->shootable;
 }
 
 bool TileCanWalk(const Tile *t) {
-	return (t->Class->Type == TILE_CLASS_DOOR && t->ClassAlt
-			&& t->ClassAlt->Name) ? t->ClassAlt->canWalk : t->Class->canWalk;
+	return TileGetDoorOrClass(t)->canWalk;
 }
 
 bool TileIsClear(const Tile *t) {
-	if (t->Class->Type != TILE_CLASS_FLOOR
-			&& t->Class->Type != TILE_CLASS_DOOR) {
+	const TileClass *tc = TileGetClass(t);
+	if (tc->Type != TILE_CLASS_FLOOR && tc->Type != TILE_CLASS_DOOR) {
 		return false;
 	}
 	// Check if tile has no things on it, excluding particles
-	CA_FOREACH(const ThingId, tid, t->things)
+	CA_FOREACH(const ThingId, tid, *TileGetThings(t))
 	if (tid->Kind != KIND_PARTICLE) return false;
 	CA_FOREACH_END()
 	return true;
 }
 
+const Pic *TileGetFloorPic(const Tile *t) {
+	const TileClass *tc = TileGetClass(t);
+	if (tc != NULL && tc->Pic != NULL && tc->Pic->Data != NULL
+			&& tc->Type != TILE_CLASS_WALL) {
+		return tc->Pic;
+	}
+	return NULL;
+}
+const Pic *TileGetWallPic(const Tile *t, struct vec2i *drawOffset) {
+	*drawOffset = svec2i(0, TILE_WALL_OFFSET_Y);
+	const TileClass *tc = TileGetClass(t);
+	const TileClass *alt = TileGetClassAlt(t);
+	if (tc->Type == TILE_CLASS_WALL) {
+		return tc->Pic;
+	} else if (tc->Type == TILE_CLASS_DOOR && alt && alt->Pic) {
+		// Doors may be offset; vertical doors are drawn centered
+		// horizontal doors are bottom aligned
+		const Pic *pic = alt->Pic;
+		drawOffset->x += (TILE_WIDTH - pic->size.x) / 2;
+		if (pic->size.y > 16) {
+			drawOffset->y += TILE_HEIGHT - (pic->size.y % TILE_HEIGHT);
+		}
+		return pic;
+	}
+	return NULL;
+}
+
 bool TileHasCharacter(Tile *t) {
-	CA_FOREACH(const ThingId, tid, t->things)
+	CA_FOREACH(const ThingId, tid, *TileGetThings(t))
 	if (tid->Kind == KIND_CHARACTER)
 	{
 		return true;
@@ -49,23 +49,51 @@
 #pragma once
 
 #include "c_array.h"
+#include "thing.h"
 #include "tile_class.h"
+#include "triggers.h"
 
+// Tiles are kept small so that whole rows of them fit in cache; the rarely
+// used things and triggers live in a side table, see TileGetThings
 typedef struct {
-	const TileClass *Class;
-	const TileClass *ClassAlt;
-	CArray triggers;	// of Trigger *
-	CArray things;		// of ThingId
+	uint16_t classIndex;	// see TileClassToIndex
+	uint16_t classAltIndex;
+	// Index into the side table, 0 if the tile has no things or triggers
+	uint32_t lists;
 	// flags for drawing
-	bool outOfSight;
-	bool isVisited;
+	bool outOfSight : 1;
+	bool isVisited : 1;
 } Tile;
 
 Tile TileNone(void);
 void TileInit(Tile *t);
 void TileDestroy(Tile *t);
+const TileClass *TileGetClass(const Tile *t);
+void TileSetClass(Tile *t, const TileClass *tc);
+// Alternate class, used for the door pic and whether it is open
+const TileClass *TileGetClassAlt(const Tile *t);
+void TileSetClassAlt(Tile *t, const TileClass *tc);
+
+// Things and triggers on the tile; never NULL
+const CArray *TileGetThings(const Tile *t);	// of ThingId
+const CArray *TileGetTriggers(const Tile *t);	// of Trigger *
+void TileAddThing(Tile *t, const ThingId tid);
+// Returns false if the thing was not on the tile
+bool TileRemoveThing(Tile *t, const ThingId tid);
+void TileAddTrigger(Tile *t, Trigger *tr);
+void TileListsTerminate(void);
+// Memory used by the things/triggers side table, for benchmarking
+size_t TileListsMemSize(void);
 bool TileIsOpaque(const Tile *t);
 bool TileIsShootable(const Tile *t);
 bool TileCanWalk(const Tile *t);
 bool TileIsClear(const Tile *t);
 bool TileHasCharacter(Tile *t);
+
+// Wall and door pics are drawn raised so that they cover the tile above
+#define TILE_WALL_OFFSET_Y (-12)
+// Pic for the floor layer, or NULL if there is none
+const Pic *TileGetFloorPic(const Tile *t);
+// Pic for the wall layer (walls and doors), or NULL if there is none.
+// drawOffset is where to draw it relative to the tile.
+const Pic *TileGetWallPic(const Tile *t, struct vec2i *drawOffset);
@@ -79,8 +79,10 @@ void TileClassesTerminate(TileClasses *c) {
 	hashmap_destroy(c->classes, TileClassDestroy);
 	hashmap_destroy(c->customClasses, TileClassDestroy);
 }
+static void TileClassIndexRelease(const TileClass *tc);
 void TileClassDestroy(any_t data) {
 	TileClass *tc = static_cast<TileClass*>(data);
+	TileClassIndexRelease(tc);
 	TileClassTerminate(tc);
 	CFREE(tc);
 }
@@ -255,3 +257,109 @@ const TileClass* TileClassesGetExit(TileClasses *c, PicManager *pm,
 	return TileClassesAdd(c, pm, &gTileExit, style, type, colorWhite,
 			colorWhite);
 }
+
+// Registered classes, by index; NULL if released
+static CArray sClassIndex;	// of const TileClass *
+// Released indices, reused before new ones
+static CArray sClassIndexFree;	// of uint16_t
+// Open addressing hash from class address to index; 0 is an empty slot.
+// Slots of released classes stay until the next rehash, so that probing
+// past them still works.
+static CArray sClassIndexHash;	// of uint16_t
+static bool sClassIndexHashStale = false;
+#define CLASS_INDEX_HASH_MIN 256
+
+static size_t ClassIndexHash(const TileClass *tc) {
+	return (size_t) (((uintptr_t) tc >> 4) * 2654435761u);
+}
+static uint16_t* ClassIndexFind(const TileClass *tc) {
+	const size_t mask = sClassIndexHash.size - 1;
+	uint16_t *slots = static_cast<uint16_t*>(sClassIndexHash.data);
+	for (size_t i = ClassIndexHash(tc) & mask;; i = (i + 1) & mask) {
+		if (slots[i] == 0 || TileClassFromIndex(slots[i]) == tc) {
+			return &slots[i];
+		}
+	}
+}
+static void ClassIndexRehash(const size_t size) {
+	CArrayResize(&sClassIndexHash, size, NULL);
+	CArrayFillZero(&sClassIndexHash);
+	for (size_t i = 1; i < sClassIndex.size; i++) {
+		const TileClass *tc = TileClassFromIndex((uint16_t) i);
+		if (tc != NULL) {
+			*ClassIndexFind(tc) = (uint16_t) i;
+		}
+	}
+	sClassIndexHashStale = false;
+}
+uint16_t TileClassToIndex(const TileClass *tc) {
+	if (tc == NULL) {
+		return 0;
+	}
+	if (sClassIndex.elemSize == 0) {
+		CArrayInit(&sClassIndex, sizeof(const TileClass*));
+		const TileClass *none = NULL;
+		CArrayPushBack(&sClassIndex, &none);
+		CArrayInit(&sClassIndexFree, sizeof(uint16_t));
+		CArrayInit(&sClassIndexHash, sizeof(uint16_t));
+		ClassIndexRehash(CLASS_INDEX_HASH_MIN);
+		// So that there is always something to fall back on
+		TileClassToIndex(&gTileNothing);
+	}
+	if (sClassIndexHashStale) {
+		ClassIndexRehash(sClassIndexHash.size);
+	}
+	uint16_t *slot = ClassIndexFind(tc);
+	if (*slot != 0) {
+		return *slot;
+	}
+	uint16_t idx;
+	if (sClassIndexFree.size > 0) {
+		idx = *(const uint16_t*) CArrayGet(&sClassIndexFree,
+				sClassIndexFree.size - 1);
+		CArrayDelete(&sClassIndexFree, sClassIndexFree.size - 1);
+		CArraySet(&sClassIndex, idx, &tc);
+	} else if (sClassIndex.size > UINT16_MAX) {
+		LOG(LM_MAP, LL_ERROR, "too many tile classes; ignoring %s", tc->Name);
+		return TileClassToIndex(&gTileNothing);
+	} else {
+		idx = (uint16_t) sClassIndex.size;
+		CArrayPushBack(&sClassIndex, &tc);
+	}
+	*slot = idx;
+	// Keep the hash at most half full
+	if (sClassIndex.size * 2 > sClassIndexHash.size) {
+		ClassIndexRehash(sClassIndexHash.size * 2);
+	}
+	return idx;
+}
+// Called when a class is freed, so that its index can be reused and the
+// registry doesn't keep growing with every campaign and style change.
+// Tiles must not use the class any more.
+static void TileClassIndexRelease(const TileClass *tc) {
+	if (sClassIndex.elemSize == 0) {
+		return;
+	}
+	// Released slots don't stop the probe, so the hash can be stale here
+	const uint16_t idx = *ClassIndexFind(tc);
+	if (idx == 0) {
+		return;
+	}
+	const TileClass *none = NULL;
+	CArraySet(&sClassIndex, idx, &none);
+	CArrayPushBack(&sClassIndexFree, &idx);
+	// Rebuild the hash before it is next used, to drop the released slot
+	sClassIndexHashStale = true;
+}
+const TileClass* TileClassFromIndex(const uint16_t idx) {
+	if (idx == 0) {
+		return NULL;
+	}
+	return static_cast<const TileClass**>(sClassIndex.data)[idx];
+}
+void TileClassIndexTerminate(void) {
+	CArrayTerminate(&sClassIndex);
+	CArrayTerminate(&sClassIndexFree);
+	CArrayTerminate(&sClassIndexHash);
+	sClassIndexHashStale = false;
+}
@@ -108,3 +108,10 @@ void TileClassGetName(char *buf, const TileClass *base, const char *style,
 void TileClassGetBaseName(char *buf, const TileClass *tc);
 const TileClass* TileClassesGetExit(TileClasses *c, PicManager *pm,
 		const char *style, const bool isShadow);
+
+// Tiles refer to their classes by a 16-bit index, to keep them small.
+// Index 0 is NULL; classes get an index the first time they are used, and
+// give it up when destroyed with TileClassDestroy.
+uint16_t TileClassToIndex(const TileClass *tc);
+const TileClass* TileClassFromIndex(const uint16_t idx);
+void TileClassIndexTerminate(void);
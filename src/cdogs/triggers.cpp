@@ -58,20 +58,36 @@
 
 CArray gWatches;	// of TWatch
 static int watchIndex = 1;
+// Ticks that watches have been updated for; condition timers count from this
+static int sWatchTicks = 0;
+
+// Index of the tiles that watch conditions depend on, sorted by tile, so
+// that conditions are only re-evaluated when their tiles change.
+// Rebuilt on the next update after conditions are added.
+typedef struct {
+	int tile;	// y * map width + x
+	int watch;	// index in gWatches
+	int condition;	// index in the watch's conditions
+} WatchTile;
+static CArray sWatchTiles;	// of WatchTile
+static bool sWatchTilesDirty = true;
+
+// Action events, shared by identical actions
+static CArray sActionEvents;	// of GameEvent
+static CArray sActionEventHashes;	// of uint32_t
 
 // Number of frames to wait before repeating the "cannot activate" event
 #define CANNOT_ACTIVATE_LOCK 50
 
-Trigger* TriggerNew(void) {
-	Trigger *t;
-	CCALLOC(t, sizeof *t);
+Trigger* TriggerNew(MissionArena *arena) {
+	Trigger *t = static_cast<Trigger*>(MissionArenaAlloc(arena, sizeof *t));
 	t->isActive = 1;
 	CArrayInit(&t->actions, sizeof(Action));
 	return t;
 }
+// The trigger itself is released with its arena
 void TriggerTerminate(Trigger *t) {
 	CArrayTerminate(&t->actions);
-	CFREE(t);
 }
 Action* TriggerAddAction(Trigger *t) {
 	Action a;
@@ -80,6 +96,36 @@ Action* TriggerAddAction(Trigger *t) {
 	return static_cast<Action*>(CArrayGet(&t->actions, t->actions.size - 1));
 }
 
+static uint32_t HashEvent(const GameEvent *e) {
+	// FNV-1a
+	// Events are zeroed by GameEventNew so padding compares equal
+	uint32_t h = 2166136261u;
+	const uint8_t *p = reinterpret_cast<const uint8_t*>(e);
+	for (size_t i = 0; i < sizeof *e; i++) {
+		h = (h ^ p[i]) * 16777619u;
+	}
+	return h;
+}
+void ActionSetEvent(Action *a, const GameEvent *e) {
+	if (sActionEvents.elemSize == 0) {
+		CArrayInit(&sActionEvents, sizeof(GameEvent));
+		CArrayInit(&sActionEventHashes, sizeof(uint32_t));
+	}
+	a->Type = ACTION_EVENT;
+	const uint32_t hash = HashEvent(e);
+	CA_FOREACH(const uint32_t, h, sActionEventHashes)
+		if (*h == hash
+				&& memcmp(CArrayGet(&sActionEvents, _ca_index), e, sizeof *e)
+						== 0) {
+			a->a.EventIndex = _ca_index;
+			return;
+		}
+	CA_FOREACH_END()
+	a->a.EventIndex = (int) sActionEvents.size;
+	CArrayPushBack(&sActionEvents, e);
+	CArrayPushBack(&sActionEventHashes, &hash);
+}
+
 TWatch* WatchNew(void) {
 	TWatch t;
 	memset(&t, 0, sizeof(TWatch));
@@ -98,6 +144,8 @@ Condition* WatchAddCondition(TWatch *w, const ConditionType type,
 	c.CounterMax = counterMax;
 	c.Pos = pos;
 	CArrayPushBack(&w->conditions, &c);
+	w->unmetCount++;
+	sWatchTilesDirty = true;
 	return static_cast<Condition*>(CArrayGet(&w->conditions,
 			w->conditions.size - 1));
 }
@@ -117,7 +165,7 @@ static void ActivateWatch(int idx) {
 			for (int j = 0; j < (int) w->conditions.size; j++) {
 				Condition *c = static_cast<Condition*>(CArrayGet(&w->conditions,
 						j));
-				c->Counter = 0;
+				c->metSince = sWatchTicks;
 			}
 			return;
 		}CA_FOREACH_END()
@@ -135,6 +183,9 @@ static void DeactivateWatch(int idx) {
 
 void WatchesInit(void) {
 	CArrayInit(&gWatches, sizeof(TWatch));
+	CArrayInit(&sWatchTiles, sizeof(WatchTile));
+	sWatchTilesDirty = true;
+	sWatchTicks = 0;
 }
 void WatchesTerminate(void) {
 	CA_FOREACH(TWatch, w, gWatches)
@@ -142,6 +193,10 @@ void WatchesTerminate(void) {
 		CArrayTerminate(&w->actions);
 	CA_FOREACH_END()
 	CArrayTerminate(&gWatches);
+	CArrayTerminate(&sWatchTiles);
+	sWatchTilesDirty = true;
+	CArrayTerminate(&sActionEvents);
+	CArrayTerminate(&sActionEventHashes);
 }
 
 static void ActionRun(Action *a, CArray *mapTriggers) {
@@ -170,7 +225,9 @@ static void ActionRun(Action *a, CArray *mapTriggers) {
 		break;
 
 	case ACTION_EVENT:
-		GameEventsEnqueue(&gGameEvents, a->a.Event);
+		GameEventsEnqueue(&gGameEvents,
+				*static_cast<const GameEvent*>(CArrayGet(&sActionEvents,
+						a->a.EventIndex)));
 		break;
 
 	case ACTION_ACTIVATEWATCH:
@@ -187,25 +244,92 @@ static void ActionRun(Action *a, CArray *mapTriggers) {
 	}
 }
 
-static bool ConditionsMet(CArray *conditions, const int ticks) {
-	bool allConditionsMet = true;
-	for (int i = 0; i < (int) conditions->size; i++) {
-		Condition *c = static_cast<Condition*>(CArrayGet(conditions, i));
-		bool conditionMet = false;
-		switch (c->Type) {
-		case CONDITION_TILECLEAR:
-			conditionMet = TileIsClear(MapGetTile(&gMap, c->Pos));
-			break;
-		}
-		if (conditionMet) {
-			c->Counter += ticks;
-			allConditionsMet = allConditionsMet && c->Counter >= c->CounterMax;
+static bool ConditionEvaluate(const Condition *c) {
+	switch (c->Type) {
+	case CONDITION_TILECLEAR:
+		return TileIsClear(MapGetTile(&gMap, c->Pos));
+	}
+	return false;
+}
+static void ConditionUpdate(TWatch *w, Condition *c) {
+	const bool isMet = ConditionEvaluate(c);
+	if (isMet == c->isMet) {
+		return;
+	}
+	c->isMet = isMet;
+	if (isMet) {
+		c->metSince = sWatchTicks;
+		w->unmetCount--;
+	} else {
+		w->unmetCount++;
+	}
+}
+
+static int CompareWatchTile(const void *v1, const void *v2) {
+	const WatchTile *w1 = static_cast<const WatchTile*>(v1);
+	const WatchTile *w2 = static_cast<const WatchTile*>(v2);
+	return w1->tile - w2->tile;
+}
+static void WatchTilesBuild(void) {
+	CArrayClear(&sWatchTiles);
+	CA_FOREACH(TWatch, w, gWatches)
+		const int watch = _ca_index;
+		CA_FOREACH(Condition, c, w->conditions)
+			WatchTile wt;
+			wt.tile = c->Pos.y * gMap.Size.x + c->Pos.x;
+			wt.watch = watch;
+			wt.condition = _ca_index;
+			CArrayPushBack(&sWatchTiles, &wt);
+			// Evaluate from scratch; from now on only changes are seen
+			if (c->isMet) {
+				c->isMet = false;
+				w->unmetCount++;
+			}
+			ConditionUpdate(w, c);
+		CA_FOREACH_END()
+	CA_FOREACH_END()
+	qsort(sWatchTiles.data, sWatchTiles.size, sWatchTiles.elemSize,
+			CompareWatchTile);
+	sWatchTilesDirty = false;
+}
+void WatchesOnTileChanged(const struct vec2i pos) {
+	if (sWatchTilesDirty) {
+		// Everything will be evaluated when the index is built
+		return;
+	}
+	// Find the first entry for this tile
+	const int tile = pos.y * gMap.Size.x + pos.x;
+	int lo = 0;
+	int hi = (int) sWatchTiles.size;
+	while (lo < hi) {
+		const int mid = (lo + hi) / 2;
+		if (static_cast<const WatchTile*>(CArrayGet(&sWatchTiles, mid))->tile
+				< tile) {
+			lo = mid + 1;
 		} else {
-			c->Counter = 0;
-			allConditionsMet = false;
+			hi = mid;
 		}
 	}
-	return allConditionsMet;
+	for (int i = lo; i < (int) sWatchTiles.size; i++) {
+		const WatchTile *wt = static_cast<const WatchTile*>(CArrayGet(
+				&sWatchTiles, i));
+		if (wt->tile != tile) {
+			break;
+		}
+		TWatch *w = static_cast<TWatch*>(CArrayGet(&gWatches, wt->watch));
+		ConditionUpdate(w, static_cast<Condition*>(CArrayGet(&w->conditions,
+				wt->condition)));
+	}
+}
+
+// All conditions hold; check that they have for long enough
+static bool WatchIsDue(const TWatch *w) {
+	CA_FOREACH(const Condition, c, w->conditions)
+		if (sWatchTicks - c->metSince < c->CounterMax) {
+			return false;
+		}
+	CA_FOREACH_END()
+	return true;
 }
 
 bool TriggerTryActivate(Trigger *t, const int flags,
@@ -240,10 +364,14 @@ void TriggerActivate(Trigger *t, CArray *mapTriggers) {
 }
 
 void UpdateWatches(CArray *mapTriggers, const int ticks) {
+	if (sWatchTilesDirty) {
+		WatchTilesBuild();
+	}
+	sWatchTicks += ticks;
 	CA_FOREACH(TWatch, w, gWatches)
-		if (!w->active)
+		if (!w->active || w->unmetCount > 0)
 			continue;
-		if (ConditionsMet(&w->conditions, ticks)) {
+		if (WatchIsDue(w)) {
 			for (int j = 0; j < (int) w->actions.size; j++) {
 				ActionRun(static_cast<Action*>(CArrayGet(&w->actions, j)),
 						mapTriggers);
@@ -57,6 +57,7 @@
 
 #include "c_array.h"
 #include "game_events.h"
+#include "mission_arena.h"
 #include "pic.h"
 #include "proto/msg.pb.h"
 
@@ -78,7 +79,8 @@ typedef struct {
 		int index;
 	} u;
 	union {
-		GameEvent Event;
+		// Events are interned and shared, see ActionSetEvent
+		int EventIndex;
 		Mix_Chunk *Sound;
 	} a;
 } Action;
@@ -96,11 +98,13 @@ typedef enum {
 } ConditionType;
 typedef struct {
 	ConditionType Type;
-	// How many ticks has this condition been fulfilled
-	// Reset to 0 when condition failed
-	int Counter;
 	int CounterMax;
 	struct vec2i Pos;
+	// Whether the condition holds; updated when its tile changes
+	bool isMet;
+	// Watch tick since which the condition has held
+	// Reset when the watch is activated
+	int metSince;
 } Condition;
 
 typedef struct {
@@ -108,6 +112,8 @@ typedef struct {
 	CArray conditions;	// of Condition
 	CArray actions;		// of Action
 	bool active;
+	// How many conditions don't hold; the watch is only checked when 0
+	int unmetCount;
 } TWatch;
 
 bool TriggerTryActivate(Trigger *t, const int flags,
@@ -116,9 +122,10 @@ bool TriggerCannotActivate(const Trigger *t);
 void TriggerSetCannotActivate(Trigger *t);
 void TriggerActivate(Trigger *t, CArray *mapTriggers);
 void UpdateWatches(CArray *mapTriggers, const int ticks);
-Trigger* TriggerNew(void);
+Trigger* TriggerNew(MissionArena *arena);
 void TriggerTerminate(Trigger *t);
 Action* TriggerAddAction(Trigger *t);
+void ActionSetEvent(Action *a, const GameEvent *e);
 
 void WatchesInit(void);
 void WatchesTerminate(void);
@@ -127,3 +134,5 @@ TWatch* WatchNew(void);
 Condition* WatchAddCondition(TWatch *w, const ConditionType type,
 		const int counterMax, const struct vec2i pos);
 Action* WatchAddAction(TWatch *w);
+// Call when things move on or off a tile of gMap, or its class changes
+void WatchesOnTileChanged(const struct vec2i pos);
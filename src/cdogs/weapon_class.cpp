@@ -28,6 +28,7 @@
 #include "weapon_class.h"
 
 #include "ammo.h"
+#include "asset_pack.h"
 #include "game_events.h"
 #include "json_utils.h"
 #include "log.h"
@@ -463,40 +464,22 @@ void BulletAndWeaponInitialize(BulletClasses *b, WeaponClasses *wcs,
 		const char *bpath, const char *gpath) {
 	BulletInitialize(b);
 
-	FILE *bf = NULL;
-	FILE *gf = NULL;
 	json_t *broot = NULL;
 	json_t *groot = NULL;
-	enum json_error e;
 
 	// 2-pass bullet loading will free root for us
 	bool freeBRoot = true;
-	char buf[CDOGS_PATH_MAX];
-	GetDataFilePath(buf, bpath);
-	bf = fopen(buf, "r");
-	if (bf == NULL) {
-		LOG(LM_MAP, LL_ERROR, "Error: cannot load bullets file %s", buf);
-		goto bail;
-	}
-	e = json_stream_parse(bf, &broot);
-	if (e != JSON_OK) {
-		LOG(LM_MAP, LL_ERROR, "Error parsing bullets file %s [error %d]", buf,
-				(int )e);
+	broot = AssetPackReadJSON(&gAssetPack, bpath);
+	if (broot == NULL) {
+		LOG(LM_MAP, LL_ERROR, "Error: cannot load bullets file %s", bpath);
 		goto bail;
 	}
 	BulletLoadJSON(b, &b->Classes, broot);
 
 	WeaponClassesInitialize(wcs);
-	GetDataFilePath(buf, gpath);
-	gf = fopen(buf, "r");
-	if (gf == NULL) {
-		LOG(LM_MAP, LL_ERROR, "Error: cannot load guns file %s", buf);
-		goto bail;
-	}
-	e = json_stream_parse(gf, &groot);
-	if (e != JSON_OK) {
-		LOG(LM_MAP, LL_ERROR, "Error parsing guns file %s [error %d]", buf,
-				(int )e);
+	groot = AssetPackReadJSON(&gAssetPack, gpath);
+	if (groot == NULL) {
+		LOG(LM_MAP, LL_ERROR, "Error: cannot load guns file %s", gpath);
 		goto bail;
 	}
 	WeaponClassesLoadJSON(wcs, &wcs->Guns, groot);
@@ -504,12 +487,7 @@ void BulletAndWeaponInitialize(BulletClasses *b, WeaponClasses *wcs,
 	BulletLoadWeapons(b);
 	freeBRoot = false;
 
-	bail: if (bf) {
-		fclose(bf);
-	}
-	if (gf) {
-		fclose(gf);
-	}
+bail:
 	if (freeBRoot) {
 		json_free_value(&broot);
 	}
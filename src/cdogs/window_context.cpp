@@ -25,6 +25,7 @@
  */
 #include "window_context.h"
 
+#include "draw/sprite_batch.h"
 #include "log.h"
 #include "texture.h"
 
@@ -104,6 +105,7 @@ SDL_Texture* WindowContextCreateTexture(WindowContext *wc,
 }
 
 void WindowContextPreRender(WindowContext *wc) {
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderDrawColor(wc->renderer, 0, 0, 0, 255) != 0) {
 		LOG(LM_GFX, LL_ERROR, "Failed to set draw color: %s", SDL_GetError());
 	}
@@ -125,5 +127,6 @@ void WindowContextPostRender(WindowContext *wc) {
 			SDL_FLIP_NONE);
 	CA_FOREACH_END()
 
+	SpriteBatchFlush(&gSpriteBatch);
 	SDL_RenderPresent(wc->renderer);
 }
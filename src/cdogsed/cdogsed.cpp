@@ -54,6 +54,7 @@
 
 #include <cdogs/XGetopt.h>
 #include <cdogs/actors.h>
+#include <cdogs/asset_pack.h>
 #include <cdogs/automap.h>
 #include <cdogs/collision/collision.h>
 #include <cdogs/config_io.h>
@@ -63,6 +64,8 @@
 #include <cdogs/files.h>
 #include <cdogs/font_utils.h>
 #include <cdogs/log.h>
+#include <cdogs/map_archive.h>
+#include <cdogs/map_layout.h>
 #include <cdogs/player_template.h>
 
 #include <tinydir/tinydir.h>
@@ -219,6 +222,7 @@ static void Display(HandleInputResult result) {
 	}
 	BlitUpdateFromBuf(ec.g, ec.g->screen);
 	WindowContextPostRender(&ec.g->gameWindow);
+	PicManagerEndFrame(&gPicManager);
 }
 
 static void Setup(const bool changedMission);
@@ -322,6 +326,11 @@ static void AdjustXC(int yc, int *xc) {
 	}
 }
 
+static int GetSaveVersion(void) {
+	return ConfigGetBool(&gConfig, "Editor.CompactMaps") ?
+			MAP_VERSION_COMPACT_GRIDS : MAP_VERSION;
+}
+
 static void Autosave(void) {
 	if (fileChanged && sTicksElapsed > ticksAutosave) {
 		ticksAutosave = sTicksElapsed + AUTOSAVE_INTERVAL_SECONDS * 1000;
@@ -330,7 +339,7 @@ static void Autosave(void) {
 		char buf[CDOGS_PATH_MAX];
 		sprintf(buf, "%s~%d%s", dirname, sAutosaveIndex,
 				PathGetBasename(lastFile));
-		MapArchiveSave(buf, &gCampaign.Setting);
+		MapArchiveSave(buf, &gCampaign.Setting, GetSaveVersion());
 		sAutosaveIndex++;
 	}
 }
@@ -427,7 +436,7 @@ static void Save(void) {
 
 		BlitUpdateFromBuf(&gGraphicsDevice, gGraphicsDevice.screen);
 		WindowContextPostRender(&gGraphicsDevice.gameWindow);
-		MapArchiveSave(filename, &gCampaign.Setting);
+		MapArchiveSave(filename, &gCampaign.Setting, GetSaveVersion());
 		fileChanged = false;
 		strcpy(lastFile, filename);
 		sAutosaveIndex = 0;
@@ -1078,6 +1087,7 @@ int main(int argc, char *argv[]) {
 		exit(EXIT_FAILURE);
 	}
 	FontLoadFromJSON(&gFont, "graphics/font.png", "graphics/font.json");
+	AssetPackInit(&gAssetPack);
 	PicManagerLoad(&gPicManager);
 	CharSpriteClassesInit(&gCharSpriteClasses);
 
@@ -1093,6 +1103,7 @@ int main(int argc, char *argv[]) {
 	MapObjectsInit(&gMapObjects, "data/map_objects.json", &gAmmo,
 			&gWeaponClasses);
 	CollisionSystemInit(&gCollisionSystem);
+	MissionArenaInit(&gMissionArena, "mission");
 	CampaignInit(&gCampaign);
 	MissionInit(&lastMission);
 	MissionInit(&currentMission);
@@ -1128,6 +1139,7 @@ int main(int argc, char *argv[]) {
 
 	EditCampaign();
 
+	MapLayoutCacheTerminate();
 	MapTerminate(&gMap);
 	MapObjectsTerminate(&gMapObjects);
 	PickupClassesTerminate(&gPickupClasses);
@@ -1140,14 +1152,18 @@ int main(int argc, char *argv[]) {
 	MissionTerminate(&lastMission);
 	MissionTerminate(&currentMission);
 	CollisionSystemTerminate(&gCollisionSystem);
+	MissionArenaTerminate(&gMissionArena);
 
 	DrawBufferTerminate(&sDrawBuffer);
 	GraphicsTerminate(ec.g);
 	CharSpriteClassesTerminate(&gCharSpriteClasses);
 	TileClassesTerminate(&gTileClasses);
+	TileListsTerminate();
+	TileClassIndexTerminate();
 	PicManagerTerminate(&gPicManager);
 	FontTerminate(&gFont);
 	PlayerTemplatesTerminate(&gPlayerTemplates);
+	AssetPackClose(&gAssetPack);
 
 	UIObjectDestroy(sObjs);
 	CArrayTerminate(&sDrawObjs);
@@ -425,7 +425,7 @@ EditorResult EditorBrushStopPainting(EditorBrush *b, Mission *m) {
 				// we are moving to an overlapped position
 				CArray movedTiles;
 				int delta;
-				CArrayInit(&movedTiles, m->u.Static.Tiles.elemSize);
+				CArrayInit(&movedTiles, sizeof(int));
 				// Copy tiles to temp from selection, clearing them
 				// in the process
 				RECT_FOREACH(Rect2iNew(b->SelectionStart, b->SelectionSize))
@@ -31,6 +31,9 @@
 
 #include <cdogs/config.h>
 #include <cdogs/log.h>
+#include <cdogs/net_stats.h>
+#include <cdogs/profiler.h>
+#include <cdogs/replay.h>
 #include <cdogs/sys_config.h>
 #include <cdogs/utils.h>
 #include <cdogs/XGetopt.h>
@@ -74,7 +77,16 @@ void PrintHelp(void) {
 	printf("    --logfile=F      Log to file by filename\n\n");
 
 	printf("%s\n", "Other:\n"
-			"    --connect=host   (Experimental) connect to a game server\n");
+			"    --connect=host   (Experimental) connect to a game server\n"
+			"    --netstats=F,ms  Write network stats to file F every ms\n"
+			"                       milliseconds (default 1000); JSON if F\n"
+			"                       ends with .json, otherwise CSV\n"
+			"    --record=F       Record the next mission played to replay\n"
+			"                       file F\n"
+			"    --replay=F,fast  Play back replay file F; with fast, as\n"
+			"                       fast as possible without drawing\n"
+			"    --trace=F        Write profiler zones to F as a Chrome\n"
+			"                       trace (about://tracing or Perfetto)\n");
 }
 
 void ProcessCommandLine(char *buf, const int argc, char *argv[]) {
@@ -103,6 +115,10 @@ bool ParseArgs(const int argc, char *argv[], ENetAddress *connectAddr,
 					required_argument, NULL, 'x' }, { "config",
 					optional_argument, NULL, 'C' }, { "log", required_argument,
 					NULL, 1000 }, { "logfile", required_argument, NULL, 1001 },
+					{ "netstats", required_argument, NULL, 1002 },
+					{ "record", required_argument, NULL, 1003 },
+					{ "replay", required_argument, NULL, 1004 },
+					{ "trace", required_argument, NULL, 1005 },
 					{ "help", no_argument, NULL, 'h' }, { 0, 0, NULL, 0 } };
 	int opt = 0;
 	int idx = 0;
@@ -155,6 +171,34 @@ bool ParseArgs(const int argc, char *argv[], ENetAddress *connectAddr,
 		case 1001:
 			LogOpenFile(optarg);
 			break;
+		case 1002: {
+			// Optional dump interval is comma separated
+			int intervalMs = NET_STATS_DUMP_INTERVAL_MS;
+			char *comma = strchr(optarg, ',');
+			if (comma) {
+				*comma = '\0';
+				intervalMs = atoi(comma + 1);
+			}
+			NetStatsOpenDump(&gNetStats, optarg, intervalMs);
+		}
+			break;
+		case 1003:
+			ReplaySetRecord(&gReplay, optarg);
+			break;
+		case 1004: {
+			// Optional "fast" playback is comma separated
+			bool isFast = false;
+			char *comma = strchr(optarg, ',');
+			if (comma) {
+				*comma = '\0';
+				isFast = strcmp(comma + 1, "fast") == 0;
+			}
+			ReplaySetPlayback(&gReplay, optarg, isFast);
+		}
+			break;
+		case 1005:
+			ProfilerOpenTrace(&gProfiler, optarg);
+			break;
 		case 'x':
 			if (enet_address_set_host(connectAddr, optarg) != 0) {
 				printf("Error: unknown host %s\n", optarg);
@@ -53,42 +53,30 @@
 #include <cdogs/actor_placement.h>
 #include <cdogs/actors.h>
 #include <cdogs/ai.h>
-#include <cdogs/ai_coop.h>
 #include <cdogs/automap.h>
 #include <cdogs/camera.h>
 #include <cdogs/draw/drawtools.h>
 #include <cdogs/events.h>
+#include <cdogs/game_tick.h>
 #include <cdogs/grafx_bg.h>
 #include <cdogs/handle_game_events.h>
 #include <cdogs/log.h>
 #include <cdogs/los.h>
 #include <cdogs/map_build.h>
+#include <cdogs/map_layout.h>
 #include <cdogs/music.h>
 #include <cdogs/net_client.h>
+#include <cdogs/net_predict.h>
 #include <cdogs/net_server.h>
 #include <cdogs/objs.h>
 #include <cdogs/pickup.h>
+#include <cdogs/profiler.h>
+#include <cdogs/replay.h>
 
 #include "briefing_screens.h"
 #include "hiscores.h"
 #include "screens_end.h"
 
-static void PlayerSpecialCommands(TActor *actor, const int cmd) {
-	if ((cmd & CMD_BUTTON2) && CMD_HAS_DIRECTION(cmd)) {
-		if (ConfigGetEnum(&gConfig, "Game.SwitchMoveStyle")
-				== SWITCHMOVE_SLIDE) {
-			SlideActor(actor, cmd);
-		}
-	} else if ((actor->lastCmd & CMD_BUTTON2) && !(cmd & CMD_BUTTON2)
-			&& !actor->specialCmdDir && !actor->CanPickupSpecial
-			&& !(ConfigGetEnum(&gConfig, "Game.SwitchMoveStyle")
-					== SWITCHMOVE_SLIDE && CMD_HAS_DIRECTION(cmd))) {
-		const PlayerData *p = PlayerDataGetByUID(actor->PlayerUID);
-		const bool allGuns = p == NULL || !PlayerHasGrenadeButton(p);
-		ActorTrySwitchWeapon(actor, allGuns);
-	}
-}
-
 // TODO: reimplement in camera
 struct vec2i GetPlayerCenter(GraphicsDevice *device, const Camera *camera,
 		const PlayerData *pData, const int playerIdx) {
@@ -137,10 +125,7 @@ typedef struct {
 	bool isMap;
 	int cmds[MAX_LOCAL_PLAYERS];
 	int lastCmds[MAX_LOCAL_PLAYERS];
-	// Only update AI every 4 ticks
-	int aiUpdateCounter;
-	PowerupSpawner healthSpawner;
-	CArray ammoSpawners;	// of PowerupSpawner
+	GameTick tick;
 } RunGameData;
 static void RunGameTerminate(GameLoopData *data);
 static void RunGameOnEnter(GameLoopData *data);
@@ -160,6 +145,7 @@ GameLoopData* RunGame(const CampaignOptions *co, struct MissionOptions *m,
 	g->FPS = ConfigGetInt(&gConfig, "Game.FPS");
 	g->SuperhotMode = ConfigGetBool(&gConfig, "Game.Superhot(tm)Mode");
 	g->InputEverySecondFrame = true;
+	g->FastForward = ReplayIsPlaying(&gReplay) && gReplay.IsFast;
 	return g;
 }
 static void RunGameReset(RunGameData *rData) {
@@ -177,12 +163,28 @@ static void RunGameOnEnter(GameLoopData *data) {
 	RunGameData *rData = static_cast<RunGameData*>(data->Data);
 
 	RunGameReset(rData);
+	NetPredictReset();
+
+	ReplayStart(&gReplay, rData->co, rData->m);
 
+	PROFILE_BEGIN("map build");
 	MapBuild(rData->map, rData->m->missionData, rData->co);
+	PROFILE_END();
+	// Generate the next mission's layout while this one is being played
+	const int nextIndex = rData->co->MissionIndex + 1;
+	if (nextIndex < (int) rData->co->Setting.Missions.size) {
+		MapLayoutPrefetch(static_cast<const Mission*>(CArrayGet(
+				&rData->co->Setting.Missions, nextIndex)),
+				rData->co->Entry.Mode, CampaignGetMissionSeed(nextIndex));
+	}
 
-	// Seed random if PVP mode (otherwise players will always spawn in same
-	// position)
-	if (IsPVP(rData->co->Entry.Mode)) {
+	// Seed random from the replay in every mode, so that playback starts
+	// from the same state as the recording did rather than whatever the
+	// menus left behind. Otherwise seed it if PVP mode (otherwise players
+	// will always spawn in same position)
+	if (ReplayIsActive(&gReplay)) {
+		srand(gReplay.Seed);
+	} else if (IsPVP(rData->co->Entry.Mode)) {
 		srand((unsigned int) time(NULL));
 	}
 
@@ -227,13 +229,7 @@ static void RunGameOnEnter(GameLoopData *data) {
 				svec2i_scale_divide(rData->map->Size, 2));
 		rData->Camera.FollowNextPlayer = true;
 	}
-	HealthSpawnerInit(&rData->healthSpawner, rData->map);
-	CArrayInit(&rData->ammoSpawners, sizeof(PowerupSpawner));
-	for (int i = 0; i < AmmoGetNumClasses(&gAmmo); i++) {
-		PowerupSpawner ps;
-		AmmoSpawnerInit(&ps, rData->map, i);
-		CArrayPushBack(&rData->ammoSpawners, &ps);
-	}
+	GameTickInit(&rData->tick, rData->m, rData->map, &rData->Camera);
 
 	rData->m->state = MISSION_STATE_WAITING;
 	rData->m->isDone = false;
@@ -256,11 +252,7 @@ static void RunGameOnExit(GameLoopData *data) {
 	// Flush events
 	HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
 
-	PowerupSpawnerTerminate(&rData->healthSpawner);
-	CA_FOREACH(PowerupSpawner, a, rData->ammoSpawners)
-		PowerupSpawnerTerminate(a);
-	CA_FOREACH_END()
-	CArrayTerminate(&rData->ammoSpawners);
+	GameTickTerminate(&rData->tick);
 	CameraTerminate(&rData->Camera);
 
 	// Draw background
@@ -285,6 +277,8 @@ static void RunGameOnExit(GameLoopData *data) {
 			const TActor *player = ActorGetByUID(p->ActorUID);
 			p->hp = player->health;
 		}CA_FOREACH_END()
+
+	ReplayStop(&gReplay);
 }
 static void RunGameInput(GameLoopData *data) {
 	RunGameData *rData = static_cast<RunGameData*>(data->Data);
@@ -295,6 +289,13 @@ static void RunGameInput(GameLoopData *data) {
 		GameEventsEnqueue(&gGameEvents, e);
 		return;
 	}
+	// Commands come from the replay instead; quit once it has run out
+	if (ReplayIsPlaying(&gReplay)) {
+		if (ReplayHasEnded(&gReplay)) {
+			gEventHandlers.HasQuit = true;
+		}
+		return;
+	}
 
 	int lastCmdAll = 0;
 	for (int i = 0; i < MAX_LOCAL_PLAYERS; i++) {
@@ -399,7 +400,6 @@ static void RunGameInput(GameLoopData *data) {
 	CameraInput(&rData->Camera, rData->cmds[0], rData->lastCmds[0]);
 }
 static void NextLoop(RunGameData *rData, LoopRunner *l);
-static void CheckMissionCompletion(const struct MissionOptions *mo);
 static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l) {
 	RunGameData *rData = static_cast<RunGameData*>(data->Data);
 
@@ -414,16 +414,6 @@ static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l) {
 		}
 	}
 
-	// Check if game can begin
-	if (!rData->m->HasBegun && MissionCanBegin()) {
-		GameEvent begin = GameEventNew(GAME_EVENT_GAME_BEGIN);
-		begin.u.GameBegin.MissionTime = gMission.time;
-		GameEventsEnqueue(&gGameEvents, begin);
-	}
-
-	// Set mission complete and display exit if it is complete
-	MissionSetMessageIfComplete(rData->m);
-
 	// If we're not hosting a net game,
 	// don't update if the game has paused or has automap shown
 	// Important: don't consider paused if we are trying to quit
@@ -440,116 +430,7 @@ static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l) {
 
 	// Update all the things in the game
 	const int ticksPerFrame = 1;
-
-	if (gPlayerDatas.size > 0) {
-		LOSReset(&gMap.LOS);
-		for (int i = 0, idx = 0; i < (int) gPlayerDatas.size; i++, idx++) {
-			const PlayerData *p = static_cast<const PlayerData*>(CArrayGet(
-					&gPlayerDatas, i));
-			if (p->ActorUID == -1)
-				continue;
-			TActor *player = ActorGetByUID(p->ActorUID);
-			if (player->dead > DEATH_MAX)
-				continue;
-			// Calculate LOS for all players alive or dying
-			LOSCalcFrom(&gMap, Vec2ToTile(player->thing.Pos),
-					!gCampaign.IsClient);
-
-			if (player->dead)
-				continue;
-
-			// Only handle inputs/commands for local players
-			if (!p->IsLocal) {
-				idx--;
-				continue;
-			}
-			if (p->inputDevice == INPUT_DEVICE_AI) {
-				rData->cmds[idx] = AICoopGetCmd(player, ticksPerFrame);
-			}
-			PlayerSpecialCommands(player, rData->cmds[idx]);
-			CommandActor(player, rData->cmds[idx], ticksPerFrame);
-		}
-	}
-
-	if (!gCampaign.IsClient) {
-		rData->aiUpdateCounter -= ticksPerFrame;
-		if (rData->aiUpdateCounter <= 0) {
-			const int enemies = AICommand(ticksPerFrame);
-			AIAddRandomEnemies(enemies, rData->m->missionData);
-			rData->aiUpdateCounter = 4;
-		} else {
-			AICommandLast(ticksPerFrame);
-		}
-	}
-
-	// If split screen never and players are too close to the
-	// edge of the screen, forcefully pull them towards the center
-	if (ConfigGetEnum(&gConfig, "Interface.Splitscreen") == SPLITSCREEN_NEVER
-			&& GetNumPlayers(PLAYER_ALIVE_OR_DYING, true, true) > 1
-			&& !IsPVP(gCampaign.Entry.Mode)) {
-		const int w = gGraphicsDevice.cachedConfig.Res.x;
-		const int h = gGraphicsDevice.cachedConfig.Res.y;
-		const struct vec2i screen = svec2i_add(
-				svec2i_assign_vec2(PlayersGetMidpoint()),
-				svec2i(-w / 2, -h / 2));
-		CA_FOREACH(const PlayerData, pd, gPlayerDatas)
-			if (!pd->IsLocal || !IsPlayerAlive(pd)) {
-				continue;
-			}
-			const TActor *p = ActorGetByUID(pd->ActorUID);
-			const int pad = CAMERA_SPLIT_PADDING;
-			struct vec2 vel = svec2_zero();
-			if (screen.x + pad > p->thing.Pos.x && p->thing.Vel.x < 1) {
-				vel.x = screen.x + pad - p->thing.Pos.x;
-			} else if (screen.x + w - pad < p->thing.Pos.x
-					&& p->thing.Vel.x > -1) {
-				vel.x = screen.x + w - pad - p->thing.Pos.x;
-			}
-			if (screen.y + pad > p->thing.Pos.y && p->thing.Vel.y < 1) {
-				vel.y = screen.y + pad - p->thing.Pos.y;
-			} else if (screen.y + h - pad < p->thing.Pos.y
-					&& p->thing.Vel.y > -1) {
-				vel.y = screen.y + h - pad - p->thing.Pos.y;
-			}
-			if (!svec2_is_zero(vel)) {
-				GameEvent ei = GameEventNew(GAME_EVENT_ACTOR_IMPULSE);
-				ei.u.ActorImpulse.UID = p->uid;
-				ei.u.ActorImpulse.Vel = Vec2ToNet(svec2_scale(vel, 0.25f));
-				ei.u.ActorImpulse.Pos = Vec2ToNet(svec2_zero());
-				GameEventsEnqueue(&gGameEvents, ei);
-				LOG(LM_MAIN, LL_TRACE,
-						"playerUID(%d) pos(%f, %f) screen(%d, %d) impulse(%f, %f)",
-						p->uid, p->thing.Pos.x, p->thing.Pos.y, screen.x,
-						screen.y, ei.u.ActorImpulse.Vel.x,
-						ei.u.ActorImpulse.Vel.y);
-			}CA_FOREACH_END()
-	}
-
-	UpdateAllActors(ticksPerFrame);
-	UpdateObjects(ticksPerFrame);
-	UpdateMobileObjects(ticksPerFrame);
-	PickupsUpdate(&gPickups, ticksPerFrame);
-	ParticlesUpdate(&gParticles, ticksPerFrame);
-
-	UpdateWatches(&rData->map->triggers, ticksPerFrame);
-
-	PowerupSpawnerUpdate(&rData->healthSpawner, ticksPerFrame);
-	CA_FOREACH(PowerupSpawner, a, rData->ammoSpawners)
-		PowerupSpawnerUpdate(a, ticksPerFrame);
-	CA_FOREACH_END()
-
-	if (!gCampaign.IsClient) {
-		CheckMissionCompletion(rData->m);
-	} else if (!NetClientIsConnected(&gNetClient)) {
-		// Check if disconnected from server; end mission
-		const NMissionEnd me = NMissionEnd_init_zero;
-		MissionDone(&gMission, me);
-	}
-
-	HandleGameEvents(&gGameEvents, &rData->Camera, &rData->healthSpawner,
-			&rData->ammoSpawners);
-
-	rData->m->time += ticksPerFrame;
+	GameTickUpdate(&rData->tick, rData->cmds, ticksPerFrame);
 
 	if (gEventHandlers.HasResolutionChanged) {
 		RunGameReset(rData);
@@ -559,6 +440,13 @@ static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l) {
 	return UPDATE_RESULT_DRAW;
 }
 static void NextLoop(RunGameData *rData, LoopRunner *l) {
+	// Replays only cover one mission; quit once played back
+	if (ReplayIsPlaying(&gReplay)) {
+		gEventHandlers.HasQuit = true;
+		LoopRunnerPop(l);
+		return;
+	}
+
 	// Find the next screen to switch to
 	const bool hasLocalPlayers = GetNumPlayers(PLAYER_ANY, false, true) > 0;
 	const int survivingPlayers = GetNumPlayers(PLAYER_ALIVE, false, false);
@@ -586,53 +474,6 @@ static void NextLoop(RunGameData *rData, LoopRunner *l) {
 		LoopRunnerChange(l, HighScoresScreen(&gCampaign, &gGraphicsDevice));
 	}
 }
-static void CheckMissionCompletion(const struct MissionOptions *mo) {
-	// Check if we need to update explore objectives
-	CA_FOREACH(const Objective, o, mo->missionData->Objectives)
-		if (o->Type != OBJECTIVE_INVESTIGATE)
-			continue;
-		const int update = MapGetExploredPercentage(&gMap) - o->done;
-		if (update > 0 && !gCampaign.IsClient) {
-			GameEvent e = GameEventNew(GAME_EVENT_OBJECTIVE_UPDATE);
-			e.u.ObjectiveUpdate.ObjectiveId = _ca_index;
-			e.u.ObjectiveUpdate.Count = update;
-			GameEventsEnqueue(&gGameEvents, e);
-		}CA_FOREACH_END()
-
-	const bool isMissionComplete = GetNumPlayers(PLAYER_ALIVE_OR_DYING, false,
-			false) > 0 && IsMissionComplete(mo);
-	if (mo->state == MISSION_STATE_PLAY && isMissionComplete) {
-		GameEvent e = GameEventNew(GAME_EVENT_MISSION_PICKUP);
-		GameEventsEnqueue(&gGameEvents, e);
-	}
-	if (mo->state == MISSION_STATE_PICKUP && !isMissionComplete) {
-		GameEvent e = GameEventNew(GAME_EVENT_MISSION_INCOMPLETE);
-		GameEventsEnqueue(&gGameEvents, e);
-	}
-	if (mo->state == MISSION_STATE_PICKUP
-			&& mo->pickupTime + PICKUP_LIMIT <= mo->time) {
-		GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
-		GameEventsEnqueue(&gGameEvents, e);
-	}
-
-	// Check that all players have been destroyed
-	// If the server has no players at all, wait for a player to join
-	if (gPlayerDatas.size > 0) {
-		// Note: there's a period of time where players are dying
-		// Wait until after this period before ending the game
-		bool allPlayersDestroyed = true;
-		CA_FOREACH(const PlayerData, p, gPlayerDatas)
-			if (p->ActorUID != -1) {
-				allPlayersDestroyed = false;
-				break;
-			}CA_FOREACH_END()
-		if (allPlayersDestroyed && AreAllPlayersDeadAndNoLives()) {
-			GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
-			e.u.MissionEnd.Delay = GAME_OVER_DELAY;
-			GameEventsEnqueue(&gGameEvents, e);
-		}
-	}
-}
 static void RunGameDraw(GameLoopData *data) {
 	RunGameData *rData = static_cast<RunGameData*>(data->Data);
 
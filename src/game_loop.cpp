@@ -34,6 +34,9 @@
 #include "events.h"
 #include "net_client.h"
 #include "net_server.h"
+#include "net_stats.h"
+#include "pic_manager.h"
+#include "profiler.h"
 #include "sounds.h"
 
 #ifdef __EMSCRIPTEN__
@@ -177,28 +180,43 @@ typedef struct {
 static LoopRunParams LoopRunParamsNew(const GameLoopData *data);
 static bool LoopRunParamsShouldSleep(LoopRunParams *p);
 static bool LoopRunParamsShouldSkip(LoopRunParams *p);
+static bool RunFrame(LoopRunInnerData *ctx);
 bool LoopRunnerRunInner(LoopRunInnerData *ctx) {
 #ifndef __EMSCRIPTEN__
 	// Frame rate control
-	if (LoopRunParamsShouldSleep(&(ctx->p))) {
+	if (LoopRunParamsShouldSleep(&(ctx->p)) && !ctx->data->FastForward) {
 		SDL_Delay(1);
 		return true;
 	}
 #endif
 
+	PROFILE_BEGIN("frame");
+	const bool result = RunFrame(ctx);
+	PROFILE_END();
+	ProfilerFrameEnd(&gProfiler);
+	return result;
+}
+static bool RunFrame(LoopRunInnerData *ctx) {
 	// Input
 	if ((ctx->data->Frames & 1) || !ctx->data->InputEverySecondFrame) {
+		PROFILE_SCOPE("input");
 		EventPoll(&gEventHandlers, ctx->p.TicksNow, NULL);
 		if (ctx->data->InputFunc) {
 			ctx->data->InputFunc(ctx->data);
 		}
 	}
 
+	PROFILE_BEGIN("net poll");
 	NetClientPoll(&gNetClient);
 	NetServerPoll(&gNetServer);
+	NetStatsUpdate(&gNetStats, ctx->p.TicksNow);
+	PROFILE_END();
 
 	// Update
+	PROFILE_BEGIN("update");
 	ctx->p.Result = ctx->data->UpdateFunc(ctx->data, ctx->l);
+	SoundTick(&gSoundDevice);
+	PROFILE_END();
 	GameLoopData *newData = GetCurrentLoop(ctx->l);
 	if (newData == NULL) {
 		return false;
@@ -211,8 +229,10 @@ bool LoopRunnerRunInner(LoopRunInnerData *ctx) {
 		return true;
 	}
 
+	PROFILE_BEGIN("net flush");
 	NetServerFlush(&gNetServer);
 	NetClientFlush(&gNetClient);
+	PROFILE_END();
 
 	bool draw = !ctx->data->HasDrawnFirst;
 	switch (ctx->p.Result) {
@@ -228,6 +248,9 @@ bool LoopRunnerRunInner(LoopRunInnerData *ctx) {
 		break;
 	}
 	ctx->data->Frames++;
+	if (ctx->data->FastForward) {
+		return true;
+	}
 #ifndef __EMSCRIPTEN__
 	// frame skip
 	if (LoopRunParamsShouldSkip(&(ctx->p))) {
@@ -237,6 +260,7 @@ bool LoopRunnerRunInner(LoopRunInnerData *ctx) {
 
 	// Draw
 	if (draw) {
+		PROFILE_SCOPE("draw");
 		WindowContextPreRender(&gGraphicsDevice.gameWindow);
 		if (gGraphicsDevice.cachedConfig.SecondWindow) {
 			WindowContextPreRender(&gGraphicsDevice.secondWindow);
@@ -248,6 +272,7 @@ bool LoopRunnerRunInner(LoopRunInnerData *ctx) {
 		if (gGraphicsDevice.cachedConfig.SecondWindow) {
 			WindowContextPostRender(&gGraphicsDevice.secondWindow);
 		}
+		PicManagerEndFrame(&gPicManager);
 		ctx->data->HasDrawnFirst = true;
 	}
 
@@ -55,6 +55,8 @@ typedef struct sGameLoopData {
 	bool SuperhotMode;
 	bool InputEverySecondFrame;
 	bool SkipNextFrame;
+	// Update as fast as possible, without drawing
+	bool FastForward;
 	int Frames;		// total frames looped
 	bool HasDrawnFirst;
 	bool IsUsed;
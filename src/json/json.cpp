@@ -20,6 +20,7 @@
 
 #include "json.h"
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -40,9 +41,7 @@ enum LEX_VALUE {
 	LEX_NAME_SEPARATOR,
 	LEX_VALUE_SEPARATOR,
 	LEX_STRING,
-	LEX_NUMBER,
-	LEX_ERROR,
-	LEX_MEMORY
+	LEX_NUMBER
 };
 
 /* rc_string part */
@@ -155,47 +154,226 @@ size_t rcs_length(rcstring *rcs) {
 
 /* end of rc_string part */
 
-enum json_error json_stream_parse(FILE *file, json_t **document) {
-	char buffer[1024]; /* hard-coded value */
-	unsigned int error = JSON_INCOMPLETE_DOCUMENT;
+/* FNV-1a, never 0 so that 0 can mean unknown */
+static unsigned int json_label_hash(const char *text, size_t length) {
+	unsigned int hash = 2166136261u;
+	size_t i;
+	for (i = 0; i < length; i++) {
+		hash = (hash ^ (unsigned char) text[i]) * 16777619u;
+	}
+	return hash != 0 ? hash : 1;
+}
 
-	struct json_parsing_info state;
+/* Parsed documents own the text they were parsed from and all of their
+ * nodes: strings and numbers are terminated in place and point into the
+ * text, and nodes are carved out of blocks, so that parsing allocates a few
+ * times per document instead of twice per node. Nodes made with json_new_*
+ * can still be inserted into a document, and are freed with it. */
+#define JSON_FLAG_BORROWED 1 /* node and text belong to a document */
+#define JSON_FLAG_DOCUMENT 2 /* root node of a document */
+#define JSON_FLAG_INDEXED 4 /* labels are in the document's label index */
+
+#define JSON_BLOCK_MIN 16
+#define JSON_BLOCK_MAX 4096
+/* Smaller objects are quicker to scan than to look up */
+#define JSON_INDEX_MIN_CHILDREN 8
+
+struct json_block {
+	struct json_block *next;
+	size_t used;
+	size_t capacity;
+	json_t nodes[1];
+};
 
-	assert(file != NULL); /* must be an open stream */
-	assert(document != NULL); /* must be a valid pointer reference */
-	assert(*document == NULL); /* only accepts a null json_t pointer, to avoid memory leaks */
+struct json_index_entry {
+	const json_t *object;
+	json_t *label;
+	unsigned int hash;
+};
 
-	json_jpi_init(&state); /* initializes the json_parsing_info object */
+struct json_document {
+	json_t root; /* first, so that the root node is the document */
+	char *buffer;
+	struct json_block *first;
+	struct json_block *block; /* the block nodes are taken from */
+	struct json_index_entry *index;
+	size_t index_mask;
+	int foreign; /* whether nodes not from the blocks were inserted */
+};
 
-	while ((error == JSON_WAITING_FOR_EOF)
-			|| (error == JSON_INCOMPLETE_DOCUMENT)) {
-		if (fgets(buffer, 1024, file) != NULL) {
-			switch (error = json_parse_fragment(&state, buffer)) {
-			case JSON_OK:
-			case JSON_WAITING_FOR_EOF:
-			case JSON_INCOMPLETE_DOCUMENT:
-				break;
+static struct json_block *json_block_new(const size_t capacity) {
+	struct json_block *block = static_cast<json_block*>(malloc(
+			offsetof(struct json_block, nodes) + capacity * sizeof(json_t)));
+	if (block == NULL)
+		return NULL;
+	block->next = NULL;
+	block->used = 0;
+	block->capacity = capacity;
+	return block;
+}
 
-			default:
-				json_free_value(&state.cursor);
-				return static_cast<json_error>(error);
+/* nodes is how many nodes the document is expected to have */
+static struct json_document *json_document_new(char *buffer,
+		const size_t nodes) {
+	struct json_document *doc;
+	size_t capacity = nodes;
+	if (capacity < JSON_BLOCK_MIN)
+		capacity = JSON_BLOCK_MIN;
+	if (capacity > JSON_BLOCK_MAX)
+		capacity = JSON_BLOCK_MAX;
+
+	doc = static_cast<json_document*>(malloc(sizeof(struct json_document)));
+	if (doc == NULL)
+		return NULL;
+	memset(doc, 0, sizeof *doc);
+	doc->root.type = JSON_OBJECT;
+	doc->root.flags = JSON_FLAG_BORROWED | JSON_FLAG_DOCUMENT;
+	doc->first = json_block_new(capacity);
+	if (doc->first == NULL) {
+		free(doc);
+		return NULL;
+	}
+	doc->block = doc->first;
+	doc->buffer = buffer;
+	return doc;
+}
+
+static void json_document_free(struct json_document *doc) {
+	struct json_block *block = doc->first;
+	while (block != NULL) {
+		struct json_block *next = block->next;
+		free(block);
+		block = next;
+	}
+	free(doc->index);
+	free(doc->buffer);
+	free(doc);
+}
+
+/* The document a node belongs to, or NULL if it has been taken out of it */
+static struct json_document *json_document_of(const json_t *node) {
+	while (node->parent != NULL)
+		node = node->parent;
+	if (!(node->flags & JSON_FLAG_DOCUMENT))
+		return NULL;
+	return reinterpret_cast<struct json_document*>(const_cast<json_t*>(node));
+}
+
+static json_t *json_document_new_node(struct json_document *doc,
+		const enum json_value_type type) {
+	struct json_block *block = doc->block;
+	json_t *node;
+	if (block->used == block->capacity) {
+		/* blocks after the current one are left over from streaming */
+		if (block->next == NULL) {
+			size_t capacity = block->capacity * 2;
+			if (capacity > JSON_BLOCK_MAX)
+				capacity = JSON_BLOCK_MAX;
+			block->next = json_block_new(capacity);
+			if (block->next == NULL)
+				return NULL;
+		}
+		block = block->next;
+		block->used = 0;
+		doc->block = block;
+	}
+	node = &block->nodes[block->used++];
+	memset(node, 0, sizeof *node);
+	node->type = type;
+	node->flags = JSON_FLAG_BORROWED;
+	return node;
+}
+
+static size_t json_index_slot(const struct json_document *doc,
+		const json_t *object, const unsigned int hash) {
+	const size_t n = reinterpret_cast<uintptr_t>(object) / sizeof(json_t);
+	return (n * 2654435761u + hash) & doc->index_mask;
+}
+
+/* Flag the object for indexing if it is big enough; returns how many labels
+ * it adds to the index */
+static size_t json_index_flag(json_t *object) {
+	size_t count = 0;
+	const json_t *child;
+	if (object->type != JSON_OBJECT)
+		return 0;
+	for (child = object->child; child != NULL; child = child->next)
+		count++;
+	if (count < JSON_INDEX_MIN_CHILDREN)
+		return 0;
+	object->flags |= JSON_FLAG_INDEXED;
+	return count;
+}
+
+static void json_index_add(struct json_document *doc, const json_t *object) {
+	json_t *label;
+	if (!(object->flags & JSON_FLAG_INDEXED))
+		return;
+	for (label = object->child; label != NULL; label = label->next) {
+		size_t slot = json_index_slot(doc, object, label->label_hash);
+		struct json_index_entry *entry;
+		for (;;) {
+			entry = &doc->index[slot];
+			if (entry->object == NULL)
 				break;
-			}
-		} else {
-			if (error == JSON_WAITING_FOR_EOF)
-				error = JSON_OK;
-			else {
-				/*TODO refine this error code */
-				error = JSON_UNKNOWN_PROBLEM;
-			}
+			/* keep the first of repeated labels */
+			if (entry->object == object && entry->hash == label->label_hash
+					&& strcmp(entry->label->text, label->text) == 0)
+				break;
+			slot = (slot + 1) & doc->index_mask;
+		}
+		if (entry->object == NULL) {
+			entry->object = object;
+			entry->label = label;
+			entry->hash = label->label_hash;
 		}
 	}
+}
 
-	if (error == JSON_OK) {
-		*document = state.cursor;
+/* Index the labels of every big object in one table, so that
+ * json_find_first_label goes straight to them */
+static enum json_error json_document_index(struct json_document *doc) {
+	struct json_block *block;
+	size_t i;
+	size_t count = json_index_flag(&doc->root);
+	size_t capacity = 1;
+	for (block = doc->first; block != NULL;
+			block = block == doc->block ? NULL : block->next) {
+		for (i = 0; i < block->used; i++)
+			count += json_index_flag(&block->nodes[i]);
+	}
+	if (count == 0)
+		return JSON_OK;
+
+	while (capacity < count * 2)
+		capacity *= 2;
+	doc->index = static_cast<json_index_entry*>(calloc(capacity,
+			sizeof(struct json_index_entry)));
+	if (doc->index == NULL)
+		return JSON_MEMORY;
+	doc->index_mask = capacity - 1;
+	json_index_add(doc, &doc->root);
+	for (block = doc->first; block != NULL;
+			block = block == doc->block ? NULL : block->next) {
+		for (i = 0; i < block->used; i++)
+			json_index_add(doc, &block->nodes[i]);
 	}
+	return JSON_OK;
+}
 
-	return static_cast<json_error>(error);
+static json_t *json_index_find(const struct json_document *doc,
+		const json_t *object, const char *text_label,
+		const unsigned int hash) {
+	size_t slot = json_index_slot(doc, object, hash);
+	for (;;) {
+		const struct json_index_entry *entry = &doc->index[slot];
+		if (entry->object == NULL)
+			return NULL;
+		if (entry->object == object && entry->hash == hash
+				&& strcmp(entry->label->text, text_label) == 0)
+			return entry->label;
+		slot = (slot + 1) & doc->index_mask;
+	}
 }
 
 json_t*
@@ -213,6 +391,8 @@ json_new_value(const enum json_value_type type) {
 	new_object->child_end = NULL;
 	new_object->previous = NULL;
 	new_object->next = NULL;
+	new_object->label_hash = 0;
+	new_object->flags = 0;
 	new_object->type = type;
 	return new_object;
 }
@@ -244,6 +424,8 @@ json_new_string(const char *text) {
 	new_object->child_end = NULL;
 	new_object->previous = NULL;
 	new_object->next = NULL;
+	new_object->label_hash = 0;
+	new_object->flags = 0;
 	new_object->type = JSON_STRING;
 	return new_object;
 }
@@ -273,6 +455,8 @@ json_new_number(const char *text) {
 	new_object->child_end = NULL;
 	new_object->previous = NULL;
 	new_object->next = NULL;
+	new_object->label_hash = 0;
+	new_object->flags = 0;
 	new_object->type = JSON_NUMBER;
 	return new_object;
 }
@@ -327,6 +511,7 @@ static void intern_json_free_value(json_t **value) {
 
 	/*fixing parent node connections */
 	if ((*value)->parent) {
+		(*value)->parent->flags &= ~JSON_FLAG_INDEXED;
 		/* fix the tree connection to the first node in the children's list */
 		if ((*value)->parent->child == (*value)) {
 			if ((*value)->next) {
@@ -347,10 +532,14 @@ static void intern_json_free_value(json_t **value) {
 	}
 
 	/*finally, freeing the memory allocated for this value */
-	if ((*value)->text != NULL) {
-		free((*value)->text);
+	if ((*value)->flags & JSON_FLAG_DOCUMENT) {
+		json_document_free(reinterpret_cast<struct json_document*>(*value));
+	} else if (!((*value)->flags & JSON_FLAG_BORROWED)) {
+		if ((*value)->text != NULL) {
+			free((*value)->text);
+		}
+		free(*value); /* the json value */
 	}
-	free(*value); /* the json value */
 	(*value) = NULL;
 }
 
@@ -361,6 +550,14 @@ void json_free_value(json_t **value) {
 		return;
 	}
 
+	/* documents holding only their own nodes need not be walked */
+	if (((*value)->flags & JSON_FLAG_DOCUMENT)
+			&& !reinterpret_cast<struct json_document*>(*value)->foreign) {
+		(*value)->child = NULL;
+		intern_json_free_value(value);
+		return;
+	}
+
 	while (*value) {
 		json_t *parent;
 
@@ -439,6 +636,14 @@ enum json_error json_insert_child(json_t *parent, json_t *child) {
 		return JSON_BAD_TREE_STRUCTURE;
 	}
 
+	if ((parent->flags & JSON_FLAG_BORROWED)
+			&& !(child->flags & JSON_FLAG_BORROWED)) {
+		struct json_document *doc = json_document_of(parent);
+		if (doc != NULL)
+			doc->foreign = 1;
+	}
+	parent->flags &= ~JSON_FLAG_INDEXED;
+
 	child->parent = parent;
 	if (parent->child) {
 		child->previous = parent->child_end;
@@ -470,6 +675,7 @@ enum json_error json_insert_pair_into_object(json_t *parent,
 	label = json_new_string(text_label);
 	if (label == NULL)
 		return JSON_MEMORY;
+	label->label_hash = json_label_hash(text_label, strlen(text_label));
 
 	/*insert value and check for error */
 	error = json_insert_child(label, value);
@@ -1168,2585 +1374,688 @@ json_unescape(const char *text) {
 	return result;
 }
 
-void json_jpi_init(struct json_parsing_info *jpi) {
-	assert(jpi != NULL);
-	jpi->state = 0;
-	jpi->lex_state = 0;
-	jpi->lex_text = NULL;
-	jpi->p = NULL;
-	jpi->cursor = NULL;
-	jpi->line = 1;
-	jpi->string_length_limit_reached = 0;
-}
-
-int lexer(const char *buffer, const char **p, unsigned int *state,
-		rcstring **text, size_t *line) {
-	assert(buffer != NULL);
-	assert(p != NULL);
-	assert(state != NULL);
-	assert(text != NULL);
-	assert(line != NULL);
-	if (*p == NULL)
-		*p = buffer;
-
-	while (**p != '\0') {
-		switch (*state) {
-
-		case 0: /* Root document */
-		{
-			switch (*(*p)++) {
-			case '\x20': /* space */
-			case '\x09': /* horizontal tab */
-				break;
-
-			case '\x0A': /* line feed or new line */
-			case '\x0D': /* Carriage return */
-				*line += 1;	// increment line number
-				break;
-
-			case '{':
-				return LEX_BEGIN_OBJECT;
-			case '}':
-				return LEX_END_OBJECT;
-			case '[':
-				return LEX_BEGIN_ARRAY;
-			case ']':
-				return LEX_END_ARRAY;
-			case ':':
-				return LEX_NAME_SEPARATOR;
-			case ',':
-				return LEX_VALUE_SEPARATOR;
-
-			case '\"':
-				*text = rcs_create(RSTRING_DEFAULT);
-				if (*text == NULL)
-					return LEX_MEMORY;
-				*state = 1; /* inside a JSON string */
-				break;
-
-			case 't':
-				*state = 7; /* true: 1 */
-				break;
-
-			case 'f':
-				*state = 10; /* false: 1 */
-				break;
+/* The parser runs over a document's own text, terminating tokens in place.
+ * It walks back up through parent pointers rather than recursing, so that
+ * nesting is only limited by memory, and keeps the errors that the original
+ * fragment parser gave for each kind of malformed document. */
+enum json_parser_state {
+	JSON_STATE_START,
+	JSON_STATE_OBJECT_OPENED,
+	JSON_STATE_OBJECT_FIELD_DONE,
+	JSON_STATE_OBJECT_SEPARATED,
+	JSON_STATE_LABEL,
+	JSON_STATE_LABEL_SEPARATED,
+	JSON_STATE_ARRAY_VALUE,
+	JSON_STATE_ARRAY_VALUE_DONE,
+	JSON_STATE_DONE
+};
 
-			case 'n':
-				*state = 14; /* false: 1 */
-				break;
+struct json_parser {
+	struct json_document *doc;
+	char *p;
+	char held; /* token character overwritten to terminate a number */
+	char *text; /* text of the last string or number */
+	size_t length;
+	json_t *cursor;
+	const struct json_array_stream *stream;
+	unsigned int stream_hash;
+	json_t *stream_array;
+	/* where nodes are taken from when each streamed element starts */
+	struct json_block *stream_block;
+	size_t stream_used;
+};
 
-			case '-':
-				*text = rcs_create(RSTRING_DEFAULT);
-				if (*text == NULL)
-					return LEX_MEMORY;
-				if (rcs_catc(*text, '-') != RS_OK)
-					return LEX_MEMORY;
-				*state = 17; /* number: '0' */
-				break;
+static int json_is_digit(const char c) {
+	return c >= '0' && c <= '9';
+}
 
-			case '0':
-				*text = rcs_create(RSTRING_DEFAULT);
-				if (*text == NULL)
-					return LEX_MEMORY;
-				if (rcs_catc(*text, '0') != RS_OK)
-					return LEX_MEMORY;
-				*state = 18; /* number: '0' */
-				break;
+static int json_is_hex(const char c) {
+	return json_is_digit(c) || (c >= 'a' && c <= 'f')
+			|| (c >= 'A' && c <= 'F');
+}
 
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-				*text = rcs_create(RSTRING_DEFAULT);
-				if (*text == NULL)
-					return LEX_MEMORY;
-				if (rcs_catc(*text, *(*p - 1)) != RS_OK)
-					return LEX_MEMORY;
-				*state = 19; /* number: decimal followup */
-				break;
+static int json_lex_at_end(const struct json_parser *jp) {
+	return jp->held == '\0' && *jp->p == '\0';
+}
 
-			default:
-				return LEX_INVALID_CHARACTER;
+/* Strings keep their escape sequences, as consumers call json_unescape
+ * themselves; the closing quote becomes the terminator */
+static enum LEX_VALUE json_lex_string(struct json_parser *jp) {
+	char *start = jp->p;
+	int i;
+	for (;;) {
+		const unsigned char c = static_cast<unsigned char>(*jp->p);
+		if (c == '\"')
+			break;
+		if (c == '\0')
+			return LEX_MORE;
+		if (c < 0x20)
+			return LEX_INVALID_CHARACTER;
+		jp->p++;
+		if (c != '\\')
+			continue;
+		switch (*jp->p) {
+		case '\"':
+		case '\\':
+		case '/':
+		case 'b':
+		case 'f':
+		case 'n':
+		case 'r':
+		case 't':
+			jp->p++;
+			break;
+		case 'u':
+			jp->p++;
+			for (i = 0; i < 4; i++, jp->p++) {
+				if (*jp->p == '\0')
+					return LEX_MORE;
+				if (!json_is_hex(*jp->p))
+					return LEX_INVALID_CHARACTER;
 			}
-		}
 			break;
+		case '\0':
+			return LEX_MORE;
+		default:
+			return LEX_INVALID_CHARACTER;
+		}
+	}
+	jp->text = start;
+	jp->length = jp->p - start;
+	*jp->p++ = '\0';
+	return LEX_STRING;
+}
 
-		case 1: /* inside a JSON string */
-		{
-			assert(*text != NULL);
-			switch (**p) {
-			case 1:
-			case 2:
-			case 3:
-			case 4:
-			case 5:
-			case 6:
-			case 7:
-			case 8:
-			case 9:
-			case 10: /* line feed */
-			case 11:
-			case 12:
-			case 13: /* carriage return */
-			case 14:
-			case 15:
-			case 16:
-			case 17:
-			case 18:
-			case 19:
-			case 20:
-			case 21:
-			case 22:
-			case 23:
-			case 24:
-			case 25:
-			case 26:
-			case 27:
-			case 28:
-			case 29:
-			case 30:
-			case 31:
-				/* ASCII control characters can only be present in a JSON string if they are escaped. If not then the document is invalid */
-				return LEX_INVALID_CHARACTER;
-				break;
-
-			case '\"': /* close JSON string */
-				/* it is expected that, in the routine that calls this function, text is set to NULL */
-				*state = 0;
-				++*p;
-				return LEX_STRING;
-				break;
+/* Numbers must be followed by whitespace, which becomes the terminator, or
+ * by the end of their container or a separator, which is held back for the
+ * next token */
+static enum LEX_VALUE json_lex_number(struct json_parser *jp) {
+	char *start = jp->p - 1;
+	char *q = start;
+	if (*q == '-') {
+		q++;
+		if (!json_is_digit(*q))
+			return *q == '\0' ? LEX_MORE : LEX_INVALID_CHARACTER;
+	}
+	if (*q == '0') {
+		q++;
+	} else {
+		while (json_is_digit(*q))
+			q++;
+	}
+	if (*q == '.') {
+		q++;
+		if (!json_is_digit(*q))
+			return *q == '\0' ? LEX_MORE : LEX_INVALID_CHARACTER;
+		while (json_is_digit(*q))
+			q++;
+	}
+	if (*q == 'e' || *q == 'E') {
+		q++;
+		if (*q == '+' || *q == '-')
+			q++;
+		if (!json_is_digit(*q))
+			return *q == '\0' ? LEX_MORE : LEX_INVALID_CHARACTER;
+		while (json_is_digit(*q))
+			q++;
+	}
+	switch (*q) {
+	case '\x20':
+	case '\x09':
+	case '\x0A':
+	case '\x0D':
+		jp->p = q + 1;
+		break;
+	case ']':
+	case '}':
+	case ',':
+		jp->held = *q;
+		jp->p = q;
+		break;
+	case '\0':
+		return LEX_MORE;
+	default:
+		return LEX_INVALID_CHARACTER;
+	}
+	*q = '\0';
+	jp->text = start;
+	jp->length = q - start;
+	return LEX_NUMBER;
+}
 
-			case '\\':
-				if (rcs_catc(*text, '\\') != RS_OK)
-					return LEX_MEMORY;
-				*state = 2; /* inside a JSON string: start escape sequence */
-				break;
+static enum LEX_VALUE json_lex_literal(struct json_parser *jp,
+		const char *rest, const enum LEX_VALUE value) {
+	for (; *rest != '\0'; rest++, jp->p++) {
+		if (*jp->p == '\0')
+			return LEX_MORE;
+		if (*jp->p != *rest)
+			return LEX_INVALID_CHARACTER;
+	}
+	return value;
+}
 
-			default:
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-			}
-			++*p;
+static enum LEX_VALUE json_lex(struct json_parser *jp) {
+	for (;;) {
+		char c = *jp->p;
+		if (jp->held != '\0') {
+			c = jp->held;
+			jp->held = '\0';
 		}
+		if (c == '\0')
+			return LEX_MORE;
+		jp->p++;
+		switch (c) {
+		case '\x20':
+		case '\x09':
+		case '\x0A':
+		case '\x0D':
 			break;
+		case '{':
+			return LEX_BEGIN_OBJECT;
+		case '}':
+			return LEX_END_OBJECT;
+		case '[':
+			return LEX_BEGIN_ARRAY;
+		case ']':
+			return LEX_END_ARRAY;
+		case ':':
+			return LEX_NAME_SEPARATOR;
+		case ',':
+			return LEX_VALUE_SEPARATOR;
+		case '\"':
+			return json_lex_string(jp);
+		case 't':
+			return json_lex_literal(jp, "rue", LEX_TRUE);
+		case 'f':
+			return json_lex_literal(jp, "alse", LEX_FALSE);
+		case 'n':
+			return json_lex_literal(jp, "ull", LEX_NULL);
+		default:
+			if (c == '-' || json_is_digit(c))
+				return json_lex_number(jp);
+			return LEX_INVALID_CHARACTER;
+		}
+	}
+}
 
-		case 2: /* inside a JSON string: start escape sequence */
-		{
-			assert(*text != NULL);
-			switch (**p) {
-			case '\\':
-			case '\"':
-			case '/':
-			case 'b':
-			case 'f':
-			case 'n':
-			case 'r':
-			case 't':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 1; /* inside a JSON string */
-				break;
+/* Append without the checks of json_insert_child; the parser only makes
+ * well-formed trees */
+static void json_append(json_t *parent, json_t *child) {
+	child->parent = parent;
+	if (parent->child == NULL) {
+		parent->child = child;
+	} else {
+		parent->child_end->next = child;
+		child->previous = parent->child_end;
+	}
+	parent->child_end = child;
+}
 
-			case 'u':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 3; /* inside a JSON string: escape unicode */
-				break;
+/* Hand a finished element of the streamed array over, then drop it and
+ * reuse its nodes for the next one */
+static void json_parser_stream(struct json_parser *jp) {
+	json_t *element = jp->stream_array->child;
+	jp->stream->callback(element, jp->stream->data);
+	json_free_value(&element);
+	jp->doc->block = jp->stream_block;
+	jp->doc->block->used = jp->stream_used;
+}
 
-			default:
-				return LEX_INVALID_CHARACTER;
-			}
-			++*p;
-		}
-			break;
+/* The value just added to the cursor is complete */
+static enum json_parser_state json_parser_value_done(struct json_parser *jp) {
+	if (jp->cursor->type == JSON_STRING) {
+		jp->cursor = jp->cursor->parent;
+		return JSON_STATE_OBJECT_FIELD_DONE;
+	}
+	if (jp->cursor == jp->stream_array)
+		json_parser_stream(jp);
+	return JSON_STATE_ARRAY_VALUE_DONE;
+}
 
-		case 3: /*inside a JSON string: escape unicode */
-		{
-			assert(*text != NULL);
-			if ((**p >= 'a') && (**p <= 'f')) {
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 4; /* inside a JSON string: escape unicode */
-			} else if ((**p >= 'A') && (**p <= 'F')) {
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 4; /* inside a JSON string: escape unicode */
-			} else if ((**p >= '0') && (**p <= '9')) {
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 4; /* inside a JSON string: escape unicode */
-			} else
-				return LEX_INVALID_CHARACTER;
-			++*p;
-		}
-			break;
+static enum json_parser_state json_parser_close(struct json_parser *jp) {
+	if (jp->cursor->parent == NULL)
+		return JSON_STATE_DONE;
+	jp->cursor = jp->cursor->parent;
+	return json_parser_value_done(jp);
+}
 
-		case 4: /* inside a JSON string: escape unicode */
-		{
-			assert(*text != NULL);
-			if ((**p >= 'a') && (**p <= 'f')) {
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 5; /* inside a JSON string: escape unicode */
-			} else if ((**p >= 'A') && (**p <= 'F')) {
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 5; /* inside a JSON string: escape unicode */
-			} else if ((**p >= '0') && (**p <= '9')) {
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 5; /* inside a JSON string: escape unicode */
-			} else
-				return LEX_INVALID_CHARACTER;
-			++*p;
-		}
-			break;
+static int json_token_type(const enum LEX_VALUE token,
+		enum json_value_type *type) {
+	switch (token) {
+	case LEX_STRING:
+		*type = JSON_STRING;
+		return 1;
+	case LEX_NUMBER:
+		*type = JSON_NUMBER;
+		return 1;
+	case LEX_TRUE:
+		*type = JSON_TRUE;
+		return 1;
+	case LEX_FALSE:
+		*type = JSON_FALSE;
+		return 1;
+	case LEX_NULL:
+		*type = JSON_NULL;
+		return 1;
+	case LEX_BEGIN_OBJECT:
+		*type = JSON_OBJECT;
+		return 1;
+	case LEX_BEGIN_ARRAY:
+		*type = JSON_ARRAY;
+		return 1;
+	default:
+		return 0;
+	}
+}
 
-		case 5: /* inside a JSON string: escape unicode */
-		{
-			assert(*text != NULL);
-			if ((**p >= 'a') && (**p <= 'f')) {
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 6; /* inside a JSON string: escape unicode */
-			} else if ((**p >= 'A') && (**p <= 'F')) {
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 6; /* inside a JSON string: escape unicode */
-			} else if ((**p >= '0') && (**p <= '9')) {
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 6; /* inside a JSON string: escape unicode */
-			} else
-				return LEX_INVALID_CHARACTER;
-			++*p;
-		}
-			break;
+static int json_parser_is_stream(const struct json_parser *jp) {
+	const json_t *label = jp->cursor;
+	return jp->stream != NULL && label->type == JSON_STRING
+			&& label->parent == &jp->doc->root
+			&& label->label_hash == jp->stream_hash
+			&& strcmp(label->text, jp->stream->label) == 0;
+}
 
-		case 6: /* inside a JSON string: escape unicode */
-		{
-			assert(*text != NULL);
-			if ((**p >= 'a') && (**p <= 'f')) {
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 1; /* inside a JSON string: escape unicode */
-			} else if ((**p >= 'A') && (**p <= 'F')) {
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 1; /* inside a JSON string: escape unicode */
-			} else if ((**p >= '0') && (**p <= '9')) {
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				*state = 1; /* inside a JSON string: escape unicode */
-			} else
-				return LEX_INVALID_CHARACTER;
-			++*p;
-		}
-			break;
+static enum json_error json_parser_value(struct json_parser *jp,
+		const enum LEX_VALUE token, enum json_parser_state *state) {
+	enum json_value_type type;
+	json_t *value;
+	if (!json_token_type(token, &type))
+		return token == LEX_INVALID_CHARACTER ?
+				JSON_ILLEGAL_CHARACTER : JSON_MALFORMED_DOCUMENT;
+	value = json_document_new_node(jp->doc, type);
+	if (value == NULL)
+		return JSON_MEMORY;
+	if (type == JSON_STRING || type == JSON_NUMBER)
+		value->text = jp->text;
+	if (type == JSON_ARRAY && json_parser_is_stream(jp)) {
+		jp->stream_array = value;
+		jp->stream_block = jp->doc->block;
+		jp->stream_used = jp->doc->block->used;
+	}
+	json_append(jp->cursor, value);
+	switch (type) {
+	case JSON_OBJECT:
+		jp->cursor = value;
+		*state = JSON_STATE_OBJECT_OPENED;
+		break;
+	case JSON_ARRAY:
+		jp->cursor = value;
+		*state = JSON_STATE_ARRAY_VALUE;
+		break;
+	default:
+		*state = json_parser_value_done(jp);
+		break;
+	}
+	return JSON_OK;
+}
 
-		case 7: /* true: 1 */
-		{
-			switch (*(*p)++) {
-			case 'r':
-				*state = 8;
-				break;
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
-			break;
+static enum json_error json_parser_label(struct json_parser *jp) {
+	json_t *label = json_document_new_node(jp->doc, JSON_STRING);
+	if (label == NULL)
+		return JSON_MEMORY;
+	label->text = jp->text;
+	label->label_hash = json_label_hash(jp->text, jp->length);
+	json_append(jp->cursor, label);
+	jp->cursor = label;
+	return JSON_OK;
+}
 
-		case 8: /* true: 2 */
-		{
-			switch (*(*p)++) {
-			case 'u':
-				*state = 9;
-				break;
+static enum json_error json_parser_run(struct json_parser *jp) {
+	enum json_parser_state state = JSON_STATE_START;
+	enum json_error error;
+	while (!json_lex_at_end(jp)) {
+		const enum LEX_VALUE token = json_lex(jp);
+		if (token == LEX_MORE) {
+			/* only whitespace was left */
+			switch (state) {
+			case JSON_STATE_START:
+				return JSON_MALFORMED_DOCUMENT;
+			case JSON_STATE_DONE:
+				return JSON_OK;
 			default:
-				return LEX_INVALID_CHARACTER;
-				break;
+				return JSON_INCOMPLETE_DOCUMENT;
 			}
 		}
-			break;
-
-		case 9: /* true: 3 */
-		{
-			switch (*(*p)++) {
-			case 'e':
-				*state = 0;
-				return LEX_TRUE;
-				break;
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
+		switch (state) {
+		case JSON_STATE_START:
+			if (token != LEX_BEGIN_OBJECT)
+				return JSON_MALFORMED_DOCUMENT;
+			jp->cursor = &jp->doc->root;
+			state = JSON_STATE_OBJECT_OPENED;
+			break;
+
+		case JSON_STATE_OBJECT_OPENED:
+		case JSON_STATE_OBJECT_SEPARATED:
+			if (token == LEX_STRING) {
+				error = json_parser_label(jp);
+				if (error != JSON_OK)
+					return error;
+				state = JSON_STATE_LABEL;
+			} else if (token == LEX_END_OBJECT
+					&& state == JSON_STATE_OBJECT_OPENED) {
+				state = json_parser_close(jp);
+			} else if (token == LEX_INVALID_CHARACTER
+					&& state == JSON_STATE_OBJECT_SEPARATED) {
+				return JSON_ILLEGAL_CHARACTER;
+			} else {
+				return JSON_MALFORMED_DOCUMENT;
 			}
-		}
 			break;
 
-		case 10: /* false: 1 */
-		{
-			switch (*(*p)++) {
-			case 'a':
-				*state = 11;
-				break;
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
+		case JSON_STATE_OBJECT_FIELD_DONE:
+			if (token == LEX_VALUE_SEPARATOR)
+				state = JSON_STATE_OBJECT_SEPARATED;
+			else if (token == LEX_END_OBJECT)
+				state = json_parser_close(jp);
+			else
+				return JSON_MALFORMED_DOCUMENT;
 			break;
 
-		case 11: /* false: 2 */
-		{
-			switch (*(*p)++) {
-			case 'l':
-				*state = 12;
-				break;
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
+		case JSON_STATE_LABEL:
+			if (token != LEX_NAME_SEPARATOR)
+				return JSON_MALFORMED_DOCUMENT;
+			state = JSON_STATE_LABEL_SEPARATED;
 			break;
 
-		case 12: /* false: 3 */
-		{
-			switch (*(*p)++) {
-			case 's':
-				*state = 13;
-				break;
-			default:
-				return LEX_INVALID_CHARACTER;
+		case JSON_STATE_ARRAY_VALUE:
+			/* this also accepts a trailing comma */
+			if (token == LEX_END_ARRAY) {
+				state = json_parser_close(jp);
 				break;
 			}
-		}
+			/* fall through */
+		case JSON_STATE_LABEL_SEPARATED:
+			error = json_parser_value(jp, token, &state);
+			if (error != JSON_OK)
+				return error;
 			break;
 
-		case 13: /* false: 4 */
-		{
-			switch (*(*p)++) {
-			case 'e':
-				*state = 0;
-				return LEX_FALSE;
-				break;
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
+		case JSON_STATE_ARRAY_VALUE_DONE:
+			if (token == LEX_VALUE_SEPARATOR)
+				state = JSON_STATE_ARRAY_VALUE;
+			else if (token == LEX_END_ARRAY)
+				state = json_parser_close(jp);
+			else
+				return JSON_MALFORMED_DOCUMENT;
 			break;
 
-		case 14: /* null: 1 */
-		{
-			switch (*(*p)++) {
-			case 'u':
-				*state = 15;
-				break;
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
+		case JSON_STATE_DONE:
+			return JSON_MALFORMED_DOCUMENT;
 		}
-			break;
+	}
+	return state == JSON_STATE_DONE ? JSON_OK : JSON_INCOMPLETE_DOCUMENT;
+}
 
-		case 15: /* null: 2 */
-		{
-			switch (*(*p)++) {
-			case 'l':
-				*state = 16;
-				break;
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
-			break;
-
-		case 16: /* null: 3 */
-		{
-			switch (*(*p)++) {
-			case 'l':
-				*state = 0;
-				return LEX_NULL;
-				break;
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
-			break;
-
-		case 17: /* number: minus sign */
-		{
-			assert(*text != NULL);
-			switch (**p) {
-			case '0':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				*state = 18; /* number: '0' */
-				break;
-
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				*state = 19; /* number: decimal followup */
-				break;
-
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
-			break;
-
-		case 18: /* number: '0' */
-		{
-			assert(*text != NULL);
-			switch (**p) {
-			case '\x20': /* space */
-			case '\x09': /* horizontal tab */
-			case '\x0A': /* line feed or new line */
-			case '\x0D': /* Carriage return */
-				++*p;
-			case ']':
-			case '}':
-			case ',':
-				*state = 0;
-				return LEX_NUMBER;
-				break;
-
-			case '.':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				*state = 20; /* number: frac start */
-				break;
-
-			case 'e':
-			case 'E':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				*state = 22; /* number: exp start */
-				break;
-
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
-			break;
-
-		case 19: /* number: int followup */
-		{
-			assert(*text != NULL);
-			switch (**p) {
-			case '\x20': /* space */
-			case '\x09': /* horizontal tab */
-			case '\x0A': /* line feed or new line */
-			case '\x0D': /* Carriage return */
-				++*p;
-			case ']':
-			case '}':
-			case ',':
-				*state = 0;
-				return LEX_NUMBER;
-				break;
-
-			case '.':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				*state = 20; /* number: frac start */
-				break;
-
-			case 'e':
-			case 'E':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				*state = 22; /* number: exp start */
-				break;
-
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				break;
-
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
-			break;
-
-		case 20: /* number: frac start */
-		{
-			assert(*text != NULL);
-			switch (**p) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				*state = 21; /* number: frac continue */
-				break;
-
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
-			break;
-
-		case 21: /* number: frac continue */
-		{
-			assert(*text != NULL);
-			switch (**p) {
-			case '\x20': /* space */
-			case '\x09': /* horizontal tab */
-			case '\x0A': /* line feed or new line */
-			case '\x0D': /* Carriage return */
-				++*p;
-			case ']':
-			case '}':
-			case ',':
-				*state = 0;
-				return LEX_NUMBER;
-				break;
-
-			case 'e':
-			case 'E':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				*state = 22; /* number: exp start */
-				break;
-
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				break;
-
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
-			break;
-
-		case 22: /* number: exp start */
-		{
-			assert(*text != NULL);
-			switch (**p) {
-			case '-':
-			case '+':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				*state = 23; /* number: exp continue */
-				break;
-
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				*state = 24; /* number: exp end */
-				break;
-
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
-			break;
-
-		case 23: /* number: exp continue */
-		{
-			assert(*text != NULL);
-			switch (**p) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				*state = 24; /* number: exp end */
-				break;
-
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
-			break;
-
-		case 24: /* number: exp end */
-		{
-			assert(*text != NULL);
-			switch (**p) {
-			case '\x20': /* space */
-			case '\x09': /* horizontal tab */
-			case '\x0A': /* line feed or new line */
-			case '\x0D': /* Carriage return */
-				++*p;
-			case ']':
-			case '}':
-			case ',':
-				*state = 0;
-				return LEX_NUMBER;
-				break;
-
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-				if (rcs_catc(*text, **p) != RS_OK)
-					return LEX_MEMORY;
-				++*p;
-				break;
-
-			default:
-				return LEX_INVALID_CHARACTER;
-				break;
-			}
-		}
-			break;
-
-		default:
-			fprintf(stderr, "JSON: *state missing: %d\n", *state);
-			return LEX_INVALID_CHARACTER;
-		}
-
-	}
-
-	*p = NULL;
-	return LEX_MORE;
-}
-
-enum json_error json_parse_fragment(struct json_parsing_info *info,
-		const char *buffer) {
-	json_t *temp = NULL;
-
-	assert(info != NULL);
-	assert(buffer != NULL);
-
-	info->p = buffer;
-	while (*info->p != '\0') {
-		switch (info->state) {
-		case 0: /* starting point */
-		{
-			switch (lexer(buffer, &info->p, &info->lex_state, &info->lex_text,
-					&info->line)) {
-			case LEX_BEGIN_OBJECT:
-				info->state = 1; /* begin object */
-				break;
-
-			case LEX_INVALID_CHARACTER:
-				return JSON_MALFORMED_DOCUMENT;
-				break;
-
-			default:
-				fprintf(stderr, "JSON: state %d: defaulted at line %ld\n",
-						info->state, (long) info->line);
-				return JSON_MALFORMED_DOCUMENT;
-				break;
-			}
-		}
-			break;
-
-		case 1: /* open object */
-		{
-			if (info->cursor == NULL) {
-				if ((info->cursor = json_new_object()) == NULL) {
-					return JSON_MEMORY;
-				}
-			} else {
-				/* perform tree sanity check */
-				assert(
-						(info->cursor->type == JSON_STRING)
-								|| (info->cursor->type == JSON_ARRAY));
-
-				if ((temp = json_new_object()) == NULL) {
-					return JSON_MEMORY;
-				}
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				info->cursor = temp;
-				temp = NULL;
-			}
-			info->state = 2; /* just entered an object */
-		}
-			break;
-
-		case 2: /* opened object */
-		{
-			/*perform tree sanity checks */
-			assert(info->cursor != NULL);
-			assert(info->cursor->type == JSON_OBJECT);
-
-			switch (lexer(buffer, &info->p, &info->lex_state, &info->lex_text,
-					&info->line)) {
-			case LEX_STRING:
-				if ((temp = json_new_value(JSON_STRING)) == NULL)
-					return JSON_MEMORY;
-				temp->text = rcs_unwrap(info->lex_text), info->lex_text = NULL;
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					/*TODO return value according to the value returned from json_insert_child() */
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				info->cursor = temp;
-				temp = NULL;
-				info->state = 5; /* label, pre label:value separator */
-				break;
-
-			case LEX_END_OBJECT:
-				if (info->cursor->parent == NULL) {
-					info->state = 99; /* finished document. only accept whitespaces until EOF */
-				} else {
-					info->cursor = info->cursor->parent;
-					switch (info->cursor->type) {
-					case JSON_STRING:
-						/* perform tree sanity checks */
-						assert(info->cursor->parent != NULL);
-
-						info->cursor = info->cursor->parent;
-						if (info->cursor->type != JSON_OBJECT) {
-							return JSON_BAD_TREE_STRUCTURE;
-						} else {
-							info->state = 3; /* finished adding a field to an object */
-						}
-						break;
-
-					case JSON_ARRAY:
-						info->state = 9;
-						break;
-
-					default:
-						return JSON_BAD_TREE_STRUCTURE;
-					}
-				}
-				break;
-
-			case LEX_MORE:
-				return JSON_INCOMPLETE_DOCUMENT;
-				break;
-
-			default:
-				/* this should never run */
-				fprintf(stderr, "JSON: state %d: defaulted at line %ld\n",
-						info->state, (long) info->line);
-				return JSON_MALFORMED_DOCUMENT;
-				break;
-			}
-		}
-			break;
-
-		case 3: /* finished adding a field to an object */
-		{
-			/*perform tree sanity checks */
-			assert(info->cursor != NULL);
-			assert(info->cursor->type == JSON_OBJECT);
-
-			switch (lexer(buffer, &info->p, &info->lex_state, &info->lex_text,
-					&info->line)) {
-			case LEX_VALUE_SEPARATOR:
-				info->state = 4; /* sibling, post-object */
-				break;
-
-			case LEX_END_OBJECT:
-				if (info->cursor->parent == NULL) {
-					info->state = 99; /* parse until EOF */
-				} else {
-					info->cursor = info->cursor->parent;
-					switch (info->cursor->type) {
-					case JSON_STRING:
-						/* perform tree sanity checks */
-						assert(info->cursor->parent != NULL);
-
-						info->cursor = info->cursor->parent;
-						if (info->cursor->type != JSON_OBJECT) {
-							return JSON_BAD_TREE_STRUCTURE;
-						} else {
-							info->state = 3; /* finished adding a field to an object */
-						}
-						break;
-
-					case JSON_ARRAY:
-						info->state = 9;
-						break;
-
-					default:
-						return JSON_BAD_TREE_STRUCTURE;
-					}
-				}
-				break;
-
-			case LEX_MORE:
-				return JSON_INCOMPLETE_DOCUMENT;
-				break;
-
-			default:
-				fprintf(stderr, "JSON: state %d: defaulted at line %ld\n",
-						info->state, (long) info->line);
-				return JSON_MALFORMED_DOCUMENT;
-				break;
-			}
-		}
-			break;
-
-		case 4: /* sibling, post-object */
-		{
-			assert(info->cursor != NULL);
-			assert(info->cursor->type == JSON_OBJECT);
-
-			switch (lexer(buffer, &info->p, &info->lex_state, &info->lex_text,
-					&info->line)) {
-			case LEX_STRING:
-				if ((temp = json_new_value(JSON_STRING)) == NULL)
-					return JSON_MEMORY;
-				temp->text = rcs_unwrap(info->lex_text), info->lex_text = NULL;
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				info->cursor = temp;
-				temp = NULL;
-				info->state = 5;
-				break;
-
-			case LEX_MORE:
-				return JSON_INCOMPLETE_DOCUMENT;
-				break;
-
-			case LEX_INVALID_CHARACTER:
-				return JSON_ILLEGAL_CHARACTER;
-				break;
-
-			default: /* this should never run */
-				fprintf(stderr, "JSON: state %d: defaulted at line %ld\n",
-						info->state, (long) info->line);
-				return JSON_MALFORMED_DOCUMENT;
-				break;
-			}
-		}
-			break;
-
-		case 5: /* label, pre name separator */
-		{
-			/* perform tree sanity checks */
-			assert(info->cursor != NULL);
-			assert(info->cursor->type == JSON_STRING);
-
-			switch (lexer(buffer, &info->p, &info->lex_state, &info->lex_text,
-					&info->line)) {
-			case LEX_NAME_SEPARATOR:
-				info->state = 6; /* label, pos label:value separator */
-				break;
-
-			case LEX_MORE:
-				return JSON_INCOMPLETE_DOCUMENT;
-				break;
-
-			default:
-				fprintf(stderr, "JSON: state %d: defaulted at line %ld\n",
-						info->state, (long) info->line);
-				return JSON_MALFORMED_DOCUMENT;
-				break;
-			}
-		}
-			break;
-
-		case 6: /* label, pos name separator */
-		{
-			unsigned int value; /* to avoid redundant code */
-			/* perform tree sanity checks */
-			assert(info->cursor != NULL);
-			assert(info->cursor->type == JSON_STRING);
-
-			switch (value = lexer(buffer, &info->p, &info->lex_state,
-					&info->lex_text, &info->line)) {
-			case LEX_STRING:
-				if ((temp = json_new_value(JSON_STRING)) == NULL)
-					return JSON_MEMORY;
-				temp->text = rcs_unwrap(info->lex_text), info->lex_text = NULL;
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					/*TODO specify the exact error message */
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				if (info->cursor->parent == NULL) {
-					info->state = 99; /* finished document. only accepts whitespaces until EOF */
-				} else {
-					info->cursor = info->cursor->parent;
-				}
-				temp = NULL;
-				info->state = 3; /* finished adding a field to an object */
-				break;
-
-			case LEX_NUMBER:
-				if ((temp = json_new_value(JSON_NUMBER)) == NULL)
-					return JSON_MEMORY;
-				temp->text = rcs_unwrap(info->lex_text), info->lex_text = NULL;
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					/*TODO specify the exact error message */
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				if (info->cursor->parent == NULL) {
-					info->state = 99; /* finished document. only accepts whitespaces until EOF */
-				} else {
-					info->cursor = info->cursor->parent;
-				}
-				temp = NULL;
-				info->state = 3; /* finished adding a field to an object */
-				break;
-
-			case LEX_TRUE:
-				if ((temp = json_new_value(JSON_TRUE)) == NULL)
-					return JSON_MEMORY;
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					/*TODO specify the exact error message */
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				if (info->cursor->parent == NULL) {
-					info->state = 99; /* finished document. only accepts whitespaces until EOF */
-				} else {
-					info->cursor = info->cursor->parent;
-				}
-				temp = NULL;
-				info->state = 3; /* finished adding a field to an object */
-				break;
-
-			case LEX_FALSE:
-				if ((temp = json_new_value(JSON_FALSE)) == NULL)
-					return JSON_MEMORY;
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					/*TODO specify the exact error message */
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				if (info->cursor->parent == NULL) {
-					info->state = 99; /* finished document. only accepts whitespaces until EOF */
-				} else {
-					info->cursor = info->cursor->parent;
-				}
-				temp = NULL;
-				info->state = 3; /* finished adding a field to an object */
-				break;
-
-			case LEX_NULL:
-				if ((temp = json_new_value(JSON_NULL)) == NULL)
-					return JSON_MEMORY;
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					/*TODO specify the exact error message */
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				if (info->cursor->parent == NULL) {
-					info->state = 99; /* finished document. only accepts whitespaces until EOF */
-				} else {
-					info->cursor = info->cursor->parent;
-				}
-				temp = NULL;
-				info->state = 3; /* finished adding a field to an object */
-				break;
-
-			case LEX_BEGIN_OBJECT:
-				info->state = 1;
-				break;
-
-			case LEX_BEGIN_ARRAY:
-				info->state = 7;
-				break;
-
-			case LEX_MORE:
-				return JSON_INCOMPLETE_DOCUMENT;
-				break;
-
-			case LEX_MEMORY:
-				return JSON_MEMORY;
-				break;
-
-			case LEX_INVALID_CHARACTER:
-				return JSON_ILLEGAL_CHARACTER;
-				break;
-
-			default:
-				fprintf(stderr, "JSON: state %d: defaulted at line %ld\n",
-						info->state, (long) info->line);
-				return JSON_MALFORMED_DOCUMENT;
-				break;
-			}
-		}
-			break;
-
-		case 7: /* open array */
-		{
-			if (info->cursor == NULL) {
-				if ((info->cursor = json_new_array()) == NULL) {
-					return JSON_MEMORY;
-				}
-			} else {
-				/* perform tree sanity checks */
-				assert(
-						(info->cursor->type == JSON_ARRAY)
-								|| (info->cursor->type == JSON_STRING));
-
-				if ((temp = json_new_array()) == NULL) {
-					return JSON_MEMORY;
-				}
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				info->cursor = temp;
-				temp = NULL;
-			}
-			info->state = 8; /* just entered an array */
-		}
-			break;
-
-		case 8: /* just entered an array */
-		{
-			/* perform tree sanity checks */
-			assert(info->cursor != NULL);
-			assert(info->cursor->type == JSON_ARRAY);
-
-			switch (lexer(buffer, &info->p, &info->lex_state, &info->lex_text,
-					&info->line)) {
-			case LEX_STRING:
-				if ((temp = json_new_value(JSON_STRING)) == NULL)
-					return JSON_MEMORY;
-				temp->text = rcs_unwrap(info->lex_text), info->lex_text = NULL;
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				temp = NULL;
-				info->state = 9; /* label, pre label:value separator */
-				break;
-
-			case LEX_NUMBER:
-				if ((temp = json_new_value(JSON_NUMBER)) == NULL)
-					return JSON_MEMORY;
-				temp->text = rcs_unwrap(info->lex_text), info->lex_text = NULL;
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				temp = NULL;
-				info->state = 9; /* label, pre label:value separator */
-				break;
-
-			case LEX_TRUE:
-				if ((temp = json_new_value(JSON_TRUE)) == NULL)
-					return JSON_MEMORY;
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				info->state = 9; /* label, pre label:value separator */
-				break;
-
-			case LEX_FALSE:
-				if ((temp = json_new_value(JSON_FALSE)) == NULL)
-					return JSON_MEMORY;
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				info->state = 9; /* label, pre label:value separator */
-				break;
-
-			case LEX_NULL:
-				if ((temp = json_new_value(JSON_NULL)) == NULL)
-					return JSON_MEMORY;
-				if (json_insert_child(info->cursor, temp) != JSON_OK) {
-					return JSON_UNKNOWN_PROBLEM;
-				}
-				info->state = 9; /* label, pre label:value separator */
-				break;
-
-			case LEX_BEGIN_ARRAY:
-				info->state = 7; /* open array */
-				break;
-
-			case LEX_END_ARRAY:
-				if (info->cursor->parent == NULL) {
-					/*TODO implement this */
-					info->state = 99; /* finished document. only accept whitespaces until EOF */
-				} else {
-					info->cursor = info->cursor->parent;
-					switch (info->cursor->type) {
-					case JSON_STRING:
-						if (info->cursor->parent == NULL)
-							return JSON_BAD_TREE_STRUCTURE;
-						else {
-							info->cursor = info->cursor->parent;
-							if (info->cursor->type != JSON_OBJECT) {
-								return JSON_BAD_TREE_STRUCTURE;
-							}
-
-							info->state = 3; /* followup to adding child to array */
-						}
-						break;
-
-					case JSON_ARRAY:
-						info->state = 9; /* followup to adding child to array */
-						break;
-
-					default:
-						return JSON_BAD_TREE_STRUCTURE;
-					}
-				}
-				break;
-
-			case LEX_BEGIN_OBJECT:
-				info->state = 1; /* open object */
-				break;
-
-			case LEX_MORE:
-				return JSON_INCOMPLETE_DOCUMENT;
-				break;
-
-			case LEX_INVALID_CHARACTER:
-				return JSON_ILLEGAL_CHARACTER;
-				break;
-
-			default:
-				fprintf(stderr, "JSON: state %d: defaulted at line %ld\n",
-						info->state, (long) info->line);
-				return JSON_MALFORMED_DOCUMENT;
-				break;
-			}
-		}
-			break;
-
-		case 9: /* followup to adding child to array */
-		{
-			/*TODO perform tree sanity checks */
-			assert(info->cursor != NULL);
-			switch (lexer(buffer, &info->p, &info->lex_state, &info->lex_text,
-					&info->line)) {
-			case LEX_VALUE_SEPARATOR:
-				info->state = 8;
-				break;
-
-			case LEX_END_ARRAY:
-				if (info->cursor->parent == NULL) {
-					info->state = 99; /* finished document. only accept whitespaces until EOF */
-				} else {
-					info->cursor = info->cursor->parent;
-					switch (info->cursor->type) {
-					case JSON_STRING:
-						if (info->cursor->parent == NULL) {
-							info->state = 99; /* finished document. only accept whitespaces until EOF */
-						} else {
-							info->cursor = info->cursor->parent;
-							if (info->cursor->type != JSON_OBJECT) {
-								return JSON_BAD_TREE_STRUCTURE;
-							} else {
-								info->state = 3; /* followup to adding child to array */
-							}
-						}
-						break;
-
-					case JSON_ARRAY:
-						info->state = 9; /* followup to adding child to array */
-						break;
-
-					default:
-						return JSON_BAD_TREE_STRUCTURE;
-					}
-				}
-				break;
-
-			case LEX_MORE:
-				return JSON_INCOMPLETE_DOCUMENT;
-				break;
-
-			default:
-				fprintf(stderr, "JSON: state %d: defaulted at line %ld\n",
-						info->state, (long) info->line);
-				return JSON_MALFORMED_DOCUMENT;
-				break;
-			}
-		}
-			break;
-
-		case 99: /* finished document. only accept whitespaces until EOF */
-		{
-			/* perform tree sanity check */
-			assert(info->cursor->parent == NULL);
-			switch (lexer(buffer, &info->p, &info->lex_state, &info->lex_text,
-					&info->line)) {
-			case LEX_MORE:
-				return JSON_WAITING_FOR_EOF;
-				break;
-
-			case LEX_MEMORY:
-				return JSON_MEMORY;
-				break;
-
-			default:
-				return JSON_MALFORMED_DOCUMENT;
-				break;
-			}
-		}
-			break;
-
-		default:
-			fprintf(stderr, "JSON: state %d: defaulted at line %ld\n",
-					info->state, (long) info->line);
-			return JSON_UNKNOWN_PROBLEM;
-		}
-	}
-	info->p = NULL;
-	if (info->state == 99)
-		return JSON_WAITING_FOR_EOF;
-	else
-		return JSON_INCOMPLETE_DOCUMENT;
-}
-
-enum json_error json_parse_document(json_t **root, const char *text) {
-	enum json_error error;
-	struct json_parsing_info *jpi;
-
-	assert(root != NULL);
-	assert(*root == NULL);
-	assert(text != NULL);
-
-	/* initialize the parsing structure */
-	jpi = static_cast<json_parsing_info*>(malloc(
-			sizeof(struct json_parsing_info)));
-	if (jpi == NULL) {
-		return JSON_MEMORY;
-	}
-	json_jpi_init(jpi);
-
-	error = json_parse_fragment(jpi, text);
-	if ((error == JSON_WAITING_FOR_EOF) || (error == JSON_OK)) {
-		*root = jpi->cursor;
-		free(jpi);
-		return JSON_OK;
-	} else {
-		free(jpi);
-		return error;
-	}
-}
-
-enum json_error json_saxy_parse(struct json_saxy_parser_status *jsps,
-		struct json_saxy_functions *jsf, char c) {
-	/* make sure everything is in it's place */
-	assert(jsps != NULL);
-	assert(jsf != NULL);
-
-	/* goto where we left off */
-	switch (jsps->state) {
-	case 0: /* general state. everything goes. */
-		goto state0;
-		break;
-	case 1: /* parse string */
-		goto state1;
-		break;
-	case 2: /* parse string: escaped character */
-		goto state2;
-		break;
-	case 3: /* parse string: escaped unicode 1 */
-		goto state3;
-		break;
-	case 4: /* parse string: escaped unicode 2 */
-		goto state4;
-		break;
-	case 5: /* parse string: escaped unicode 3 */
-		goto state5;
-		break;
-	case 6: /* parse string: escaped unicode 4 */
-		goto state6;
-		break;
-	case 7: /* parse true: tr */
-		goto state7;
-		break;
-	case 8: /* parse true: tru */
-		goto state8;
-		break;
-	case 9: /* parse true: true */
-		goto state9;
-		break;
-	case 10: /* parse false: fa */
-		goto state10;
-		break;
-	case 11: /* parse false: fal */
-		goto state11;
-		break;
-	case 12: /* parse false: fals */
-		goto state12;
-		break;
-	case 13: /* parse false: false */
-		goto state13;
-		break;
-	case 14: /* parse null: nu */
-		goto state14;
-		break;
-	case 15: /* parse null: nul */
-		goto state15;
-		break;
-	case 16: /* parse null: null */
-		goto state16;
-		break;
-	case 17: /* parse number: 0 */
-		goto state17;
-		break;
-	case 18: /* parse number: start fraccional part */
-		goto state18;
-		break;
-	case 19: /* parse number: fraccional part */
-		goto state19;
-		break;
-	case 20: /* parse number: start exponent part */
-		goto state20;
-		break;
-	case 21: /* parse number: exponent part */
-		goto state21;
-		break;
-	case 22: /* parse number: exponent sign part */
-		goto state22;
-		break;
-	case 23: /* parse number: start negative */
-		goto state23;
-		break;
-	case 24: /* parse number: decimal part */
-		goto state24;
-		break;
-	case 25: /* open object */
-		goto state25;
-		break;
-	case 26: /* close object/array */
-		goto state26;
-		break;
-	case 27: /* sibling followup */
-		goto state27;
-		break;
-
-	default: /* oops... this should never be reached */
-		return JSON_UNKNOWN_PROBLEM;
-	}
-
-	state0: /* starting point */
-	{
-		switch (c) {
-		case '\x20':
-		case '\x09':
-		case '\x0A':
-		case '\x0D': /* JSON insignificant white spaces */
-			break;
-
-		case '\"': /* starting a string */
-			jsps->string_length_limit_reached = 0;
-			jsps->state = 1;
-			break;
-
-		case '{':
-			if (jsf->open_object != NULL)
-				jsf->open_object();
-			jsps->state = 25; /*open object */
-			break;
-
-		case '}':
-			if (jsf->close_object != NULL)
-				jsf->close_object();
-			jsps->state = 26; /* close object/array */
-			break;
-
-		case '[':
-			if (jsf->open_array != NULL)
-				jsf->open_array();
-			/*                      jsps->state = 0;        // redundant*/
-			break;
-
-		case ']':
-			if (jsf->close_array != NULL)
-				jsf->close_array();
-			jsps->state = 26; /* close object/array */
-			break;
-
-		case 't':
-			jsps->state = 7; /* parse true: tr */
-			break;
-
-		case 'f':
-			jsps->state = 10; /* parse false: fa */
-			break;
-
-		case 'n':
-			jsps->state = 14; /* parse null: nu */
-			break;
-
-		case ':':
-			if (jsf->label_value_separator != NULL)
-				jsf->label_value_separator();
-			/*                      jsps->state = 0;        // redundant*/
-			break;
-
-		case ',':
-			if (jsf->sibling_separator != NULL)
-				jsf->sibling_separator();
-			jsps->state = 27; /* sibling followup */
-			break;
-
-		case '0':
-			jsps->string_length_limit_reached = 0;
-			jsps->state = 17; /* parse number: 0 */
-			if ((jsps->temp = rcs_create(5)) == NULL) {
-				return JSON_MEMORY;
-			}
-			if (rcs_catc((jsps->temp), '0') != RS_OK) {
-				return JSON_MEMORY;
-			}
-			break;
-
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-			jsps->string_length_limit_reached = 0;
-			jsps->state = 24; /* parse number: decimal */
-			if ((jsps->temp = rcs_create(5)) == NULL) {
-				return JSON_MEMORY;
-			}
-			if (rcs_catc((jsps->temp), c) != RS_OK) {
-				return JSON_MEMORY;
-			}
-			break;
-
-		case '-':
-			jsps->string_length_limit_reached = 0;
-			jsps->state = 23; /* number: */
-			jsps->temp = NULL;
-			if ((jsps->temp = rcs_create(5)) == NULL) {
-				return JSON_MEMORY;
-			}
-			if (rcs_catc((jsps->temp), '-') != RS_OK) {
-				return JSON_MEMORY;
-			}
-
-			break;
-
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-			break;
-		}
-		return JSON_OK;
-	}
-
-	state1: /* parse string */
-	{
-		switch (c) {
-		case '\\':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH - 1) /* check if there is space for a two character escape sequence */
-				{
-					if (rcs_catc((jsps->temp), '\\') != RS_OK) {
-						return JSON_MEMORY;
-					}
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			jsps->state = 2; /* parse string: escaped character */
-			break;
-
-		case '\"': /* end of string */
-			if ((jsps->temp) != NULL) {
-				jsps->state = 0; /* starting point */
-				if (jsf->new_string != NULL)
-					jsf->new_string(((jsps->temp))->text); /*copied or integral? */
-				rcs_free(&jsps->temp);
-			} else
-				return JSON_UNKNOWN_PROBLEM;
-			break;
-
-		default:
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH) /* check if there is space for a two character escape sequence */
-				{
-					if (rcs_catc((jsps->temp), c) != RS_OK) {
-						return JSON_MEMORY;
-					}
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			break;
-		}
-		return JSON_OK;
-	}
-
-	state2: /* parse string: escaped character */
-	{
-		switch (c) {
-		case '\"':
-		case '\\':
-		case '/':
-		case 'b':
-		case 'f':
-		case 'n':
-		case 'r':
-		case 't':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH) {
-					if (rcs_catc((jsps->temp), c) != RS_OK) {
-						return JSON_MEMORY;
-					}
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			break;
-
-		case 'u':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH - 4) {
-					if (rcs_catc((jsps->temp), 'u') != RS_OK) {
-						return JSON_MEMORY;
-					}
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			jsps->state = 3; /* parse string: escaped unicode 1; */
-			break;
-
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-			break;
-		}
-		return JSON_OK;
-	}
-
-	state3: /* parse string: escaped unicode 1 */
-	{
-		switch (c) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH - 3) {
-					if (rcs_catc((jsps->temp), 'u') != RS_OK) {
-						return JSON_MEMORY;
-					}
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			jsps->state = 4; /* parse string. escaped unicode 2 */
-			break;
-
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-		}
-		return JSON_OK;
-	}
-
-	state4: /* parse string: escaped unicode 2 */
-	{
-		switch (c) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH - 2) {
-					if (rcs_catc((jsps->temp), c) != RS_OK) {
-						return JSON_MEMORY;
-					}
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			jsps->state = 5; /* parse string. escaped unicode 3 */
-			break;
-
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-		}
-		return JSON_OK;
-	}
-
-	state5: /* parse string: escaped unicode 3 */
-	{
-		switch (c) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH - 1) {
-					if (rcs_catc((jsps->temp), c) != RS_OK) {
-						return JSON_MEMORY;
-					}
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			jsps->state = 6; /* parse string. escaped unicode 4 */
-			break;
-
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-		}
-		return JSON_OK;
-	}
-
-	state6: /* parse string: escaped unicode 4 */
-	{
-		switch (c) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH) {
-					if (rcs_catc((jsps->temp), c) != RS_OK) {
-						return JSON_MEMORY;
-					}
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			jsps->state = 1; /* parse string */
-			break;
-
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-		}
-		return JSON_OK;
-	}
-
-	state7: /* parse true: tr */
-	{
-		if (c != 'r') {
-			return JSON_ILLEGAL_CHARACTER;
-		}
-
-		jsps->state = 8; /* parse true: tru */
-		return JSON_OK;
-	}
-
-	state8: /* parse true: tru */
-	{
-		if (c != 'u') {
-			return JSON_ILLEGAL_CHARACTER;
-		}
-
-		jsps->state = 9; /* parse true: true */
-		return JSON_OK;
-	}
-
-	state9: /* parse true: true */
-	{
-		if (c != 'e') {
-			return JSON_ILLEGAL_CHARACTER;
-		}
-
-		jsps->state = 0; /* back to general state. */
-		if (jsf->new_true != NULL)
-			jsf->new_true();
-		return JSON_OK;
-	}
-
-	state10: /* parse false: fa */
-	{
-		if (c != 'a') {
-			return JSON_ILLEGAL_CHARACTER;
-		}
-
-		jsps->state = 11; /* parse true: fal */
-		return JSON_OK;
-	}
-
-	state11: /* parse false: fal */
-	{
-		if (c != 'l') {
-			return JSON_ILLEGAL_CHARACTER;
-		}
-
-		jsps->state = 12; /* parse true: fals */
-		return JSON_OK;
-	}
-
-	state12: /* parse false: fals */
-	{
-		if (c != 's') {
-			return JSON_ILLEGAL_CHARACTER;
-		}
-
-		jsps->state = 13; /* parse true: false */
-		return JSON_OK;
-	}
-
-	state13: /* parse false: false */
-	{
-		if (c != 'e') {
-			return JSON_ILLEGAL_CHARACTER;
-		}
-
-		jsps->state = 0; /* general state. everything goes. */
-		if (jsf->new_false != NULL)
-			jsf->new_false();
-		return JSON_OK;
-	}
-
-	state14: /* parse null: nu */
-	{
-		if (c != 'u') {
-			return JSON_ILLEGAL_CHARACTER;
-		}
-
-		jsps->state = 15; /* parse null: nul */
-		return JSON_OK;
-	}
-
-	state15: /* parse null: nul */
-	{
-		if (c != 'l') {
-			return JSON_ILLEGAL_CHARACTER;
-		}
-
-		jsps->state = 16; /* parse null: null */
-		return JSON_OK;
-	}
-
-	state16: /* parse null: null */
-	{
-		if (c != 'l') {
-			return JSON_ILLEGAL_CHARACTER;
-		}
-
-		jsps->state = 0; /* general state. everything goes. */
-		if (jsf->new_null != NULL)
-			jsf->new_null();
-		return JSON_OK;
-	}
-
-	state17: /* parse number: 0 */
-	{
-		switch (c) {
-		case '.':
-			if ((jsps->temp = rcs_create(5)) == NULL) {
-				return JSON_MEMORY;
-			}
-			if (rcs_catc((jsps->temp), '.') != RS_OK) {
-				return JSON_MEMORY;
-			}
-			jsps->state = 18; /* parse number: fraccional part */
-			break;
-
-		case '\x20':
-		case '\x09':
-		case '\x0A':
-		case '\x0D': /* JSON insignificant white spaces */
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
-
-			jsps->state = 0;
-			break;
-
-		case '}':
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
-
-			if (jsf->open_object != NULL)
-				jsf->close_object();
-			jsps->state = 26; /* close object/array */
-			break;
-
-		case ']':
-
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
-
-			if (jsf->open_object != NULL)
-				jsf->close_array();
-			jsps->state = 26; /* close object/array */
-			break;
-
-		case ',':
-
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
-
-			if (jsf->open_object != NULL)
-				jsf->label_value_separator();
-			jsps->state = 27; /* sibling followup */
-			break;
-
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-			break;
-		}
-
-		return JSON_OK;
-	}
-
-	state18: /* parse number: start fraccional part */
-	{
-		switch (c) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH / 2) {
-					if (rcs_catc((jsps->temp), c) != RS_OK) {
-						return JSON_MEMORY;
-					}
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			jsps->state = 19; /* parse number: fractional part */
-			break;
-
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-			break;
-		}
-		return JSON_OK;
-	}
-
-	state19: /* parse number: fraccional part */
-	{
-		switch (c) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH / 2) {
-					if (rcs_catc((jsps->temp), c) != RS_OK) {
-						return JSON_MEMORY;
-					}
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			/*                      jsps->state = 19;       // parse number: fractional part*/
-			break;
-
-		case 'e':
-		case 'E':
-			if (rcs_catc((jsps->temp), c) != RS_OK) {
-				return JSON_MEMORY;
-			}
-
-			jsps->state = 20; /* parse number: start exponent part */
-			break;
-
-		case '\x20':
-		case '\x09':
-		case '\x0A':
-		case '\x0D': /* JSON insignificant white spaces */
-
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
-
-			jsps->state = 0;
-			break;
-
-		case '}':
-
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
-
-			if (jsf->open_object != NULL)
-				jsf->close_object();
-			jsps->state = 26; /* close object/array */
-			break;
-
-		case ']':
-			if (jsf->new_number != NULL) {
-				if ((jsps->temp) == NULL)
-					return JSON_MEMORY;
-				jsf->new_number((jsps->temp)->text);
-				rcs_free(&jsps->temp);
-			} else {
-				rcs_free(&jsps->temp);
-				jsps->temp = NULL;
-			}
-			if (jsf->open_object != NULL)
-				jsf->close_array();
-			jsps->state = 26; /* close object/array */
-			break;
-
-		case ',':
-
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
+enum json_error json_parse_buffer(json_t **root, char *buffer,
+		const struct json_array_stream *stream) {
+	struct json_parser jp;
+	enum json_error error;
 
-			if (jsf->label_value_separator != NULL)
-				jsf->label_value_separator();
-			jsps->state = 27; /* sibling followup */
-			break;
+	assert(root != NULL);
+	assert(*root == NULL);
+	assert(buffer != NULL);
 
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-			break;
-		}
-		return JSON_OK;
+	memset(&jp, 0, sizeof jp);
+	jp.doc = json_document_new(buffer, strlen(buffer) / 32);
+	if (jp.doc == NULL) {
+		free(buffer);
+		return JSON_MEMORY;
 	}
+	jp.p = buffer;
+	jp.stream = stream;
+	if (stream != NULL)
+		jp.stream_hash = json_label_hash(stream->label, strlen(stream->label));
 
-	state20: /* parse number: start exponent part */
-	{
-		switch (c) {
-		case '+':
-		case '-':
-			jsps->string_length_limit_reached = 0;
-			if (rcs_catc((jsps->temp), c) != RS_OK) {
-				return JSON_MEMORY;
-			}
+	error = json_parser_run(&jp);
+	*root = &jp.doc->root;
+	if (error == JSON_OK)
+		error = json_document_index(jp.doc);
+	if (error != JSON_OK)
+		json_free_value(root);
+	return error;
+}
 
-			jsps->state = 22; /* parse number: exponent sign part */
-			break;
+enum json_error json_parse_document(json_t **root, const char *text) {
+	const size_t length = strlen(text) + 1;
+	char *buffer;
 
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH) {
-					if (rcs_catc((jsps->temp), c) != RS_OK) {
-						return JSON_MEMORY;
-					}
+	assert(root != NULL);
+	assert(*root == NULL);
 
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			jsps->state = 21; /* parse number: exponent part */
-			break;
+	buffer = static_cast<char*>(malloc(length));
+	if (buffer == NULL)
+		return JSON_MEMORY;
+	memcpy(buffer, text, length);
+	return json_parse_buffer(root, buffer, NULL);
+}
 
-		default:
-			return JSON_ILLEGAL_CHARACTER;
+static char *json_read_stream(FILE *file) {
+	size_t capacity = 4096;
+	size_t length = 0;
+	char *buffer = static_cast<char*>(malloc(capacity));
+	if (buffer == NULL)
+		return NULL;
+	for (;;) {
+		length += fread(buffer + length, 1, capacity - 1 - length, file);
+		if (length < capacity - 1)
 			break;
+		char *grown = static_cast<char*>(realloc(buffer, capacity * 2));
+		if (grown == NULL) {
+			free(buffer);
+			return NULL;
 		}
-		return JSON_OK;
+		buffer = grown;
+		capacity *= 2;
 	}
+	buffer[length] = '\0';
+	return buffer;
+}
 
-	state21: /* parse number: exponent part */
-	{
-		switch (c) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH) {
-					if (rcs_catc((jsps->temp), c) != RS_OK) {
-						return JSON_MEMORY;
-					}
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			/*                              jsps->state = 21;       // parse number: exponent part*/
-			break;
-
-		case '\x20':
-		case '\x09':
-		case '\x0A':
-		case '\x0D': /* JSON insignificant white spaces */
-
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
-
-			jsps->state = 0;
-			break;
+enum json_error json_stream_parse(FILE *file, json_t **document) {
+	char *buffer;
 
-		case '}':
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
+	assert(file != NULL); /* must be an open stream */
+	assert(document != NULL); /* must be a valid pointer reference */
+	assert(*document == NULL); /* only accepts a null json_t pointer, to avoid memory leaks */
 
-			if (jsf->open_object != NULL)
-				jsf->close_object();
-			jsps->state = 26; /* close object */
-			break;
+	/* the document is parsed in place, so the whole stream is read first */
+	buffer = json_read_stream(file);
+	if (buffer == NULL)
+		return JSON_MEMORY;
+	return json_parse_buffer(document, buffer, NULL);
+}
 
-		case ']':
-			if (jsf->new_number != NULL) {
-				if ((jsps->temp) == NULL)
-					return JSON_MEMORY;
-				jsf->new_number((jsps->temp)->text);
-				free(jsps->temp);
-				jsps->temp = NULL;
-			} else {
-				free((jsps->temp));
-				jsps->temp = NULL;
-			}
-			if (jsf->open_object != NULL)
-				jsf->close_array();
-			jsps->state = 26; /* close object/array */
-			break;
+/* Grow an array of size elements to hold at least n */
+static int json_flat_reserve(void **array, size_t *capacity, const size_t n,
+		const size_t size) {
+	size_t grown = *capacity > 0 ? *capacity : 64;
+	void *p;
+	if (n <= *capacity)
+		return 1;
+	while (grown < n)
+		grown *= 2;
+	p = realloc(*array, grown * size);
+	if (p == NULL)
+		return 0;
+	*array = p;
+	*capacity = grown;
+	return 1;
+}
 
-		case ',':
-			if (jsf->new_number != NULL) {
-				if ((jsps->temp) == NULL)
-					return JSON_MEMORY;
-				jsf->new_number((jsps->temp)->text);
-				free((jsps->temp));
-				jsps->temp = NULL;
-			} else {
-				free(jsps->temp);
-				jsps->temp = NULL;
-			}
-			if (jsf->label_value_separator != NULL)
-				jsf->label_value_separator();
-			jsps->state = 27; /* sibling followup */
-			break;
+enum json_error json_flatten(const json_t *root, struct json_flat_node **nodes,
+		size_t *count, char **strings, size_t *length) {
+	size_t nodes_capacity = 0;
+	size_t strings_capacity = 0;
+	int32_t *parents = NULL; /* indices of the nodes above the current one */
+	size_t parents_capacity = 0;
+	size_t depth = 0;
+	const json_t *node = root;
 
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-			break;
+	assert(root != NULL);
+	assert(root->parent == NULL);
+
+	*nodes = NULL;
+	*count = 0;
+	*strings = NULL;
+	*length = 0;
+	while (node != NULL) {
+		struct json_flat_node *flat;
+		if (!json_flat_reserve(reinterpret_cast<void**>(nodes),
+				&nodes_capacity, *count + 1, sizeof **nodes))
+			goto memory;
+		flat = &(*nodes)[*count];
+		flat->parent = depth > 0 ? parents[depth - 1] : -1;
+		flat->type = node->type;
+		flat->text = JSON_FLAT_NO_TEXT;
+		if (node->text != NULL) {
+			const size_t n = strlen(node->text) + 1;
+			if (!json_flat_reserve(reinterpret_cast<void**>(strings),
+					&strings_capacity, *length + n, 1))
+				goto memory;
+			memcpy(*strings + *length, node->text, n);
+			flat->text = (uint32_t) *length;
+			*length += n;
+		}
+		(*count)++;
+
+		if (node->child != NULL) {
+			if (!json_flat_reserve(reinterpret_cast<void**>(&parents),
+					&parents_capacity, depth + 1, sizeof *parents))
+				goto memory;
+			parents[depth++] = (int32_t) (*count - 1);
+			node = node->child;
+			continue;
 		}
-		return JSON_OK;
-	}
-
-	state22: /* parse number: start exponent part */
-	{
-		switch (c) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH) {
-					rcs_catc((jsps->temp), c);
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			jsps->state = 21; /* parse number: exponent part */
-			break;
-
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-			break;
+		while (node != root && node->next == NULL) {
+			node = node->parent;
+			depth--;
 		}
-		return JSON_OK;
+		node = node == root ? NULL : node->next;
 	}
+	free(parents);
+	return JSON_OK;
 
-	state23: /* parse number: start negative */
-	{
-		switch (c) {
-		case '0':
-			rcs_catc((jsps->temp), c);
-			jsps->state = 17; /* parse number: 0 */
-			break;
-
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH / 2) {
-					if ((jsps->temp = rcs_create(5)) == NULL) {
-						return JSON_MEMORY;
-					}
-					if (rcs_catc((jsps->temp), c) != RS_OK) {
-						return JSON_MEMORY;
-					} else {
-						jsps->string_length_limit_reached = 1;
-					}
-				}
-			}
-			jsps->state = 24; /* parse number: start decimal part */
-			break;
+memory:
+	free(parents);
+	free(*nodes);
+	free(*strings);
+	*nodes = NULL;
+	*strings = NULL;
+	return JSON_MEMORY;
+}
 
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-			break;
-		}
-		return JSON_OK;
+/* Whether a node can be added to parent: containers take any number of
+ * nodes, but objects only labels, and labels one value */
+static int json_flat_fits(const json_t *parent,
+		const enum json_value_type type) {
+	switch (parent->type) {
+	case JSON_OBJECT:
+		return type == JSON_STRING;
+	case JSON_ARRAY:
+		return 1;
+	case JSON_STRING:
+		return parent->parent != NULL && parent->parent->type == JSON_OBJECT
+				&& parent->child == NULL;
+	default:
+		return 0;
 	}
+}
 
-	state24: /* parse number: decimal part */
-	{
-		switch (c) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-			if (!jsps->string_length_limit_reached) {
-				if (rcs_length((jsps->temp)) < JSON_MAX_STRING_LENGTH / 2) {
-					if ((jsps->temp = rcs_create(5)) == NULL) {
-						return JSON_MEMORY;
-					}
-					if (rcs_catc((jsps->temp), c) != RS_OK) {
-						return JSON_MEMORY;
-					}
-				} else {
-					jsps->string_length_limit_reached = 1;
-				}
-			}
-			/*                              jsps->state = 24;       // parse number: decimal part*/
-			break;
-
-		case '.':
-			if ((jsps->temp = rcs_create(5)) == NULL) {
-				return JSON_MEMORY;
-			}
-			if (rcs_catc((jsps->temp), '.') != RS_OK) {
-				return JSON_MEMORY;
-			}
-
-			jsps->state = 18; /* parse number: start exponent part */
-			break;
-
-		case 'e':
-		case 'E':
-			if ((jsps->temp = rcs_create(5)) == NULL) {
-				return JSON_MEMORY;
-			}
-			if (rcs_catc((jsps->temp), c) != RS_OK) {
-				return JSON_MEMORY;
-			}
-
-			jsps->string_length_limit_reached = 0; /* reset to accept the exponential part */
-			jsps->state = 20; /* parse number: start exponent part */
-			break;
-
-		case '\x20':
-		case '\x09':
-		case '\x0A':
-		case '\x0D': /* JSON insignificant white spaces */
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
-
-			jsps->state = 0;
-			break;
-
-		case '}':
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
-
-			if (jsf->open_object != NULL)
-				jsf->close_object();
-			jsps->state = 26; /* close object/array */
-			break;
-
-		case ']':
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
-
-			if (jsf->open_object != NULL)
-				jsf->close_array();
-			jsps->state = 26; /* close object/array */
-			break;
-
-		case ',':
-			if ((jsps->temp) == NULL)
-				return JSON_MEMORY;
-			if (jsf->new_number != NULL) {
-				jsf->new_number((jsps->temp)->text);
-			}
-			rcs_free(&jsps->temp);
+enum json_error json_unflatten(json_t **root,
+		const struct json_flat_node *nodes, const size_t count,
+		const char *strings, const size_t length) {
+	struct json_document *doc;
+	json_t **made;
+	char *buffer = NULL;
+	enum json_error error = JSON_OK;
+	size_t i;
 
-			if (jsf->label_value_separator != NULL)
-				jsf->label_value_separator();
-			jsps->state = 27; /* sibling followup */
-			break;
+	assert(root != NULL);
+	assert(*root == NULL);
 
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-			break;
-		}
-		return JSON_OK;
+	/* the root is the document's, and the strings must all be terminated */
+	if (count == 0 || nodes[0].parent != -1 || nodes[0].type != JSON_OBJECT
+			|| (length > 0 && strings[length - 1] != '\0'))
+		return JSON_BAD_TREE_STRUCTURE;
+	if (length > 0) {
+		buffer = static_cast<char*>(malloc(length));
+		if (buffer == NULL)
+			return JSON_MEMORY;
+		memcpy(buffer, strings, length);
+	}
+	doc = json_document_new(buffer, count);
+	if (doc == NULL) {
+		free(buffer);
+		return JSON_MEMORY;
 	}
-
-	state25: /* open object */
-	{
-		switch (c) {
-		case '\x20':
-		case '\x09':
-		case '\x0A':
-		case '\x0D': /* JSON insignificant white spaces */
-			break;
-
-		case '\"':
-			jsps->temp = NULL;
-			jsps->state = 1;
-			break;
-
-		case '}':
-			if (jsf->close_object != NULL)
-				jsf->close_object();
-			jsps->state = 26; /* close object */
-			break;
-
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-			break;
-		}
-		return JSON_OK;
+	*root = &doc->root;
+	made = static_cast<json_t**>(malloc(count * sizeof *made));
+	if (made == NULL) {
+		json_free_value(root);
+		return JSON_MEMORY;
 	}
-
-	state26: /* close object/array */
-	{
-		switch (c) {
-		case '\x20':
-		case '\x09':
-		case '\x0A':
-		case '\x0D': /* JSON insignificant white spaces */
-			break;
-
-		case '}':
-			if (jsf->close_object != NULL)
-				jsf->close_object();
-			/*                      jsp->state = 26;        // close object*/
-			break;
-
-		case ']':
-			if (jsf->close_array != NULL)
-				jsf->close_array();
-			/*                      jsps->state = 26;       // close object/array*/
-			break;
-
-		case ',':
-			if (jsf->sibling_separator != NULL)
-				jsf->sibling_separator();
-			jsps->state = 27; /* sibling followup */
-			break;
-
-		default:
-			return JSON_ILLEGAL_CHARACTER;
+	made[0] = &doc->root;
+	for (i = 1; i < count; i++) {
+		const struct json_flat_node *flat = &nodes[i];
+		const enum json_value_type type =
+				static_cast<enum json_value_type>(flat->type);
+		json_t *parent;
+		json_t *node;
+		if (flat->parent < 0 || (size_t) flat->parent >= i
+				|| flat->type > JSON_NULL
+				|| (flat->text != JSON_FLAT_NO_TEXT && flat->text >= length)) {
+			error = JSON_BAD_TREE_STRUCTURE;
 			break;
 		}
-		return JSON_OK;
-	}
-
-	state27: /* sibling followup */
-	{
-		switch (c) {
-		case '\x20':
-		case '\x09':
-		case '\x0A':
-		case '\x0D': /* JSON insignificant white spaces */
-			break;
-
-		case '\"':
-			jsps->state = 1;
-			jsps->temp = NULL;
-			break;
-
-		case '{':
-			if (jsf->open_object != NULL)
-				jsf->open_object();
-			jsps->state = 25; /*open object */
-			break;
-
-		case '[':
-			if (jsf->open_array != NULL)
-				jsf->open_array();
-			/*                      jsps->state = 0;        // redundant*/
-			break;
-
-		case 't':
-			jsps->state = 7; /* parse true: tr */
+		parent = made[flat->parent];
+		if (!json_flat_fits(parent, type)) {
+			error = JSON_BAD_TREE_STRUCTURE;
 			break;
-
-		case 'f':
-			jsps->state = 10; /* parse false: fa */
-			break;
-
-		case 'n':
-			jsps->state = 14; /* parse null: nu */
-			break;
-
-		case '0':
-			jsps->state = 17; /* parse number: 0 */
-			if ((jsps->temp = rcs_create(5)) == NULL) {
-				return JSON_MEMORY;
-			}
-			if (rcs_catc((jsps->temp), '0') != RS_OK) {
-				return JSON_MEMORY;
-			}
-			break;
-
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-			jsps->state = 24; /* parse number: decimal */
-			if ((jsps->temp = rcs_create(5)) == NULL) {
-				return JSON_MEMORY;
-			}
-			if (rcs_catc((jsps->temp), c) != RS_OK) {
-				return JSON_MEMORY;
-			}
+		}
+		node = json_document_new_node(doc, type);
+		if (node == NULL) {
+			error = JSON_MEMORY;
 			break;
-
-		case '-':
-			jsps->state = 23; /* number: */
-			if ((jsps->temp = rcs_create(RSTRING_DEFAULT)) == NULL) {
-				return JSON_MEMORY;
-			}
-			if (rcs_catc((jsps->temp), '-') != RS_OK) {
-				return JSON_MEMORY;
+		}
+		if (flat->text != JSON_FLAT_NO_TEXT)
+			node->text = buffer + flat->text;
+		if (parent->type == JSON_OBJECT) {
+			if (node->text == NULL) {
+				error = JSON_BAD_TREE_STRUCTURE;
+				break;
 			}
-			break;
-
-		default:
-			return JSON_ILLEGAL_CHARACTER;
-			break;
+			node->label_hash = json_label_hash(node->text, strlen(node->text));
 		}
-		return JSON_OK;
+		json_append(parent, node);
+		made[i] = node;
 	}
-
-	//return JSON_UNKNOWN_PROBLEM;
+	free(made);
+	if (error == JSON_OK)
+		error = json_document_index(doc);
+	if (error != JSON_OK)
+		json_free_value(root);
+	return error;
 }
 
 json_t*
 json_find_first_label(const json_t *object, const char *text_label) {
 	json_t *cursor;
+	unsigned int hash;
 
 	assert(object != NULL);
 	assert(text_label != NULL);
 	assert(object->type == JSON_OBJECT);
 
+	hash = json_label_hash(text_label, strlen(text_label));
+	if (object->flags & JSON_FLAG_INDEXED) {
+		const struct json_document *doc = json_document_of(object);
+		if (doc != NULL)
+			return json_index_find(doc, object, text_label, hash);
+	}
 	for (cursor = object->child; cursor != NULL; cursor = cursor->next) {
-		if (strcmp(cursor->text, text_label) == 0)
+		if ((cursor->label_hash == 0 || cursor->label_hash == hash)
+				&& strcmp(cursor->text, text_label) == 0)
 			break;
 	}
 	return cursor;
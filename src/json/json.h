@@ -93,46 +93,35 @@ typedef struct json_value {
 	struct json_value *parent; /*!< The pointer pointing to the parent node in the document tree */
 	struct json_value *child; /*!< The pointer pointing to the first child node in the document tree */
 	struct json_value *child_end; /*!< The pointer pointing to the last child node in the document tree */
+	unsigned int label_hash; /*!< Hash of text for object labels, to speed up json_find_first_label; 0 if not known */
+	unsigned int flags; /*!< Internal; how the node is owned and indexed */
 } json_t;
 
 /**
- The structure holding all information needed to resume parsing
+ The element handler for json_parse_buffer; each element of the streamed
+ array is only valid during the call, and must not be modified
  **/
-struct json_parsing_info {
-	unsigned int state; /*!< the state where the parsing was left on the last parser run */
-	unsigned int lex_state;
-	rcstring *lex_text;
-	const char *p;
-	int string_length_limit_reached; /*!< flag informing if the string limit length defined by JSON_MAX_STRING_LENGTH was reached */
-	size_t line;	// current document line
-	json_t *cursor; /*!< pointers to nodes belonging to the document tree which aid the document parsing */
-};
+typedef void (*json_element_callback)(json_t *element, void *data);
 
 /**
- The structure which holds the pointers to the functions that will be called by the saxy parser whenever their evens are triggered
+ Which array json_parse_buffer streams instead of keeping in the tree
  **/
-struct json_saxy_functions {
-	int (*open_object)(void);
-	int (*close_object)(void);
-	int (*open_array)(void);
-	int (*close_array)(void);
-	int (*new_string)(char *text);
-	int (*new_number)(char *text);
-	int (*new_true)(void);
-	int (*new_false)(void);
-	int (*new_null)(void);
-	int (*label_value_separator)(void);
-	int (*sibling_separator)(void);
+struct json_array_stream {
+	const char *label; /*!< label of the array in the root object */
+	json_element_callback callback; /*!< called with every element of the array */
+	void *data; /*!< passed to callback */
 };
 
 /**
- The structure holding the information needed for json_saxy_parse to resume parsing
+ A node of a document stored flat, e.g. in a file, in pre-order so that
+ parents come before their children
  **/
-struct json_saxy_parser_status {
-	unsigned int state; /*!< current parser state */
-	int string_length_limit_reached; /*!< flag informing if the string limit length defined by JSON_MAX_STRING_LENGTH was reached */
-	rcstring *temp; /*!< temporary string which will be used to build up parsed strings between parser runs. */
+struct json_flat_node {
+	int32_t parent; /*!< index of the parent node; -1 for the root */
+	uint32_t type; /*!< the enum json_value_type of the node */
+	uint32_t text; /*!< offset of the node's text in the strings, or JSON_FLAT_NO_TEXT */
 };
+#define JSON_FLAT_NO_TEXT UINT32_MAX
 
 /** 
  Buils a json_t document by parsing an open file stream
@@ -200,7 +189,8 @@ json_t* json_new_false(void);
 json_t* json_new_bool(int value);
 
 /**
- Frees the memory appointed to the value fed as the parameter, as well as all the child nodes
+ Frees the memory appointed to the value fed as the parameter, as well as all the child nodes.
+ The nodes of a parsed document are only released once its root is freed.
  @param value the root node of the tree being freed
  **/
 void json_free_value(json_t **value);
@@ -269,38 +259,49 @@ char* json_escape(const char *text);
 char* json_unescape(const char *text);
 
 /**
- This function takes care of the tedious task of initializing any instance of 
- struct json_parsing_info
- @param jpi a pointer to a struct json_parsing_info instance
+ Produces a document tree from a JSON markup text string that contains a complete document
+ @param root a reference to a pointer to a json_t type. The function allocates memory to the passed pointer and sets up the value
+ @param text a c-string containing a complete JSON text document
+ @return a pointer to the new document tree or NULL if some error occurred
  **/
-void json_jpi_init(struct json_parsing_info *jpi);
+enum json_error json_parse_document(json_t **root, const char *text);
 
 /**
- Produces a document tree sequentially from a JSON markup text fragment
- @param info the information necessary to resume parsing any incomplete document
- @param buffer a null-terminated c-string containing a JSON document fragment
- @return a code describing how the operation ended up
+ Produces a document tree by parsing a buffer in place. The document takes
+ over the buffer, whose strings and numbers its nodes point into, and frees
+ it along with the tree, or straight away if parsing fails.
+ @param root a reference to a pointer to a json_t type, set to NULL, which will store the parsed document
+ @param buffer a malloc'd c-string containing a complete JSON text document
+ @param stream if not NULL, the array in the root object whose elements are handed to a callback one at a time as they are parsed, so that big arrays need not be held whole; the array is left empty in the tree
+ @return a json_error error code according to how the parsing operation went
  **/
-enum json_error json_parse_fragment(struct json_parsing_info *info,
-		const char *buffer);
+enum json_error json_parse_buffer(json_t **root, char *buffer,
+		const struct json_array_stream *stream);
 
 /**
- Produces a document tree from a JSON markup text string that contains a complete document
- @param root a reference to a pointer to a json_t type. The function allocates memory to the passed pointer and sets up the value
- @param text a c-string containing a complete JSON text document
- @return a pointer to the new document tree or NULL if some error occurred
+ Stores a parsed document flat, for json_unflatten to rebuild without parsing
+ @param root the root of a document
+ @param nodes set to a malloc'd array of the nodes, in pre-order
+ @param count set to the number of nodes
+ @param strings set to a malloc'd buffer of the nodes' texts, each terminated by a nul character
+ @param length set to the length of strings
+ @return a json_error error code according to how the operation went
  **/
-enum json_error json_parse_document(json_t **root, const char *text);
+enum json_error json_flatten(const json_t *root, struct json_flat_node **nodes,
+		size_t *count, char **strings, size_t *length);
 
 /**
- Function to perform a SAX-like parsing of any JSON document or document fragment that is passed to it
- @param jsps a structure holding the status information of the current parser
- @param jsf a structure holding the function pointers to the event functions
- @param c the character to be parsed
- @return a json_error code informing how the parsing went
+ Rebuilds a document stored by json_flatten. The strings are copied into the document, which is indexed as if it had been parsed.
+ @param root a reference to a pointer to a json_t type, set to NULL, which will store the document
+ @param nodes the nodes in pre-order
+ @param count the number of nodes
+ @param strings the nodes' texts
+ @param length the length of strings
+ @return JSON_BAD_TREE_STRUCTURE if the nodes don't make a document, otherwise a json_error error code according to how the operation went
  **/
-enum json_error json_saxy_parse(struct json_saxy_parser_status *jsps,
-		struct json_saxy_functions *jsf, char c);
+enum json_error json_unflatten(json_t **root,
+		const struct json_flat_node *nodes, const size_t count,
+		const char *strings, const size_t length);
 
 /**
  Searches through the object's children for a label holding the text text_label
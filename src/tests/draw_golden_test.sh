@@ -0,0 +1,34 @@
+#!/bin/sh
+# Pixel-exact check of the map renderer against a golden image
+#
+# Draws the first frame of a fixed stress mission with cdogs-bench, before
+# any tick runs, and compares it with the golden image; the test fails if
+# any pixel differs or the golden image is missing.
+#
+# Usage: draw_golden_test.sh BENCH [--record]
+#   BENCH     path to a built cdogs-bench
+#   --record  write the golden image instead of comparing with it
+#
+# Record the golden image once with a cdogs-bench whose drawing is known to
+# be right (the renderer before the per-layer draw lists), commit it, then
+# run this against every build.
+set -e
+
+if [ -z "$1" ]
+then
+  echo "Usage: $0 BENCH [--record]"
+  exit 2
+fi
+BENCH=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+RECORD=
+if [ "$2" = "--record" ]
+then
+  RECORD=--record-golden
+fi
+
+# The bench loads data relative to the repository root
+cd "$(dirname "$0")/../.."
+GOLDEN=src/tests/golden/draw_classic_64x64_seed1.png
+"$BENCH" --map=classic --size=64x64 --enemies=50 --barrels=50 \
+  --players=1 --seed=1 --warmup=0 --ticks=1 \
+  --golden="$GOLDEN" $RECORD
@@ -0,0 +1,139 @@
+#include <cbehave/cbehave.h>
+
+#include <string.h>
+
+#include <grid_codec.h>
+
+#include <SDL2/SDL_joystick.h>
+
+#include <utils.h>
+
+// Stubs
+const char* JoyName(const int deviceIndex) {
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+static bool DecodeEquals(const char *text, const uint16_t *values,
+		const int count) {
+	CArray a;
+	CArrayInit(&a, sizeof(uint16_t));
+	bool ok = GridDecode(&a, text, count) && (int) a.size == count;
+	for (int i = 0; ok && i < count; i++) {
+		ok = *(const uint16_t*) CArrayGet(&a, i) == values[i];
+	}
+	CArrayTerminate(&a);
+	return ok;
+}
+static bool DecodeFails(const char *text, const int count) {
+	CArray a;
+	CArrayInit(&a, sizeof(uint16_t));
+	const bool ok = GridDecode(&a, text, count);
+	const bool isEmpty = a.size == 0;
+	CArrayTerminate(&a);
+	return !ok && isEmpty;
+}
+
+FEATURE(GridRoundTrip, "Grid round trip")
+	SCENARIO("Round trip")
+		GIVEN("a grid with runs and single values")
+		uint16_t values[200];
+		for (int i = 0; i < 200; i++) {
+			values[i] = (uint16_t) (i < 100 ? 1 : (i % 7 == 0 ? i : 2));
+		}
+
+		WHEN("I encode and decode it")
+		char *text = GridEncode(values, 200);
+
+		THEN("the result should be the same grid")
+		SHOULD_BE_TRUE(DecodeEquals(text, values, 200));
+		AND("the runs should make it smaller than the values")
+		SHOULD_INT_LT((int) strlen(text), 200);
+		CFREE(text);
+		SCENARIO_END
+
+	SCENARIO("Empty grid")
+		GIVEN("an empty grid")
+
+		WHEN("I encode and decode it")
+		char *text = GridEncode(NULL, 0);
+
+		THEN("the text should be empty")
+		SHOULD_STR_EQUAL(text, "");
+		AND("decode to an empty grid")
+		SHOULD_BE_TRUE(DecodeEquals(text, NULL, 0));
+		CFREE(text);
+		SCENARIO_END
+
+	SCENARIO("Max values")
+		GIVEN("a grid of the largest values")
+		uint16_t values[5] = { 0xffff, 0xffff, 0, 0xffff, 0x8000 };
+
+		WHEN("I encode and decode it")
+		char *text = GridEncode(values, 5);
+
+		THEN("the result should be the same grid")
+		SHOULD_BE_TRUE(DecodeEquals(text, values, 5));
+		CFREE(text);
+		SCENARIO_END
+	FEATURE_END
+
+FEATURE(GridDecodeMalformed, "Grid decode malformed input")
+	SCENARIO("Truncated input")
+		GIVEN("an encoded grid")
+		uint16_t values[4] = { 1, 2, 300, 4 };
+		char *text = GridEncode(values, 4);
+
+		WHEN("it is truncated")
+		THEN("decoding should fail for every shorter length")
+		const int len = (int) strlen(text);
+		for (int i = len - 1; i >= 0; i--) {
+			text[i] = '\0';
+			SHOULD_BE_TRUE(DecodeFails(text, 4));
+		}
+		CFREE(text);
+		SCENARIO_END
+
+	SCENARIO("Bad base64")
+		GIVEN("text that isn't valid base64")
+		THEN("decoding should fail")
+		// Bad characters
+		SHOULD_BE_TRUE(DecodeFails("AQ!B", 1));
+		// Not a multiple of 4 characters
+		SHOULD_BE_TRUE(DecodeFails("AQE", 1));
+		// Padding in the middle
+		SHOULD_BE_TRUE(DecodeFails("AQ==AQ==", 2));
+		// Padding before data
+		SHOULD_BE_TRUE(DecodeFails("AQ=B", 1));
+		SCENARIO_END
+
+	SCENARIO("Bad varints")
+		GIVEN("runs that are zero, or values over 16 bits")
+		THEN("decoding should fail")
+		// run 0, value 1
+		SHOULD_BE_TRUE(DecodeFails("AAE=", 0));
+		// run 1, value 0x10000
+		SHOULD_BE_TRUE(DecodeFails("AYCABA==", 1));
+		// run 1, varint longer than 5 bytes
+		SHOULD_BE_TRUE(DecodeFails("AYCAgICAAQ==", 1));
+		SCENARIO_END
+
+	SCENARIO("Run count overflow")
+		GIVEN("an encoded grid")
+		uint16_t values[10] = { 0 };
+		char *text = GridEncode(values, 10);
+
+		WHEN("it is decoded as a smaller grid")
+		THEN("decoding should fail")
+		SHOULD_BE_TRUE(DecodeFails(text, 9));
+		AND("a larger grid should fail too")
+		SHOULD_BE_TRUE(DecodeFails(text, 11));
+		CFREE(text);
+		AND("a huge run should fail")
+		// run 0xffffffff, value 0
+		SHOULD_BE_TRUE(DecodeFails("/////w8A", 10));
+		SCENARIO_END
+	FEATURE_END
+
+CBEHAVE_RUN("Grid codec features are:", TEST_FEATURE(GridRoundTrip),
+		TEST_FEATURE(GridDecodeMalformed))
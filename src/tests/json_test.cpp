@@ -62,4 +62,364 @@ FEATURE(json_format_string, "String format")
 		SCENARIO_END
 	FEATURE_END
 
-CBEHAVE_RUN("JSON features are:", TEST_FEATURE(json_format_string))
+FEATURE(json_parse_document, "Parse document")
+	SCENARIO("Escapes")
+		GIVEN("a document with escaped strings and UTF-16 surrogates")
+		const char *text = "{\"s\": \"a\\\"b\\\\c\\/d\\n\\t"
+				"\\u00e9\\ud83d\\ude00\"}";
+
+		WHEN("I parse it")
+		json_t *root = NULL;
+		const int error = (int)json_parse_document(&root, text);
+
+		THEN("the parse should be successful")
+		SHOULD_INT_EQUAL(error, (int)JSON_OK);
+		AND("the string should keep its escapes")
+		const json_t *s = json_find_first_label(root, "s")->child;
+		SHOULD_STR_EQUAL(s->text,
+				"a\\\"b\\\\c\\/d\\n\\t\\u00e9\\ud83d\\ude00");
+		AND("unescape to UTF-8")
+		char *unescaped = json_unescape(s->text);
+		SHOULD_STR_EQUAL(unescaped,
+				"a\"b\\c/d\n\t\xc3\xa9\xf0\x9f\x98\x80");
+		CFREE(unescaped);
+		json_free_value(&root);
+		SCENARIO_END
+
+	SCENARIO("Numbers")
+		GIVEN("a document with integers, fractions and exponents")
+		const char *text =
+				"{\"n\": [0, -0, 12, -3.25, 1e10, 2E-3, -4.5e+6]}";
+
+		WHEN("I parse it")
+		json_t *root = NULL;
+		const int error = (int)json_parse_document(&root, text);
+
+		THEN("the parse should be successful")
+		SHOULD_INT_EQUAL(error, (int)JSON_OK);
+		AND("the numbers should keep their text")
+		const char *expected[] = {
+			"0", "-0", "12", "-3.25", "1e10", "2E-3", "-4.5e+6"
+		};
+		const json_t *n = json_find_first_label(root, "n")->child->child;
+		for (int i = 0; i < 7; i++, n = n->next) {
+			SHOULD_INT_EQUAL((int)n->type, (int)JSON_NUMBER);
+			SHOULD_STR_EQUAL(n->text, expected[i]);
+		}
+		SHOULD_BE_TRUE(n == NULL);
+		json_free_value(&root);
+		SCENARIO_END
+
+	SCENARIO("Deep nesting")
+		GIVEN("a document nested deeper than the fast parser goes")
+		const int depth = 1000;
+		char *text;
+		CMALLOC(text, depth * 2 + 16);
+		strcpy(text, "{\"a\":");
+		for (int i = 0; i < depth; i++) {
+			strcat(text, "[");
+		}
+		for (int i = 0; i < depth; i++) {
+			strcat(text, "]");
+		}
+		strcat(text, "}");
+
+		WHEN("I parse it")
+		json_t *root = NULL;
+		const int error = (int)json_parse_document(&root, text);
+
+		THEN("the parse should be successful")
+		SHOULD_INT_EQUAL(error, (int)JSON_OK);
+		AND("the arrays should all be there")
+		int found = 0;
+		for (const json_t *v = json_find_first_label(root, "a")->child;
+				v != NULL; v = v->child) {
+			SHOULD_INT_EQUAL((int)v->type, (int)JSON_ARRAY);
+			found++;
+		}
+		SHOULD_INT_EQUAL(found, depth);
+		json_free_value(&root);
+		CFREE(text);
+		SCENARIO_END
+
+	SCENARIO("Duplicate labels")
+		GIVEN("a document with a repeated label")
+		const char *text = "{\"ab\": 1, \"ba\": 2, \"ab\": 3}";
+
+		WHEN("I parse it and look up the labels")
+		json_t *root = NULL;
+		const int error = (int)json_parse_document(&root, text);
+
+		THEN("the parse should be successful")
+		SHOULD_INT_EQUAL(error, (int)JSON_OK);
+		AND("the first of the repeated labels should be found")
+		SHOULD_STR_EQUAL(json_find_first_label(root, "ab")->child->text, "1");
+		SHOULD_STR_EQUAL(json_find_first_label(root, "ba")->child->text, "2");
+		AND("missing labels should not be found")
+		SHOULD_BE_TRUE(json_find_first_label(root, "a") == NULL);
+		SHOULD_BE_TRUE(json_find_first_label(root, "abc") == NULL);
+		json_free_value(&root);
+		SCENARIO_END
+
+	SCENARIO("Malformed documents")
+		GIVEN("malformed documents")
+		const struct {
+			const char *text;
+			enum json_error error;
+		} cases[] = {
+			{ "", JSON_INCOMPLETE_DOCUMENT },
+			{ "   ", JSON_MALFORMED_DOCUMENT },
+			{ "[1]", JSON_MALFORMED_DOCUMENT },
+			{ "{", JSON_INCOMPLETE_DOCUMENT },
+			{ "{\"a\":1", JSON_INCOMPLETE_DOCUMENT },
+			{ "{\"a\":\"abc", JSON_INCOMPLETE_DOCUMENT },
+			{ "{\"a\":1,}", JSON_MALFORMED_DOCUMENT },
+			{ "{a:1}", JSON_MALFORMED_DOCUMENT },
+			{ "{\"a\" 1}", JSON_MALFORMED_DOCUMENT },
+			{ "{\"a\":[,1]}", JSON_MALFORMED_DOCUMENT },
+			{ "{\"a\":{\"b\":}}", JSON_MALFORMED_DOCUMENT },
+			{ "{} x", JSON_MALFORMED_DOCUMENT },
+			{ "{\"a\":01}", JSON_ILLEGAL_CHARACTER },
+			{ "{\"a\":1.}", JSON_ILLEGAL_CHARACTER },
+			{ "{\"a\":1e}", JSON_ILLEGAL_CHARACTER },
+			{ "{\"a\":-}", JSON_ILLEGAL_CHARACTER },
+			{ "{\"a\":+1}", JSON_ILLEGAL_CHARACTER },
+			{ "{\"a\":tru}", JSON_ILLEGAL_CHARACTER },
+			{ "{\"a\":\"\\x\"}", JSON_ILLEGAL_CHARACTER },
+			{ "{\"a\":\"\\u12G4\"}", JSON_ILLEGAL_CHARACTER },
+			{ "{\"a\":\"a\nb\"}", JSON_ILLEGAL_CHARACTER },
+		};
+
+		WHEN("I parse them")
+		THEN("they should fail with the same errors as they always have")
+		for (int i = 0; i < (int)(sizeof cases / sizeof cases[0]); i++) {
+			json_t *root = NULL;
+			SHOULD_INT_EQUAL((int)json_parse_document(&root, cases[i].text),
+					(int)cases[i].error);
+			SHOULD_BE_TRUE(root == NULL);
+		}
+		SCENARIO_END
+
+	SCENARIO("Trailing comma in array")
+		GIVEN("an array with a trailing comma, as accepted before")
+		const char *text = "{\"a\": [1, 2,]}";
+
+		WHEN("I parse it")
+		json_t *root = NULL;
+		const int error = (int)json_parse_document(&root, text);
+
+		THEN("the parse should be successful")
+		SHOULD_INT_EQUAL(error, (int)JSON_OK);
+		json_free_value(&root);
+		SCENARIO_END
+
+	SCENARIO("In place")
+		GIVEN("a buffer holding a document")
+		const char *text = "{\"s\": \"abc\", \"n\": [12,3 ]}";
+		char *buffer;
+		CSTRDUP(buffer, text);
+		const size_t length = strlen(buffer);
+
+		WHEN("I parse the buffer")
+		json_t *root = NULL;
+		const int error = (int)json_parse_buffer(&root, buffer, NULL);
+
+		THEN("the parse should be successful")
+		SHOULD_INT_EQUAL(error, (int)JSON_OK);
+		AND("the strings and numbers should point into the buffer")
+		const json_t *s = json_find_first_label(root, "s");
+		SHOULD_BE_TRUE(s->text >= buffer && s->text < buffer + length);
+		SHOULD_STR_EQUAL(s->child->text, "abc");
+		SHOULD_BE_TRUE(
+				s->child->text >= buffer && s->child->text < buffer + length);
+		const json_t *n = json_find_first_label(root, "n")->child->child;
+		SHOULD_STR_EQUAL(n->text, "12");
+		SHOULD_STR_EQUAL(n->next->text, "3");
+		SHOULD_BE_TRUE(n->next->next == NULL);
+		AND("nodes added later should be freed with the document")
+		json_insert_pair_into_object(root, "added", json_new_string("x"));
+		SHOULD_STR_EQUAL(
+				json_find_first_label(root, "added")->child->text, "x");
+		json_free_value(&root);
+		SHOULD_BE_TRUE(root == NULL);
+		SCENARIO_END
+
+	SCENARIO("Big objects")
+		GIVEN("an object with many labels, some repeated")
+		char text[4096];
+		strcpy(text, "{");
+		for (int i = 0; i < 100; i++) {
+			char buf[32];
+			sprintf(buf, "%s\"k%d\": %d", i > 0 ? ", " : "", i % 90, i);
+			strcat(text, buf);
+		}
+		strcat(text, ", \"o\": {\"k1\": 1}}");
+
+		WHEN("I parse it")
+		json_t *root = NULL;
+		const int error = (int)json_parse_document(&root, text);
+
+		THEN("the parse should be successful")
+		SHOULD_INT_EQUAL(error, (int)JSON_OK);
+		AND("every label should be found, the first of repeats first")
+		bool found = true;
+		for (int i = 0; i < 90; i++) {
+			char label[16];
+			char value[16];
+			sprintf(label, "k%d", i);
+			sprintf(value, "%d", i);
+			const json_t *l = json_find_first_label(root, label);
+			found = found && l != NULL && strcmp(l->child->text, value) == 0;
+		}
+		SHOULD_BE_TRUE(found);
+		AND("labels should only be found in their own object")
+		SHOULD_BE_TRUE(json_find_first_label(root, "k90") == NULL);
+		const json_t *o = json_find_first_label(root, "o")->child;
+		SHOULD_BE_TRUE(json_find_first_label(o, "k2") == NULL);
+		SHOULD_STR_EQUAL(json_find_first_label(o, "k1")->child->text, "1");
+		AND("labels added later should be found too")
+		AddIntPair(root, "k90", 90);
+		SHOULD_STR_EQUAL(
+				json_find_first_label(root, "k90")->child->text, "90");
+		SHOULD_STR_EQUAL(
+				json_find_first_label(root, "k89")->child->text, "89");
+		json_free_value(&root);
+		SCENARIO_END
+	FEATURE_END
+
+static void CountElement(json_t *element, void *data) {
+	int *sum = (int *)data;
+	*sum += atoi(json_find_first_label(element, "v")->child->text);
+}
+FEATURE(json_parse_buffer, "Stream array")
+	SCENARIO("Elements handed over one at a time")
+		GIVEN("a document with a big array")
+		const int count = 5000;
+		char *text;
+		CMALLOC(text, count * 32 + 64);
+		strcpy(text, "{\"Version\": 1, \"Items\": [");
+		char *p = text + strlen(text);
+		for (int i = 0; i < count; i++) {
+			p += sprintf(p, "%s{\"v\": %d, \"a\": [1, 2]}",
+					i > 0 ? "," : "", i);
+		}
+		strcpy(p, "], \"After\": true}");
+
+		WHEN("I parse it, streaming the array")
+		json_t *root = NULL;
+		int sum = 0;
+		struct json_array_stream stream = { "Items", CountElement, &sum };
+		const int error = (int)json_parse_buffer(&root, text, &stream);
+
+		THEN("the parse should be successful")
+		SHOULD_INT_EQUAL(error, (int)JSON_OK);
+		AND("every element should have been handed over")
+		SHOULD_INT_EQUAL(sum, count * (count - 1) / 2);
+		AND("the array should be left empty")
+		SHOULD_BE_TRUE(json_find_first_label(root, "Items")->child->child
+				== NULL);
+		AND("the rest of the document should be kept")
+		SHOULD_STR_EQUAL(
+				json_find_first_label(root, "Version")->child->text, "1");
+		SHOULD_INT_EQUAL(
+				(int)json_find_first_label(root, "After")->child->type,
+				(int)JSON_TRUE);
+		json_free_value(&root);
+		SCENARIO_END
+	FEATURE_END
+
+FEATURE(json_flatten, "Flat documents")
+	SCENARIO("Round trip")
+		GIVEN("a parsed document")
+		json_t *root = NULL;
+		json_parse_document(&root,
+				"{\"Version\": 2, \"Items\": [{\"Name\": \"a\\\"b\", "
+				"\"Ok\": true}, [], {}, null, -1.5e3], \"Empty\": \"\", "
+				"\"A\": 1, \"B\": 2, \"C\": 3, \"D\": 4, \"E\": 5}");
+		char *expected = NULL;
+		json_tree_to_string(root, &expected);
+
+		WHEN("I flatten it and rebuild it")
+		struct json_flat_node *nodes;
+		size_t count;
+		char *strings;
+		size_t length;
+		const int flattened =
+				(int)json_flatten(root, &nodes, &count, &strings, &length);
+		json_t *rebuilt = NULL;
+		const int error = (int)json_unflatten(&rebuilt, nodes, count, strings,
+				length);
+
+		THEN("both should be successful")
+		SHOULD_INT_EQUAL(flattened, (int)JSON_OK);
+		SHOULD_INT_EQUAL(error, (int)JSON_OK);
+		AND("the rebuilt document should be the same")
+		char *actual = NULL;
+		json_tree_to_string(rebuilt, &actual);
+		SHOULD_STR_EQUAL(actual, expected);
+		AND("its labels should be found")
+		SHOULD_STR_EQUAL(
+				json_find_first_label(rebuilt, "E")->child->text, "5");
+		SHOULD_STR_EQUAL(
+				json_find_first_label(rebuilt, "Empty")->child->text, "");
+		SHOULD_BE_TRUE(json_find_first_label(rebuilt, "F") == NULL);
+		free(actual);
+		free(expected);
+		free(nodes);
+		free(strings);
+		json_free_value(&rebuilt);
+		json_free_value(&root);
+		SCENARIO_END
+	SCENARIO("Malformed nodes")
+		GIVEN("nodes that don't make a document")
+		const char strings[] = "a\0b";
+		const struct json_flat_node valueInObject[] = {
+			{ -1, JSON_OBJECT, JSON_FLAT_NO_TEXT },
+			{ 0, JSON_NUMBER, 2 }
+		};
+		const struct json_flat_node parentAfter[] = {
+			{ -1, JSON_OBJECT, JSON_FLAT_NO_TEXT },
+			{ 2, JSON_STRING, 0 },
+			{ 0, JSON_STRING, 2 }
+		};
+		const struct json_flat_node twoValues[] = {
+			{ -1, JSON_OBJECT, JSON_FLAT_NO_TEXT },
+			{ 0, JSON_STRING, 0 },
+			{ 1, JSON_TRUE, JSON_FLAT_NO_TEXT },
+			{ 1, JSON_TRUE, JSON_FLAT_NO_TEXT }
+		};
+		const struct json_flat_node textOutside[] = {
+			{ -1, JSON_OBJECT, JSON_FLAT_NO_TEXT },
+			{ 0, JSON_STRING, 4 }
+		};
+		const struct json_flat_node arrayRoot[] = {
+			{ -1, JSON_ARRAY, JSON_FLAT_NO_TEXT }
+		};
+
+		WHEN("I rebuild them")
+		json_t *root = NULL;
+		const int e1 = (int)json_unflatten(&root, valueInObject, 2, strings,
+				sizeof strings);
+		const int e2 = (int)json_unflatten(&root, parentAfter, 3, strings,
+				sizeof strings);
+		const int e3 = (int)json_unflatten(&root, twoValues, 4, strings,
+				sizeof strings);
+		const int e4 = (int)json_unflatten(&root, textOutside, 2, strings,
+				sizeof strings);
+		const int e5 = (int)json_unflatten(&root, arrayRoot, 1, strings,
+				sizeof strings);
+
+		THEN("each should fail")
+		SHOULD_INT_EQUAL(e1, (int)JSON_BAD_TREE_STRUCTURE);
+		SHOULD_INT_EQUAL(e2, (int)JSON_BAD_TREE_STRUCTURE);
+		SHOULD_INT_EQUAL(e3, (int)JSON_BAD_TREE_STRUCTURE);
+		SHOULD_INT_EQUAL(e4, (int)JSON_BAD_TREE_STRUCTURE);
+		SHOULD_INT_EQUAL(e5, (int)JSON_BAD_TREE_STRUCTURE);
+		AND("no document should be made")
+		SHOULD_BE_TRUE(root == NULL);
+		SCENARIO_END
+	FEATURE_END
+
+CBEHAVE_RUN("JSON features are:", TEST_FEATURE(json_format_string),
+		TEST_FEATURE(json_parse_document), TEST_FEATURE(json_parse_buffer),
+		TEST_FEATURE(json_flatten))
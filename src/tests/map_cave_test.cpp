@@ -0,0 +1,262 @@
+#include <cbehave/cbehave.h>
+
+#include <string.h>
+
+#include <map_cave.h>
+
+#include <SDL2/SDL_joystick.h>
+
+// Stubs
+const char* JoyName(const int deviceIndex) {
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+// Fixed seed generator so that the maps are the same on every platform
+static unsigned TestRand(unsigned *seed) {
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 16) & 0x7fff;
+}
+
+static int PaddedIndex(const struct vec2i size, const int x, const int y) {
+	return (y + CAVE_BORDER) * (size.x + 2 * CAVE_BORDER) + x + CAVE_BORDER;
+}
+static uint8_t *RandomWalls(const struct vec2i size, const int fill,
+		unsigned *seed) {
+	const int pw = size.x + 2 * CAVE_BORDER;
+	const int ph = size.y + 2 * CAVE_BORDER;
+	uint8_t *walls;
+	CMALLOC(walls, pw * ph);
+	memset(walls, 1, pw * ph);
+	for (int y = 0; y < size.y; y++) {
+		for (int x = 0; x < size.x; x++) {
+			walls[PaddedIndex(size, x, y)] =
+					(int) (TestRand(seed) % 100) < fill;
+		}
+	}
+	return walls;
+}
+
+// Reference automaton: count the neighbours of every tile one by one,
+// treating tiles outside the map as walls
+static int CountWallsAround(const uint8_t *walls, const struct vec2i size,
+		const int x, const int y, const int d) {
+	int c = 0;
+	for (int dy = -d; dy <= d; dy++) {
+		for (int dx = -d; dx <= d; dx++) {
+			const int nx = x + dx;
+			const int ny = y + dy;
+			if (nx < 0 || nx >= size.x || ny < 0 || ny >= size.y ||
+					walls[ny * size.x + nx]) {
+				c++;
+			}
+		}
+	}
+	return c;
+}
+static void CaveRepNaive(uint8_t *walls, const struct vec2i size,
+		const int r1, const int r2, const int reps) {
+	uint8_t *buf;
+	CMALLOC(buf, size.x * size.y);
+	for (int i = 0; i < reps; i++) {
+		for (int y = 0; y < size.y; y++) {
+			for (int x = 0; x < size.x; x++) {
+				buf[y * size.x + x] =
+						CountWallsAround(walls, size, x, y, 1) >= r1 ||
+						CountWallsAround(walls, size, x, y, 2) <= r2;
+			}
+		}
+		memcpy(walls, buf, size.x * size.y);
+	}
+	CFREE(buf);
+}
+
+// Runs the automaton both ways on a random map; returns whether they match
+static bool CaveRepMatches(const struct vec2i size, const int fill,
+		const int r1, const int r2, const int reps, unsigned *seed) {
+	uint8_t *walls = RandomWalls(size, fill, seed);
+	uint8_t *expected;
+	CMALLOC(expected, size.x * size.y);
+	for (int y = 0; y < size.y; y++) {
+		for (int x = 0; x < size.x; x++) {
+			expected[y * size.x + x] = walls[PaddedIndex(size, x, y)];
+		}
+	}
+	CaveRepWalls(walls, size, r1, r2, reps);
+	CaveRepNaive(expected, size, r1, r2, reps);
+	bool ok = true;
+	for (int y = 0; y < size.y; y++) {
+		for (int x = 0; x < size.x; x++) {
+			ok = ok && walls[PaddedIndex(size, x, y)] ==
+					expected[y * size.x + x];
+		}
+	}
+	// The border must stay all walls
+	const int pw = size.x + 2 * CAVE_BORDER;
+	const int ph = size.y + 2 * CAVE_BORDER;
+	for (int y = 0; y < ph; y++) {
+		for (int x = 0; x < pw; x++) {
+			const bool isBorder = x < CAVE_BORDER || y < CAVE_BORDER ||
+					x >= size.x + CAVE_BORDER || y >= size.y + CAVE_BORDER;
+			ok = ok && (!isBorder || walls[y * pw + x]);
+		}
+	}
+	CFREE(walls);
+	CFREE(expected);
+	return ok;
+}
+
+// Reference labeller: flood fill each area in scan order
+static void FloodFillNaive(int *labels, const struct vec2i size,
+		const int idx, const int label) {
+	int *stack;
+	CMALLOC(stack, size.x * size.y * sizeof *stack);
+	int top = 0;
+	stack[top++] = idx;
+	labels[idx] = label;
+	while (top > 0) {
+		const int i = stack[--top];
+		const int x = i % size.x;
+		const int y = i / size.x;
+		const int next[4] = {
+			y > 0 ? i - size.x : -1,
+			y < size.y - 1 ? i + size.x : -1,
+			x > 0 ? i - 1 : -1,
+			x < size.x - 1 ? i + 1 : -1
+		};
+		for (int j = 0; j < 4; j++) {
+			if (next[j] >= 0 && labels[next[j]] == 0) {
+				labels[next[j]] = label;
+				stack[top++] = next[j];
+			}
+		}
+	}
+	CFREE(stack);
+}
+static int LabelAreasNaive(int *labels, const struct vec2i size) {
+	int numAreas = 0;
+	for (int i = 0; i < size.x * size.y; i++) {
+		if (labels[i] == 0) {
+			FloodFillNaive(labels, size, i, ++numAreas);
+		}
+	}
+	return numAreas;
+}
+
+// Labels a random map both ways; returns whether they match
+static bool LabelAreasMatches(const struct vec2i size, const int fill,
+		unsigned *seed) {
+	CArray fl;
+	CArrayInit(&fl, sizeof(int));
+	const int zero = 0;
+	CArrayResize(&fl, size.x * size.y, &zero);
+	int *expected;
+	CMALLOC(expected, size.x * size.y * sizeof *expected);
+	CA_FOREACH(int, label, fl)
+		*label = (int) (TestRand(seed) % 100) < fill ? -1 : 0;
+		expected[_ca_index] = *label;
+	CA_FOREACH_END()
+	const int numAreas = CaveLabelAreas(&fl, size);
+	const int numAreasExpected = LabelAreasNaive(expected, size);
+	bool ok = numAreas == numAreasExpected &&
+			memcmp(fl.data, expected, size.x * size.y * sizeof *expected) == 0;
+	CArrayTerminate(&fl);
+	CFREE(expected);
+	return ok;
+}
+
+static const struct vec2i sizes[] = {
+	{ 1, 1 }, { 1, 7 }, { 9, 1 }, { 2, 3 }, { 5, 5 }, { 17, 11 },
+	{ 32, 32 }, { 64, 48 }
+};
+#define NUM_SIZES (sizeof sizes / sizeof sizes[0])
+
+FEATURE(CaveRep, "Cave automaton")
+	SCENARIO("Same result as counting every neighbour")
+		GIVEN("random maps of various sizes and fills, with a fixed seed")
+		unsigned seed = 1;
+		WHEN("the automaton is run with various rules and repetitions")
+		bool ok = true;
+		for (int i = 0; i < (int) NUM_SIZES; i++) {
+			for (int fill = 0; fill <= 100; fill += 20) {
+				for (int r1 = 0; r1 <= 10; r1 += 2) {
+					for (int r2 = -1; r2 <= 25; r2 += 4) {
+						for (int reps = 1; reps <= 4; reps++) {
+							ok = ok && CaveRepMatches(
+								sizes[i], fill, r1, r2, reps, &seed);
+						}
+					}
+				}
+			}
+		}
+		THEN("the result should be the same as the naive automaton")
+		SHOULD_BE_TRUE(ok);
+	SCENARIO_END
+	SCENARIO("Default cave settings")
+		GIVEN("a map with the default cave settings")
+		unsigned seed = 12345;
+		WHEN("the automaton is run")
+		bool ok = true;
+		for (int i = 0; i < 20; i++) {
+			ok = ok && CaveRepMatches(svec2i(48, 48), 40, 5, 2, 4, &seed);
+		}
+		THEN("the result should be the same as the naive automaton")
+		SHOULD_BE_TRUE(ok);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(CaveLabelAreas, "Cave area labelling")
+	SCENARIO("Same labels as flood filling in scan order")
+		GIVEN("random maps of various sizes and fills, with a fixed seed")
+		unsigned seed = 1;
+		WHEN("the areas are labelled")
+		bool ok = true;
+		for (int i = 0; i < (int) NUM_SIZES; i++) {
+			for (int fill = 0; fill <= 100; fill += 10) {
+				for (int j = 0; j < 10; j++) {
+					ok = ok && LabelAreasMatches(sizes[i], fill, &seed);
+				}
+			}
+		}
+		THEN("the labels should be the same as the naive flood fill")
+		SHOULD_BE_TRUE(ok);
+	SCENARIO_END
+	SCENARIO("Spiral")
+		GIVEN("a spiral, whose areas merge late in the scan")
+		const struct vec2i size = svec2i(9, 9);
+		const char *rows[] = {
+			".........",
+			"#######.#",
+			".....#.#.",
+			".###.#.#.",
+			".#.#.#.#.",
+			".#...#.#.",
+			".#####.#.",
+			".......#.",
+			"########.",
+		};
+		CArray fl;
+		CArrayInit(&fl, sizeof(int));
+		const int zero = 0;
+		CArrayResize(&fl, size.x * size.y, &zero);
+		CA_FOREACH(int, label, fl)
+			*label = rows[_ca_index / size.x][_ca_index % size.x] == '#' ?
+				-1 : 0;
+		CA_FOREACH_END()
+		WHEN("the areas are labelled")
+		const int numAreas = CaveLabelAreas(&fl, size);
+		THEN("there should be three areas")
+		SHOULD_INT_EQUAL(numAreas, 3);
+		AND("the top row should be the first area")
+		SHOULD_INT_EQUAL(*(int*) CArrayGet(&fl, 0 * 9 + 7), 1);
+		AND("the spiral should be the second area")
+		SHOULD_INT_EQUAL(*(int*) CArrayGet(&fl, 4 * 9 + 2), 2);
+		SHOULD_INT_EQUAL(*(int*) CArrayGet(&fl, 2 * 9 + 6), 2);
+		AND("the right edge should be the third area")
+		SHOULD_INT_EQUAL(*(int*) CArrayGet(&fl, 8 * 9 + 8), 3);
+		CArrayTerminate(&fl);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Map cave features are:", TEST_FEATURE(CaveRep),
+		TEST_FEATURE(CaveLabelAreas))